@@ -173,6 +173,26 @@ typedef struct xi_bsp_socket_events_s
     uint8_t out_socket_connect_finished : 1;
 } xi_bsp_socket_events_t;
 
+/**
+ * @typedef xi_bsp_io_net_iovec_t
+ * @brief One buffer of a gathering write.
+ *
+ * Describes a continuous piece of memory passed to xi_bsp_io_net_writev, the same way
+ * struct iovec does for POSIX writev().
+ */
+typedef struct xi_bsp_io_net_iovec_s
+{
+    /** the data to send */
+    const uint8_t* buf;
+    /** number of bytes to send from the buffer */
+    size_t count;
+} xi_bsp_io_net_iovec_t;
+
+/** maximum number of buffers the Xively Client passes to a single writev call */
+#ifndef XI_BSP_IO_NET_IOVEC_MAX
+#define XI_BSP_IO_NET_IOVEC_MAX 8
+#endif
+
 /**
  * @function
  * @brief Provides a method for the Xively library to query socket states. These states
@@ -189,19 +209,22 @@ typedef struct xi_bsp_socket_events_s
  * state of the socket and fill in the corresponding fields in xi_bsp_socket_state_t for
  * that descriptor.
  *
+ * This function replaces xi_bsp_io_net_select, which took its timeout in seconds.
+ *
  * @param [in] socket_events_array an array of sockets and sockets' events
  * @param [in] socket_events_array_size size of the socket_events_array
- * @param [in] timeout used for passive waiting function must not wait longer than the
- * given timeout ( in seconds )
+ * @param [in] timeout_ms used for passive waiting function must not wait longer than
+ * the given timeout ( in milliseconds )
  *
  * @return
  * - XI_BSP_IO_NET_STATE_OK - if select call updated any socket event
  * - XI_BSP_IO_NET_STATE_TIMEOUT - if select call has encountered timeout
  * - XI_BSP_IO_NET_STATE_ERROR - if select call finished with error
  */
-xi_bsp_io_net_state_t xi_bsp_io_net_select( xi_bsp_socket_events_t* socket_events_array,
-                                            size_t socket_events_array_size,
-                                            long timeout_sec /* in seconds */ );
+xi_bsp_io_net_state_t
+xi_bsp_io_net_select_ms( xi_bsp_socket_events_t* socket_events_array,
+                         size_t socket_events_array_size,
+                         long timeout_ms /* in milliseconds */ );
 
 /**
  * @function
@@ -293,6 +316,28 @@ xi_bsp_io_net_state_t xi_bsp_io_net_write( xi_bsp_socket_t xi_socket_nonblocking
                                            int* out_written_count,
                                            const uint8_t* buf,
                                            size_t count );
+
+/**
+ * @function
+ * @brief Sends data from several buffers on the socket with a single write.
+ *
+ * The Xively Client calls this function when an outgoing message is made of more than
+ * one buffer, e.g. an MQTT PUBLISH header followed by the application's payload. The
+ * buffers should be sent in order as if they were one continuous buffer. On platforms
+ * without a gathering write it is enough to send only the first buffer, the Xively
+ * Client calls this function again with the remaining data.
+ *
+ * @param [in] xi_socket_nonblocking data is sent on this socket
+ * @param [out] out_written_count upon return this should contain the number of sent bytes
+ *                                counted over all the buffers
+ * @param [in] iov the buffers to send, none of them is empty
+ * @param [in] iov_count number of buffers, at most XI_BSP_IO_NET_IOVEC_MAX
+ * @return same as for xi_bsp_io_net_write with count being the sum of the buffer sizes
+ */
+xi_bsp_io_net_state_t xi_bsp_io_net_writev( xi_bsp_socket_t xi_socket_nonblocking,
+                                            int* out_written_count,
+                                            const xi_bsp_io_net_iovec_t* iov,
+                                            int iov_count );
 /**
  * @function
  * @brief Reads data from the socket.
@@ -47,6 +47,17 @@ xi_time_t xi_bsp_time_getcurrenttime_seconds();
  */
 xi_time_t xi_bsp_time_getcurrenttime_milliseconds();
 
+/**
+ * @function
+ * @brief Returns elapsed milliseconds since an arbitrary fixed point, e.g. boot.
+ *
+ * Unlike xi_bsp_time_getcurrenttime_milliseconds this clock must never step
+ * backwards or forwards when the wall clock is adjusted. The event dispatcher
+ * schedules its timers against it whenever xi_time_t is wide enough to hold a
+ * millisecond count. On platforms with a 32 bit xi_time_t it is allowed to wrap.
+ */
+xi_time_t xi_bsp_time_getmonotonictime_milliseconds();
+
 #ifdef __cplusplus
 }
 #endif
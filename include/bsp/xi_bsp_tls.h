@@ -51,6 +51,30 @@ typedef enum xi_bsp_tls_state_e {
     XI_BSP_TLS_STATE_WRITE_ERROR = 7,
 } xi_bsp_tls_state_t;
 
+/**
+ * @typedef xi_bsp_tls_config_t
+ * @brief Xively Client BSP TLS's shared configuration representation type
+ *
+ * Holds everything that does not depend on a single connection, e.g. the parsed CA
+ * certificates, the TLS library's configuration or a seeded random generator, so that
+ * it is made once and used by every TLS context and every reconnect. It is reference
+ * counted: xi_bsp_tls_config_create returns it with one reference, xi_bsp_tls_init takes
+ * one more for the context and xi_bsp_tls_cleanup drops it. The Xively Client is unaware
+ * of the actual content and structure thus does not read or write this configuration.
+ */
+typedef void xi_bsp_tls_config_t;
+
+/**
+ * @typedef xi_bsp_tls_session_t
+ * @brief Xively Client BSP TLS's session representation type
+ *
+ * A session negotiated by a finished handshake, e.g. a session id or a session ticket
+ * with its master secret. The Xively Client keeps the last one and offers it on the next
+ * connection so that the server can resume it and skip the asymmetric cryptography of a
+ * full handshake. The Xively Client is unaware of its content.
+ */
+typedef void xi_bsp_tls_session_t;
+
 /**
  * @typedef xi_bsp_tls_init_params_t
  * @brief Xively Client BSP TLS init function parameters.
@@ -79,6 +103,10 @@ typedef struct xi_bsp_tls_init_params_s
      * check and SNI */
     const char* domain_name;
 
+    /** shared configuration made by xi_bsp_tls_config_create, if not NULL it must be
+     * used instead of the ca_cert_pem_buf and referenced until xi_bsp_tls_cleanup */
+    xi_bsp_tls_config_t* tls_config;
+
 } xi_bsp_tls_init_params_t;
 
 /**
@@ -91,6 +119,38 @@ typedef struct xi_bsp_tls_init_params_s
  */
 typedef void xi_bsp_tls_context_t;
 
+/**
+ * @function
+ * @brief Makes the configuration shared by TLS contexts.
+ *
+ * Parses the CA certificate from the init_params and prepares everything else that the
+ * contexts can share. Only the CA certificate and the allocator fields of the
+ * init_params are used, the content of the init_params will be destroyed after the
+ * xi_bsp_tls_config_create exits. The Xively Client calls it once and passes the
+ * result to each xi_bsp_tls_init through init_params->tls_config.
+ *
+ * @param [out] tls_config pointer to a NULL pointer to a xi_bsp_tls_config_t
+ * @param [in] init_params data required for TLS library initialisation
+ * @return
+ *  - XI_BSP_TLS_STATE_OK in case of success
+ *  - XI_BSP_TLS_STATE_CERT_ERROR if the CA certificate can't be loaded
+ *  - XI_BSP_TLS_STATE_INIT_ERROR otherwise
+ */
+xi_bsp_tls_state_t xi_bsp_tls_config_create( xi_bsp_tls_config_t** tls_config,
+                                             xi_bsp_tls_init_params_t* init_params );
+
+/**
+ * @function
+ * @brief Drops a reference to the shared configuration.
+ *
+ * The configuration is deallocated with its last reference. Must set *tls_config to
+ * NULL.
+ *
+ * @param [in|out] tls_config
+ * @return XI_BSP_TLS_STATE_OK
+ */
+xi_bsp_tls_state_t xi_bsp_tls_config_release( xi_bsp_tls_config_t** tls_config );
+
 /**
  * @function
  * @brief Provides a method for the Xively library to initialise a TLS library.
@@ -111,6 +171,10 @@ typedef void xi_bsp_tls_context_t;
  * or received correctly throught the Xively Client's I/O system. For more details please
  * refer to our reference implementations for WolfSSL and MBEDTLS libraries.
  *
+ * If init_params->tls_config is not NULL the context must take a reference to it and use
+ * it, otherwise the context makes its own configuration as xi_bsp_tls_config_create
+ * would.
+ *
  * @param [out] tls_context pointer to a pointer to a xi_bsp_tls_context_t
  * @param [in] init_params data required for TLS library initialisation
  * @return
@@ -123,8 +187,9 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
  * @function
  * @brief Provides a method for the Xively library to clean the TLS library.
  *
- * Must deallocate the TLS library's previously allocated resources. Must clean content of
- * the *tls_context.
+ * Must deallocate the TLS library's previously allocated resources and drop the
+ * context's reference to the shared configuration. Must clean content of the
+ * *tls_context.
  *
  * @param [in|out] tls_context
  * @return XI_BSP_TLS_STATE_OK
@@ -154,6 +219,51 @@ xi_bsp_tls_state_t xi_bsp_tls_cleanup( xi_bsp_tls_context_t** tls_context );
  */
 xi_bsp_tls_state_t xi_bsp_tls_connect( xi_bsp_tls_context_t* tls_context );
 
+/**
+ * @function
+ * @brief Saves the session of a connection for a later resumption.
+ *
+ * Called after xi_bsp_tls_connect returned XI_BSP_TLS_STATE_OK. The session returned is
+ * owned by the caller and must stay valid after the xi_bsp_tls_cleanup of the context,
+ * the Xively Client releases it with xi_bsp_tls_session_free.
+ *
+ * @param [in] tls_context
+ * @param [out] session pointer to a NULL pointer to a xi_bsp_tls_session_t
+ * @return
+ *  - XI_BSP_TLS_STATE_OK in case of success
+ *  - XI_BSP_TLS_STATE_CONNECT_ERROR if there is no session to save
+ */
+xi_bsp_tls_state_t xi_bsp_tls_save_session( xi_bsp_tls_context_t* tls_context,
+                                            xi_bsp_tls_session_t** session );
+
+/**
+ * @function
+ * @brief Offers a saved session to the server during the next handshake.
+ *
+ * Called after xi_bsp_tls_init and before the first xi_bsp_tls_connect of the context.
+ * The session stays owned by the caller. If the server declines it the handshake must
+ * fall back to a full one, so an error returned here is not fatal for the connection.
+ *
+ * @param [in] tls_context
+ * @param [in] session made by xi_bsp_tls_save_session
+ * @return
+ *  - XI_BSP_TLS_STATE_OK in case of success
+ *  - XI_BSP_TLS_STATE_INIT_ERROR otherwise
+ */
+xi_bsp_tls_state_t xi_bsp_tls_restore_session( xi_bsp_tls_context_t* tls_context,
+                                               xi_bsp_tls_session_t* session );
+
+/**
+ * @function
+ * @brief Releases a session made by xi_bsp_tls_save_session.
+ *
+ * Must set *session to NULL.
+ *
+ * @param [in|out] session
+ * @return XI_BSP_TLS_STATE_OK
+ */
+xi_bsp_tls_state_t xi_bsp_tls_session_free( xi_bsp_tls_session_t** session );
+
 /**
  * @function
  * @brief Implements the TLS read.
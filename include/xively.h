@@ -473,6 +473,8 @@ extern xi_state_t xi_connect_with_lastwill_to( xi_context_handle_t xih,
  * to fulfill the request
  * @retval XI_INTERNAL_ERROR   If an unforseen and unrecoverable error has occured.
  * @retval XI_BACKOFF_TERMINAL If backoff has been applied
+ * @retval XI_MQTT_PUBLISH_WINDOW_FULL If a QoS1 message can not be queued because
+ * the publish window is full, see xi_set_publish_window
  */
 extern xi_state_t xi_publish( xi_context_handle_t xih,
                               const char* topic,
@@ -523,6 +525,8 @@ extern xi_state_t xi_publish( xi_context_handle_t xih,
  * fulfill the request
  * @retval XI_INTERNAL_ERROR  If an unforseen and unrecoverable error has
  * occurred.
+ * @retval XI_MQTT_PUBLISH_WINDOW_FULL If a QoS1 message can not be queued because
+ * the publish window is full, see xi_set_publish_window
  */
 extern xi_state_t xi_publish_timeseries( xi_context_handle_t xih,
                                          const char* topic,
@@ -613,6 +617,8 @@ extern xi_state_t xi_publish_timeseries( xi_context_handle_t xih,
  * to fulfill the request
  * @retval XI_INTERNAL_ERROR    If an unforseen and unrecoverable error has
  * occurred.
+ * @retval XI_MQTT_PUBLISH_WINDOW_FULL If a QoS1 message can not be queued because
+ * the publish window is full, see xi_set_publish_window
  */
 extern xi_state_t xi_publish_formatted_timeseries( xi_context_handle_t xih,
                                                    const char* topic,
@@ -669,6 +675,8 @@ extern xi_state_t xi_publish_formatted_timeseries( xi_context_handle_t xih,
  * fulfill the request
  * @retval XI_INTERNAL_ERROR  If an unforseen and unrecoverable error has
  * occurred.
+ * @retval XI_MQTT_PUBLISH_WINDOW_FULL If a QoS1 message can not be queued because
+ * the publish window is full, see xi_set_publish_window
  */
 extern xi_state_t xi_publish_data( xi_context_handle_t xih,
                                    const char* topic,
@@ -679,6 +687,54 @@ extern xi_state_t xi_publish_data( xi_context_handle_t xih,
                                    xi_user_callback_t* callback,
                                    void* user_data );
 
+/**
+ * @brief     Publishes binary data without copying it.
+ * @detailed  Works as xi_publish_data, except the payload is not copied into the Xively
+ * Client's memory. It is sent straight from the given buffer, which the application
+ * lends to the Xively Client and must keep unchanged until release_callback is called.
+ *
+ * release_callback is called from the Xively Client's event processing once the
+ * message is no longer needed: after it has been written for QoS 0, after PUBACK
+ * arrived for QoS 1, or when the publication is dropped because of an error or a
+ * shutdown. It is called exactly once for each successful call of this function. If
+ * this function returns an error, XI_MQTT_PUBLISH_WINDOW_FULL included, the buffer
+ * stays with the application and release_callback is not called.
+ *
+ * @param [in] xih a context handle created by invoking xi_create_context
+ * @param [in] topic a string based topic name that you have created for
+ * messaging via the xively webservice.
+ * @param [in] data the payload to send to the xively service.
+ * @param [in] data_len size of the payload in bytes.
+ * @param [in] qos Quality of Service MQTT level. 0, 1, or 2.
+ * @param [in] retain of the message, retain may be XI_MQTT_RETAIN_TRUE or
+ * XI_MQTT_RETAIN_FALSE.
+ * @param [in] callback Optional callback function that will be called upon
+ * successful or unsuccessful msg delivery. This may be NULL.
+ * @param [in] release_callback function that hands the data buffer back to the
+ * application. Must not be NULL.
+ * @param [in] user_data Optional abstract data that will be passed to both callbacks.
+ * This may be NULL.
+ *
+ * @see xi_publish_data
+ *
+ * @retval XI_STATE_OK If the publication request was formatted correctly.
+ * @retval XI_OUT_OF_MEMORY   If the platform did not have enough free memory to
+ * fulfill the request
+ * @retval XI_BACKOFF_TERMINAL If backoff has been applied
+ * @retval XI_MQTT_PUBLISH_WINDOW_FULL If a QoS1 message can not be queued because
+ * the publish window is full, see xi_set_publish_window
+ */
+extern xi_state_t
+xi_publish_data_borrowed( xi_context_handle_t xih,
+                          const char* topic,
+                          const uint8_t* data,
+                          size_t data_len,
+                          const xi_mqtt_qos_t qos,
+                          const xi_mqtt_retain_t retain,
+                          xi_user_callback_t* callback,
+                          xi_buffer_release_callback_t* release_callback,
+                          void* user_data );
+
 /**
  * @brief     Subscribes to request notifications if a message from the xively
  * service is posted to the given topic.
@@ -731,6 +787,40 @@ extern xi_state_t xi_subscribe( xi_context_handle_t xih,
                                 xi_user_subscription_callback_t* callback,
                                 void* user_data );
 
+/**
+ * @brief     Subscribes to a topic whose messages are passed to the callback in parts
+ * as they are received.
+ * @detailed  Works like xi_subscribe except for the messages. Instead of one
+ * XI_SUB_CALL_MESSAGE call with the whole payload, the callback gets successive
+ * XI_SUB_CALL_MESSAGE_CHUNK calls. In each of them temporary_payload_data holds the
+ * part of the payload starting at payload_offset and is_final_chunk is set in the last
+ * one. A part is at most XI_MQTT_INBOUND_PAYLOAD_CHUNK_SIZE bytes long and payloads
+ * shorter than that arrive in a single call. So messages of any size can be processed
+ * while the memory used for them stays bounded by the part size.
+ *
+ * A QoS 1 message is acknowledged after its last part.
+ *
+ * @param [in] xih a context handle created by invoking xi_create_context
+ * @param [in] topic a string based topic name that you have created for
+ * messaging via the xively webservice.
+ * @param [in] qos Quality of Service MQTT level. 0, 1, or 2.
+ * @param [in] callback a function pointer to be invoked with the subscription
+ * confirmation and with each part of the messages
+ * @param [in] user a pointer that will be returned back during the callback invocation
+ *
+ * @see xi_subscribe
+ *
+ * @retval XI_STATE_OK If the subscription request was formatted correctly.
+ * @retval XI_OUT_OF_MEMORY   If the platform did not have enough free memory to
+ * fulfill the request
+ * @retval XI_INTERNAL_ERROR  If an unforseen and unrecoverable error has occurred.
+ */
+extern xi_state_t xi_subscribe_streamed( xi_context_handle_t xih,
+                                         const char* topic,
+                                         const xi_mqtt_qos_t qos,
+                                         xi_user_subscription_callback_t* callback,
+                                         void* user_data );
+
 /**
  * @brief     Closes the connection associated with the provide context.
  * @detailed  Closes connection to the Xively Service.  This will happen asynchronously.
@@ -790,6 +880,31 @@ xi_timed_task_handle_t xi_schedule_timed_task( xi_context_handle_t xih,
                                                const uint8_t repeats_forever,
                                                void* data );
 
+/**
+ * @brief     Same as xi_schedule_timed_task but with the delay given in milliseconds
+ * @detailed  The delay is rounded up to the resolution of the library clock, which is
+ * a millisecond on POSIX platforms with a 64 bit long and a second elsewhere.
+ *
+ * @param [in] xih a context handle created by invoking xi_create_context
+ * @param [in] xi_user_task_callback_t* a function pointer to be invoked when
+ * given time has passed
+ * @param [in] milliseconds_from_now number of milliseconds to wait before task
+ * invocation
+ * @param [in] repeats_forever if zero is passed the callback will be called only once,
+ * otherwise the callback will be called continuously with the milliseconds_from_now
+ * delay until xi_cancel_timed_task() called.
+ *
+ * @see xi_schedule_timed_task
+ * @see xi_cancel_timed_task
+ *
+ * @retval xi_time_task_handle_t same as in xi_schedule_timed_task
+ */
+xi_timed_task_handle_t xi_schedule_timed_task_ms( xi_context_handle_t xih,
+                                                  xi_user_task_callback_t* callback,
+                                                  const xi_time_t milliseconds_from_now,
+                                                  const uint8_t repeats_forever,
+                                                  void* data );
+
 /**
  * @brief     Cancel a timed task
  * @detailed  This function cancels the timed execution of the task defined by the given
@@ -836,6 +951,59 @@ extern void xi_set_network_timeout( uint32_t timeout );
  **/
 extern uint32_t xi_get_network_timeout( void );
 
+/**
+ * @brief     Sets the size of the buffer the Xively Client reads the socket into
+ * @detailed  Each read from the socket, and each read of decrypted data from the TLS
+ * library, is done into a buffer of this size. A larger buffer means fewer read calls
+ * and fewer passes through the layer chain for large inbound messages at the cost of
+ * memory held per read. The default is XI_IO_BUFFER_SIZE, 16 KB on POSIX platforms.
+ *
+ * The new size is used for the reads started after this call.
+ *
+ * @param [in] size of the receive buffer in bytes, must be greater than zero.
+ *
+ * @retval XI_STATE_OK              If the size was set.
+ * @retval XI_INVALID_PARAMETER     If the size was zero.
+ *
+ * @see xi_get_io_buffer_size
+ **/
+extern xi_state_t xi_set_io_buffer_size( uint32_t size );
+
+/**
+ * @brief     Returns the size of the buffer the Xively Client reads the socket into
+ *
+ * @see xi_set_io_buffer_size
+ **/
+extern uint32_t xi_get_io_buffer_size( void );
+
+/**
+ * @brief     Sets how many QoS1 messages may wait for their PUBACK at the same time
+ * @detailed  The Xively Client sends up to this many QoS1 publications without waiting
+ * for the broker to acknowledge the ones sent before. Once this many are sent and not
+ * acknowledged, or queued to be sent, xi_publish* calls of QoS1 return
+ * XI_MQTT_PUBLISH_WINDOW_FULL until an acknowledgement arrives. Publications are
+ * handed to the event loop asynchronously, so the ones made in a burst before the
+ * loop runs may go over the window by a few; these wait and are sent in the order
+ * they were made as the acknowledgements arrive. Publications made before the
+ * connection is open wait the same way. The default is XI_MQTT_PUBLISH_WINDOW, 0,
+ * which means no limit.
+ *
+ * The messages not yet acknowledged when the connection is lost are sent again in the
+ * original order after a reconnect if the session is continued.
+ *
+ * @param [in] window the number of QoS1 messages in flight, 0 for no limit.
+ *
+ * @see xi_get_publish_window
+ **/
+extern void xi_set_publish_window( uint16_t window );
+
+/**
+ * @brief     Returns how many QoS1 messages may wait for their PUBACK at the same time
+ *
+ * @see xi_set_publish_window
+ **/
+extern uint16_t xi_get_publish_window( void );
+
 
 /**
  * @brief     Sets Maximum Amount of Heap Allocated Memory the Xively Client May Use
@@ -87,6 +87,7 @@ typedef enum {
     XI_FS_WRITE_ERROR,                     /* 66 */
     XI_FS_CLOSE_ERROR,                     /* 67 */
     XI_FS_REMOVE_ERROR,                    /* 68 */
+    XI_MQTT_PUBLISH_WINDOW_FULL,           /* 69 */
     XI_ERROR_COUNT /* add above this line, and this sould always be last. */
 } xi_state_t;
 
@@ -69,6 +69,18 @@ typedef void( xi_user_callback_t )( xi_context_handle_t in_context_handle,
                                     void* data,
                                     xi_state_t state );
 
+/**
+ * @typedef xi_buffer_release_callback_t
+ * @brief callback used to hand a borrowed buffer back to the application
+ *
+ * Called once the Xively Client no longer references a buffer passed to
+ * xi_publish_data_borrowed, after that the application may free or reuse it.
+ *
+ * @param [in]  buffer the data pointer given to xi_publish_data_borrowed
+ * @param [in]  user_data the user_data given to xi_publish_data_borrowed
+ */
+typedef void( xi_buffer_release_callback_t )( const uint8_t* buffer, void* user_data );
+
 /**
  * @enum xi_sub_call_type_t
  * @brief determines the subscription callback type and the data passed to the user
@@ -80,11 +92,15 @@ typedef void( xi_user_callback_t )( xi_context_handle_t in_context_handle,
  * should be used from the params
  * XI_SUBSCRIPTION_DATA_MESSAGE - callback is a MESSAGE notification thus message part
  * should be used from the params
+ * XI_SUB_CALL_MESSAGE_CHUNK - callback carries a part of a MESSAGE received on a
+ * subscription made with xi_subscribe_streamed, message part of the params holds the
+ * part and its position within the payload
  */
 typedef enum xi_subscription_data_type_e {
     XI_SUB_CALL_UNKNOWN = 0,
     XI_SUB_CALL_SUBACK,
-    XI_SUB_CALL_MESSAGE
+    XI_SUB_CALL_MESSAGE,
+    XI_SUB_CALL_MESSAGE_CHUNK
 } xi_sub_call_type_t;
 
 /**
@@ -114,6 +130,12 @@ typedef union xi_sub_call_params_u {
         xi_mqtt_retain_t retain;
         xi_mqtt_qos_t qos;
         xi_mqtt_dup_t dup_flag;
+        /* where temporary_payload_data starts within the whole payload, its length and
+         * whether temporary_payload_data holds its end, a whole message is a single
+         * final chunk at offset 0 */
+        size_t payload_offset;
+        size_t payload_total_length;
+        uint8_t is_final_chunk;
     } message;
 } xi_sub_call_params_t;
 
@@ -126,7 +148,10 @@ typedef union xi_sub_call_params_u {
             0,                                                                           \
             XI_MQTT_RETAIN_FALSE,                                                        \
             XI_MQTT_QOS_AT_MOST_ONCE,                                                    \
-            XI_MQTT_DUP_FALSE                                                            \
+            XI_MQTT_DUP_FALSE,                                                           \
+            0,                                                                           \
+            0,                                                                           \
+            0                                                                            \
         }                                                                                \
     }
 
@@ -73,6 +73,29 @@ extern xi_state_t xi_senml_serialize( xi_senml_t* senml_structure,
                                       uint8_t** out_buffer,
                                       uint32_t* out_size );
 
+/**
+ * @name xi_senml_serialize_to_buffer
+ * @brief Creates the JSON string of a senml structure in a buffer of the caller.
+ *
+ * Same output as xi_senml_serialize's but nothing is allocated. If the buffer is too
+ * small, or NULL, nothing is written to it and out_size tells the size needed, so the
+ * function can be called with a NULL buffer first to learn it.
+ *
+ * @param [in] senml_structure the structure to be converted into its string
+ *                             represenation
+ * @param [out] buffer this buffer will contain the string, not zero terminated
+ * @param [in] buffer_size size of the buffer
+ * @param [out] out_size the length of the string, written or not
+ *
+ * @retval XI_STATE_OK if succeeded
+ * @retval XI_BUFFER_OVERFLOW if the string doesn't fit in the buffer
+ * @retval other in case of failure, see xively_error.h for error codes
+ */
+extern xi_state_t xi_senml_serialize_to_buffer( xi_senml_t* senml_structure,
+                                                uint8_t* buffer,
+                                                uint32_t buffer_size,
+                                                uint32_t* out_size );
+
 /**
  * @name xi_create_senml_struct
  * @brief Allocates and initializes a senml structure, recommended usage through the API
@@ -89,10 +89,30 @@ ifdef XI_CBOR_MESSAGE_MAX_BUFFER_SIZE
 XI_CONFIG_FLAGS += -DXI_CBOR_MESSAGE_MAX_BUFFER_SIZE=$(XI_CBOR_MESSAGE_MAX_BUFFER_SIZE)
 endif
 
+ifdef XI_IO_BUFFER_SIZE
+XI_CONFIG_FLAGS += -DXI_IO_BUFFER_SIZE=$(XI_IO_BUFFER_SIZE)
+endif
+
 ifdef XI_SFT_FILE_CHUNK_SIZE
 XI_CONFIG_FLAGS += -DXI_SFT_FILE_CHUNK_SIZE=$(XI_SFT_FILE_CHUNK_SIZE)
 endif
 
+ifdef XI_SFT_FILE_CHUNK_SIZE_MAX
+XI_CONFIG_FLAGS += -DXI_SFT_FILE_CHUNK_SIZE_MAX=$(XI_SFT_FILE_CHUNK_SIZE_MAX)
+endif
+
+ifdef XI_THREADPOOL_NUMOFTHREADS
+XI_CONFIG_FLAGS += -DXI_THREADPOOL_NUMOFTHREADS=$(XI_THREADPOOL_NUMOFTHREADS)
+endif
+
+ifdef XI_THREADPOOL_MAXNUMOFTHREADS
+XI_CONFIG_FLAGS += -DXI_THREADPOOL_MAXNUMOFTHREADS=$(XI_THREADPOOL_MAXNUMOFTHREADS)
+endif
+
+ifdef XI_VECTOR_INDEX_TYPE_BITS
+XI_CONFIG_FLAGS += -DXI_VECTOR_INDEX_TYPE_BITS=$(XI_VECTOR_INDEX_TYPE_BITS)
+endif
+
 ifneq (,$(XI_DEBUG_PRINTF))
     XI_CONFIG_FLAGS += -DXI_DEBUG_PRINTF=$(XI_DEBUG_PRINTF)
 endif
@@ -175,6 +195,31 @@ XI_SRCDIRS += $(LIBXIVELY_SOURCE_DIR)/memory
 XI_SRCDIRS += $(LIBXIVELY_SOURCE_DIR)/event_loop
 XI_SRCDIRS += $(LIBXIVELY_SOURCE_DIR)/time
 
+# EVENT_LOOP: select (portable, default) or epoll (linux only)
+XI_EVENT_LOOP ?= select
+
+ifeq ($(XI_EVENT_LOOP),epoll)
+	XI_CONFIG_FLAGS += -DXI_EVENT_LOOP_EPOLL
+	XI_EVENT_LOOP_EPOLL_ENABLED := 1
+	XI_SRCDIRS += $(LIBXIVELY_SOURCE_DIR)/event_loop/epoll
+else ifneq ($(XI_EVENT_LOOP),select)
+	$(error Unknown event loop [$(XI_EVENT_LOOP)], please choose select or epoll)
+endif
+
+# BSP_MEM: platform (the BSP's own xi_bsp_mem, default) or arena (static arena)
+XI_BSP_MEM ?= platform
+
+ifeq ($(XI_BSP_MEM),arena)
+	XI_CONFIG_FLAGS += -DXI_BSP_MEM_ARENA
+	XI_BSP_MEM_ARENA_ENABLED := 1
+	XI_SRCDIRS += $(XI_BSP_DIR)/mem/arena
+	# deferred, the test makefiles may size the arena for their own needs
+	XI_CONFIG_FLAGS += $(if $(XI_BSP_MEM_ARENA_SIZE),-DXI_BSP_MEM_ARENA_SIZE=$(XI_BSP_MEM_ARENA_SIZE))
+	XI_CONFIG_FLAGS += $(if $(XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER),-DXI_BSP_MEM_ARENA_MAX_BLOCK_ORDER=$(XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER))
+else ifneq ($(XI_BSP_MEM),platform)
+	$(error Unknown BSP memory backend [$(XI_BSP_MEM)], please choose platform or arena)
+endif
+
 # if no tls_bsp then set proper flag
 ifeq (,$(findstring tls_bsp,$(CONFIG)))
 	XI_CONFIG_FLAGS += -DXI_NO_TLS_LAYER
@@ -258,9 +303,16 @@ ifeq ($(XI_DEBUG_OUTPUT),0)
 XI_SOURCES := $(filter-out $(LIBXIVELY_SOURCE_DIR)/xi_debug.c, $(XI_SOURCES) )
 endif
 
+# the arena replaces the memory functions of the platform BSP
+ifdef XI_BSP_MEM_ARENA_ENABLED
+XI_SOURCES := $(filter-out $(XI_BSP_DIR)/platform/$(XI_BSP_PLATFORM)/xi_bsp_mem_%.c, \
+	$(XI_SOURCES) )
+endif
+
 ifdef MAKEFILE_DEBUG
 $(info --mt-config-- Using [$(XI_BSP_PLATFORM)] BSP configuration)
 $(info --mt-config-- event_loop=$(XI_EVENT_LOOP))
+$(info --mt-config-- bsp_mem=$(XI_BSP_MEM))
 $(info --mt-config-- $$XI_PLATFORM_BASE is [${XI_PLATFORM_BASE}])
 $(info --mt-config-- $$XI_PLATFORM_MODULES is [${XI_PLATFORM_MODULES}])
 $(info --mt-config-- $$LIBXIVELY_SOURCE_DIR is [${LIBXIVELY_SOURCE_DIR}])
@@ -58,6 +58,7 @@ WOLFSSL_SETTINGS =        \
     -DHAVE_OCSP           \
     -DHAVE_SNI            \
     -DHAVE_TLS_EXTENSIONS \
+    -DHAVE_SESSION_TICKET \
     -DTIME_OVERRIDES      \
     -DNO_DES              \
     -DNO_DES3             \
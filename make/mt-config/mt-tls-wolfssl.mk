@@ -10,6 +10,7 @@ XI_TLS_LIB_NAME ?= wolfssl
 # wolfssl API
 XI_CONFIG_FLAGS += -DHAVE_SNI
 XI_CONFIG_FLAGS += -DHAVE_CERTIFICATE_STATUS_REQUEST
+XI_CONFIG_FLAGS += -DHAVE_SESSION_TICKET
 
 # libxively OCSP stapling feature switch
 XI_CONFIG_FLAGS += -DXI_TLS_OCSP_STAPLING
@@ -26,6 +26,18 @@ ifndef XI_CONTROL_TOPIC_ENABLED
     XI_UTEST_EXCLUDED += xi_utest_protobuf_engine.c xi_utest_protobuf_endianess.c xi_utest_control_topic.c
 endif
 
+ifndef XI_EVENT_LOOP_EPOLL_ENABLED
+    XI_UTEST_EXCLUDED += xi_utest_event_loop_epoll.c
+endif
+
+ifndef XI_BSP_MEM_ARENA_ENABLED
+    XI_UTEST_EXCLUDED += xi_utest_bsp_mem_arena.c
+else ifneq (,$(filter tests,$(MAKECMDGOALS)))
+    # the datastructure and time event tests hold 100000 allocations at once
+    XI_BSP_MEM_ARENA_SIZE ?= 67108864 # 64 MB
+    XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER ?= 24
+endif
+
 ifdef XI_SECURE_FILE_TRANSFER_ENABLED
     XI_UTEST_SOURCES += $(wildcard $(XI_TEST_DIR)/common/control_topic/*.c)
 else
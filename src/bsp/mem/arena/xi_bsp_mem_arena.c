@@ -0,0 +1,349 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include <xi_bsp_mem.h>
+
+#include "xi_bsp_mem_arena.h"
+#include "xi_critical_section.h"
+#include "xi_critical_section_def.h"
+
+#if ( XI_BSP_MEM_ARENA_SIZE ) % ( 1 << ( XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER ) ) != 0
+#error XI_BSP_MEM_ARENA_SIZE has to be a multiple of the largest block
+#endif
+
+#if XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER > XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER
+#error XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER can not exceed XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER
+#endif
+
+#define XI_BSP_MEM_ARENA_BLOCK_SIZE( order ) ( ( size_t )1 << ( order ) )
+
+/* put in front of every block, the union keeps the payload aligned as malloc() would */
+typedef union xi_bsp_mem_arena_header_u {
+    struct
+    {
+        uint32_t byte_count;
+        uint8_t order;
+        uint8_t is_free;
+    } block;
+    long double align_long_double;
+    uint64_t align_uint64;
+    void* align_ptr;
+} xi_bsp_mem_arena_header_t;
+
+/* free blocks keep the links of their size class freelist right after the header */
+typedef struct xi_bsp_mem_arena_free_block_s
+{
+    xi_bsp_mem_arena_header_t header;
+    struct xi_bsp_mem_arena_free_block_s* prev;
+    struct xi_bsp_mem_arena_free_block_s* next;
+} xi_bsp_mem_arena_free_block_t;
+
+/* the smallest block has to be able to hold the freelist links */
+typedef char xi_bsp_mem_arena_min_block_check_t
+    [( sizeof( xi_bsp_mem_arena_free_block_t ) <=
+       XI_BSP_MEM_ARENA_BLOCK_SIZE( XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER ) )
+         ? 1
+         : -1];
+
+static union {
+    uint8_t bytes[XI_BSP_MEM_ARENA_SIZE];
+    xi_bsp_mem_arena_header_t align;
+} xi_bsp_mem_arena_storage;
+
+static struct
+{
+    xi_bsp_mem_arena_free_block_t* free_lists[XI_BSP_MEM_ARENA_ORDER_COUNT];
+    size_t free_blocks[XI_BSP_MEM_ARENA_ORDER_COUNT];
+    size_t bytes_in_use;
+    size_t requested_bytes_in_use;
+    size_t peak_bytes_in_use;
+    size_t allocation_count;
+    size_t failed_allocation_count;
+    uint8_t is_initialised;
+} xi_bsp_mem_arena;
+
+#ifdef XI_MODULE_THREAD_ENABLED
+/* static initialisation of the critical section */
+static struct xi_critical_section_s xi_bsp_mem_arena_cs = {0};
+#endif
+
+static void xi_bsp_mem_arena_push( xi_bsp_mem_arena_free_block_t* block, uint8_t order )
+{
+    const uint8_t index = order - XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER;
+
+    block->header.block.order      = order;
+    block->header.block.is_free    = 1;
+    block->header.block.byte_count = 0;
+    block->prev                    = NULL;
+    block->next                    = xi_bsp_mem_arena.free_lists[index];
+
+    if ( NULL != block->next )
+    {
+        block->next->prev = block;
+    }
+
+    xi_bsp_mem_arena.free_lists[index] = block;
+    xi_bsp_mem_arena.free_blocks[index] += 1;
+}
+
+static void xi_bsp_mem_arena_unlink( xi_bsp_mem_arena_free_block_t* block )
+{
+    const uint8_t index = block->header.block.order - XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER;
+
+    if ( NULL != block->prev )
+    {
+        block->prev->next = block->next;
+    }
+    else
+    {
+        xi_bsp_mem_arena.free_lists[index] = block->next;
+    }
+
+    if ( NULL != block->next )
+    {
+        block->next->prev = block->prev;
+    }
+
+    block->header.block.is_free = 0;
+    xi_bsp_mem_arena.free_blocks[index] -= 1;
+}
+
+static void xi_bsp_mem_arena_initialise( void )
+{
+    uint8_t* const base = xi_bsp_mem_arena_storage.bytes;
+    size_t offset       = 0;
+
+    for ( ; offset < XI_BSP_MEM_ARENA_SIZE;
+          offset += XI_BSP_MEM_ARENA_BLOCK_SIZE( XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER ) )
+    {
+        xi_bsp_mem_arena_push(
+            ( xi_bsp_mem_arena_free_block_t* )( void* )( base + offset ),
+            XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER );
+    }
+
+    xi_bsp_mem_arena.is_initialised = 1;
+}
+
+/* smallest order that fits byte_count and the header, above the max one if none does */
+static uint8_t xi_bsp_mem_arena_order_for( size_t byte_count )
+{
+    uint8_t order = XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER;
+
+    if ( byte_count >
+         XI_BSP_MEM_ARENA_BLOCK_SIZE( XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER ) -
+             sizeof( xi_bsp_mem_arena_header_t ) )
+    {
+        return XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER + 1;
+    }
+
+    while ( XI_BSP_MEM_ARENA_BLOCK_SIZE( order ) <
+            byte_count + sizeof( xi_bsp_mem_arena_header_t ) )
+    {
+        ++order;
+    }
+
+    return order;
+}
+
+static void* xi_bsp_mem_arena_alloc_locked( size_t byte_count )
+{
+    const uint8_t order = xi_bsp_mem_arena_order_for( byte_count );
+    uint8_t found_order = order;
+
+    if ( 0 == xi_bsp_mem_arena.is_initialised )
+    {
+        xi_bsp_mem_arena_initialise();
+    }
+
+    /* at most XI_BSP_MEM_ARENA_ORDER_COUNT steps, independent of the arena contents */
+    while ( found_order <= XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER &&
+            NULL == xi_bsp_mem_arena.free_lists[found_order -
+                                                XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER] )
+    {
+        ++found_order;
+    }
+
+    if ( found_order > XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER )
+    {
+        xi_bsp_mem_arena.failed_allocation_count += 1;
+        return NULL;
+    }
+
+    xi_bsp_mem_arena_free_block_t* block =
+        xi_bsp_mem_arena.free_lists[found_order - XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER];
+
+    xi_bsp_mem_arena_unlink( block );
+
+    /* split down to the requested size class, the upper halves become free blocks */
+    while ( found_order > order )
+    {
+        --found_order;
+
+        uint8_t* const upper_half =
+            ( uint8_t* )block + XI_BSP_MEM_ARENA_BLOCK_SIZE( found_order );
+
+        xi_bsp_mem_arena_push( ( xi_bsp_mem_arena_free_block_t* )( void* )upper_half,
+                               found_order );
+    }
+
+    block->header.block.order      = order;
+    block->header.block.byte_count = ( uint32_t )byte_count;
+
+    xi_bsp_mem_arena.bytes_in_use += XI_BSP_MEM_ARENA_BLOCK_SIZE( order );
+    xi_bsp_mem_arena.requested_bytes_in_use += byte_count;
+    xi_bsp_mem_arena.allocation_count += 1;
+
+    if ( xi_bsp_mem_arena.bytes_in_use > xi_bsp_mem_arena.peak_bytes_in_use )
+    {
+        xi_bsp_mem_arena.peak_bytes_in_use = xi_bsp_mem_arena.bytes_in_use;
+    }
+
+    return &block->header + 1;
+}
+
+static void xi_bsp_mem_arena_free_locked( xi_bsp_mem_arena_header_t* header )
+{
+    uint8_t* const base = xi_bsp_mem_arena_storage.bytes;
+    uint8_t order       = header->block.order;
+
+    assert( ( uint8_t* )header >= base );
+    assert( ( uint8_t* )header < base + XI_BSP_MEM_ARENA_SIZE );
+    assert( 0 == header->block.is_free );
+
+    xi_bsp_mem_arena.bytes_in_use -= XI_BSP_MEM_ARENA_BLOCK_SIZE( order );
+    xi_bsp_mem_arena.requested_bytes_in_use -= header->block.byte_count;
+    xi_bsp_mem_arena.allocation_count -= 1;
+
+    size_t offset = ( size_t )( ( uint8_t* )header - base );
+
+    /* merge with the buddy for as long as it is a free block of the same size class */
+    while ( order < XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER )
+    {
+        const size_t buddy_offset = offset ^ XI_BSP_MEM_ARENA_BLOCK_SIZE( order );
+        xi_bsp_mem_arena_free_block_t* buddy =
+            ( xi_bsp_mem_arena_free_block_t* )( void* )( base + buddy_offset );
+
+        if ( 0 == buddy->header.block.is_free || order != buddy->header.block.order )
+        {
+            break;
+        }
+
+        xi_bsp_mem_arena_unlink( buddy );
+
+        offset = ( offset < buddy_offset ) ? offset : buddy_offset;
+        ++order;
+    }
+
+    xi_bsp_mem_arena_push( ( xi_bsp_mem_arena_free_block_t* )( void* )( base + offset ),
+                           order );
+}
+
+void* xi_bsp_mem_alloc( size_t byte_count )
+{
+    xi_lock_critical_section( &xi_bsp_mem_arena_cs );
+
+    void* ptr = xi_bsp_mem_arena_alloc_locked( byte_count );
+
+    xi_unlock_critical_section( &xi_bsp_mem_arena_cs );
+
+    return ptr;
+}
+
+void* xi_bsp_mem_realloc( void* ptr, size_t byte_count )
+{
+    if ( NULL == ptr )
+    {
+        return xi_bsp_mem_alloc( byte_count );
+    }
+
+    xi_bsp_mem_arena_header_t* header = ( xi_bsp_mem_arena_header_t* )ptr - 1;
+    void* new_ptr                     = NULL;
+
+    xi_lock_critical_section( &xi_bsp_mem_arena_cs );
+
+    /* the block already has room for the new size, it stays where it is */
+    if ( xi_bsp_mem_arena_order_for( byte_count ) <= header->block.order )
+    {
+        xi_bsp_mem_arena.requested_bytes_in_use -= header->block.byte_count;
+        xi_bsp_mem_arena.requested_bytes_in_use += byte_count;
+        header->block.byte_count = ( uint32_t )byte_count;
+
+        xi_unlock_critical_section( &xi_bsp_mem_arena_cs );
+        return ptr;
+    }
+
+    new_ptr = xi_bsp_mem_arena_alloc_locked( byte_count );
+
+    /* as realloc() on failure the original block is left untouched */
+    if ( NULL != new_ptr )
+    {
+        memcpy( new_ptr, ptr, header->block.byte_count );
+        xi_bsp_mem_arena_free_locked( header );
+    }
+
+    xi_unlock_critical_section( &xi_bsp_mem_arena_cs );
+
+    return new_ptr;
+}
+
+void xi_bsp_mem_free( void* ptr )
+{
+    if ( NULL == ptr )
+    {
+        return;
+    }
+
+    xi_lock_critical_section( &xi_bsp_mem_arena_cs );
+
+    xi_bsp_mem_arena_free_locked( ( xi_bsp_mem_arena_header_t* )ptr - 1 );
+
+    xi_unlock_critical_section( &xi_bsp_mem_arena_cs );
+}
+
+void xi_bsp_mem_arena_get_stats( xi_bsp_mem_arena_stats_t* stats )
+{
+    assert( NULL != stats );
+
+    memset( stats, 0, sizeof( xi_bsp_mem_arena_stats_t ) );
+
+    xi_lock_critical_section( &xi_bsp_mem_arena_cs );
+
+    if ( 0 == xi_bsp_mem_arena.is_initialised )
+    {
+        xi_bsp_mem_arena_initialise();
+    }
+
+    stats->arena_size              = XI_BSP_MEM_ARENA_SIZE;
+    stats->bytes_in_use            = xi_bsp_mem_arena.bytes_in_use;
+    stats->requested_bytes_in_use  = xi_bsp_mem_arena.requested_bytes_in_use;
+    stats->peak_bytes_in_use       = xi_bsp_mem_arena.peak_bytes_in_use;
+    stats->allocation_count        = xi_bsp_mem_arena.allocation_count;
+    stats->failed_allocation_count = xi_bsp_mem_arena.failed_allocation_count;
+    stats->free_bytes = XI_BSP_MEM_ARENA_SIZE - xi_bsp_mem_arena.bytes_in_use;
+
+    uint8_t index = 0;
+    for ( ; index < XI_BSP_MEM_ARENA_ORDER_COUNT; ++index )
+    {
+        stats->free_blocks[index] = xi_bsp_mem_arena.free_blocks[index];
+
+        if ( 0 != stats->free_blocks[index] )
+        {
+            stats->largest_free_block =
+                XI_BSP_MEM_ARENA_BLOCK_SIZE( index + XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER );
+        }
+    }
+
+    xi_unlock_critical_section( &xi_bsp_mem_arena_cs );
+
+    if ( 0 != stats->free_bytes )
+    {
+        stats->external_fragmentation_percent = ( uint8_t )(
+            100 - ( stats->largest_free_block * 100 ) / stats->free_bytes );
+    }
+}
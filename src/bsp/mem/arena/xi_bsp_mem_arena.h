@@ -0,0 +1,94 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#ifndef __XI_BSP_MEM_ARENA_H__
+#define __XI_BSP_MEM_ARENA_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Arena backend of the xi_bsp_mem API, built instead of the platform's
+ * xi_bsp_mem_<platform>.c when XI_BSP_MEM=arena is given to make. The sizes below can
+ * be overridden with XI_BSP_MEM_ARENA_SIZE and XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER on the
+ * make command line.
+ *
+ * The arena is a single static buffer carved into power of two blocks, each size class
+ * has its own freelist. Allocation takes a block from the smallest non-empty class that
+ * fits and splits it in halves down to the requested class, freeing merges a block with
+ * its buddy for as long as the buddy is free. The number of size classes is fixed at
+ * compile time so both are constant time, and no memory outside of the arena is used.
+ */
+
+/* the smallest block, header and freelist links included, as a power of two */
+#ifndef XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER
+#define XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER 5
+#endif
+
+/* the largest block and so the largest single allocation, as a power of two */
+#ifndef XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER 20
+#else
+#define XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER 14
+#endif
+#endif
+
+/* size of the arena in bytes, has to be a multiple of the largest block */
+#ifndef XI_BSP_MEM_ARENA_SIZE
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_BSP_MEM_ARENA_SIZE ( 1024 * 1024 )
+#else
+#define XI_BSP_MEM_ARENA_SIZE ( 32 * 1024 )
+#endif
+#endif
+
+#define XI_BSP_MEM_ARENA_ORDER_COUNT                                                     \
+    ( XI_BSP_MEM_ARENA_MAX_BLOCK_ORDER - XI_BSP_MEM_ARENA_MIN_BLOCK_ORDER + 1 )
+
+/**
+ * @brief snapshot of the arena usage
+ *
+ * bytes_in_use counts whole blocks, the difference to requested_bytes_in_use is the
+ * internal fragmentation caused by rounding up to the size classes. The external
+ * fragmentation is the part of the free memory that is not available as a single
+ * block, 0 when all of it could serve one allocation, close to 100 when it is split
+ * into small pieces.
+ */
+typedef struct xi_bsp_mem_arena_stats_s
+{
+    size_t arena_size;
+    size_t bytes_in_use;
+    size_t requested_bytes_in_use;
+    size_t peak_bytes_in_use;
+    size_t free_bytes;
+    size_t largest_free_block;
+    size_t allocation_count;
+    size_t failed_allocation_count;
+    uint8_t external_fragmentation_percent;
+    /* free_blocks[i] is the number of free blocks of 2^(MIN_BLOCK_ORDER + i) bytes */
+    size_t free_blocks[XI_BSP_MEM_ARENA_ORDER_COUNT];
+} xi_bsp_mem_arena_stats_t;
+
+/**
+ * @brief xi_bsp_mem_arena_get_stats
+ *
+ * Fills the stats with the current state of the arena. The cost is linear in the
+ * number of size classes only.
+ *
+ * @param stats to fill, must not be NULL
+ */
+void xi_bsp_mem_arena_get_stats( xi_bsp_mem_arena_stats_t* stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __XI_BSP_MEM_ARENA_H__ */
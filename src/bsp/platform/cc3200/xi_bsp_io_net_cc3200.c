@@ -196,6 +196,20 @@ xi_bsp_io_net_state_t xi_bsp_io_net_write( xi_bsp_socket_t xi_socket,
     return XI_BSP_IO_NET_STATE_OK;
 }
 
+xi_bsp_io_net_state_t xi_bsp_io_net_writev( xi_bsp_socket_t xi_socket,
+                                            int* out_written_count,
+                                            const xi_bsp_io_net_iovec_t* iov,
+                                            int iov_count )
+{
+    if ( NULL == iov || 0 >= iov_count )
+    {
+        return XI_BSP_IO_NET_STATE_ERROR;
+    }
+
+    /* no gathering write here, the Xively Client sends the rest with the next call */
+    return xi_bsp_io_net_write( xi_socket, out_written_count, iov[0].buf, iov[0].count );
+}
+
 xi_bsp_io_net_state_t xi_bsp_io_net_read( xi_bsp_socket_t xi_socket,
                                           int* out_read_count,
                                           uint8_t* buf,
@@ -232,9 +246,10 @@ xi_bsp_io_net_state_t xi_bsp_io_net_close_socket( xi_bsp_socket_t* xi_socket )
     return XI_BSP_IO_NET_STATE_OK;
 }
 
-xi_bsp_io_net_state_t xi_bsp_io_net_select( xi_bsp_socket_events_t* socket_events_array,
-                                            size_t socket_events_array_size,
-                                            long timeout_sec )
+xi_bsp_io_net_state_t
+xi_bsp_io_net_select_ms( xi_bsp_socket_events_t* socket_events_array,
+                         size_t socket_events_array_size,
+                         long timeout_ms )
 {
     fd_set rfds;
     fd_set wfds;
@@ -291,7 +306,8 @@ xi_bsp_io_net_state_t xi_bsp_io_net_select( xi_bsp_socket_events_t* socket_event
     /* calculate max fd */
     const int max_fd = MAX( max_fd_read, MAX( max_fd_write, max_fd_error ) );
 
-    tv.tv_sec = 1;
+    tv.tv_sec  = timeout_ms / 1000;
+    tv.tv_usec = ( timeout_ms % 1000 ) * 1000;
 
     /* call the actual posix select */
     const int result = select( max_fd + 1, &rfds, &wfds, &efds, &tv );
@@ -44,3 +44,10 @@ xi_time_t xi_bsp_time_getcurrenttime_milliseconds()
        do not fit into 32 bits */
     return xi_bsp_time_sntp_getseconds_posix();
 }
+
+xi_time_t xi_bsp_time_getmonotonictime_milliseconds()
+{
+    /* uptime is advanced once a second by the periodic timer, it is not affected by
+       SNTP corrections */
+    return ( xi_time_t )uptime * 1000;
+}
@@ -56,6 +56,20 @@ xi_bsp_io_net_state_t xi_bsp_io_net_write( xi_bsp_socket_t xi_socket,
     return XI_BSP_IO_NET_STATE_OK;
 }
 
+xi_bsp_io_net_state_t xi_bsp_io_net_writev( xi_bsp_socket_t xi_socket,
+                                            int* out_written_count,
+                                            const xi_bsp_io_net_iovec_t* iov,
+                                            int iov_count )
+{
+    if ( NULL == iov || 0 >= iov_count )
+    {
+        return XI_BSP_IO_NET_STATE_ERROR;
+    }
+
+    /* no gathering write here, the Xively Client sends the rest with the next call */
+    return xi_bsp_io_net_write( xi_socket, out_written_count, iov[0].buf, iov[0].count );
+}
+
 xi_bsp_io_net_state_t xi_bsp_io_net_read( xi_bsp_socket_t xi_socket,
                                           int* out_read_count,
                                           uint8_t* buf,
@@ -74,13 +88,14 @@ xi_bsp_io_net_state_t xi_bsp_io_net_close_socket( xi_bsp_socket_t* xi_socket )
     return XI_BSP_IO_NET_STATE_OK;
 }
 
-xi_bsp_io_net_state_t xi_bsp_io_net_select( xi_bsp_socket_events_t* socket_events_array,
-                                            size_t socket_events_array_size,
-                                            long timeout_sec )
+xi_bsp_io_net_state_t
+xi_bsp_io_net_select_ms( xi_bsp_socket_events_t* socket_events_array,
+                         size_t socket_events_array_size,
+                         long timeout_ms )
 {
     ( void )socket_events_array;
     ( void )socket_events_array_size;
-    ( void )timeout_sec;
+    ( void )timeout_ms;
 
     return XI_BSP_IO_NET_STATE_OK;
 }
@@ -73,6 +73,11 @@ xi_time_t xi_bsp_time_getcurrenttime_milliseconds()
     return xi_bsp_time_getcurrenttime_seconds() * 1000;
 }
 
+xi_time_t xi_bsp_time_getmonotonictime_milliseconds()
+{
+    return ( xi_time_t )xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
 /**
  * Function required by WolfSSL to track the current time.
  */
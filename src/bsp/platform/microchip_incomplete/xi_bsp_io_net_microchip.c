@@ -112,6 +112,20 @@ xi_bsp_io_net_state_t xi_bsp_io_net_write( xi_bsp_socket_t xi_socket,
     return XI_BSP_IO_NET_STATE_OK;
 }
 
+xi_bsp_io_net_state_t xi_bsp_io_net_writev( xi_bsp_socket_t xi_socket,
+                                            int* out_written_count,
+                                            const xi_bsp_io_net_iovec_t* iov,
+                                            int iov_count )
+{
+    if ( NULL == iov || 0 >= iov_count )
+    {
+        return XI_BSP_IO_NET_STATE_ERROR;
+    }
+
+    /* no gathering write here, the Xively Client sends the rest with the next call */
+    return xi_bsp_io_net_write( xi_socket, out_written_count, iov[0].buf, iov[0].count );
+}
+
 xi_bsp_io_net_state_t xi_bsp_io_net_read( xi_bsp_socket_t xi_socket,
                                           int* out_read_count,
                                           uint8_t* buf,
@@ -157,12 +171,13 @@ xi_bsp_io_net_state_t xi_bsp_io_net_close_socket( xi_bsp_socket_t* xi_socket )
     return XI_BSP_IO_NET_STATE_OK;
 }
 
-xi_bsp_io_net_state_t xi_bsp_io_net_select( xi_bsp_socket_events_t* socket_events_array,
-                                            size_t socket_events_array_size,
-                                            long timeout )
+xi_bsp_io_net_state_t
+xi_bsp_io_net_select_ms( xi_bsp_socket_events_t* socket_events_array,
+                         size_t socket_events_array_size,
+                         long timeout_ms )
 {
     /* unused at least for now */
-    ( void )timeout;
+    ( void )timeout_ms;
 
     /* translate the library socket events settings to the set's of events used by posix
      * select */
@@ -15,3 +15,8 @@ xi_time_t xi_bsp_time_getcurrenttime_milliseconds()
 {
     return ( xi_time_t )TickConvertToMilliseconds( TickGet() );
 }
+
+xi_time_t xi_bsp_time_getmonotonictime_milliseconds()
+{
+    return ( xi_time_t )TickConvertToMilliseconds( TickGet() );
+}
@@ -11,6 +11,7 @@
 #include <netdb.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <stdio.h>
@@ -145,6 +146,51 @@ xi_bsp_io_net_state_t xi_bsp_io_net_write( xi_bsp_socket_t xi_socket,
     return XI_BSP_IO_NET_STATE_OK;
 }
 
+xi_bsp_io_net_state_t xi_bsp_io_net_writev( xi_bsp_socket_t xi_socket,
+                                            int* out_written_count,
+                                            const xi_bsp_io_net_iovec_t* iov,
+                                            int iov_count )
+{
+    if ( NULL == out_written_count || NULL == iov || 0 >= iov_count ||
+         XI_BSP_IO_NET_IOVEC_MAX < iov_count )
+    {
+        return XI_BSP_IO_NET_STATE_ERROR;
+    }
+
+    struct iovec vec[XI_BSP_IO_NET_IOVEC_MAX];
+
+    int i = 0;
+    for ( ; i < iov_count; ++i )
+    {
+        vec[i].iov_base = ( void* )iov[i].buf;
+        vec[i].iov_len  = iov[i].count;
+    }
+
+    int errval = 0;
+
+    *out_written_count = writev( xi_socket, vec, iov_count );
+
+    if ( 0 > *out_written_count )
+    {
+        errval = errno;
+        errno  = 0;
+
+        if ( EAGAIN == errval )
+        {
+            return XI_BSP_IO_NET_STATE_BUSY;
+        }
+
+        if ( ECONNRESET == errval || EPIPE == errval )
+        {
+            return XI_BSP_IO_NET_STATE_CONNECTION_RESET;
+        }
+
+        return XI_BSP_IO_NET_STATE_ERROR;
+    }
+
+    return XI_BSP_IO_NET_STATE_OK;
+}
+
 xi_bsp_io_net_state_t xi_bsp_io_net_read( xi_bsp_socket_t xi_socket,
                                           int* out_read_count,
                                           uint8_t* buf,
@@ -198,9 +244,10 @@ xi_bsp_io_net_state_t xi_bsp_io_net_close_socket( xi_bsp_socket_t* xi_socket )
     return XI_BSP_IO_NET_STATE_OK;
 }
 
-xi_bsp_io_net_state_t xi_bsp_io_net_select( xi_bsp_socket_events_t* socket_events_array,
-                                            size_t socket_events_array_size,
-                                            long timeout_sec )
+xi_bsp_io_net_state_t
+xi_bsp_io_net_select_ms( xi_bsp_socket_events_t* socket_events_array,
+                         size_t socket_events_array_size,
+                         long timeout_ms )
 {
     fd_set rfds;
     fd_set wfds;
@@ -257,7 +304,8 @@ xi_bsp_io_net_state_t xi_bsp_io_net_select( xi_bsp_socket_events_t* socket_event
     /* calculate max fd */
     const int max_fd = MAX( max_fd_read, MAX( max_fd_write, max_fd_error ) );
 
-    tv.tv_sec = timeout_sec;
+    tv.tv_sec  = timeout_ms / 1000;
+    tv.tv_usec = ( timeout_ms % 1000 ) * 1000;
 
     /* call the actual posix select */
     const int result = select( max_fd + 1, &rfds, &wfds, &efds, &tv );
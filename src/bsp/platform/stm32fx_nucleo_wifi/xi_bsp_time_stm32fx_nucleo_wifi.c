@@ -27,3 +27,8 @@ xi_time_t xi_bsp_time_getcurrenttime_milliseconds()
 {
     return xi_bsp_time_sntp_getseconds_posix() + HAL_GetTick() / 1000;
 }
+
+xi_time_t xi_bsp_time_getmonotonictime_milliseconds()
+{
+    return ( xi_time_t )HAL_GetTick();
+}
@@ -21,3 +21,8 @@ xi_time_t xi_bsp_time_getcurrenttime_milliseconds()
 {
     return ( xi_time_t )xTaskGetTickCount() * portTICK_RATE_MS;
 }
+
+xi_time_t xi_bsp_time_getmonotonictime_milliseconds()
+{
+    return ( xi_time_t )xTaskGetTickCount() * portTICK_RATE_MS;
+}
@@ -36,18 +36,34 @@ mbedtls_prepare_certificate_buffer( uint8_t* cert_buffer, size_t cert_buffer_len
 }
 
 /**
- * @typedef mbedtls_tls_context_t
- * @brief holds data important for mbedtls related bsp functions
+ * @typedef mbedtls_tls_config_t
+ * @brief holds the parsed CA chain, the ssl configuration and the random generator
+ * shared by all of the contexts
+ *
+ * The BSP TLS functions are called only from the client's event loop so the reference
+ * count and the random generator are not guarded.
  **/
-typedef struct mbedtls_tls_context_s
+typedef struct mbedtls_tls_config_s
 {
-    mbedtls_ssl_context ssl;
     mbedtls_ssl_config conf;
 
     mbedtls_entropy_context entropy;
     mbedtls_ctr_drbg_context ctr_drbg;
 
     mbedtls_x509_crt cacert;
+
+    uint32_t ref_count;
+} mbedtls_tls_config_t;
+
+/**
+ * @typedef mbedtls_tls_context_t
+ * @brief holds data important for mbedtls related bsp functions
+ **/
+typedef struct mbedtls_tls_context_s
+{
+    mbedtls_ssl_context ssl;
+
+    mbedtls_tls_config_t* config;
 } mbedtls_tls_context_t;
 
 int xi_mbedtls_recv( void* xively_io_callback_context, unsigned char* buf, size_t len )
@@ -114,16 +130,16 @@ int xi_mbedtls_send( void* xively_io_callback_context,
     return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
 }
 
-xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
-                                    xi_bsp_tls_init_params_t* init_params )
+xi_bsp_tls_state_t xi_bsp_tls_config_create( xi_bsp_tls_config_t** tls_config,
+                                             xi_bsp_tls_init_params_t* init_params )
 {
-    assert( NULL != tls_context );
-    assert( NULL == *tls_context );
+    assert( NULL != tls_config );
+    assert( NULL == *tls_config );
     assert( NULL != init_params );
 
     xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
 
-    if ( NULL == tls_context || NULL != *tls_context )
+    if ( NULL == tls_config || NULL != *tls_config )
     {
         return XI_BSP_TLS_STATE_INIT_ERROR;
     }
@@ -137,53 +153,61 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
     mbedtls_platform_set_calloc_free( init_params->fp_xively_calloc,
                                       init_params->fp_xively_free );
 
-    mbedtls_tls_context_t* mbedtls_tls_context =
-        ( mbedtls_tls_context_t* )mbedtls_calloc( sizeof( mbedtls_tls_context_t ), 1 );
+    mbedtls_tls_config_t* mbedtls_tls_config =
+        ( mbedtls_tls_config_t* )mbedtls_calloc( sizeof( mbedtls_tls_config_t ), 1 );
 
-    /* save tls context, this value will be passed back in other BSP TLS functions */
-    *tls_context = mbedtls_tls_context;
+    if ( NULL == mbedtls_tls_config )
+    {
+        return XI_BSP_TLS_STATE_INIT_ERROR;
+    }
 
-    /* initialise the mbedtls context */
-    mbedtls_ssl_init( &mbedtls_tls_context->ssl );
-    mbedtls_ssl_config_init( &mbedtls_tls_context->conf );
+    mbedtls_tls_config->ref_count = 1;
 
-    /* initialise RNG */
-    mbedtls_entropy_init( &mbedtls_tls_context->entropy );
-    mbedtls_ctr_drbg_init( &mbedtls_tls_context->ctr_drbg );
+    mbedtls_ssl_config_init( &mbedtls_tls_config->conf );
+    mbedtls_x509_crt_init( &mbedtls_tls_config->cacert );
+
+    /* initialise RNG, seeded once for all of the contexts */
+    mbedtls_entropy_init( &mbedtls_tls_config->entropy );
+    mbedtls_ctr_drbg_init( &mbedtls_tls_config->ctr_drbg );
 
     if ( ( ret_state = mbedtls_ctr_drbg_seed(
-               &mbedtls_tls_context->ctr_drbg, mbedtls_entropy_func,
-               &mbedtls_tls_context->entropy, ( const unsigned char* )personalization,
+               &mbedtls_tls_config->ctr_drbg, mbedtls_entropy_func,
+               &mbedtls_tls_config->entropy, ( const unsigned char* )personalization,
                sizeof( personalization ) ) ) != 0 )
     {
         xi_bsp_debug_format( " failed ! mbedtls_ctr_drbg_seed returned %d", ret_state );
         goto err_handling;
     }
 
-    /* register I/O functions */
-    mbedtls_ssl_set_bio( &mbedtls_tls_context->ssl,
-                         init_params->xively_io_callback_context, xi_mbedtls_send,
-                         xi_mbedtls_recv, NULL );
-
-    ret_state = mbedtls_ssl_config_defaults(
-        &mbedtls_tls_context->conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
-        MBEDTLS_SSL_PRESET_DEFAULT );
+    if ( ( ret_state = mbedtls_ssl_config_defaults(
+               &mbedtls_tls_config->conf, MBEDTLS_SSL_IS_CLIENT,
+               MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT ) ) != 0 )
+    {
+        xi_bsp_debug_format( " failed ! mbedtls_ssl_config_defaults returned %d",
+                             ret_state );
+        goto err_handling;
+    }
 
 #ifdef XI_DISABLE_CERTVERIFY
-    mbedtls_ssl_conf_authmode( &mbedtls_tls_context->conf, MBEDTLS_SSL_VERIFY_NONE );
+    mbedtls_ssl_conf_authmode( &mbedtls_tls_config->conf, MBEDTLS_SSL_VERIFY_NONE );
 #else
-    mbedtls_ssl_conf_authmode( &mbedtls_tls_context->conf, MBEDTLS_SSL_VERIFY_REQUIRED );
+    mbedtls_ssl_conf_authmode( &mbedtls_tls_config->conf, MBEDTLS_SSL_VERIFY_REQUIRED );
 #endif
 
-    /* init & parse the CA certificates */
-    mbedtls_x509_crt_init( &mbedtls_tls_context->cacert );
+#if defined( MBEDTLS_SSL_SESSION_TICKETS )
+    /* ask for a ticket so that the server doesn't have to keep the session resumed on
+     * reconnect */
+    mbedtls_ssl_conf_session_tickets( &mbedtls_tls_config->conf,
+                                      MBEDTLS_SSL_SESSION_TICKETS_ENABLED );
+#endif
 
     /* this is required via the mbedtls in order to parse the PEM certificate correctly -
      * mbedtls requires '\0' at the end of the buffer that contains PEM certificate */
     mbedtls_prepare_certificate_buffer( init_params->ca_cert_pem_buf,
                                         init_params->ca_cert_pem_buf_length );
 
-    ret_state = mbedtls_x509_crt_parse( &mbedtls_tls_context->cacert,
+    /* parse the CA certificates */
+    ret_state = mbedtls_x509_crt_parse( &mbedtls_tls_config->cacert,
                                         init_params->ca_cert_pem_buf,
                                         init_params->ca_cert_pem_buf_length );
 
@@ -194,13 +218,117 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
     }
 
     /* set the ca certificate chain */
-    mbedtls_ssl_conf_ca_chain( &mbedtls_tls_context->conf, &mbedtls_tls_context->cacert,
+    mbedtls_ssl_conf_ca_chain( &mbedtls_tls_config->conf, &mbedtls_tls_config->cacert,
                                NULL );
-    mbedtls_ssl_conf_rng( &mbedtls_tls_context->conf, mbedtls_ctr_drbg_random,
-                          &mbedtls_tls_context->ctr_drbg );
+    mbedtls_ssl_conf_rng( &mbedtls_tls_config->conf, mbedtls_ctr_drbg_random,
+                          &mbedtls_tls_config->ctr_drbg );
+
+    *tls_config = mbedtls_tls_config;
+
+    return XI_BSP_TLS_STATE_OK;
+
+err_handling:
+    /* the release leaves the *tls_config NULL again */
+    *tls_config = mbedtls_tls_config;
+    xi_bsp_tls_config_release( tls_config );
+
+    return XI_BSP_TLS_STATE_INIT_ERROR;
+}
+
+xi_bsp_tls_state_t xi_bsp_tls_config_release( xi_bsp_tls_config_t** tls_config )
+{
+    assert( NULL != tls_config );
+
+    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
+
+    mbedtls_tls_config_t* mbedtls_tls_config = *tls_config;
+
+    if ( NULL == mbedtls_tls_config )
+    {
+        return XI_BSP_TLS_STATE_OK;
+    }
+
+    assert( 0 < mbedtls_tls_config->ref_count );
+
+    mbedtls_tls_config->ref_count -= 1;
+
+    if ( 0 == mbedtls_tls_config->ref_count )
+    {
+        mbedtls_x509_crt_free( &mbedtls_tls_config->cacert );
+        mbedtls_ssl_config_free( &mbedtls_tls_config->conf );
+        mbedtls_ctr_drbg_free( &mbedtls_tls_config->ctr_drbg );
+        mbedtls_entropy_free( &mbedtls_tls_config->entropy );
+
+        mbedtls_free( mbedtls_tls_config );
+    }
+
+    *tls_config = NULL;
+
+    return XI_BSP_TLS_STATE_OK;
+}
+
+xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
+                                    xi_bsp_tls_init_params_t* init_params )
+{
+    assert( NULL != tls_context );
+    assert( NULL == *tls_context );
+    assert( NULL != init_params );
+
+    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
+
+    if ( NULL == tls_context || NULL != *tls_context )
+    {
+        return XI_BSP_TLS_STATE_INIT_ERROR;
+    }
+
+    /* return state used for checking each mbedtls function */
+    int ret_state                   = 0;
+    xi_bsp_tls_state_t result       = XI_BSP_TLS_STATE_INIT_ERROR;
+    xi_bsp_tls_config_t* tls_config = init_params->tls_config;
+
+    mbedtls_platform_set_calloc_free( init_params->fp_xively_calloc,
+                                      init_params->fp_xively_free );
+
+    mbedtls_tls_context_t* mbedtls_tls_context =
+        ( mbedtls_tls_context_t* )mbedtls_calloc( sizeof( mbedtls_tls_context_t ), 1 );
+
+    if ( NULL == mbedtls_tls_context )
+    {
+        return XI_BSP_TLS_STATE_INIT_ERROR;
+    }
+
+    /* save tls context, this value will be passed back in other BSP TLS functions */
+    *tls_context = mbedtls_tls_context;
+
+    /* initialise the mbedtls context */
+    mbedtls_ssl_init( &mbedtls_tls_context->ssl );
+
+    /* take a reference to the shared configuration or make a private one */
+    if ( NULL != tls_config )
+    {
+        mbedtls_tls_context->config = tls_config;
+        mbedtls_tls_context->config->ref_count += 1;
+    }
+    else
+    {
+        result = xi_bsp_tls_config_create( &tls_config, init_params );
+
+        if ( XI_BSP_TLS_STATE_OK != result )
+        {
+            goto err_handling;
+        }
+
+        mbedtls_tls_context->config = tls_config;
+        result                      = XI_BSP_TLS_STATE_INIT_ERROR;
+    }
+
+    /* register I/O functions */
+    mbedtls_ssl_set_bio( &mbedtls_tls_context->ssl,
+                         init_params->xively_io_callback_context, xi_mbedtls_send,
+                         xi_mbedtls_recv, NULL );
 
     if ( ( ret_state = mbedtls_ssl_setup( &mbedtls_tls_context->ssl,
-                                          &mbedtls_tls_context->conf ) ) != 0 )
+                                          &mbedtls_tls_context->config->conf ) ) != 0 )
     {
         xi_bsp_debug_format( " failed  ! mbedtls_ssl_setup returned %d", ret_state );
         goto err_handling;
@@ -218,7 +346,7 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
     return XI_BSP_TLS_STATE_OK;
 
 err_handling:
-    return XI_BSP_TLS_STATE_INIT_ERROR;
+    return result;
 }
 
 xi_bsp_tls_state_t xi_bsp_tls_connect( xi_bsp_tls_context_t* tls_context )
@@ -252,8 +380,88 @@ xi_bsp_tls_state_t xi_bsp_tls_connect( xi_bsp_tls_context_t* tls_context )
             return XI_BSP_TLS_STATE_CONNECT_ERROR;
     }
 
-    /* after succesfull connection unload the certificate */
-    mbedtls_x509_crt_free( &mbedtls_tls_context->cacert );
+    /* the CA chain is shared with the other contexts and the reconnects so it stays
+     * loaded until the configuration is released */
+    return XI_BSP_TLS_STATE_OK;
+}
+
+xi_bsp_tls_state_t xi_bsp_tls_save_session( xi_bsp_tls_context_t* tls_context,
+                                            xi_bsp_tls_session_t** session )
+{
+    assert( NULL != tls_context );
+    assert( NULL != session );
+    assert( NULL == *session );
+
+    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
+
+    mbedtls_tls_context_t* mbedtls_tls_context = tls_context;
+
+    mbedtls_ssl_session* mbedtls_session =
+        ( mbedtls_ssl_session* )mbedtls_calloc( sizeof( mbedtls_ssl_session ), 1 );
+
+    if ( NULL == mbedtls_session )
+    {
+        return XI_BSP_TLS_STATE_CONNECT_ERROR;
+    }
+
+    mbedtls_ssl_session_init( mbedtls_session );
+
+    /* makes a deep copy, ticket included, that outlives the ssl context */
+    const int ret_state =
+        mbedtls_ssl_get_session( &mbedtls_tls_context->ssl, mbedtls_session );
+
+    if ( 0 != ret_state )
+    {
+        xi_bsp_debug_format( " failed ! mbedtls_ssl_get_session returned %d", ret_state );
+
+        mbedtls_ssl_session_free( mbedtls_session );
+        mbedtls_free( mbedtls_session );
+
+        return XI_BSP_TLS_STATE_CONNECT_ERROR;
+    }
+
+    *session = mbedtls_session;
+
+    return XI_BSP_TLS_STATE_OK;
+}
+
+xi_bsp_tls_state_t xi_bsp_tls_restore_session( xi_bsp_tls_context_t* tls_context,
+                                               xi_bsp_tls_session_t* session )
+{
+    assert( NULL != tls_context );
+    assert( NULL != session );
+
+    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
+
+    mbedtls_tls_context_t* mbedtls_tls_context = tls_context;
+
+    /* the session is copied, the server falls back to a full handshake if it doesn't
+     * know it anymore */
+    const int ret_state =
+        mbedtls_ssl_set_session( &mbedtls_tls_context->ssl, session );
+
+    if ( 0 != ret_state )
+    {
+        xi_bsp_debug_format( " failed ! mbedtls_ssl_set_session returned %d", ret_state );
+        return XI_BSP_TLS_STATE_INIT_ERROR;
+    }
+
+    return XI_BSP_TLS_STATE_OK;
+}
+
+xi_bsp_tls_state_t xi_bsp_tls_session_free( xi_bsp_tls_session_t** session )
+{
+    assert( NULL != session );
+
+    mbedtls_ssl_session* mbedtls_session = *session;
+
+    if ( NULL != mbedtls_session )
+    {
+        mbedtls_ssl_session_free( mbedtls_session );
+        mbedtls_free( mbedtls_session );
+
+        *session = NULL;
+    }
 
     return XI_BSP_TLS_STATE_OK;
 }
@@ -340,11 +548,10 @@ xi_bsp_tls_state_t xi_bsp_tls_cleanup( xi_bsp_tls_context_t** tls_context )
 
     if ( NULL != mbedtls_tls_context )
     {
-        mbedtls_x509_crt_free( &mbedtls_tls_context->cacert );
-        mbedtls_ssl_config_free( &mbedtls_tls_context->conf );
+        xi_bsp_tls_config_t* tls_config = mbedtls_tls_context->config;
+
         mbedtls_ssl_free( &mbedtls_tls_context->ssl );
-        mbedtls_ctr_drbg_free( &mbedtls_tls_context->ctr_drbg );
-        mbedtls_entropy_free( &mbedtls_tls_context->entropy );
+        xi_bsp_tls_config_release( &tls_config );
 
         mbedtls_free( *tls_context );
 
@@ -8,6 +8,7 @@
 #include <cyassl/ctaocrypt/memory.h>
 #include <cyassl/ssl.h>
 #include <wolfssl/error-ssl.h>
+#include <wolfssl/version.h>
 #include <xi_bsp_tls.h>
 #include <xi_bsp_debug.h>
 
@@ -15,9 +16,27 @@
 
 #define WOLFSSL_DEBUG_LOG 0
 
-typedef struct wolfssl_tls_context_s
+/* wolfSSL_get1_session hands out a reference counted copy of the session from 5.1.0 on,
+ * before that it returns the same entry of the client cache as CyaSSL_get_session */
+#if LIBWOLFSSL_VERSION_HEX >= 0x05001000
+#define XI_WOLFSSL_SESSION_GET1
+#else
+/* the session is copied field by field */
+#include <wolfssl/internal.h>
+#endif
+
+/* the CyaSSL context with the CA certificates loaded, shared by all of the objects. The
+ * BSP TLS functions are called only from the client's event loop so the reference count
+ * is not guarded. */
+typedef struct wolfssl_tls_config_s
 {
     CYASSL_CTX* ctx;
+    uint32_t ref_count;
+} wolfssl_tls_config_t;
+
+typedef struct wolfssl_tls_context_s
+{
+    wolfssl_tls_config_t* config;
     CYASSL* obj;
 } wolfssl_tls_context_t;
 
@@ -68,26 +87,24 @@ int xi_wolfssl_send( CYASSL* ssl, char* buf, int sz, void* context )
     }
 }
 
-xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
-                                    xi_bsp_tls_init_params_t* init_params )
+xi_bsp_tls_state_t xi_bsp_tls_config_create( xi_bsp_tls_config_t** tls_config,
+                                             xi_bsp_tls_init_params_t* init_params )
 {
-    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
+    assert( NULL != tls_config );
+    assert( NULL == *tls_config );
 
-    int ret                                    = 0;
-    xi_bsp_tls_state_t result                  = XI_BSP_TLS_STATE_OK;
-    wolfssl_tls_context_t* wolfssl_tls_context = NULL;
+    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
 
-#ifdef XI_TLS_OCSP_STAPLING
-    const int nonce_options = 0;
-#endif
+    int ret                                  = 0;
+    xi_bsp_tls_state_t result                = XI_BSP_TLS_STATE_OK;
+    wolfssl_tls_config_t* wolfssl_tls_config = NULL;
 
     ret = CyaSSL_Init();
 
     if ( ret != SSL_SUCCESS )
     {
         xi_bsp_debug_logger( "failed to initialize CyaSSL library" );
-        result = XI_BSP_TLS_STATE_INIT_ERROR;
-        goto err_handling;
+        return XI_BSP_TLS_STATE_INIT_ERROR;
     }
 
     ret = CyaSSL_SetAllocators( init_params->fp_xively_alloc, init_params->fp_xively_free,
@@ -96,21 +113,26 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
     if ( 0 != ret )
     {
         xi_bsp_debug_logger( "failed to initialize CyaSSL library" );
-        result = XI_BSP_TLS_STATE_INIT_ERROR;
-        goto err_handling;
+        CyaSSL_Cleanup();
+        return XI_BSP_TLS_STATE_INIT_ERROR;
     }
 
     xi_bsp_debug_logger( "initialized CyaSSL library" );
 
-    wolfssl_tls_context =
-        ( wolfssl_tls_context_t* )wolfSSL_Malloc( sizeof( wolfssl_tls_context_t ) );
+    wolfssl_tls_config =
+        ( wolfssl_tls_config_t* )wolfSSL_Malloc( sizeof( wolfssl_tls_config_t ) );
 
-    /* save tls context, this value will be passed back in other BSP TLS functions */
-    *tls_context = wolfssl_tls_context;
+    if ( NULL == wolfssl_tls_config )
+    {
+        CyaSSL_Cleanup();
+        return XI_BSP_TLS_STATE_INIT_ERROR;
+    }
 
-    wolfssl_tls_context->ctx = CyaSSL_CTX_new( CyaSSLv23_client_method() );
+    /* from now on the release takes care of the CyaSSL_Cleanup */
+    wolfssl_tls_config->ref_count = 1;
+    wolfssl_tls_config->ctx       = CyaSSL_CTX_new( CyaSSLv23_client_method() );
 
-    if ( NULL == wolfssl_tls_context->ctx )
+    if ( NULL == wolfssl_tls_config->ctx )
     {
         xi_bsp_debug_logger( "failed to create CyaSSL context" );
         result = XI_BSP_TLS_STATE_INIT_ERROR;
@@ -119,15 +141,117 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
 
     xi_bsp_debug_logger( "CyaSSL context created" );
 
-    CyaSSL_SetIORecv( wolfssl_tls_context->ctx, xi_wolfssl_recv );
-    CyaSSL_SetIOSend( wolfssl_tls_context->ctx, xi_wolfssl_send );
+    CyaSSL_SetIORecv( wolfssl_tls_config->ctx, xi_wolfssl_recv );
+    CyaSSL_SetIOSend( wolfssl_tls_config->ctx, xi_wolfssl_send );
 
 #ifdef XI_DISABLE_CERTVERIFY
     /* disable verify cause no proper certificate */
-    CyaSSL_CTX_set_verify( wolfssl_tls_context->ctx, SSL_VERIFY_NONE, 0 );
+    CyaSSL_CTX_set_verify( wolfssl_tls_config->ctx, SSL_VERIFY_NONE, 0 );
+#endif
+
+    /* POST/PRE-CONDITIONS */
+    assert( NULL != init_params->ca_cert_pem_buf );
+    assert( 0 < init_params->ca_cert_pem_buf_length );
+
+    /* loading the certificate, once for all of the objects made from this context */
+    ret = CyaSSL_CTX_load_verify_buffer(
+        wolfssl_tls_config->ctx, init_params->ca_cert_pem_buf,
+        init_params->ca_cert_pem_buf_length, SSL_FILETYPE_PEM );
+
+    if ( SSL_SUCCESS != ret )
+    {
+        xi_bsp_debug_format( "failed to load CA certificate, reason: %d", ret );
+        result = XI_BSP_TLS_STATE_CERT_ERROR;
+        goto err_handling;
+    }
+
+    *tls_config = wolfssl_tls_config;
+
+    return XI_BSP_TLS_STATE_OK;
+
+err_handling:
+    /* the release leaves the *tls_config NULL again */
+    *tls_config = wolfssl_tls_config;
+    xi_bsp_tls_config_release( tls_config );
+
+    return result;
+}
+
+xi_bsp_tls_state_t xi_bsp_tls_config_release( xi_bsp_tls_config_t** tls_config )
+{
+    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
+
+    if ( NULL == tls_config || NULL == *tls_config )
+    {
+        return XI_BSP_TLS_STATE_OK;
+    }
+
+    wolfssl_tls_config_t* wolfssl_tls_config = *tls_config;
+
+    assert( 0 < wolfssl_tls_config->ref_count );
+
+    wolfssl_tls_config->ref_count -= 1;
+
+    if ( 0 == wolfssl_tls_config->ref_count )
+    {
+        if ( NULL != wolfssl_tls_config->ctx )
+        {
+            CyaSSL_CTX_UnloadCAs( wolfssl_tls_config->ctx );
+            CyaSSL_CTX_free( wolfssl_tls_config->ctx );
+        }
+
+        wolfSSL_Free( wolfssl_tls_config );
+        CyaSSL_Cleanup();
+    }
+
+    *tls_config = NULL;
+
+    return XI_BSP_TLS_STATE_OK;
+}
+
+xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
+                                    xi_bsp_tls_init_params_t* init_params )
+{
+    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
+
+    xi_bsp_tls_state_t result                  = XI_BSP_TLS_STATE_OK;
+    wolfssl_tls_context_t* wolfssl_tls_context = NULL;
+    xi_bsp_tls_config_t* tls_config            = init_params->tls_config;
+
+#ifdef XI_TLS_OCSP_STAPLING
+    const int nonce_options = 0;
 #endif
 
-    wolfssl_tls_context->obj = CyaSSL_new( wolfssl_tls_context->ctx );
+    /* take a reference to the shared configuration or make a private one, either way
+     * the CyaSSL library is initialised from here on */
+    if ( NULL != tls_config )
+    {
+        ( ( wolfssl_tls_config_t* )tls_config )->ref_count += 1;
+    }
+    else
+    {
+        result = xi_bsp_tls_config_create( &tls_config, init_params );
+
+        if ( XI_BSP_TLS_STATE_OK != result )
+        {
+            return result;
+        }
+    }
+
+    wolfssl_tls_context =
+        ( wolfssl_tls_context_t* )wolfSSL_Malloc( sizeof( wolfssl_tls_context_t ) );
+
+    if ( NULL == wolfssl_tls_context )
+    {
+        xi_bsp_tls_config_release( &tls_config );
+        return XI_BSP_TLS_STATE_INIT_ERROR;
+    }
+
+    /* save tls context, this value will be passed back in other BSP TLS functions */
+    *tls_context = wolfssl_tls_context;
+
+    wolfssl_tls_context->config = tls_config;
+    wolfssl_tls_context->obj    = CyaSSL_new( wolfssl_tls_context->config->ctx );
 
     if ( NULL == wolfssl_tls_context->obj )
     {
@@ -172,8 +296,8 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
     /* change this next statement to:
            nonce_option = WOLFSSL_CSR_OCSP_USE_NONCE
        once the gateway can support it */
-    ret = wolfSSL_UseOCSPStapling( wolfssl_tls_context->obj, WOLFSSL_CSR_OCSP,
-                                   nonce_options );
+    const int ret = wolfSSL_UseOCSPStapling( wolfssl_tls_context->obj, WOLFSSL_CSR_OCSP,
+                                             nonce_options );
     if ( SSL_SUCCESS != ret )
     {
         xi_bsp_debug_format( "failed to enable OCSP Stapling, reason: %d", ret );
@@ -186,7 +310,7 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
     /* standard OCSP, separate socket connection to a OCSP responder */
 
     const int no_options = 0;
-    ret                  = wolfSSL_EnableOCSP( wolfssl_tls_context->obj, no_options );
+    const int ret        = wolfSSL_EnableOCSP( wolfssl_tls_context->obj, no_options );
     if ( SSL_SUCCESS != ret )
     {
         xi_bsp_debug_format( "failed to enable OCSP support, reason: %d", ret );
@@ -198,6 +322,17 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
 
 /* no OCSP */
 
+#endif
+
+#ifdef HAVE_SESSION_TICKET
+    /* ask for a ticket so that the server doesn't have to keep the session resumed on
+     * reconnect */
+    if ( SSL_SUCCESS != wolfSSL_UseSessionTicket( wolfssl_tls_context->obj ) )
+    {
+        xi_bsp_debug_logger( "failed to enable session tickets" );
+        result = XI_BSP_TLS_STATE_INIT_ERROR;
+        goto err_handling;
+    }
 #endif
 
     CyaSSL_set_using_nonblock( wolfssl_tls_context->obj, 1 );
@@ -207,22 +342,6 @@ xi_bsp_tls_state_t xi_bsp_tls_init( xi_bsp_tls_context_t** tls_context,
     CyaSSL_SetIOWriteCtx( wolfssl_tls_context->obj,
                           init_params->xively_io_callback_context );
 
-    /* POST/PRE-CONDITIONS */
-    assert( NULL != init_params->ca_cert_pem_buf );
-    assert( 0 < init_params->ca_cert_pem_buf_length );
-
-    /* loading the certificate */
-    ret = CyaSSL_CTX_load_verify_buffer(
-        wolfssl_tls_context->ctx, init_params->ca_cert_pem_buf,
-        init_params->ca_cert_pem_buf_length, SSL_FILETYPE_PEM );
-
-    if ( SSL_SUCCESS != ret )
-    {
-        xi_bsp_debug_format( "failed to load CA certificate, reason: %d", ret );
-        result = XI_BSP_TLS_STATE_CERT_ERROR;
-        goto err_handling;
-    }
-
 err_handling:
 
     return result;
@@ -267,6 +386,106 @@ xi_bsp_tls_state_t xi_bsp_tls_connect( xi_bsp_tls_context_t* tls_context )
     return XI_BSP_TLS_STATE_CONNECT_ERROR;
 }
 
+/* CyaSSL keeps the sessions in its own client cache and CyaSSL_get_session returns an
+ * entry of it, which a later connection may overwrite. The saved session is a copy the
+ * caller owns instead. */
+xi_bsp_tls_state_t xi_bsp_tls_save_session( xi_bsp_tls_context_t* tls_context,
+                                            xi_bsp_tls_session_t** session )
+{
+    assert( NULL != tls_context );
+    assert( NULL != session );
+
+    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
+
+    /* get back the wolfssl_tls_context */
+    wolfssl_tls_context_t* wolfssl_tls_context = tls_context;
+
+#ifdef XI_WOLFSSL_SESSION_GET1
+    *session = wolfSSL_get1_session( wolfssl_tls_context->obj );
+
+    return ( NULL == *session ) ? XI_BSP_TLS_STATE_CONNECT_ERROR : XI_BSP_TLS_STATE_OK;
+#else
+    const WOLFSSL_SESSION* cached_session =
+        CyaSSL_get_session( wolfssl_tls_context->obj );
+
+    if ( NULL == cached_session )
+    {
+        return XI_BSP_TLS_STATE_CONNECT_ERROR;
+    }
+
+    WOLFSSL_SESSION* session_copy =
+        ( WOLFSSL_SESSION* )wolfSSL_Malloc( sizeof( WOLFSSL_SESSION ) );
+
+    if ( NULL == session_copy )
+    {
+        return XI_BSP_TLS_STATE_CONNECT_ERROR;
+    }
+
+    *session_copy = *cached_session;
+
+#ifdef HAVE_SESSION_TICKET
+    /* a ticket too long for the static buffer is left out, the session id is offered
+     * without it */
+    if ( session_copy->isDynamic )
+    {
+        session_copy->ticketLen = 0;
+        session_copy->isDynamic = 0;
+    }
+
+    session_copy->ticket = session_copy->staticTicket;
+#endif
+
+    *session = session_copy;
+
+    return XI_BSP_TLS_STATE_OK;
+#endif
+}
+
+xi_bsp_tls_state_t xi_bsp_tls_restore_session( xi_bsp_tls_context_t* tls_context,
+                                               xi_bsp_tls_session_t* session )
+{
+    assert( NULL != tls_context );
+    assert( NULL != session );
+
+    xi_bsp_debug_format( "[ %s ]", __FUNCTION__ );
+
+    /* get back the wolfssl_tls_context */
+    wolfssl_tls_context_t* wolfssl_tls_context = tls_context;
+
+    const int ret = CyaSSL_set_session( wolfssl_tls_context->obj, session );
+
+    if ( SSL_SUCCESS != ret )
+    {
+        xi_bsp_debug_format( "failed to set the session, reason: %d", ret );
+        return XI_BSP_TLS_STATE_INIT_ERROR;
+    }
+
+#if !defined( XI_WOLFSSL_SESSION_GET1 ) && defined( HAVE_SESSION_TICKET )
+    /* the session is assigned as a whole, its ticket must not point into the copy */
+    wolfssl_tls_context->obj->session.ticket =
+        wolfssl_tls_context->obj->session.staticTicket;
+#endif
+
+    return XI_BSP_TLS_STATE_OK;
+}
+
+xi_bsp_tls_state_t xi_bsp_tls_session_free( xi_bsp_tls_session_t** session )
+{
+    assert( NULL != session );
+
+    if ( NULL != *session )
+    {
+#ifdef XI_WOLFSSL_SESSION_GET1
+        wolfSSL_SESSION_free( *session );
+#else
+        wolfSSL_Free( *session );
+#endif
+        *session = NULL;
+    }
+
+    return XI_BSP_TLS_STATE_OK;
+}
+
 xi_bsp_tls_state_t xi_bsp_tls_read( xi_bsp_tls_context_t* tls_context,
                                     uint8_t* data_ptr,
                                     size_t data_size,
@@ -388,12 +607,12 @@ xi_bsp_tls_state_t xi_bsp_tls_cleanup( xi_bsp_tls_context_t** tls_context )
     }
 
     wolfssl_tls_context_t* wolfssl_tls_context = *tls_context;
+    xi_bsp_tls_config_t* tls_config            = wolfssl_tls_context->config;
 
-    // here unload the possibly remaining cert binary
-    CyaSSL_CTX_UnloadCAs( wolfssl_tls_context->ctx );
     CyaSSL_free( wolfssl_tls_context->obj );
-    CyaSSL_CTX_free( wolfssl_tls_context->ctx );
-    CyaSSL_Cleanup();
+
+    /* the CA certificates stay loaded as long as other contexts use the configuration */
+    xi_bsp_tls_config_release( &tls_config );
 
     wolfSSL_Free( *tls_context );
     *tls_context = NULL;
@@ -72,6 +72,11 @@ xi_vector_create_from( xi_vector_elem_t* array, size_t len, xi_memory_type_t mem
 
     xi_state_t state = XI_STATE_OK;
 
+    if ( len > XI_VECTOR_INDEX_TYPE_MAX )
+    {
+        return NULL;
+    }
+
     XI_ALLOC( xi_vector_t, ret, state );
 
     ret->array       = array;
@@ -141,9 +146,18 @@ xi_vector_push( xi_vector_t* vector, const union xi_vector_selector_u value )
 
     xi_state_t state = XI_STATE_OK;
 
-    if ( vector->elem_no + 1 > vector->capacity )
+    if ( vector->elem_no >= vector->capacity )
     {
-        XI_CHECK_MEMORY( xi_vector_realloc( vector, vector->capacity * 2 ), state );
+        /* the capacity can't grow past the range of the index type */
+        XI_CHECK_CND( vector->capacity == XI_VECTOR_INDEX_TYPE_MAX, XI_OUT_OF_MEMORY,
+                      state );
+
+        const xi_vector_index_type_t new_capacity =
+            ( vector->capacity > XI_VECTOR_INDEX_TYPE_MAX / 2 )
+                ? XI_VECTOR_INDEX_TYPE_MAX
+                : vector->capacity * 2;
+
+        XI_CHECK_MEMORY( xi_vector_realloc( vector, new_capacity ), state );
     }
 
     vector->array[vector->elem_no].selector_t = value;
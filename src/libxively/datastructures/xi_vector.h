@@ -17,8 +17,30 @@
 extern "C" {
 #endif
 
+/* Width of the vector index type can be chosen at build time, it limits the number of
+ * elements that each vector ( time events, fd tuples, subscriptions, handles ) can
+ * hold. POSIX platforms default to 32 bits, the others keep the small footprint. */
+#ifndef XI_VECTOR_INDEX_TYPE_BITS
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_VECTOR_INDEX_TYPE_BITS 32
+#else
+#define XI_VECTOR_INDEX_TYPE_BITS 8
+#endif
+#endif
+
 /* ! This type has to be SIGNED ! */
+#if XI_VECTOR_INDEX_TYPE_BITS == 32
+typedef int32_t xi_vector_index_type_t;
+#define XI_VECTOR_INDEX_TYPE_MAX INT32_MAX
+#elif XI_VECTOR_INDEX_TYPE_BITS == 16
+typedef int16_t xi_vector_index_type_t;
+#define XI_VECTOR_INDEX_TYPE_MAX INT16_MAX
+#elif XI_VECTOR_INDEX_TYPE_BITS == 8
 typedef int8_t xi_vector_index_type_t;
+#define XI_VECTOR_INDEX_TYPE_MAX INT8_MAX
+#else
+#error "XI_VECTOR_INDEX_TYPE_BITS has to be one of 8, 16 or 32"
+#endif
 
 union xi_vector_selector_u {
     void* ptr_value;
@@ -73,6 +73,7 @@ static volatile size_t xi_memory_application_limit =
 static volatile size_t xi_memory_total_limit =
     XI_MEMORY_LIMITER_APPLICATION_MEMORY_LIMIT + XI_MEMORY_LIMITER_SYSTEM_MEMORY_LIMIT;
 static volatile size_t xi_memory_allocated = 0;
+static volatile size_t xi_memory_allocation_count = 0;
 
 static xi_state_t
 xi_memory_limiter_will_allocation_fit( xi_memory_limiter_allocation_type_t memory_type,
@@ -136,6 +137,11 @@ size_t xi_memory_limiter_get_allocated_space()
     return xi_memory_allocated;
 }
 
+size_t xi_memory_limiter_get_allocation_count()
+{
+    return xi_memory_allocation_count;
+}
+
 void* xi_memory_limiter_alloc( xi_memory_limiter_allocation_type_t limit_type,
                                size_t size_to_alloc,
                                const char* file,
@@ -202,6 +208,7 @@ void* xi_memory_limiter_alloc( xi_memory_limiter_allocation_type_t limit_type,
 
     entry->size = real_size_to_alloc;
     xi_memory_allocated += real_size_to_alloc;
+    xi_memory_allocation_count += 1;
 
 end:
     xi_unlock_critical_section( &xi_memory_limiter_cs );
@@ -311,6 +318,7 @@ void* xi_memory_limiter_realloc( xi_memory_limiter_allocation_type_t limit_type,
 
     entry->size = real_size_to_alloc;
     xi_memory_allocated += real_diff;
+    xi_memory_allocation_count += 1;
 
     ptr_to_ret = get_ptr_from_entry( r_ptr );
 
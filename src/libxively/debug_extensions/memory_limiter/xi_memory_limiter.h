@@ -97,6 +97,14 @@ xi_memory_limiter_get_current_limit( xi_memory_limiter_allocation_type_t limit_t
  */
 extern size_t xi_memory_limiter_get_allocated_space();
 
+/**
+ * @brief xi_memory_limiter_get_allocation_count
+ *
+ * @return number of successful allocations and reallocations so far, a difference of
+ * two readings is the number of times the platform allocator was called in between
+ */
+extern size_t xi_memory_limiter_get_allocation_count();
+
 /**
  * @brief simulates free operation on memory block it just re-add the memory to
  * the pool it will
@@ -9,6 +9,125 @@
 #include "xi_event_dispatcher_api.h"
 #include "xi_list.h"
 #include "xi_helpers.h"
+#include "xi_bsp_time.h"
+
+#ifdef XI_EVENT_LOOP_EPOLL
+#include "xi_event_loop_epoll.h"
+
+/* queues the socket for the epoll_ctl sync done by the event loop before it waits,
+ * must be called with the instance critical section locked */
+static void
+xi_evtd_mark_socket_changed( xi_evtd_instance_t* instance, xi_evtd_fd_tuple_t* tuple )
+{
+    if ( XI_EVTD_FD_TYPE_SOCKET == tuple->fd_type && 0 == tuple->is_changed )
+    {
+        tuple->is_changed = 1;
+        XI_LIST_PUSH_FRONT( xi_evtd_fd_tuple_t, instance->changed_sockets, tuple );
+    }
+}
+#else
+/* the poll based loops re-read the whole handle list on every wait, nothing to sync */
+static void
+xi_evtd_mark_socket_changed( xi_evtd_instance_t* instance, xi_evtd_fd_tuple_t* tuple )
+{
+    XI_UNUSED( instance );
+    XI_UNUSED( tuple );
+}
+#endif
+
+#ifdef XI_MODULE_THREAD_ENABLED
+/* must be called with the instance critical section unlocked */
+static void xi_evtd_new_event_added( xi_evtd_instance_t* instance )
+{
+    if ( XI_EVENT_HANDLE_UNSET != instance->on_new_event.handle_type )
+    {
+        xi_evtd_execute_handle( &instance->on_new_event );
+    }
+}
+#else
+#define xi_evtd_new_event_added( instance )
+#endif
+
+#ifdef XI_MODULE_THREAD_ENABLED
+#define XI_EVTD_LOAD_PTR( ptr ) __atomic_load_n( ptr, __ATOMIC_ACQUIRE )
+#define XI_EVTD_STORE_PTR( ptr, value ) __atomic_store_n( ptr, value, __ATOMIC_RELEASE )
+#define XI_EVTD_EXCHANGE_PTR( ptr, value )                                               \
+    __atomic_exchange_n( ptr, value, __ATOMIC_ACQ_REL )
+#define XI_EVTD_LOAD_FLAG( flag ) __atomic_load_n( flag, __ATOMIC_ACQUIRE )
+#define XI_EVTD_STORE_FLAG( flag, value )                                                \
+    __atomic_store_n( flag, value, __ATOMIC_RELEASE )
+#else
+#define XI_EVTD_LOAD_PTR( ptr ) ( *( ptr ) )
+#define XI_EVTD_STORE_PTR( ptr, value ) ( *( ptr ) = ( value ) )
+#define XI_EVTD_EXCHANGE_PTR( ptr, value ) xi_evtd_exchange_ptr( ptr, value )
+#define XI_EVTD_LOAD_FLAG( flag ) ( *( flag ) )
+#define XI_EVTD_STORE_FLAG( flag, value ) ( *( flag ) = ( value ) )
+
+static xi_event_handle_queue_t*
+xi_evtd_exchange_ptr( xi_event_handle_queue_t** ptr, xi_event_handle_queue_t* value )
+{
+    xi_event_handle_queue_t* prev = *ptr;
+    *ptr                          = value;
+    return prev;
+}
+#endif
+
+/* O(1) and lock free, may be called from any thread */
+static void
+xi_evtd_call_queue_push( xi_evtd_instance_t* instance, xi_event_handle_queue_t* elem )
+{
+    XI_EVTD_STORE_PTR( &elem->__next, NULL );
+
+    xi_event_handle_queue_t* prev =
+        XI_EVTD_EXCHANGE_PTR( &instance->call_queue_tail, elem );
+
+    /* until this store the consumer sees the queue end at prev */
+    XI_EVTD_STORE_PTR( &prev->__next, elem );
+}
+
+/* must be called with the instance critical section locked, returns NULL if the queue
+ * is empty or its next element is still being pushed */
+static xi_event_handle_queue_t* xi_evtd_call_queue_pop( xi_evtd_instance_t* instance )
+{
+    xi_event_handle_queue_t* head = instance->call_queue_head;
+    xi_event_handle_queue_t* next = XI_EVTD_LOAD_PTR( &head->__next );
+
+    if ( head == &instance->call_queue_stub )
+    {
+        if ( NULL == next )
+        {
+            return NULL;
+        }
+
+        instance->call_queue_head = next;
+        head                      = next;
+        next                      = XI_EVTD_LOAD_PTR( &head->__next );
+    }
+
+    if ( NULL != next )
+    {
+        instance->call_queue_head = next;
+        return head;
+    }
+
+    if ( head != XI_EVTD_LOAD_PTR( &instance->call_queue_tail ) )
+    {
+        return NULL;
+    }
+
+    /* head is the last element, the stub takes its place before it is handed out */
+    xi_evtd_call_queue_push( instance, &instance->call_queue_stub );
+
+    next = XI_EVTD_LOAD_PTR( &head->__next );
+
+    if ( NULL != next )
+    {
+        instance->call_queue_head = next;
+        return head;
+    }
+
+    return NULL;
+}
 
 static inline int8_t xi_evtd_cmp_fd( const union xi_vector_selector_u* e0,
                                      const union xi_vector_selector_u* value )
@@ -65,6 +184,8 @@ static int8_t xi_evtd_register_fd( xi_evtd_instance_t* instance,
         }
     }
 
+    xi_evtd_mark_socket_changed( instance, tuple );
+
     xi_unlock_critical_section( instance->cs );
 
     return 1;
@@ -112,6 +233,21 @@ xi_evtd_unregister_fd( xi_evtd_instance_t* instance, xi_vector_t* container, xi_
     if ( -1 != id )
     {
         assert( NULL != container->array[id].selector_t.ptr_value );
+
+#ifdef XI_EVENT_LOOP_EPOLL
+        {
+            xi_evtd_fd_tuple_t* tuple =
+                ( xi_evtd_fd_tuple_t* )container->array[id].selector_t.ptr_value;
+
+            if ( 1 == tuple->is_changed )
+            {
+                XI_LIST_DROP( xi_evtd_fd_tuple_t, instance->changed_sockets, tuple );
+            }
+
+            xi_event_loop_epoll_socket_unregistered( instance, tuple );
+        }
+#endif
+
         XI_SAFE_FREE( container->array[id].selector_t.ptr_value );
         xi_vector_del( container, id );
 
@@ -161,6 +297,8 @@ int8_t xi_evtd_continue_when_evt_on_socket( xi_evtd_instance_t* instance,
         tuple->event_type = event_type;
         tuple->handle     = handle;
 
+        xi_evtd_mark_socket_changed( instance, tuple );
+
         xi_unlock_critical_section( instance->cs );
 
         return 1;
@@ -176,19 +314,35 @@ void xi_evtd_continue_when_empty( xi_evtd_instance_t* instance, xi_event_handle_
     instance->on_empty = handle;
 }
 
+#ifdef XI_MODULE_THREAD_ENABLED
+void xi_evtd_notify_on_new_event( xi_evtd_instance_t* instance, xi_event_handle_t handle )
+{
+    instance->on_new_event = handle;
+}
+#endif
+
 xi_event_handle_queue_t*
 xi_evtd_execute( xi_evtd_instance_t* instance, xi_event_handle_t handle )
 {
     xi_state_t state = XI_STATE_OK;
-    XI_ALLOC_SYSTEM( xi_event_handle_queue_t, queue_elem, state );
 
-    queue_elem->handle = handle;
+    xi_lock_critical_section( instance->call_queue_pool_cs );
 
-    xi_lock_critical_section( instance->cs );
+    xi_event_handle_queue_t* queue_elem =
+        ( xi_event_handle_queue_t* )xi_memory_pool_take( &instance->call_queue_pool );
 
-    XI_LIST_PUSH_BACK( xi_event_handle_queue_t, instance->call_queue, queue_elem );
+    xi_unlock_critical_section( instance->call_queue_pool_cs );
 
-    xi_unlock_critical_section( instance->cs );
+    if ( NULL == queue_elem )
+    {
+        XI_ALLOC_SYSTEM_AT( xi_event_handle_queue_t, queue_elem, state );
+    }
+
+    queue_elem->handle = handle;
+
+    xi_evtd_call_queue_push( instance, queue_elem );
+
+    xi_evtd_new_event_added( instance );
 
     return queue_elem;
 
@@ -200,24 +354,52 @@ xi_state_t xi_evtd_execute_in( xi_evtd_instance_t* instance,
                                xi_event_handle_t handle,
                                xi_time_t time_diff,
                                xi_time_event_handle_t* ret_time_event_handle )
+{
+    return xi_evtd_execute_in_ticks( instance, handle,
+                                     XI_EVTD_SECONDS_TO_TICKS( time_diff ),
+                                     ret_time_event_handle );
+}
+
+xi_state_t xi_evtd_execute_in_ticks( xi_evtd_instance_t* instance,
+                                     xi_event_handle_t handle,
+                                     xi_time_t time_diff_ticks,
+                                     xi_time_event_handle_t* ret_time_event_handle )
 {
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_ALLOC( xi_time_event_t, time_event, ret_state );
+    xi_lock_critical_section( instance->cs );
 
-    time_event->event_handle      = handle;
-    time_event->time_of_execution = instance->current_step + time_diff;
+    xi_time_event_t* time_event =
+        ( xi_time_event_t* )xi_memory_pool_take( &instance->time_event_pool );
 
-    xi_lock_critical_section( instance->cs );
+    if ( NULL == time_event )
+    {
+        XI_ALLOC_AT( xi_time_event_t, time_event, ret_state );
+    }
+    else
+    {
+        memset( time_event, 0, sizeof( xi_time_event_t ) );
+    }
+
+    time_event->event_handle      = handle;
+    time_event->time_of_execution = instance->current_step + time_diff_ticks;
 
     ret_state = xi_time_event_add( instance->time_events_container, time_event,
                                    ret_time_event_handle );
 
+    if ( XI_STATE_OK != ret_state )
+    {
+        xi_memory_pool_give( &instance->time_event_pool, time_event );
+    }
+
+err_handling:
     xi_unlock_critical_section( instance->cs );
 
-    return ret_state;
+    if ( XI_STATE_OK == ret_state )
+    {
+        xi_evtd_new_event_added( instance );
+    }
 
-err_handling:
     return ret_state;
 }
 
@@ -232,9 +414,9 @@ xi_evtd_cancel( xi_evtd_instance_t* instance, xi_time_event_handle_t* time_event
     ret_state = xi_time_event_cancel( instance->time_events_container, time_event_handle,
                                       &time_event );
 
-    xi_unlock_critical_section( instance->cs );
+    xi_memory_pool_give( &instance->time_event_pool, time_event );
 
-    XI_SAFE_FREE( time_event );
+    xi_unlock_critical_section( instance->cs );
 
     return ret_state;
 }
@@ -242,16 +424,29 @@ xi_evtd_cancel( xi_evtd_instance_t* instance, xi_time_event_handle_t* time_event
 xi_state_t xi_evtd_restart( xi_evtd_instance_t* instance,
                             xi_time_event_handle_t* time_event_handle,
                             xi_time_t new_time )
+{
+    return xi_evtd_restart_ticks( instance, time_event_handle,
+                                  XI_EVTD_SECONDS_TO_TICKS( new_time ) );
+}
+
+xi_state_t xi_evtd_restart_ticks( xi_evtd_instance_t* instance,
+                                  xi_time_event_handle_t* time_event_handle,
+                                  xi_time_t new_time_ticks )
 {
     xi_state_t ret_state = XI_STATE_OK;
 
     xi_lock_critical_section( instance->cs );
 
     ret_state = xi_time_event_restart( instance->time_events_container, time_event_handle,
-                                       instance->current_step + new_time );
+                                       instance->current_step + new_time_ticks );
 
     xi_unlock_critical_section( instance->cs );
 
+    if ( XI_STATE_OK == ret_state )
+    {
+        xi_evtd_new_event_added( instance );
+    }
+
     return ret_state;
 }
 
@@ -270,6 +465,15 @@ xi_evtd_instance_t* xi_evtd_create_instance( void )
     XI_CHECK_MEMORY( evtd_instance->handles_and_file_fd, state );
 
     XI_CHECK_STATE( xi_init_critical_section( &evtd_instance->cs ) );
+    XI_CHECK_STATE( xi_init_critical_section( &evtd_instance->call_queue_pool_cs ) );
+
+    evtd_instance->call_queue_head = &evtd_instance->call_queue_stub;
+    evtd_instance->call_queue_tail = &evtd_instance->call_queue_stub;
+
+    const xi_memory_pool_t empty_pool = xi_make_memory_pool( XI_EVTD_MEMORY_POOL_SIZE );
+
+    evtd_instance->call_queue_pool = empty_pool;
+    evtd_instance->time_event_pool = empty_pool;
 
     return evtd_instance;
 
@@ -289,11 +493,20 @@ void xi_evtd_destroy_instance( xi_evtd_instance_t* instance )
 
     xi_lock_critical_section( cs );
 
+#ifdef XI_EVENT_LOOP_EPOLL
+    xi_event_loop_epoll_destroy( instance );
+#endif
+
     xi_vector_destroy( instance->handles_and_file_fd );
     xi_vector_destroy( instance->handles_and_socket_fd );
     xi_time_event_destroy( instance->time_events_container );
     xi_vector_destroy( instance->time_events_container );
 
+    xi_memory_pool_drain( &instance->call_queue_pool );
+    xi_memory_pool_drain( &instance->time_event_pool );
+
+    xi_destroy_critical_section( &instance->call_queue_pool_cs );
+
     XI_SAFE_FREE( instance );
 
     xi_unlock_critical_section( cs );
@@ -353,21 +566,17 @@ static uint8_t xi_state_is_fatal( xi_state_t e )
     }
 }
 
-extern uint8_t
-xi_evtd_single_step( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
+uint8_t xi_evtd_single_step_ticks( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
 {
     if ( evtd_instance == NULL )
         return 0;
 
-    evtd_instance->current_step = new_step;
-
     xi_event_handle_queue_t* queue_elem = NULL;
 
     xi_lock_critical_section( evtd_instance->cs );
-    if ( !XI_LIST_EMPTY( xi_event_handle_queue_t, evtd_instance->call_queue ) )
-    {
-        XI_LIST_POP( xi_event_handle_queue_t, evtd_instance->call_queue, queue_elem );
-    }
+    /* current_step is the base of every execute_in/restart, keep it under the lock */
+    evtd_instance->current_step = new_step;
+    queue_elem                  = xi_evtd_call_queue_pop( evtd_instance );
     xi_unlock_critical_section( evtd_instance->cs );
 
     if ( queue_elem == NULL )
@@ -380,18 +589,31 @@ xi_evtd_single_step( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
         xi_debug_logger( "error while processing normal events" );
     }
 
-    XI_SAFE_FREE( queue_elem );
+    xi_lock_critical_section( evtd_instance->call_queue_pool_cs );
+    xi_memory_pool_give( &evtd_instance->call_queue_pool, queue_elem );
+    xi_unlock_critical_section( evtd_instance->call_queue_pool_cs );
 
     return 1;
 }
 
+extern uint8_t
+xi_evtd_single_step( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
+{
+    return xi_evtd_single_step_ticks( evtd_instance,
+                                      XI_EVTD_SECONDS_TO_TICKS( new_step ) );
+}
+
 void xi_evtd_step( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
+{
+    xi_evtd_step_ticks( evtd_instance, XI_EVTD_SECONDS_TO_TICKS( new_step ) );
+}
+
+void xi_evtd_step_ticks( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
 {
     if ( evtd_instance == NULL )
         return;
 
-    evtd_instance->current_step = new_step;
-    xi_time_event_t* tmp        = NULL;
+    xi_time_event_t* tmp = NULL;
 
 #ifdef XI_DEUBG_OUTPUT_EVENT_SYSTEM
     xi_debug_format( "[size of time event queue: %d]",
@@ -401,6 +623,8 @@ void xi_evtd_step( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
 
     xi_lock_critical_section( evtd_instance->cs );
 
+    evtd_instance->current_step = new_step;
+
     /* zero - not NULL elem_no it's a number not a pointer */
     while ( 0 != evtd_instance->time_events_container->elem_no )
     {
@@ -414,8 +638,6 @@ void xi_evtd_step( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
 
             xi_state_t result = xi_evtd_execute_handle( handle );
 
-            XI_SAFE_FREE( tmp );
-
             if ( xi_state_is_fatal( result ) == 1 )
             {
                 xi_debug_logger( "error while processing timed events" );
@@ -423,6 +645,8 @@ void xi_evtd_step( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
             }
 
             xi_lock_critical_section( evtd_instance->cs );
+
+            xi_memory_pool_give( &evtd_instance->time_event_pool, tmp );
         }
         else
         {
@@ -442,7 +666,7 @@ void xi_evtd_step( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
 #endif
 
     /* execute all handlers in call_queue */
-    while ( xi_evtd_single_step( evtd_instance, new_step ) )
+    while ( xi_evtd_single_step_ticks( evtd_instance, new_step ) )
         ;
 
     xi_lock_critical_section( evtd_instance->cs );
@@ -466,7 +690,12 @@ void xi_evtd_step( xi_evtd_instance_t* evtd_instance, xi_time_t new_step )
 
 uint8_t xi_evtd_dispatcher_continue( xi_evtd_instance_t* instance )
 {
-    return instance != NULL && instance->stop != 1;
+    return instance != NULL && 1 != XI_EVTD_LOAD_FLAG( &instance->stop );
+}
+
+uint8_t xi_evtd_is_call_queue_empty( xi_evtd_instance_t* instance )
+{
+    return &instance->call_queue_stub == XI_EVTD_LOAD_PTR( &instance->call_queue_tail );
 }
 
 uint8_t xi_evtd_all_continue( xi_evtd_instance_t** event_dispatchers, uint8_t num_evtds )
@@ -482,6 +711,34 @@ uint8_t xi_evtd_all_continue( xi_evtd_instance_t** event_dispatchers, uint8_t nu
     return all_continue;
 }
 
+/* must be called with the instance critical section locked, the lock is released for
+ * the time of the handle execution */
+static void
+xi_evtd_execute_fd_tuple( xi_evtd_instance_t* instance, xi_evtd_fd_tuple_t* tuple )
+{
+    /* save the handle to execute */
+    xi_event_handle_t to_exec = tuple->handle;
+
+    /* set the default one if fd type socket */
+    if ( XI_EVTD_FD_TYPE_SOCKET == tuple->fd_type )
+    {
+        tuple->event_type = XI_EVENT_WANT_READ; // default
+        tuple->handle     = tuple->read_handle;
+
+        xi_evtd_mark_socket_changed( instance, tuple );
+    }
+
+    /* execute previously saved handle
+     * we save the handle because the tuple->handle
+     * may be overrided within the handle execution
+     * so we don't won't to override that again */
+    xi_unlock_critical_section( instance->cs );
+
+    xi_evtd_execute_handle( &to_exec );
+
+    xi_lock_critical_section( instance->cs );
+}
+
 xi_state_t xi_evtd_update_event_on_fd( xi_evtd_instance_t* instance,
                                        xi_vector_t* container,
                                        xi_fd_t fd )
@@ -494,28 +751,8 @@ xi_state_t xi_evtd_update_event_on_fd( xi_evtd_instance_t* instance,
 
     if ( id != -1 )
     {
-        xi_evtd_fd_tuple_t* tuple =
-            ( xi_evtd_fd_tuple_t* )container->array[id].selector_t.ptr_value;
-
-        /* save the handle to execute */
-        xi_event_handle_t to_exec = tuple->handle;
-
-        /* set the default one if fd type socket */
-        if ( XI_EVTD_FD_TYPE_SOCKET == tuple->fd_type )
-        {
-            tuple->event_type = XI_EVENT_WANT_READ; // default
-            tuple->handle     = tuple->read_handle;
-        }
-
-        /* execute previously saved handle
-         * we save the handle because the tuple->handle
-         * may be overrided within the handle execution
-         * so we don't won't to override that again */
-        xi_unlock_critical_section( instance->cs );
-
-        xi_evtd_execute_handle( &to_exec );
-
-        xi_lock_critical_section( instance->cs );
+        xi_evtd_execute_fd_tuple(
+            instance, ( xi_evtd_fd_tuple_t* )container->array[id].selector_t.ptr_value );
     }
     else
     {
@@ -541,11 +778,39 @@ xi_state_t xi_evtd_update_event_on_file( xi_evtd_instance_t* instance, xi_fd_t f
     return xi_evtd_update_event_on_fd( instance, instance->handles_and_file_fd, fd );
 }
 
+xi_state_t xi_evtd_update_event_on_fd_tuple( xi_evtd_instance_t* instance,
+                                             xi_evtd_fd_tuple_t* tuple )
+{
+    assert( instance != 0 );
+    assert( tuple != 0 );
+
+    xi_lock_critical_section( instance->cs );
+
+    xi_evtd_execute_fd_tuple( instance, tuple );
+
+    xi_unlock_critical_section( instance->cs );
+
+    return XI_STATE_OK;
+}
+
+xi_time_t xi_evtd_get_current_time_ticks( void )
+{
+#if XI_EVTD_TICKS_PER_SECOND == 1
+    return xi_bsp_time_getcurrenttime_seconds();
+#else
+    /* monotonic, so timers neither fire early nor stall when the wall clock is set */
+    return xi_bsp_time_getmonotonictime_milliseconds() /
+           ( 1000 / XI_EVTD_TICKS_PER_SECOND );
+#endif
+}
+
 void xi_evtd_stop( xi_evtd_instance_t* instance )
 {
     assert( instance != 0 );
 
-    instance->stop = 1;
+    XI_EVTD_STORE_FLAG( &instance->stop, 1 );
+
+    xi_evtd_new_event_added( instance );
 }
 
 uint8_t xi_evtd_update_file_fd_events( xi_evtd_instance_t* const event_dispatcher )
@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <limits.h>
 
 #include "xi_config.h"
 #include "xi_vector.h"
@@ -21,6 +22,7 @@
 #include "xi_event_handle_queue.h"
 
 #include "xi_critical_section.h"
+#include "xi_memory_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,6 +30,40 @@ extern "C" {
 
 typedef intptr_t xi_fd_t;
 
+/* The event dispatcher counts time in ticks. A tick is a millisecond wherever xi_time_t
+ * is wide enough to hold the milliseconds since Epoch, a second otherwise. */
+#ifndef XI_EVTD_TICKS_PER_SECOND
+#if defined( XI_PLATFORM_BASE_POSIX ) && ( LONG_MAX > 2147483647L )
+#define XI_EVTD_TICKS_PER_SECOND 1000
+#else
+#define XI_EVTD_TICKS_PER_SECOND 1
+#endif
+#endif
+
+#if ( 1000 % XI_EVTD_TICKS_PER_SECOND ) != 0
+#error XI_EVTD_TICKS_PER_SECOND must be a divisor of 1000
+#endif
+
+#define XI_EVTD_SECONDS_TO_TICKS( s ) ( ( xi_time_t )( s ) * XI_EVTD_TICKS_PER_SECOND )
+
+/* rounds up so a time event is never executed before the requested time */
+#define XI_EVTD_MILLISECONDS_TO_TICKS( ms )                                              \
+    ( ( ( xi_time_t )( ms ) + ( 1000 / XI_EVTD_TICKS_PER_SECOND ) - 1 ) /                \
+      ( 1000 / XI_EVTD_TICKS_PER_SECOND ) )
+
+#define XI_EVTD_TICKS_TO_MILLISECONDS( t )                                               \
+    ( ( xi_time_t )( t ) * ( 1000 / XI_EVTD_TICKS_PER_SECOND ) )
+
+/* number of released call queue elements and time events each event dispatcher keeps
+ * for reuse, 0 gives every one of them back to the platform allocator right away */
+#ifndef XI_EVTD_MEMORY_POOL_SIZE
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_EVTD_MEMORY_POOL_SIZE 64
+#else
+#define XI_EVTD_MEMORY_POOL_SIZE 8
+#endif
+#endif
+
 typedef enum xi_evtd_fd_type_e {
     XI_EVTD_FD_TYPE_SOCKET = 0,
     XI_EVTD_FD_TYPE_FILE
@@ -40,18 +76,44 @@ typedef struct xi_evtd_tuple_s
     xi_event_handle_t read_handle;
     xi_event_type_t event_type;
     xi_evtd_fd_type_t fd_type;
+#ifdef XI_EVENT_LOOP_EPOLL
+    struct xi_evtd_tuple_s* __next; /* link in the changed sockets list */
+    uint32_t polled_events;         /* epoll interest currently set in the kernel */
+    uint8_t is_changed;
+#endif
 } xi_evtd_fd_tuple_t;
 
 typedef struct xi_evtd_instance_s
 {
-    xi_time_t current_step;
+    xi_time_t current_step; /* in ticks */
     xi_vector_t* time_events_container;
-    xi_event_handle_queue_t* call_queue;
+    /* intrusive multi producer single consumer queue of the handles to execute, the
+     * producers only swap call_queue_tail, the consumer pops at call_queue_head under
+     * cs, the stub element keeps the queue from ever running out of elements */
+    xi_event_handle_queue_t* call_queue_head;
+    xi_event_handle_queue_t* call_queue_tail;
+    xi_event_handle_queue_t call_queue_stub;
     struct xi_critical_section_s* cs;
     xi_vector_t* handles_and_socket_fd;
     xi_vector_t* handles_and_file_fd;
     xi_event_handle_t on_empty;
+#ifdef XI_MODULE_THREAD_ENABLED
+    /* lets a thread waiting for this dispatcher's events block, see
+     * xi_evtd_notify_on_new_event */
+    xi_event_handle_t on_new_event;
+#endif
+    /* guarded by call_queue_pool_cs so producers stay off cs */
+    xi_memory_pool_t call_queue_pool;
+    struct xi_critical_section_s* call_queue_pool_cs;
+    /* guarded by cs */
+    xi_memory_pool_t time_event_pool;
+    /* atomic, set by xi_evtd_stop from any thread */
     uint8_t stop;
+#ifdef XI_EVENT_LOOP_EPOLL
+    /* sockets whose event_type changed since the last epoll_ctl sync */
+    xi_evtd_fd_tuple_t* changed_sockets;
+    struct xi_event_loop_epoll_s* epoll;
+#endif
 } xi_evtd_instance_t;
 
 extern int8_t xi_evtd_register_file_fd( xi_evtd_instance_t* instance,
@@ -75,33 +137,84 @@ extern int8_t xi_evtd_continue_when_evt_on_socket( xi_evtd_instance_t* instance,
 extern void
 xi_evtd_continue_when_empty( xi_evtd_instance_t* instance, xi_event_handle_t handle );
 
+#ifdef XI_MODULE_THREAD_ENABLED
+/**
+ * @brief xi_evtd_notify_on_new_event
+ *
+ * Makes the dispatcher call the handle, on the calling thread and outside of its
+ * critical section, after a handle is queued, a time event is added or restarted and
+ * after the dispatcher is stopped. A thread owning the dispatcher can then sleep until
+ * that or its earliest time event instead of polling. The handle is not disposed, it
+ * has to be set before other threads start using the dispatcher.
+ */
+extern void
+xi_evtd_notify_on_new_event( xi_evtd_instance_t* instance, xi_event_handle_t handle );
+#endif
+
 extern xi_event_handle_queue_t*
 xi_evtd_execute( xi_evtd_instance_t* instance, xi_event_handle_t handle );
 
+/* time_diff is given in seconds */
 extern xi_state_t xi_evtd_execute_in( xi_evtd_instance_t* instance,
                                       xi_event_handle_t handle,
                                       xi_time_t time_diff,
                                       xi_time_event_handle_t* ret_time_event_handle );
 
+extern xi_state_t
+xi_evtd_execute_in_ticks( xi_evtd_instance_t* instance,
+                          xi_event_handle_t handle,
+                          xi_time_t time_diff_ticks,
+                          xi_time_event_handle_t* ret_time_event_handle );
+
 extern xi_state_t
 xi_evtd_cancel( xi_evtd_instance_t* instance, xi_time_event_handle_t* time_event_handle );
 
+/* new_time is given in seconds */
 extern xi_state_t xi_evtd_restart( xi_evtd_instance_t* instance,
                                    xi_time_event_handle_t* time_event_handle,
                                    xi_time_t new_time );
 
+extern xi_state_t xi_evtd_restart_ticks( xi_evtd_instance_t* instance,
+                                         xi_time_event_handle_t* time_event_handle,
+                                         xi_time_t new_time_ticks );
+
 extern xi_evtd_instance_t* xi_evtd_create_instance( void );
 
 extern void xi_evtd_destroy_instance( xi_evtd_instance_t* instance );
 
 extern xi_event_handle_return_t xi_evtd_execute_handle( xi_event_handle_t* handle );
 
+/* new_step is given in seconds */
 extern uint8_t xi_evtd_single_step( xi_evtd_instance_t* instance, xi_time_t new_step );
 
+/* new_step is given in seconds */
 extern void xi_evtd_step( xi_evtd_instance_t* instance, xi_time_t new_step );
 
+extern uint8_t
+xi_evtd_single_step_ticks( xi_evtd_instance_t* instance, xi_time_t new_step_ticks );
+
+extern void xi_evtd_step_ticks( xi_evtd_instance_t* instance, xi_time_t new_step_ticks );
+
+/**
+ * @brief xi_evtd_get_current_time_ticks
+ *
+ * Reads the BSP clock with the resolution of the event dispatcher tick. With
+ * millisecond ticks this is the monotonic BSP clock, not the wall clock.
+ *
+ * @return current time in ticks
+ */
+extern xi_time_t xi_evtd_get_current_time_ticks( void );
+
 extern uint8_t xi_evtd_dispatcher_continue( xi_evtd_instance_t* instance );
 
+/**
+ * @brief xi_evtd_is_call_queue_empty
+ *
+ * @return 1 if there is no handle waiting for execution, the last one popped may still
+ * be running, 0 otherwise
+ */
+extern uint8_t xi_evtd_is_call_queue_empty( xi_evtd_instance_t* instance );
+
 extern uint8_t
 xi_evtd_all_continue( xi_evtd_instance_t** event_dispatchers, uint8_t num_evtds );
 
@@ -111,6 +224,19 @@ xi_evtd_update_event_on_socket( xi_evtd_instance_t* instance, xi_fd_t fds );
 extern xi_state_t
 xi_evtd_update_event_on_file( xi_evtd_instance_t* instance, xi_fd_t fds );
 
+/**
+ * @brief xi_evtd_update_event_on_fd_tuple
+ *
+ * Same as xi_evtd_update_event_on_socket but skips the lookup of the tuple, for event
+ * loops that keep a pointer to the registered tuple ( e.g. in epoll_event.data ).
+ *
+ * @param instance of an event dispatcher the tuple is registered in
+ * @param tuple registered socket tuple, must not be unregistered yet
+ * @return XI_STATE_OK
+ */
+extern xi_state_t xi_evtd_update_event_on_fd_tuple( xi_evtd_instance_t* instance,
+                                                    xi_evtd_fd_tuple_t* tuple );
+
 extern void xi_evtd_stop( xi_evtd_instance_t* instance );
 
 extern xi_event_handle_t
@@ -133,8 +259,9 @@ extern uint8_t xi_evtd_update_file_fd_events( xi_evtd_instance_t* const instance
  * Calculates the time of execution of the earliest event registered in event dispatcher.
  *
  * @param instance of an event dispatcher which will be queried for the time
- * @param pointer to the xi_time_t where the value of time of execution of the earliest
- * event will be stored, if there is no events value under the pointer want be modified
+ * @param pointer to the xi_time_t where the value of time of execution ( in ticks ) of
+ * the earliest event will be stored, if there is no events value under the pointer want
+ * be modified
  * @return XI_STATE_OK if the earliest event exists, XI_ELEMENT_NOT_FOUND if there is no
  * events
  */
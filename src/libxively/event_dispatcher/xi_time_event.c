@@ -11,186 +11,266 @@
  * implementation assumes that the element type is always the xi_time_event_t.
  *
  * It uses the vector as a container type. The vector stores pointers to the time events.
- * Time events are always sorted in the vector by the time event execution time.
+ * Time events are kept in the vector as an implicit d-ary min-heap ordered by the time
+ * event execution time, so the element with the minimum execution time is always at the
+ * index 0.
+ *
+ * Each of the time events keeps its current index in the heap, thanks to that the
+ * element associated with a time event handle can be reached in O(1). Insertion,
+ * cancellation, restart and removal of the top element cost O(log n).
+ *
+ * The heap on its own is not a stable container, so time events with equal execution
+ * time are additionally ordered by the sequence number assigned on add and restart. That
+ * keeps the order of execution of such events the same as in the order they were
+ * scheduled.
  */
 
+/* sequence numbers are compared using serial number arithmetic, so the wrap around of
+ * the counter doesn't affect the order of the time events */
+static uint32_t xi_time_event_sequence_counter = 0;
+
+/* the counter is shared by the containers of all the dispatchers, with threading those
+ * can be modified from different threads at the same time */
+#ifdef XI_MODULE_THREAD_ENABLED
+#define XI_TIME_EVENT_NEXT_SEQUENCE_NUMBER()                                             \
+    __sync_fetch_and_add( &xi_time_event_sequence_counter, 1 )
+#else
+#define XI_TIME_EVENT_NEXT_SEQUENCE_NUMBER() ( xi_time_event_sequence_counter++ )
+#endif
+
+#define XI_TIME_EVENT_HEAP_PARENT( index ) ( ( ( index )-1 ) / XI_TIME_EVENT_HEAP_ARITY )
+#define XI_TIME_EVENT_HEAP_FIRST_CHILD( index )                                          \
+    ( ( index )*XI_TIME_EVENT_HEAP_ARITY + 1 )
+
 /*
  * STATIC INTERNAL FUNCTIONS
  */
 
 /**
- * @brief xi_swap_time_events
- *
- * Swaps the two xi_time_event_t elements in the provided vector.
+ * @brief xi_time_event_at
  *
+ * Helper accessor that returns the time event stored at the given index.
  *
  * @param vector
- * @param lhs_index
- * @param rhs_index
+ * @param index
  */
-static void xi_swap_time_events( xi_vector_t* vector,
-                                 xi_vector_index_type_t lhs_index,
-                                 xi_vector_index_type_t rhs_index )
+static inline xi_time_event_t*
+xi_time_event_at( const xi_vector_t* vector, xi_vector_index_type_t index )
 {
-    /* PRE-CONDITIONS */
-    assert( NULL != vector );
-    assert( lhs_index < vector->elem_no );
-    assert( rhs_index < vector->elem_no );
-    assert( lhs_index >= 0 );
-    assert( rhs_index >= 0 );
+    return ( xi_time_event_t* )vector->array[index].selector_t.ptr_value;
+}
 
-    xi_time_event_t* lhs_time_event =
-        ( xi_time_event_t* )vector->array[lhs_index].selector_t.ptr_value;
-    xi_time_event_t* rhs_time_event =
-        ( xi_time_event_t* )vector->array[rhs_index].selector_t.ptr_value;
+/**
+ * @brief xi_time_event_precedes
+ *
+ * Container order predicate, returns 1 if the lhs time event has to be executed before
+ * the rhs time event.
+ *
+ * @param lhs
+ * @param rhs
+ */
+static inline int
+xi_time_event_precedes( const xi_time_event_t* lhs, const xi_time_event_t* rhs )
+{
+    if ( lhs->time_of_execution != rhs->time_of_execution )
+    {
+        return lhs->time_of_execution < rhs->time_of_execution;
+    }
 
-    xi_vector_swap_elems( vector, lhs_index, rhs_index );
+    return ( int32_t )( lhs->sequence_number - rhs->sequence_number ) < 0;
+}
 
-    lhs_time_event->position = rhs_index;
-    rhs_time_event->position = lhs_index;
+/**
+ * @brief xi_time_event_place_at
+ *
+ * Stores the time event at the given index and updates its position so that the time
+ * event handle associated with it keeps pointing to the right element.
+ *
+ * @param vector
+ * @param index
+ * @param time_event
+ */
+static inline void xi_time_event_place_at( xi_vector_t* vector,
+                                           xi_vector_index_type_t index,
+                                           xi_time_event_t* time_event )
+{
+    vector->array[index].selector_t.ptr_value = time_event;
+    time_event->position                      = index;
 }
 
 /**
- * @brief xi_time_event_bubble_core
+ * @brief xi_time_event_sift_up
  *
- * Generic bubbler. This function eliminates code repeatition for the logic of bubbling
- * an element in both directions in the vector. It is used by
- * xi_time_event_bubble_and_sort_down and xi_time_event_bubble_and_sort_up.
+ * Moves the element from the given position towards the root of the heap until the heap
+ * invariant is restored. Instead of swapping at each level the parents are shifted down
+ * and the element is written only once at its final position.
  *
- * @param vector - input vector, container of time events
- * @param index - position of the elment to bubble
- * @param dir - direction of bubbling - +1 stands for up -1 means down
- * @return new index of bubbled element
+ * @note: invariant of this container - no element precedes its parent:
+ * !xi_time_event_precedes( vector[i], vector[parent(i)] )
+ *
+ * @param vector
+ * @param index
+ * @return new index of the element
  */
 static xi_vector_index_type_t
-xi_time_event_bubble_core( xi_vector_t* vector, xi_vector_index_type_t index, int8_t dir )
+xi_time_event_sift_up( xi_vector_t* vector, xi_vector_index_type_t index )
 {
     /* PRE-CONDITIONS */
     assert( NULL != vector );
-    assert( vector->elem_no > 0 );
     assert( index >= 0 );
     assert( index < vector->elem_no );
-    assert( dir == -1 || dir == 1 );
-
-    /* guards */
-    const xi_vector_elem_t* end   = &vector->array[XI_MAX( vector->elem_no - 1, 0 )];
-    const xi_vector_elem_t* begin = &vector->array[0];
 
-    /* lonely traveler */
-    xi_vector_elem_t* elem_to_bubble = &vector->array[index];
+    xi_time_event_t* time_event = xi_time_event_at( vector, index );
 
-    while ( ( dir < 0 ) ? ( elem_to_bubble != begin ) : ( elem_to_bubble != end ) )
+    while ( index > 0 )
     {
-        const xi_time_event_t* time_event_to_cmp =
-            ( elem_to_bubble + dir )->selector_t.ptr_value;
-        const xi_time_event_t* time_event_to_bubble =
-            elem_to_bubble->selector_t.ptr_value;
-
-        if ( ( dir < 0 ) ? ( time_event_to_bubble->time_of_execution <
-                             time_event_to_cmp->time_of_execution )
-                         : ( time_event_to_bubble->time_of_execution >
-                             time_event_to_cmp->time_of_execution ) )
-        {
-            /* if the elements are not in the right order lets swap them */
-            xi_swap_time_events( vector, time_event_to_cmp->position,
-                                 time_event_to_bubble->position );
+        const xi_vector_index_type_t parent_index = XI_TIME_EVENT_HEAP_PARENT( index );
+        xi_time_event_t* parent = xi_time_event_at( vector, parent_index );
 
-            /* update the ptr */
-            elem_to_bubble += dir;
-        }
-        else
+        if ( 0 == xi_time_event_precedes( time_event, parent ) )
         {
-            /* thanks to the container invariant on the order of the elemements we can
-             * break at this moment */
             break;
         }
+
+        xi_time_event_place_at( vector, index, parent );
+        index = parent_index;
     }
 
-    return ( ( xi_time_event_t* )( elem_to_bubble->selector_t.ptr_value ) )->position;
+    xi_time_event_place_at( vector, index, time_event );
+
+    return index;
 }
 
 /**
- * @brief xi_time_event_bubble_and_sort_down
+ * @brief xi_time_event_sift_down
  *
- * Helper function used for insertion and re-insertion ( cancel opertaion ). It uses
- * the
- * bubble sort algorithm to put the element on the proper position.
+ * Moves the element from the given position towards the leaves of the heap until the
+ * heap invariant is restored. It works using the same principle as
+ * xi_time_event_sift_up function.
  *
- * @note: invariant of this container - it's elements are sorted using the time of
- * execution so:
- * vector[i].time_of_execution <= vector[i+1].time_of_execution
+ * @see xi_time_event_sift_up
  *
  * @param vector
  * @param index
- * @return new index of the element after bubbling it
+ * @return new index of the element
  */
 static xi_vector_index_type_t
-xi_time_event_bubble_and_sort_down( xi_vector_t* vector, xi_vector_index_type_t index )
+xi_time_event_sift_down( xi_vector_t* vector, xi_vector_index_type_t index )
 {
     /* PRE-CONDITIONS */
     assert( NULL != vector );
     assert( index >= 0 );
     assert( index < vector->elem_no );
 
-    return xi_time_event_bubble_core( vector, index, -1 );
+    xi_time_event_t* time_event = xi_time_event_at( vector, index );
+
+    /* size_t is used for the children indexes so that their computation can't overflow
+     * the vector index type */
+    const size_t elem_no = ( size_t )vector->elem_no;
+
+    for ( ;; )
+    {
+        const size_t first_child = XI_TIME_EVENT_HEAP_FIRST_CHILD( ( size_t )index );
+
+        if ( first_child >= elem_no )
+        {
+            break;
+        }
+
+        const size_t last_child =
+            XI_MIN( first_child + XI_TIME_EVENT_HEAP_ARITY, elem_no );
+
+        /* find the child with the minimum execution time */
+        size_t min_child               = first_child;
+        xi_time_event_t* min_child_evt = xi_time_event_at( vector, first_child );
+
+        size_t child = first_child + 1;
+        for ( ; child < last_child; ++child )
+        {
+            xi_time_event_t* child_evt = xi_time_event_at( vector, child );
+
+            if ( xi_time_event_precedes( child_evt, min_child_evt ) )
+            {
+                min_child     = child;
+                min_child_evt = child_evt;
+            }
+        }
+
+        if ( 0 == xi_time_event_precedes( min_child_evt, time_event ) )
+        {
+            break;
+        }
+
+        xi_time_event_place_at( vector, index, min_child_evt );
+        index = ( xi_vector_index_type_t )min_child;
+    }
+
+    xi_time_event_place_at( vector, index, time_event );
+
+    return index;
 }
 
 /**
- * @brief xi_time_event_bubble_and_sort_up
+ * @brief xi_time_event_fix_at
  *
- * Helper function used to restarting time event. It bubbles the time event element up
- * to
- * the end of the container. It works using the same principle as
- * xi_time_event_bubble_and_sort_down function.
- *
- * @see xi_time_event_bubble_and_sort_down function xi_time_event_restart
+ * Restores the heap invariant for the element at the given position after its key has
+ * changed or after it has been put in place of a removed element.
  *
  * @param vector
  * @param index
- * @return
+ * @return new index of the element
  */
 static xi_vector_index_type_t
-xi_time_event_bubble_and_sort_up( xi_vector_t* vector, xi_vector_index_type_t index )
+xi_time_event_fix_at( xi_vector_t* vector, xi_vector_index_type_t index )
 {
-    /* PRE-CONDITIONS */
-    assert( NULL != vector );
-    assert( index >= 0 );
-    assert( index < vector->elem_no );
+    if ( index > 0 &&
+         xi_time_event_precedes(
+             xi_time_event_at( vector, index ),
+             xi_time_event_at( vector, XI_TIME_EVENT_HEAP_PARENT( index ) ) ) )
+    {
+        return xi_time_event_sift_up( vector, index );
+    }
 
-    return xi_time_event_bubble_core( vector, index, 1 );
+    return xi_time_event_sift_down( vector, index );
 }
 
-
 /**
- * @brief xi_time_event_move_to_the_end
+ * @brief xi_time_event_remove_at
  *
- * Helper function that moves the element form the given position ( index ) to the end
- * of
- * the vector.
+ * Helper function that removes the element from the given position. The last element of
+ * the heap is moved into the released slot and then sifted to its proper position.
  *
  * @param vector
  * @param index
+ * @return the removed time event
  */
-static void
-xi_time_event_move_to_the_end( xi_vector_t* vector, xi_vector_index_type_t index )
+static xi_time_event_t*
+xi_time_event_remove_at( xi_vector_t* vector, xi_vector_index_type_t index )
 {
     /* PRE-CONDITIONS */
     assert( NULL != vector );
     assert( vector->elem_no > 0 );
-    assert( index < vector->elem_no );
     assert( index >= 0 );
+    assert( index < vector->elem_no );
 
-    const xi_vector_index_type_t last_elem_index   = vector->elem_no - 1;
-    xi_vector_index_type_t elem_to_swap_with_index = index + 1;
+    xi_time_event_t* removed_time_event       = xi_time_event_at( vector, index );
+    const xi_vector_index_type_t last_index = vector->elem_no - 1;
 
-    while ( index < last_elem_index )
+    if ( index != last_index )
     {
-        xi_swap_time_events( vector, index, elem_to_swap_with_index );
+        xi_time_event_place_at( vector, index, xi_time_event_at( vector, last_index ) );
+    }
 
-        /* once swapped update the indexes */
-        index += 1;
-        elem_to_swap_with_index += 1;
+    xi_vector_del( vector, last_index );
+
+    if ( index < vector->elem_no )
+    {
+        xi_time_event_fix_at( vector, index );
     }
+
+    removed_time_event->position = XI_TIME_EVENT_POSITION_INVALID;
+
+    return removed_time_event;
 }
 
 /**
@@ -208,9 +288,10 @@ xi_insert_time_event( xi_vector_t* vector, xi_time_event_t* time_event )
     assert( NULL != vector );
     assert( NULL != time_event );
 
-    xi_state_t local_state                = XI_STATE_OK;
-    xi_vector_index_type_t index          = 0;
-    const xi_vector_elem_t* element_added = NULL;
+    xi_state_t local_state       = XI_STATE_OK;
+    xi_vector_index_type_t index = 0;
+
+    time_event->sequence_number = XI_TIME_EVENT_NEXT_SEQUENCE_NUMBER();
 
     /* add the element to the end of the vector */
     {
@@ -220,14 +301,9 @@ xi_insert_time_event( xi_vector_t* vector, xi_time_event_t* time_event )
         XI_CHECK_MEMORY( inserted_element, local_state );
     }
 
-    /* update the time event new position */
-    time_event->position = vector->elem_no - 1;
-
-    index = xi_time_event_bubble_and_sort_down( vector, vector->elem_no - 1 );
+    index = xi_time_event_sift_up( vector, vector->elem_no - 1 );
 
-    element_added = &vector->array[index];
-
-    return element_added;
+    return &vector->array[index];
 
 err_handling:
     return NULL;
@@ -291,8 +367,7 @@ xi_state_t xi_time_event_add( xi_vector_t* vector,
     xi_state_t out_state              = XI_STATE_OK;
     xi_time_event_t* added_time_event = NULL;
 
-    /* call the insert at function it will place the new element at the proper place
-     */
+    /* call the insert function it will place the new element at the proper place */
     const xi_vector_elem_t* elem = xi_insert_time_event( vector, time_event );
 
     /* if there is a problem with the memory go to err_handling */
@@ -330,19 +405,7 @@ xi_time_event_t* xi_time_event_get_top( xi_vector_t* vector )
         return NULL;
     }
 
-    xi_time_event_t* top_one = ( xi_time_event_t* )vector->array[0].selector_t.ptr_value;
-
-    /* the trick is to bubble the element to the end of the vector and then to delete
-     * it*/
-    if ( vector->elem_no > 1 )
-    {
-        xi_time_event_move_to_the_end( vector, 0 );
-        xi_vector_del( vector, vector->elem_no - 1 );
-    }
-    else
-    {
-        xi_vector_del( vector, vector->elem_no - 1 );
-    }
+    xi_time_event_t* top_one = xi_time_event_remove_at( vector, 0 );
 
     xi_time_event_dispose_time_event( top_one );
 
@@ -359,9 +422,7 @@ xi_time_event_t* xi_time_event_peek_top( xi_vector_t* vector )
         return NULL;
     }
 
-    xi_time_event_t* top_one = ( xi_time_event_t* )vector->array[0].selector_t.ptr_value;
-
-    return top_one;
+    return xi_time_event_at( vector, 0 );
 }
 
 xi_state_t xi_time_event_restart( xi_vector_t* vector,
@@ -384,23 +445,15 @@ xi_state_t xi_time_event_restart( xi_vector_t* vector,
     }
 
     /* let's update the key of this element */
-    xi_time_event_t* time_event =
-        ( xi_time_event_t* )vector->array[index].selector_t.ptr_value;
+    xi_time_event_t* time_event = xi_time_event_at( vector, index );
 
     /* sanity check on the time handle */
     assert( time_event->time_event_handle == time_event_handle );
 
-    xi_time_t old_time            = time_event->time_of_execution;
     time_event->time_of_execution = new_time;
+    time_event->sequence_number   = XI_TIME_EVENT_NEXT_SEQUENCE_NUMBER();
 
-    if ( new_time < old_time )
-    {
-        xi_time_event_bubble_and_sort_down( vector, index );
-    }
-    else
-    {
-        xi_time_event_bubble_and_sort_up( vector, index );
-    }
+    xi_time_event_fix_at( vector, index );
 
     return XI_STATE_OK;
 }
@@ -425,18 +478,8 @@ xi_state_t xi_time_event_cancel( xi_vector_t* vector,
         return XI_ELEMENT_NOT_FOUND;
     }
 
-    /* if it's somwhere else than the end, let's swap it with the last element */
-    if ( index < vector->elem_no - 1 )
-    {
-        xi_time_event_move_to_the_end( vector, index );
-    }
-
     /* let's update the return parameter */
-    *cancelled_time_event =
-        ( xi_time_event_t* )vector->array[vector->elem_no - 1].selector_t.ptr_value;
-
-    /* now we can remove that element from the vector */
-    xi_vector_del( vector, vector->elem_no - 1 );
+    *cancelled_time_event = xi_time_event_remove_at( vector, index );
 
     xi_time_event_dispose_time_event( *cancelled_time_event );
 
@@ -32,12 +32,19 @@ typedef struct xi_time_event_s
 {
     xi_event_handle_t event_handle;
     xi_time_t time_of_execution;
+    uint32_t sequence_number;
     xi_vector_index_type_t position;
     xi_time_event_handle_t* time_event_handle;
 } xi_time_event_t;
 
 #define XI_TIME_EVENT_POSITION_INVALID -1
 
+/* number of children of each node of the time event heap, 4 gives shallower trees and
+ * better memory locality than the binary heap while keeping the sift down cheap */
+#ifndef XI_TIME_EVENT_HEAP_ARITY
+#define XI_TIME_EVENT_HEAP_ARITY 4
+#endif
+
 #define xi_make_empty_time_event_handle()                                                \
     {                                                                                    \
         NULL                                                                             \
@@ -50,7 +57,7 @@ typedef struct xi_time_event_s
 
 #define xi_make_empty_time_event()                                                       \
     {                                                                                    \
-        xi_make_empty_event_handle(), 0, XI_TIME_EVENT_POSITION_INVALID, NULL            \
+        xi_make_empty_event_handle(), 0, 0, XI_TIME_EVENT_POSITION_INVALID, NULL         \
     }
 
 
@@ -85,7 +92,7 @@ xi_state_t xi_time_event_add( xi_vector_t* vector,
  *
  * Returns the pointer to the first element in the container which is guaranteed by the
  * time event implementation to be the time event with minimum execution time of all time
- * events stored within this container.
+ * events stored within this container. The complexity of this operation is O(log n).
  *
  * It removes the returned time event element from the vector. Use xi_time_event_pee_top
  * in order to minitor for the value of the minimum element without removing it from the
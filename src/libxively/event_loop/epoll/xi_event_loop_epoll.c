@@ -0,0 +1,343 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include <sys/epoll.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "xi_event_loop.h"
+#include "xi_event_loop_epoll.h"
+#include "xi_debug.h"
+#include "xi_list.h"
+
+/*
+ * Linux only event loop. Each event dispatcher owns an epoll descriptor that holds the
+ * interest list of its sockets. The dispatcher queues every socket whose event_type
+ * changes on its changed_sockets list so before each wait only those are passed to
+ * epoll_ctl, instead of rebuilding the whole select() set on every iteration.
+ */
+struct xi_event_loop_epoll_s
+{
+    int epoll_fd;
+    struct epoll_event ready_events[XI_EVENT_LOOP_EPOLL_MAX_EVENTS];
+    int ready_events_count;
+};
+
+static uint32_t xi_event_loop_epoll_events_from_type( xi_event_type_t event_type )
+{
+    uint32_t events = 0;
+
+    if ( ( event_type & XI_EVENT_WANT_READ ) > 0 )
+    {
+        events |= EPOLLIN;
+    }
+
+    /* connect finishes when the socket becomes writable, same as with select */
+    if ( ( event_type & ( XI_EVENT_WANT_WRITE | XI_EVENT_WANT_CONNECT ) ) > 0 )
+    {
+        events |= EPOLLOUT;
+    }
+
+    if ( ( event_type & XI_EVENT_ERROR ) > 0 )
+    {
+        events |= EPOLLPRI;
+    }
+
+    return events;
+}
+
+static xi_state_t xi_event_loop_epoll_create( xi_evtd_instance_t* instance )
+{
+    xi_state_t state = XI_STATE_OK;
+
+    XI_ALLOC_AT( struct xi_event_loop_epoll_s, instance->epoll, state );
+
+    instance->epoll->epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+
+    if ( -1 == instance->epoll->epoll_fd )
+    {
+        xi_debug_format( "epoll_create1 failed with errno: %d", errno );
+        state = XI_INTERNAL_ERROR;
+        goto err_handling;
+    }
+
+    return XI_STATE_OK;
+
+err_handling:
+    XI_SAFE_FREE( instance->epoll );
+    return state;
+}
+
+void xi_event_loop_epoll_destroy( xi_evtd_instance_t* instance )
+{
+    assert( NULL != instance );
+
+    if ( NULL == instance->epoll )
+    {
+        return;
+    }
+
+    close( instance->epoll->epoll_fd );
+    XI_SAFE_FREE( instance->epoll );
+}
+
+void xi_event_loop_epoll_socket_unregistered( xi_evtd_instance_t* instance,
+                                              xi_evtd_fd_tuple_t* tuple )
+{
+    assert( NULL != instance );
+    assert( NULL != tuple );
+
+    if ( NULL == instance->epoll )
+    {
+        return;
+    }
+
+    if ( 0 != tuple->polled_events )
+    {
+        /* the socket might have been closed already, the kernel dropped it then */
+        epoll_ctl( instance->epoll->epoll_fd, EPOLL_CTL_DEL, ( int )tuple->fd, NULL );
+        tuple->polled_events = 0;
+    }
+
+    /* the tuple is going to be released, the batch must not point at it anymore */
+    int i = 0;
+    for ( ; i < instance->epoll->ready_events_count; ++i )
+    {
+        if ( instance->epoll->ready_events[i].data.ptr == tuple )
+        {
+            instance->epoll->ready_events[i].data.ptr = NULL;
+        }
+    }
+}
+
+/**
+ * @brief xi_event_loop_epoll_sync
+ *
+ * Applies the interest changes queued by the event dispatcher to its epoll descriptor.
+ * Sockets whose event_type has been changed back and forth are skipped without a
+ * system call.
+ */
+static xi_state_t xi_event_loop_epoll_sync( xi_evtd_instance_t* instance )
+{
+    xi_state_t state          = XI_STATE_OK;
+    xi_evtd_fd_tuple_t* tuple = NULL;
+
+    if ( NULL == instance->epoll )
+    {
+        state = xi_event_loop_epoll_create( instance );
+        XI_CHECK_STATE( state );
+    }
+
+    xi_lock_critical_section( instance->cs );
+
+    while ( !XI_LIST_EMPTY( xi_evtd_fd_tuple_t, instance->changed_sockets ) )
+    {
+        XI_LIST_POP( xi_evtd_fd_tuple_t, instance->changed_sockets, tuple );
+        tuple->is_changed = 0;
+
+        const uint32_t events = xi_event_loop_epoll_events_from_type( tuple->event_type );
+
+        if ( events == tuple->polled_events )
+        {
+            continue;
+        }
+
+        struct epoll_event event;
+        memset( &event, 0, sizeof( event ) );
+
+        event.events   = events;
+        event.data.ptr = tuple;
+
+        int op = EPOLL_CTL_MOD;
+
+        if ( 0 == events )
+        {
+            op = EPOLL_CTL_DEL;
+        }
+        else if ( 0 == tuple->polled_events )
+        {
+            op = EPOLL_CTL_ADD;
+        }
+
+        if ( -1 == epoll_ctl( instance->epoll->epoll_fd, op, ( int )tuple->fd, &event ) )
+        {
+            xi_debug_format( "epoll_ctl failed on fd: %d with errno: %d",
+                             ( int )tuple->fd, errno );
+
+            /* make select() like behaviour, a broken descriptor fails the loop */
+            state = XI_INTERNAL_ERROR;
+            break;
+        }
+
+        tuple->polled_events = events;
+    }
+
+    xi_unlock_critical_section( instance->cs );
+
+err_handling:
+    return state;
+}
+
+static xi_state_t
+xi_event_loop_epoll_fetch( xi_evtd_instance_t* instance, int timeout_ms )
+{
+    struct xi_event_loop_epoll_s* epoll = instance->epoll;
+
+    epoll->ready_events_count = epoll_wait( epoll->epoll_fd, epoll->ready_events,
+                                            XI_EVENT_LOOP_EPOLL_MAX_EVENTS, timeout_ms );
+
+    if ( -1 == epoll->ready_events_count )
+    {
+        epoll->ready_events_count = 0;
+
+        if ( EINTR != errno )
+        {
+            xi_debug_format( "epoll_wait failed with errno: %d", errno );
+            return XI_INTERNAL_ERROR;
+        }
+    }
+
+    return XI_STATE_OK;
+}
+
+/**
+ * @brief xi_event_loop_epoll_wait
+ *
+ * Blocks until any of the dispatchers has a ready socket or the timeout expires. With
+ * more than one dispatcher the epoll descriptors themselves are polled, each of them is
+ * readable when its interest list has a ready socket.
+ */
+static xi_state_t xi_event_loop_epoll_wait( xi_evtd_instance_t** event_dispatchers,
+                                            uint8_t num_evtds,
+                                            xi_time_t timeout_ms )
+{
+
+    if ( 1 == num_evtds )
+    {
+        return xi_event_loop_epoll_fetch( event_dispatchers[0], ( int )timeout_ms );
+    }
+
+    struct pollfd epoll_fds[num_evtds];
+    memset( epoll_fds, 0, sizeof( struct pollfd ) * num_evtds );
+
+    uint8_t evtd_id = 0;
+    for ( evtd_id = 0; evtd_id < num_evtds; ++evtd_id )
+    {
+        epoll_fds[evtd_id].fd     = event_dispatchers[evtd_id]->epoll->epoll_fd;
+        epoll_fds[evtd_id].events = POLLIN;
+    }
+
+    if ( -1 == poll( epoll_fds, num_evtds, ( int )timeout_ms ) )
+    {
+        if ( EINTR == errno )
+        {
+            return XI_STATE_OK;
+        }
+
+        xi_debug_format( "poll failed with errno: %d", errno );
+        return XI_INTERNAL_ERROR;
+    }
+
+    for ( evtd_id = 0; evtd_id < num_evtds; ++evtd_id )
+    {
+        if ( 0 != epoll_fds[evtd_id].revents )
+        {
+            const xi_state_t state =
+                xi_event_loop_epoll_fetch( event_dispatchers[evtd_id], 0 );
+
+            if ( XI_STATE_OK != state )
+            {
+                return state;
+            }
+        }
+    }
+
+    return XI_STATE_OK;
+}
+
+static void xi_event_loop_epoll_dispatch( xi_evtd_instance_t* instance )
+{
+    struct xi_event_loop_epoll_s* epoll = instance->epoll;
+
+    int i = 0;
+    for ( ; i < epoll->ready_events_count; ++i )
+    {
+        xi_evtd_fd_tuple_t* tuple =
+            ( xi_evtd_fd_tuple_t* )epoll->ready_events[i].data.ptr;
+
+        /* unregistered by one of the handlers executed earlier in this batch */
+        if ( NULL == tuple )
+        {
+            continue;
+        }
+
+        epoll->ready_events[i].data.ptr = NULL;
+
+        xi_evtd_update_event_on_fd_tuple( instance, tuple );
+    }
+
+    epoll->ready_events_count = 0;
+}
+
+xi_state_t xi_event_loop_with_evtds( uint32_t num_iterations,
+                                     xi_evtd_instance_t** event_dispatchers,
+                                     uint8_t num_evtds )
+{
+    if ( NULL == event_dispatchers || 0 == num_evtds )
+    {
+        return XI_INVALID_PARAMETER;
+    }
+
+    xi_state_t state         = XI_STATE_OK;
+    uint32_t loops_processed = 0;
+    uint8_t evtd_id          = 0;
+
+    while ( xi_evtd_all_continue( event_dispatchers, num_evtds ) &&
+            ( 0 == num_iterations || loops_processed < num_iterations ) )
+    {
+        loops_processed += 1;
+
+        uint8_t was_file_updated = 0;
+
+        for ( evtd_id = 0; evtd_id < num_evtds; ++evtd_id )
+        {
+            was_file_updated |=
+                xi_evtd_update_file_fd_events( event_dispatchers[evtd_id] );
+        }
+
+        /* file handlers may have changed the sockets so sync after them */
+        for ( evtd_id = 0; evtd_id < num_evtds; ++evtd_id )
+        {
+            state = xi_event_loop_epoll_sync( event_dispatchers[evtd_id] );
+            XI_CHECK_STATE( state );
+        }
+
+        const xi_time_t timeout_ms =
+            ( was_file_updated != 0 )
+                ? 0
+                : xi_event_loop_calculate_timeout( event_dispatchers, num_evtds );
+
+        state = xi_event_loop_epoll_wait( event_dispatchers, num_evtds, timeout_ms );
+        XI_CHECK_STATE( state );
+
+        for ( evtd_id = 0; evtd_id < num_evtds; ++evtd_id )
+        {
+            xi_event_loop_epoll_dispatch( event_dispatchers[evtd_id] );
+        }
+
+        /* update time based events */
+        for ( evtd_id = 0; evtd_id < num_evtds; ++evtd_id )
+        {
+            xi_evtd_step_ticks( event_dispatchers[evtd_id],
+                                xi_evtd_get_current_time_ticks() );
+        }
+    }
+
+err_handling:
+    return state;
+}
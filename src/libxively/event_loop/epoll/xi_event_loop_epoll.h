@@ -0,0 +1,47 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#ifndef __XI_EVENT_LOOP_EPOLL_H__
+#define __XI_EVENT_LOOP_EPOLL_H__
+
+#include "xi_event_dispatcher_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* maximum number of ready sockets taken from the kernel in a single epoll_wait */
+#ifndef XI_EVENT_LOOP_EPOLL_MAX_EVENTS
+#define XI_EVENT_LOOP_EPOLL_MAX_EVENTS 64
+#endif
+
+/**
+ * @brief xi_event_loop_epoll_socket_unregistered
+ *
+ * Removes the socket from the epoll interest list of the event dispatcher and forgets
+ * any readiness already fetched for it. Called by the event dispatcher with its
+ * critical section locked, right before the tuple is released.
+ *
+ * @param instance of an event dispatcher the socket was registered in
+ * @param tuple of the socket being unregistered
+ */
+void xi_event_loop_epoll_socket_unregistered( xi_evtd_instance_t* instance,
+                                              xi_evtd_fd_tuple_t* tuple );
+
+/**
+ * @brief xi_event_loop_epoll_destroy
+ *
+ * Closes the epoll descriptor of the event dispatcher and releases its state.
+ *
+ * @param instance of an event dispatcher being destroyed
+ */
+void xi_event_loop_epoll_destroy( xi_evtd_instance_t* instance );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __XI_EVENT_LOOP_EPOLL_H__ */
@@ -6,9 +6,72 @@
 
 #include "xi_event_loop.h"
 #include "xi_bsp_io_net.h"
-#include "xi_bsp_time.h"
 #include "xi_event_dispatcher_api.h"
 
+xi_time_t xi_event_loop_calculate_timeout( xi_evtd_instance_t** event_dispatchers,
+                                           uint8_t num_evtds )
+{
+    assert( NULL != event_dispatchers );
+
+    uint8_t was_timeout_candidate_set = 0;
+    xi_time_t timeout_candidate       = 0;
+
+    uint8_t evtd_id = 0;
+    for ( evtd_id = 0; evtd_id < num_evtds; ++evtd_id )
+    {
+        xi_evtd_instance_t* event_dispatcher = event_dispatchers[evtd_id];
+        assert( NULL != event_dispatcher );
+
+        /* pick the smallest possible timeout with respect to all dispatchers */
+        xi_time_t tmp_timeout = 0;
+        xi_state_t state =
+            xi_evtd_get_time_of_earliest_event( event_dispatcher, &tmp_timeout );
+
+        /* if the heap wasn't empty */
+        if ( XI_STATE_OK == state )
+        {
+            /* if the timeout candidate has been initialised */
+            if ( 1 == was_timeout_candidate_set )
+            {
+                timeout_candidate = XI_MIN( timeout_candidate, tmp_timeout );
+            }
+            else /* if it hasn't been initialised */
+            {
+                timeout_candidate = tmp_timeout;
+            }
+
+            was_timeout_candidate_set = 1;
+        }
+    }
+
+    /* store the current time */
+    const xi_time_t current_time = xi_evtd_get_current_time_ticks();
+
+    /* recalculate the timeout */
+    if ( was_timeout_candidate_set )
+    {
+        if ( timeout_candidate >= current_time )
+        {
+            timeout_candidate =
+                XI_EVTD_TICKS_TO_MILLISECONDS( timeout_candidate - current_time );
+        }
+        else
+        {
+            /* this is possible if the first event to execute is in the past */
+            timeout_candidate = 0;
+        }
+    }
+    else
+    {
+        timeout_candidate = XI_DEFAULT_IDLE_TIMEOUT * 1000;
+    }
+
+    /* make it clamped from the top */
+    return XI_MIN( timeout_candidate, ( xi_time_t )XI_MAX_IDLE_TIMEOUT * 1000 );
+}
+
+#ifndef XI_EVENT_LOOP_EPOLL
+
 
 /**
  * @brief xi_bsp_event_loop_count_all_sockets
@@ -51,10 +114,8 @@ xi_bsp_event_loop_transform_to_bsp_select( xi_evtd_instance_t** in_event_dispatc
         return XI_INVALID_PARAMETER;
     }
 
-    size_t socket_id                  = 0;
-    uint8_t was_file_updated          = 0;
-    uint8_t was_timeout_candidate_set = 0;
-    xi_time_t timeout_candidate       = 0;
+    size_t socket_id         = 0;
+    uint8_t was_file_updated = 0;
 
     uint8_t evtd_id = 0;
     for ( evtd_id = 0; evtd_id < in_num_evtds; ++evtd_id )
@@ -64,29 +125,6 @@ xi_bsp_event_loop_transform_to_bsp_select( xi_evtd_instance_t** in_event_dispatc
 
         xi_vector_index_type_t i = 0;
 
-        /* pick the smallest possible timeout with respect to all dispatchers */
-        {
-            xi_time_t tmp_timeout = 0;
-            xi_state_t state =
-                xi_evtd_get_time_of_earliest_event( event_dispatcher, &tmp_timeout );
-
-            /* if the heap wasn't empty */
-            if ( XI_STATE_OK == state )
-            {
-                /* if the timeout candidate has been initialised */
-                if ( 1 == was_timeout_candidate_set )
-                {
-                    timeout_candidate = XI_MIN( timeout_candidate, tmp_timeout );
-                }
-                else /* if it hasn't been initialised */
-                {
-                    timeout_candidate = tmp_timeout;
-                }
-
-                was_timeout_candidate_set = 1;
-            }
-        }
-
         for ( i = 0; i < event_dispatcher->handles_and_socket_fd->elem_no; ++i )
         {
             xi_evtd_fd_tuple_t* tuple =
@@ -117,32 +155,11 @@ xi_bsp_event_loop_transform_to_bsp_select( xi_evtd_instance_t** in_event_dispatc
         was_file_updated |= xi_evtd_update_file_fd_events( event_dispatcher );
     }
 
-    /* store the current time */
-    const xi_time_t current_time = xi_bsp_time_getcurrenttime_seconds();
-
-    /* recalculate the timeout */
-    if ( was_timeout_candidate_set )
-    {
-        if ( timeout_candidate >= current_time )
-        {
-            timeout_candidate = timeout_candidate - current_time;
-        }
-        else
-        {
-            /* this is possible if the first event to execute is in the past */
-            timeout_candidate = 0;
-        }
-    }
-    else
-    {
-        timeout_candidate = XI_DEFAULT_IDLE_TIMEOUT;
-    }
-
-    /* make it clamped from the top */
-    timeout_candidate = XI_MIN( timeout_candidate, XI_MAX_IDLE_TIMEOUT );
-
     /* update the return parameter */
-    *out_timeout = ( was_file_updated != 0 ) ? ( 0 ) : ( timeout_candidate );
+    *out_timeout = ( was_file_updated != 0 )
+                       ? ( 0 )
+                       : xi_event_loop_calculate_timeout( in_event_dispatchers,
+                                                          in_num_evtds );
 
     return XI_STATE_OK;
 }
@@ -237,7 +254,7 @@ xi_state_t xi_event_loop_with_evtds( uint32_t num_iterations,
         memset( array_of_sockets_to_update, 0,
                 sizeof( xi_bsp_socket_events_t ) * no_of_sockets_to_update );
 
-        /* for storing the timeout */
+        /* for storing the timeout in milliseconds */
         xi_time_t timeout = 0;
 
         /* transpose data from event dispatcher to socketd to update array */
@@ -247,9 +264,9 @@ xi_state_t xi_event_loop_with_evtds( uint32_t num_iterations,
         XI_CHECK_STATE( state );
 
         /* call the bsp select function */
-        const xi_bsp_io_net_state_t select_state =
-            xi_bsp_io_net_select( ( xi_bsp_socket_events_t* )&array_of_sockets_to_update,
-                                  no_of_sockets_to_update, timeout );
+        const xi_bsp_io_net_state_t select_state = xi_bsp_io_net_select_ms(
+            ( xi_bsp_socket_events_t* )&array_of_sockets_to_update,
+            no_of_sockets_to_update, timeout );
 
         if ( XI_BSP_IO_NET_STATE_OK == select_state )
         {
@@ -269,11 +286,13 @@ xi_state_t xi_event_loop_with_evtds( uint32_t num_iterations,
         uint8_t evtd_id = 0;
         for ( evtd_id = 0; evtd_id < num_evtds; ++evtd_id )
         {
-            xi_evtd_step( event_dispatchers[evtd_id],
-                          xi_bsp_time_getcurrenttime_seconds() );
+            xi_evtd_step_ticks( event_dispatchers[evtd_id],
+                                xi_evtd_get_current_time_ticks() );
         }
     }
 
 err_handling:
     return state;
 }
+
+#endif /* XI_EVENT_LOOP_EPOLL */
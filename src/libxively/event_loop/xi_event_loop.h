@@ -13,6 +13,20 @@
 extern "C" {
 #endif
 
+/**
+ * @brief xi_event_loop_calculate_timeout
+ *
+ * Calculates how long the event loop may block waiting for the sockets, that is the
+ * time left to the earliest time event of all the given dispatchers clamped to the
+ * XI_MAX_IDLE_TIMEOUT, or XI_DEFAULT_IDLE_TIMEOUT if there are no time events.
+ *
+ * @param event_dispatchers array of event dispatchers
+ * @param num_evtds size of the array
+ * @return timeout in milliseconds
+ */
+xi_time_t xi_event_loop_calculate_timeout( xi_evtd_instance_t** event_dispatchers,
+                                           uint8_t num_evtds );
+
 xi_state_t xi_event_loop_with_evtds( uint32_t num_iterations,
                                      xi_evtd_instance_t** event_dispatchers,
                                      uint8_t num_evtds );
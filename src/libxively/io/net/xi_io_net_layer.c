@@ -132,6 +132,61 @@ err_handling:
     return XI_PROCESS_CONNECT_ON_THIS_LAYER( context, data, in_out_state );
 }
 
+/* writes what is left of the buffer, a chain of descriptors linked through __next
+ * (e.g. an MQTT PUBLISH header followed by its payload) is sent with a single
+ * gathering write */
+static xi_bsp_io_net_state_t xi_io_net_layer_write( xi_bsp_socket_t socket,
+                                                    int* out_written_count,
+                                                    const xi_data_desc_t* buffer )
+{
+    /* skip the descriptors already sent */
+    while ( NULL != buffer->__next && buffer->curr_pos == buffer->capacity )
+    {
+        buffer = buffer->__next;
+    }
+
+    if ( NULL == buffer->__next )
+    {
+        return xi_bsp_io_net_write( socket, out_written_count,
+                                    buffer->data_ptr + buffer->curr_pos,
+                                    buffer->capacity - buffer->curr_pos );
+    }
+
+    xi_bsp_io_net_iovec_t iov[XI_BSP_IO_NET_IOVEC_MAX];
+    int iov_count = 0;
+
+    for ( ; NULL != buffer && iov_count < XI_BSP_IO_NET_IOVEC_MAX;
+          buffer = buffer->__next )
+    {
+        if ( buffer->curr_pos < buffer->capacity )
+        {
+            iov[iov_count].buf   = buffer->data_ptr + buffer->curr_pos;
+            iov[iov_count].count = buffer->capacity - buffer->curr_pos;
+            ++iov_count;
+        }
+    }
+
+    return xi_bsp_io_net_writev( socket, out_written_count, iov, iov_count );
+}
+
+/* marks len bytes of the buffer chain as sent, returns the number of bytes left */
+static size_t xi_io_net_layer_mark_written( xi_data_desc_t* buffer, size_t len )
+{
+    size_t left = 0;
+
+    for ( ; NULL != buffer; buffer = buffer->__next )
+    {
+        const size_t written = XI_MIN( len, buffer->capacity - buffer->curr_pos );
+
+        buffer->curr_pos += written;
+        len -= written;
+
+        left += buffer->capacity - buffer->curr_pos;
+    }
+
+    return left;
+}
+
 xi_state_t xi_io_net_layer_push( void* context, void* data, xi_state_t in_out_state )
 {
     XI_LAYER_FUNCTION_PRINT_FUNCTION_DIGEST();
@@ -150,7 +205,7 @@ xi_state_t xi_io_net_layer_push( void* context, void* data, xi_state_t in_out_st
     if ( XI_THIS_LAYER_NOT_OPERATIONAL( context ) || layer_data == NULL )
     {
         xi_debug_logger( "layer not operational" );
-        xi_free_desc( &buffer );
+        xi_free_desc_chain( &buffer );
 
         return XI_STATE_OK;
     }
@@ -160,9 +215,7 @@ xi_state_t xi_io_net_layer_push( void* context, void* data, xi_state_t in_out_st
         do
         {
             /* call bsp write */
-            bsp_state = xi_bsp_io_net_write( layer_data->socket, &len,
-                                             buffer->data_ptr + buffer->curr_pos,
-                                             buffer->capacity - buffer->curr_pos );
+            bsp_state = xi_io_net_layer_write( layer_data->socket, &len, buffer );
 
             /* verify the state if it's an error or a need to wait */
             if ( XI_BSP_IO_NET_STATE_OK != bsp_state )
@@ -191,7 +244,7 @@ xi_state_t xi_io_net_layer_push( void* context, void* data, xi_state_t in_out_st
                 }
                 else if ( XI_BSP_IO_NET_STATE_CONNECTION_RESET == bsp_state )
                 {
-                    xi_free_desc( &buffer );
+                    xi_free_desc_chain( &buffer );
                     xi_debug_logger( "connection reset" );
                     return XI_PROCESS_CLOSE_EXTERNALLY_ON_THIS_LAYER(
                         context, 0, XI_CONNECTION_RESET_BY_PEER_ERROR );
@@ -201,19 +254,18 @@ xi_state_t xi_io_net_layer_push( void* context, void* data, xi_state_t in_out_st
                     /* any other issue */
                     xi_debug_format( "error writing: BSP error code = %d\n",
                                      ( int )bsp_state );
-                    xi_free_desc( &buffer );
+                    xi_free_desc_chain( &buffer );
                     return XI_PROCESS_CLOSE_EXTERNALLY_ON_THIS_LAYER(
                         context, data, XI_SOCKET_WRITE_ERROR );
                 }
             }
 
-            buffer->curr_pos += len;
-            left = buffer->capacity - buffer->curr_pos;
+            left = xi_io_net_layer_mark_written( buffer, ( size_t )XI_MAX( len, 0 ) );
         } while ( left > 0 );
     }
 
     xi_debug_format( "%d bytes written", len );
-    xi_free_desc( &buffer );
+    xi_free_desc_chain( &buffer );
 
     return XI_PROCESS_PUSH_ON_NEXT_LAYER( context, 0, XI_STATE_WRITTEN );
 }
@@ -244,15 +296,14 @@ xi_state_t xi_io_net_layer_pull( void* context, void* data, xi_state_t in_out_st
     {
         buffer_desc = ( xi_data_desc_t* )data;
 
-        memset( buffer_desc->data_ptr, 0, XI_IO_BUFFER_SIZE );
-        assert( buffer_desc->capacity == XI_IO_BUFFER_SIZE ); // sanity check
-
+        /* no need to clear it, only the first length bytes are ever read from it */
         buffer_desc->curr_pos = 0;
         buffer_desc->length   = 0;
     }
     else /* if there was no buffer we have to create new one */
     {
-        buffer_desc = xi_make_empty_desc_alloc( XI_IO_BUFFER_SIZE );
+        buffer_desc =
+            xi_make_empty_desc_alloc_uninitialized( xi_globals.io_buffer_size );
         XI_CHECK_MEMORY( buffer_desc, in_out_state );
     }
 
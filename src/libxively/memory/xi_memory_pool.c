@@ -0,0 +1,106 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "xi_macros.h"
+#include "xi_memory_pool.h"
+
+void* xi_memory_pool_take( xi_memory_pool_t* pool )
+{
+    assert( NULL != pool );
+
+    void* object = pool->free_list;
+
+    if ( NULL != object )
+    {
+        pool->free_list = *( void** )object;
+        pool->free_count -= 1;
+    }
+
+    return object;
+}
+
+void xi_memory_pool_give( xi_memory_pool_t* pool, void* object )
+{
+    assert( NULL != pool );
+
+    if ( NULL == object )
+    {
+        return;
+    }
+
+    if ( pool->free_count >= pool->max_free_count )
+    {
+        xi_free( object );
+        return;
+    }
+
+    *( void** )object = pool->free_list;
+    pool->free_list   = object;
+    pool->free_count += 1;
+}
+
+void xi_memory_pool_drain( xi_memory_pool_t* pool )
+{
+    assert( NULL != pool );
+
+    while ( NULL != pool->free_list )
+    {
+        xi_free( xi_memory_pool_take( pool ) );
+    }
+}
+
+void xi_memory_pool_resize( xi_memory_pool_t* pool, uint16_t max_free_count )
+{
+    assert( NULL != pool );
+
+    pool->max_free_count = max_free_count;
+
+    while ( pool->free_count > max_free_count )
+    {
+        xi_free( xi_memory_pool_take( pool ) );
+    }
+}
+
+void* xi_memory_pool_alloc( xi_memory_pool_t* pool,
+                            struct xi_critical_section_s* cs,
+                            size_t object_size )
+{
+    XI_UNUSED( cs );
+
+    xi_lock_critical_section( cs );
+
+    void* object = xi_memory_pool_take( pool );
+
+    xi_unlock_critical_section( cs );
+
+    if ( NULL == object )
+    {
+        object = xi_alloc( object_size );
+    }
+
+    if ( NULL != object )
+    {
+        memset( object, 0, object_size );
+    }
+
+    return object;
+}
+
+void xi_memory_pool_release( xi_memory_pool_t* pool,
+                             struct xi_critical_section_s* cs,
+                             void* object )
+{
+    XI_UNUSED( cs );
+
+    xi_lock_critical_section( cs );
+
+    xi_memory_pool_give( pool, object );
+
+    xi_unlock_critical_section( cs );
+}
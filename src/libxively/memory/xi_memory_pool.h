@@ -0,0 +1,96 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#ifndef __XI_MEMORY_POOL_H__
+#define __XI_MEMORY_POOL_H__
+
+#include <stdint.h>
+
+#include "xi_allocator.h"
+#include "xi_critical_section.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Free list of released objects of a single fixed size. Objects given back are kept for
+ * reuse instead of going back to the platform allocator, up to max_free_count of them,
+ * so steady state allocation of hot objects does not reach xi_bsp_mem_alloc. The free
+ * list is threaded through the first bytes of the objects themselves. The pool is not
+ * thread safe, its owner has to serialise the access.
+ */
+typedef struct xi_memory_pool_s
+{
+    void* free_list;
+    uint16_t free_count;
+    uint16_t max_free_count;
+} xi_memory_pool_t;
+
+#define xi_make_memory_pool( max_free_count )                                            \
+    {                                                                                    \
+        NULL, 0, max_free_count                                                          \
+    }
+
+/**
+ * @brief xi_memory_pool_take
+ *
+ * @return one of the objects given back earlier or NULL if there are none, the
+ * content of the object is unspecified
+ */
+void* xi_memory_pool_take( xi_memory_pool_t* pool );
+
+/**
+ * @brief xi_memory_pool_give
+ *
+ * Keeps the object for reuse or releases it with xi_free if the pool is full. The
+ * object has to be at least sizeof( void* ) big and allocated by any of the xi_alloc
+ * family.
+ */
+void xi_memory_pool_give( xi_memory_pool_t* pool, void* object );
+
+/**
+ * @brief xi_memory_pool_drain
+ *
+ * Releases every object kept by the pool.
+ */
+void xi_memory_pool_drain( xi_memory_pool_t* pool );
+
+/**
+ * @brief xi_memory_pool_resize
+ *
+ * Changes max_free_count, the objects kept above the new limit are released with
+ * xi_free.
+ */
+void xi_memory_pool_resize( xi_memory_pool_t* pool, uint16_t max_free_count );
+
+/**
+ * @brief xi_memory_pool_alloc
+ *
+ * Takes an object from a pool shared between threads, or allocates one with xi_alloc
+ * when the pool is empty. Like with XI_ALLOC the object is zeroed.
+ *
+ * @param cs guards the pool, it is not used without the thread module
+ * @return the object or NULL if out of memory
+ */
+void* xi_memory_pool_alloc( xi_memory_pool_t* pool,
+                            struct xi_critical_section_s* cs,
+                            size_t object_size );
+
+/**
+ * @brief xi_memory_pool_release
+ *
+ * xi_memory_pool_give for a pool shared between threads.
+ */
+void xi_memory_pool_release( xi_memory_pool_t* pool,
+                             struct xi_critical_section_s* cs,
+                             void* object );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __XI_MEMORY_POOL_H__ */
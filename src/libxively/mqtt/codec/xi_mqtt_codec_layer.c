@@ -47,6 +47,63 @@ static void clear_task_queue( void* context )
     assert( layer_data->task_queue == 0 );
 }
 
+/* serialises a single message, a PUBLISH payload is not copied but linked to the header
+ * as the next descriptor of the chain, the previous layers send the whole chain */
+static xi_state_t xi_mqtt_codec_layer_serialise( xi_mqtt_message_t* msg,
+                                                 xi_data_desc_t** out )
+{
+    xi_state_t state           = XI_STATE_OK;
+    size_t msg_contents_size   = 0;
+    size_t remaining_len       = 0;
+    size_t publish_payload_len = 0;
+    xi_mqtt_serialiser_t serializer;
+
+    xi_mqtt_serialiser_init( &serializer );
+
+    XI_CHECK_STATE( state = xi_mqtt_serialiser_size( &msg_contents_size, &remaining_len,
+                                                     &publish_payload_len, NULL, msg ) );
+
+    xi_debug_format( "[m.id[%d] m.type[%d]] encoding", xi_mqtt_get_message_id( msg ),
+                     msg->common.common_u.common_bits.type );
+
+    msg_contents_size -= publish_payload_len;
+
+    *out = xi_make_empty_desc_alloc( msg_contents_size );
+
+    XI_CHECK_MEMORY( *out, state );
+
+    /* if it's publish then the payload is not serialised
+     * for more details check serialiser implementation */
+    if ( XI_MQTT_SERIALISER_RC_ERROR == xi_mqtt_serialiser_write( &serializer, msg, *out,
+                                                                  msg_contents_size,
+                                                                  remaining_len ) )
+    {
+        xi_debug_format( "[m.id[%d] m.type[%d]] mqtt_codec_layer serialization error",
+                         xi_mqtt_get_message_id( msg ),
+                         msg->common.common_u.common_bits.type );
+
+        state = XI_MQTT_SERIALIZER_ERROR;
+
+        goto err_handling;
+    }
+
+    if ( XI_MQTT_TYPE_PUBLISH == msg->common.common_u.common_bits.type &&
+         msg->publish.content->length > 0 )
+    {
+        /* make a new desc but keep sharing memory */
+        ( *out )->__next = xi_make_desc_from_buffer_share(
+            msg->publish.content->data_ptr, msg->publish.content->length );
+
+        XI_CHECK_MEMORY( ( *out )->__next, state );
+    }
+
+    return XI_STATE_OK;
+
+err_handling:
+    xi_free_desc_chain( out );
+    return state;
+}
+
 xi_state_t xi_mqtt_codec_layer_push( void* context, void* data, xi_state_t in_out_state )
 {
     XI_LAYER_FUNCTION_PRINT_FUNCTION_DIGEST();
@@ -54,16 +111,9 @@ xi_state_t xi_mqtt_codec_layer_push( void* context, void* data, xi_state_t in_ou
     xi_mqtt_codec_layer_data_t* layer_data =
         ( xi_mqtt_codec_layer_data_t* )XI_THIS_LAYER( context )->user_data;
 
-    xi_mqtt_message_t* msg       = ( xi_mqtt_message_t* )data;
-    uint8_t* buffer              = NULL;
-    xi_data_desc_t* data_desc    = NULL;
-    size_t msg_contents_size     = 0;
-    size_t remaining_len         = 0;
-    size_t publish_payload_len   = 0;
-    xi_mqtt_serialiser_rc_t rc   = XI_MQTT_SERIALISER_RC_ERROR;
-    xi_data_desc_t* payload_desc = NULL;
-
-    xi_mqtt_serialiser_t serializer;
+    xi_mqtt_message_t* msg    = ( xi_mqtt_message_t* )data;
+    xi_data_desc_t* data_desc = NULL;
+    size_t batch_size         = 0;
 
     if ( XI_THIS_LAYER_NOT_OPERATIONAL( context ) || NULL == layer_data )
     {
@@ -107,45 +157,37 @@ xi_state_t xi_mqtt_codec_layer_push( void* context, void* data, xi_state_t in_ou
     /*------------------------------ BEGIN COROUTINE ----------------------- */
     XI_CR_START( layer_data->push_cs );
 
-    xi_mqtt_serialiser_init( &serializer );
-
     XI_CHECK_MEMORY( msg, in_out_state );
     layer_data->msg_id   = xi_mqtt_get_message_id( msg );
     layer_data->msg_type = ( xi_mqtt_type_t )msg->common.common_u.common_bits.type;
 
-    in_out_state = xi_mqtt_serialiser_size( &msg_contents_size, &remaining_len,
-                                            &publish_payload_len, NULL, msg );
-
-    XI_CHECK_STATE( in_out_state );
-
-    xi_debug_format( "[m.id[%d] m.type[%d]] encoding", layer_data->msg_id,
-                     msg->common.common_u.common_bits.type );
-
-    msg_contents_size -= publish_payload_len;
-
-    data_desc = xi_make_empty_desc_alloc( msg_contents_size );
+    /* the head of the queue is the msg being sent, the messages queued up behind it
+     * while the previous write was in progress go out with it */
+    assert( msg == layer_data->task_queue->msg );
 
-    XI_CHECK_MEMORY( data_desc, in_out_state );
+    layer_data->batch_length =
+        xi_mqtt_codec_layer_measure_batch( layer_data->task_queue, &batch_size );
 
-    /* if it's publish then the payload is sent separately
-     * for more details check serialiser implementation and this function
-     * at line 169 */
-    rc = xi_mqtt_serialiser_write( &serializer, msg, data_desc, msg_contents_size,
-                                   remaining_len );
+    if ( 1 < layer_data->batch_length )
+    {
+        XI_CHECK_STATE( in_out_state = xi_mqtt_codec_layer_serialise_batch(
+                            layer_data->task_queue, layer_data->batch_length,
+                            batch_size, &data_desc ) );
 
-    if ( rc == XI_MQTT_SERIALISER_RC_ERROR )
+        xi_debug_format( "[m.id[%d] m.type[%d]] mqtt_codec_layer sending %d messages",
+                         layer_data->msg_id, layer_data->msg_type,
+                         ( int )layer_data->batch_length );
+    }
+    else
     {
-        xi_debug_format( "[m.id[%d] m.type[%d]] mqtt_codec_layer serialization error",
-                         layer_data->msg_id, layer_data->msg_type );
+        layer_data->batch_length = 1;
 
-        in_out_state = XI_MQTT_SERIALIZER_ERROR;
+        XI_CHECK_STATE( in_out_state = xi_mqtt_codec_layer_serialise( msg, &data_desc ) );
 
-        goto err_handling;
+        xi_debug_format( "[m.id[%d] m.type[%d]] mqtt_codec_layer sending message",
+                         layer_data->msg_id, layer_data->msg_type );
     }
 
-    xi_debug_format( "[m.id[%d] m.type[%d]] mqtt_codec_layer sending message",
-                     layer_data->msg_id, layer_data->msg_type );
-
     XI_CR_YIELD( layer_data->push_cs,
                  XI_PROCESS_PUSH_ON_PREV_LAYER( context, data_desc, in_out_state ) );
 
@@ -155,35 +197,9 @@ xi_state_t xi_mqtt_codec_layer_push( void* context, void* data, xi_state_t in_ou
 
     /* PRE-CONTINUE-CONDITIONS */
     assert( NULL != task );
+    assert( NULL != task->msg );
 
-    /* restore msg pointer since it is no longer available
-     * from the function argument */
-    msg = task->msg;
-
-    /* PRE-CONTINUE-CONDITIONS */
-    assert( NULL != msg );
-
-    /* if header failed no need to */
-    if ( XI_STATE_WRITTEN != in_out_state )
-    {
-        goto finalise;
-    }
-
-    /* if publish and not empty payload then send payload */
-    if ( XI_MQTT_TYPE_PUBLISH == msg->common.common_u.common_bits.type &&
-         msg->publish.content->length > 0 )
-    {
-        /* make a new desc but keep sharing memory */
-        payload_desc = xi_make_desc_from_buffer_share( msg->publish.content->data_ptr,
-                                                       msg->publish.content->length );
-
-        XI_CHECK_MEMORY( payload_desc, in_out_state );
-
-        XI_CR_YIELD( layer_data->push_cs, XI_PROCESS_PUSH_ON_PREV_LAYER(
-                                              context, payload_desc, XI_STATE_OK ) );
-    }
-
-finalise: /* common part for all messages */
+    /* common part for all messages */
     if ( XI_STATE_WRITTEN == in_out_state )
     {
         xi_debug_format( "[m.id[%d] m.type[%d]] mqtt_codec_layer message sent",
@@ -195,28 +211,22 @@ finalise: /* common part for all messages */
                          layer_data->msg_id, layer_data->msg_type );
     }
 
-    /* PRE-CONDITIONS */
-    assert( NULL != task );
-    assert( NULL != task->msg );
-
-    /* releases the msg memory as it's no longer needed */
-    xi_mqtt_message_free( &task->msg );
-
-    /* here the state must be either WRITTEN or FAILED_WRITING
-     * sanity check to valid the state */
-    assert( in_out_state == XI_STATE_WRITTEN || in_out_state == XI_STATE_FAILED_WRITING );
-
-    xi_mqtt_written_data_t* written_data = xi_alloc_make_tuple(
-        xi_mqtt_written_data_t, layer_data->msg_id, layer_data->msg_type );
+    /* every message of the batch shares the result of the write */
+    for ( ; 0 < layer_data->batch_length && NULL != layer_data->task_queue;
+          --layer_data->batch_length )
+    {
+        XI_LIST_POP( xi_mqtt_codec_layer_task_t, layer_data->task_queue, task );
 
-    XI_CHECK_MEMORY( written_data, in_out_state );
+        xi_mqtt_written_data_t* written_data =
+            xi_alloc_make_tuple( xi_mqtt_written_data_t, task->msg_id, task->msg_type );
 
-    XI_PROCESS_PUSH_ON_NEXT_LAYER( context, written_data, in_out_state );
+        /* release the task and the msg as they are no longer required */
+        xi_mqtt_codec_layer_free_task( &task );
 
-    XI_LIST_POP( xi_mqtt_codec_layer_task_t, layer_data->task_queue, task );
+        XI_CHECK_MEMORY( written_data, in_out_state );
 
-    /* release the task as it's no longer required */
-    xi_mqtt_codec_layer_free_task( &task );
+        XI_PROCESS_PUSH_ON_NEXT_LAYER( context, written_data, in_out_state );
+    }
 
     /* pop the next task and register it's execution */
     if ( NULL != layer_data->task_queue )
@@ -238,8 +248,7 @@ err_handling:
     xi_debug_format( "something went wrong during mqtt message encoding: %s",
                      xi_get_state_string( in_out_state ) );
 
-    XI_SAFE_FREE( buffer );
-    XI_SAFE_FREE( data_desc );
+    xi_free_desc_chain( &data_desc );
     clear_task_queue( context );
     XI_CR_RESET( layer_data->push_cs );
 
@@ -271,11 +280,17 @@ xi_state_t xi_mqtt_codec_layer_pull( void* context, void* data, xi_state_t in_ou
 
     XI_CR_START( layer_data->pull_cs );
 
-    assert( layer_data->msg == 0 );
+    /* the message of the next part of a PUBLISH payload is prepared already */
+    if ( 0 == xi_mqtt_parser_has_pending_part( &layer_data->parser ) )
+    {
+        assert( layer_data->msg == 0 );
 
-    XI_ALLOC_AT( xi_mqtt_message_t, layer_data->msg, in_out_state );
+        XI_ALLOC_AT( xi_mqtt_message_t, layer_data->msg, in_out_state );
 
-    xi_mqtt_parser_init( &layer_data->parser );
+        xi_mqtt_parser_init( &layer_data->parser );
+        xi_mqtt_parser_chunk_payload( &layer_data->parser,
+                                      XI_MQTT_INBOUND_PAYLOAD_CHUNK_SIZE );
+    }
 
     do
     {
@@ -305,8 +320,27 @@ xi_state_t xi_mqtt_codec_layer_pull( void* context, void* data, xi_state_t in_ou
 
     xi_debug_mqtt_message_dump( layer_data->msg );
 
+    xi_mqtt_message_t* next_part = NULL;
+
+    /* every part of a payload travels up with the topic so it can be dispatched */
+    if ( 0 != xi_mqtt_parser_has_pending_part( &layer_data->parser ) )
+    {
+        XI_ALLOC_AT( xi_mqtt_message_t, next_part, layer_data->local_state );
+
+        next_part->publish.topic_name =
+            xi_make_desc_from_buffer_copy( layer_data->msg->publish.topic_name->data_ptr,
+                                           layer_data->msg->publish.topic_name->length );
+
+        if ( NULL == next_part->publish.topic_name )
+        {
+            xi_mqtt_message_free( &next_part );
+            layer_data->local_state = XI_OUT_OF_MEMORY;
+            goto err_handling;
+        }
+    }
+
     xi_mqtt_message_t* recvd = layer_data->msg;
-    layer_data->msg          = NULL;
+    layer_data->msg          = next_part;
 
     /* register next stage of processing */
     XI_PROCESS_PULL_ON_NEXT_LAYER( context, recvd, layer_data->local_state );
@@ -341,8 +375,9 @@ err_handling:
 
     if ( layer_data )
     {
-        /* reset the coroutine state */
+        /* reset the coroutine state, a payload read in parts is abandoned */
         XI_CR_RESET( layer_data->pull_cs );
+        xi_mqtt_parser_init( &layer_data->parser );
         clear_task_queue( context );
     }
 
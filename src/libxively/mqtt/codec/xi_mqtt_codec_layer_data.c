@@ -4,8 +4,28 @@
  * it is licensed under the BSD 3-Clause license.
  */
 
+#include "xi_critical_section_def.h"
+#include "xi_memory_pool.h"
 #include "xi_mqtt_codec_layer_data.h"
 #include "xi_mqtt_message.h"
+#include "xi_mqtt_serialiser.h"
+#include "xi_config.h"
+
+/* empty and so bypassed until xi_mqtt_codec_layer_task_pool_resize gives it a size */
+static xi_memory_pool_t xi_mqtt_codec_layer_task_pool = xi_make_memory_pool( 0 );
+
+/* static initialisation of the critical section, the event dispatchers of different
+ * contexts may run on different threads */
+static struct xi_critical_section_s xi_mqtt_codec_layer_task_pool_cs = {0};
+
+void xi_mqtt_codec_layer_task_pool_resize( uint16_t max_free_count )
+{
+    xi_lock_critical_section( &xi_mqtt_codec_layer_task_pool_cs );
+
+    xi_memory_pool_resize( &xi_mqtt_codec_layer_task_pool, max_free_count );
+
+    xi_unlock_critical_section( &xi_mqtt_codec_layer_task_pool_cs );
+}
 
 xi_mqtt_codec_layer_task_t* xi_mqtt_codec_layer_make_task( xi_mqtt_message_t* msg )
 {
@@ -13,7 +33,11 @@ xi_mqtt_codec_layer_task_t* xi_mqtt_codec_layer_make_task( xi_mqtt_message_t* ms
 
     assert( NULL != msg );
 
-    XI_ALLOC( xi_mqtt_codec_layer_task_t, new_task, state );
+    xi_mqtt_codec_layer_task_t* new_task =
+        ( xi_mqtt_codec_layer_task_t* )xi_memory_pool_alloc(
+            &xi_mqtt_codec_layer_task_pool, &xi_mqtt_codec_layer_task_pool_cs,
+            sizeof( xi_mqtt_codec_layer_task_t ) );
+    XI_CHECK_MEMORY( new_task, state );
 
     new_task->msg_id   = xi_mqtt_get_message_id( msg );
     new_task->msg_type = ( xi_mqtt_type_t )msg->common.common_u.common_bits.type;
@@ -54,5 +78,83 @@ void xi_mqtt_codec_layer_free_task( xi_mqtt_codec_layer_task_t** task )
     }
 
     xi_mqtt_message_free( &( *task )->msg );
-    XI_SAFE_FREE( ( *task ) );
+
+    xi_memory_pool_release( &xi_mqtt_codec_layer_task_pool,
+                            &xi_mqtt_codec_layer_task_pool_cs, *task );
+    *task = NULL;
+}
+
+size_t xi_mqtt_codec_layer_measure_batch( const xi_mqtt_codec_layer_task_t* task,
+                                          size_t* batch_size )
+{
+    size_t batch_length = 0;
+
+    *batch_size = 0;
+
+    for ( ; NULL != task; task = task->__next )
+    {
+        size_t msg_size            = 0;
+        size_t remaining_len       = 0;
+        size_t publish_payload_len = 0;
+
+        if ( XI_STATE_OK != xi_mqtt_serialiser_size( &msg_size, &remaining_len,
+                                                     &publish_payload_len, NULL,
+                                                     task->msg ) ||
+             *batch_size + msg_size > XI_MQTT_OUTBOUND_BATCH_SIZE )
+        {
+            break;
+        }
+
+        *batch_size += msg_size;
+        ++batch_length;
+    }
+
+    return batch_length;
+}
+
+xi_state_t xi_mqtt_codec_layer_serialise_batch( const xi_mqtt_codec_layer_task_t* task,
+                                                size_t batch_length,
+                                                size_t batch_size,
+                                                xi_data_desc_t** out )
+{
+    xi_state_t state = XI_STATE_OK;
+    xi_mqtt_serialiser_t serializer;
+
+    *out = xi_make_empty_desc_alloc( batch_size );
+    XI_CHECK_MEMORY( *out, state );
+
+    for ( ; 0 < batch_length; --batch_length, task = task->__next )
+    {
+        size_t msg_size            = 0;
+        size_t remaining_len       = 0;
+        size_t publish_payload_len = 0;
+
+        XI_CHECK_STATE( state = xi_mqtt_serialiser_size( &msg_size, &remaining_len,
+                                                         &publish_payload_len, NULL,
+                                                         task->msg ) );
+
+        xi_mqtt_serialiser_init( &serializer );
+
+        if ( XI_MQTT_SERIALISER_RC_ERROR ==
+             xi_mqtt_serialiser_write( &serializer, task->msg, *out,
+                                       msg_size - publish_payload_len, remaining_len ) )
+        {
+            state = XI_MQTT_SERIALIZER_ERROR;
+            goto err_handling;
+        }
+
+        if ( 0 < publish_payload_len )
+        {
+            XI_CHECK_STATE(
+                state = xi_data_desc_append_data( *out, task->msg->publish.content ) );
+        }
+    }
+
+    assert( ( *out )->length == ( *out )->capacity );
+
+    return XI_STATE_OK;
+
+err_handling:
+    xi_free_desc( out );
+    return state;
 }
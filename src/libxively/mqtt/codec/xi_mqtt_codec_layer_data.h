@@ -30,6 +30,8 @@ typedef struct xi_mqtt_codec_layer_data_s
     xi_state_t local_state;
     uint16_t msg_id;
     xi_mqtt_type_t msg_type;
+    /* number of tasks from the head of the queue sent with the write in progress */
+    size_t batch_length;
     uint16_t pull_cs;
     uint16_t push_cs;
 } xi_mqtt_codec_layer_data_t;
@@ -42,6 +44,24 @@ typedef struct xi_mqtt_codec_layer_data_s
  * @param msg
  * @return
  */
+/* number of released tasks kept for reuse while a context exists, the messages they
+ * carry are not kept */
+#ifndef XI_MQTT_CODEC_LAYER_TASK_POOL_SIZE
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_MQTT_CODEC_LAYER_TASK_POOL_SIZE 16
+#else
+#define XI_MQTT_CODEC_LAYER_TASK_POOL_SIZE 2
+#endif
+#endif
+
+/**
+ * @brief xi_mqtt_codec_layer_task_pool_resize
+ *
+ * Sets how many released tasks are kept for reuse instead of being freed, the ones
+ * above the new size are freed right away. 0, the initial size, turns the reuse off.
+ */
+extern void xi_mqtt_codec_layer_task_pool_resize( uint16_t max_free_count );
+
 extern xi_mqtt_codec_layer_task_t*
 xi_mqtt_codec_layer_make_task( xi_mqtt_message_t* msg );
 
@@ -79,6 +99,38 @@ void xi_mqtt_codec_layer_continue_task( xi_mqtt_codec_layer_task_t* task,
  */
 extern void xi_mqtt_codec_layer_free_task( xi_mqtt_codec_layer_task_t** task );
 
+/**
+ * @brief xi_mqtt_codec_layer_measure_batch
+ *
+ * Counts the tasks from the given one on whose messages fit together in
+ * XI_MQTT_OUTBOUND_BATCH_SIZE bytes, payloads included.
+ *
+ * @param task the first task of the batch
+ * @param batch_size set to the serialised size of the counted messages
+ * @return number of tasks in the batch, 0 if not even the first message fits
+ */
+extern size_t xi_mqtt_codec_layer_measure_batch( const xi_mqtt_codec_layer_task_t* task,
+                                                 size_t* batch_size );
+
+/**
+ * @brief xi_mqtt_codec_layer_serialise_batch
+ *
+ * Serialises the messages of batch_length tasks one after the other into a single
+ * buffer of batch_size bytes. The payloads are copied so that the whole batch can be
+ * sent with a single write.
+ *
+ * @param task the first task of the batch
+ * @param batch_length as returned by xi_mqtt_codec_layer_measure_batch
+ * @param batch_size as returned by xi_mqtt_codec_layer_measure_batch
+ * @param out set to the buffer, NULL on error
+ * @return XI_STATE_OK or the error of the serialisation
+ */
+extern xi_state_t
+xi_mqtt_codec_layer_serialise_batch( const xi_mqtt_codec_layer_task_t* task,
+                                     size_t batch_length,
+                                     size_t batch_size,
+                                     xi_data_desc_t** out );
+
 #ifdef __cplusplus
 }
 #endif
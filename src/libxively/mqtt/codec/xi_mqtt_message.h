@@ -121,6 +121,11 @@ typedef union xi_mqtt_message_u {
         uint16_t message_id;
 
         xi_data_desc_t* content;
+        /* position of the content within the payload and the length of the whole
+         * payload, they differ from 0 and content->length only for the parts of a
+         * payload that is received in parts, see xi_mqtt_parser_chunk_payload */
+        size_t content_offset;
+        size_t content_total_length;
     } publish;
 
     struct
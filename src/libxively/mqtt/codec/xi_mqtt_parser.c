@@ -158,32 +158,42 @@ err_handling:
 #define READ_STRING( into )                                                              \
     do                                                                                   \
     {                                                                                    \
-        local_state = read_string( parser, into, src );                                  \
-        XI_CR_YIELD_UNTIL( parser->cs, ( local_state == XI_STATE_WANT_READ ),            \
+        parser->local_state = read_string( parser, into, src );                          \
+        XI_CR_YIELD_UNTIL( parser->cs, ( parser->local_state == XI_STATE_WANT_READ ),    \
                            XI_STATE_WANT_READ );                                         \
-        if ( local_state != XI_STATE_OK )                                                \
+        if ( parser->local_state != XI_STATE_OK )                                        \
         {                                                                                \
-            XI_CR_EXIT( parser->cs, local_state );                                       \
+            XI_CR_EXIT( parser->cs, parser->local_state );                               \
         }                                                                                \
-    } while ( local_state != XI_STATE_OK )
+    } while ( parser->local_state != XI_STATE_OK )
 
 #define READ_DATA( into )                                                                \
     do                                                                                   \
     {                                                                                    \
-        local_state = read_data( parser, into, src );                                    \
-        XI_CR_YIELD_UNTIL( parser->cs, ( local_state == XI_STATE_WANT_READ ),            \
+        parser->local_state = read_data( parser, into, src );                            \
+        XI_CR_YIELD_UNTIL( parser->cs, ( parser->local_state == XI_STATE_WANT_READ ),    \
                            XI_STATE_WANT_READ );                                         \
-        if ( local_state != XI_STATE_OK )                                                \
+        if ( parser->local_state != XI_STATE_OK )                                        \
         {                                                                                \
-            XI_CR_EXIT( parser->cs, local_state );                                       \
+            XI_CR_EXIT( parser->cs, parser->local_state );                               \
         }                                                                                \
-    } while ( local_state != XI_STATE_OK )
+    } while ( parser->local_state != XI_STATE_OK )
 
 void xi_mqtt_parser_init( xi_mqtt_parser_t* parser )
 {
     memset( parser, 0, sizeof( xi_mqtt_parser_t ) );
 }
 
+void xi_mqtt_parser_chunk_payload( xi_mqtt_parser_t* parser, size_t payload_chunk_size )
+{
+    parser->payload_chunk_size = payload_chunk_size;
+}
+
+uint8_t xi_mqtt_parser_has_pending_part( const xi_mqtt_parser_t* parser )
+{
+    return parser->payload_offset < parser->payload_length;
+}
+
 void xi_mqtt_parser_buffer( xi_mqtt_parser_t* parser,
                             uint8_t* buffer,
                             size_t buffer_length )
@@ -193,16 +203,369 @@ void xi_mqtt_parser_buffer( xi_mqtt_parser_t* parser,
     parser->buffer_length  = buffer_length;
 }
 
+/*
+ * Fast path for packets which are already whole in the input buffer. The packet is
+ * decoded in a single pass and its strings and payload are allocated once at their
+ * final size instead of being grown from 4 bytes by the byte at a time coroutine.
+ *
+ * It consumes exactly the bytes the coroutine would consume, anything it can not take
+ * - a partial packet, an invalid remaining length, a type the coroutine rejects or
+ * field lengths that point past the packet - is left to the coroutine as before.
+ */
+
+static uint16_t xi_mqtt_parser_peek_uint16( const uint8_t* data )
+{
+    return ( uint16_t )( ( data[0] << 8 ) + data[1] );
+}
+
+static uint8_t
+xi_mqtt_parser_skip( size_t available, size_t* offset, size_t byte_count )
+{
+    if ( available - *offset < byte_count )
+    {
+        return 0;
+    }
+
+    *offset += byte_count;
+    return 1;
+}
+
+static uint8_t
+xi_mqtt_parser_skip_string( const uint8_t* data, size_t available, size_t* offset )
+{
+    if ( 0 == xi_mqtt_parser_skip( available, offset, 2 ) )
+    {
+        return 0;
+    }
+
+    return xi_mqtt_parser_skip( available, offset,
+                                xi_mqtt_parser_peek_uint16( data + *offset - 2 ) );
+}
+
+/**
+ * @brief xi_mqtt_parser_measure_buffered
+ *
+ * Checks whether the packet at the beginning of data can be decoded from the available
+ * bytes. Sets the fixed header value and for CONNECT the flags of the message, the
+ * coroutine overwrites both in case the packet is left to it.
+ *
+ * @return 1 and the lengths of the packet if it can be decoded, 0 otherwise
+ */
+static uint8_t xi_mqtt_parser_measure_buffered( const xi_mqtt_parser_t* parser,
+                                                xi_mqtt_message_t* message,
+                                                const uint8_t* data,
+                                                size_t available,
+                                                size_t* header_length,
+                                                size_t* remaining_length,
+                                                size_t* packet_length )
+{
+    size_t offset         = 1;
+    size_t multiplier     = 1;
+    size_t digit_bytes    = 0;
+    size_t payload_length = 0;
+    uint8_t digit         = 0;
+
+    *remaining_length = 0;
+
+    do
+    {
+        if ( offset >= available )
+        {
+            return 0;
+        }
+
+        digit = data[offset];
+        offset += 1;
+        digit_bytes += 1;
+
+        *remaining_length += ( digit & 0x7f ) * multiplier;
+        multiplier *= 128;
+    } while ( ( digit & 0x80 ) != 0 && digit_bytes < 4 );
+
+    /* the coroutine reports the invalid remaining length */
+    if ( digit >= 0x80 )
+    {
+        return 0;
+    }
+
+    *header_length = offset;
+
+    message->common.common_u.common_value = data[0];
+
+    switch ( message->common.common_u.common_bits.type )
+    {
+        case XI_MQTT_TYPE_CONNECT:
+            if ( 0 == xi_mqtt_parser_skip_string( data, available, &offset ) ||
+                 0 == xi_mqtt_parser_skip( available, &offset, 4 ) )
+            {
+                return 0;
+            }
+
+            /* protocol version, flags and keepalive follow the protocol name */
+            message->connect.flags_u.flags_value = data[offset - 3];
+
+            if ( 0 == xi_mqtt_parser_skip_string( data, available, &offset ) )
+            {
+                return 0;
+            }
+
+            if ( message->connect.flags_u.flags_bits.will &&
+                 ( 0 == xi_mqtt_parser_skip_string( data, available, &offset ) ||
+                   0 == xi_mqtt_parser_skip_string( data, available, &offset ) ) )
+            {
+                return 0;
+            }
+
+            if ( message->connect.flags_u.flags_bits.username_follows &&
+                 0 == xi_mqtt_parser_skip_string( data, available, &offset ) )
+            {
+                return 0;
+            }
+
+            if ( message->connect.flags_u.flags_bits.password_follows &&
+                 0 == xi_mqtt_parser_skip_string( data, available, &offset ) )
+            {
+                return 0;
+            }
+            break;
+        case XI_MQTT_TYPE_PUBLISH:
+            if ( 0 == xi_mqtt_parser_skip_string( data, available, &offset ) ||
+                 ( message->common.common_u.common_bits.qos > 0 &&
+                   0 == xi_mqtt_parser_skip( available, &offset, 2 ) ) )
+            {
+                return 0;
+            }
+
+            /* the payload is what is left of the remaining length */
+            if ( offset - *header_length > *remaining_length )
+            {
+                return 0;
+            }
+
+            payload_length = *remaining_length - ( offset - *header_length );
+
+            /* payloads returned in parts are left to the coroutine */
+            if ( 0 == xi_mqtt_parser_skip( available, &offset, payload_length ) ||
+                 ( 0 < parser->payload_chunk_size &&
+                   payload_length > parser->payload_chunk_size ) )
+            {
+                return 0;
+            }
+            break;
+        case XI_MQTT_TYPE_CONNACK:
+        case XI_MQTT_TYPE_PUBACK:
+        case XI_MQTT_TYPE_PUBREC:
+        case XI_MQTT_TYPE_PUBREL:
+        case XI_MQTT_TYPE_PUBCOMP:
+            if ( 0 == xi_mqtt_parser_skip( available, &offset, 2 ) )
+            {
+                return 0;
+            }
+            break;
+        case XI_MQTT_TYPE_SUBSCRIBE:
+            if ( 0 == xi_mqtt_parser_skip( available, &offset, 2 ) ||
+                 0 == xi_mqtt_parser_skip_string( data, available, &offset ) ||
+                 0 == xi_mqtt_parser_skip( available, &offset, 1 ) )
+            {
+                return 0;
+            }
+            break;
+        case XI_MQTT_TYPE_SUBACK:
+            if ( 0 == xi_mqtt_parser_skip( available, &offset, 3 ) )
+            {
+                return 0;
+            }
+            break;
+        case XI_MQTT_TYPE_PINGRESP:
+        case XI_MQTT_TYPE_DISCONNECT:
+            break;
+        default:
+            return 0;
+    }
+
+    *packet_length = offset;
+
+    return 1;
+}
+
+/* one byte above the exact size keeps the data NUL terminated for %s debug output */
+static xi_data_desc_t* xi_mqtt_parser_copy_desc( const uint8_t* data, size_t length )
+{
+    xi_data_desc_t* desc = xi_make_empty_desc_alloc_uninitialized( length + 1 );
+
+    if ( NULL != desc )
+    {
+        memcpy( desc->data_ptr, data, length );
+        desc->data_ptr[length] = '\0';
+        desc->length           = length;
+    }
+
+    return desc;
+}
+
+static xi_state_t
+xi_mqtt_parser_take_string( const uint8_t* data, size_t* offset, xi_data_desc_t** dst )
+{
+    const size_t length = xi_mqtt_parser_peek_uint16( data + *offset );
+
+    /* as with the coroutine an empty string still gets a descriptor */
+    *dst = xi_mqtt_parser_copy_desc( data + *offset + 2, length );
+
+    if ( NULL == *dst )
+    {
+        return XI_OUT_OF_MEMORY;
+    }
+
+    *offset += 2 + length;
+
+    return XI_STATE_OK;
+}
+
+/**
+ * @brief xi_mqtt_parser_execute_buffered
+ *
+ * Decodes a packet the xi_mqtt_parser_measure_buffered accepted, the bounds are not
+ * checked again. On success the src is moved past the packet.
+ */
+static xi_state_t xi_mqtt_parser_execute_buffered( xi_mqtt_message_t* message,
+                                                   xi_data_desc_t* src,
+                                                   size_t header_length,
+                                                   size_t remaining_length,
+                                                   size_t packet_length )
+{
+    const uint8_t* data = src->data_ptr + src->curr_pos;
+    size_t offset       = header_length;
+    xi_state_t state    = XI_STATE_OK;
+
+    message->common.remaining_length = remaining_length;
+
+    switch ( message->common.common_u.common_bits.type )
+    {
+        case XI_MQTT_TYPE_CONNECT:
+            XI_CHECK_STATE( state = xi_mqtt_parser_take_string(
+                                data, &offset, &message->connect.protocol_name ) );
+
+            message->connect.protocol_version = data[offset];
+            message->connect.keepalive = xi_mqtt_parser_peek_uint16( data + offset + 2 );
+            offset += 4;
+
+            XI_CHECK_STATE( state = xi_mqtt_parser_take_string(
+                                data, &offset, &message->connect.client_id ) );
+
+            if ( message->connect.flags_u.flags_bits.will )
+            {
+                XI_CHECK_STATE( state = xi_mqtt_parser_take_string(
+                                    data, &offset, &message->connect.will_topic ) );
+                XI_CHECK_STATE( state = xi_mqtt_parser_take_string(
+                                    data, &offset, &message->connect.will_message ) );
+            }
+
+            if ( message->connect.flags_u.flags_bits.username_follows )
+            {
+                XI_CHECK_STATE( state = xi_mqtt_parser_take_string(
+                                    data, &offset, &message->connect.username ) );
+            }
+
+            if ( message->connect.flags_u.flags_bits.password_follows )
+            {
+                XI_CHECK_STATE( state = xi_mqtt_parser_take_string(
+                                    data, &offset, &message->connect.password ) );
+            }
+            break;
+        case XI_MQTT_TYPE_CONNACK:
+            message->connack._unused     = data[offset];
+            message->connack.return_code = data[offset + 1];
+            break;
+        case XI_MQTT_TYPE_PUBLISH:
+            XI_CHECK_STATE( state = xi_mqtt_parser_take_string(
+                                data, &offset, &message->publish.topic_name ) );
+
+            if ( message->common.common_u.common_bits.qos > 0 )
+            {
+                message->publish.message_id = xi_mqtt_parser_peek_uint16( data + offset );
+                offset += 2;
+            }
+
+            if ( packet_length > offset )
+            {
+                message->publish.content =
+                    xi_mqtt_parser_copy_desc( data + offset, packet_length - offset );
+                XI_CHECK_MEMORY( message->publish.content, state );
+
+                message->publish.content_total_length = packet_length - offset;
+            }
+            break;
+        case XI_MQTT_TYPE_PUBACK:
+            message->puback.message_id = xi_mqtt_parser_peek_uint16( data + offset );
+            break;
+        case XI_MQTT_TYPE_PUBREC:
+            message->pubrec.message_id = xi_mqtt_parser_peek_uint16( data + offset );
+            break;
+        case XI_MQTT_TYPE_PUBREL:
+            message->pubrel.message_id = xi_mqtt_parser_peek_uint16( data + offset );
+            break;
+        case XI_MQTT_TYPE_PUBCOMP:
+            message->pubcomp.message_id = xi_mqtt_parser_peek_uint16( data + offset );
+            break;
+        case XI_MQTT_TYPE_SUBSCRIBE:
+            message->subscribe.message_id = xi_mqtt_parser_peek_uint16( data + offset );
+            offset += 2;
+
+            XI_ALLOC_AT( xi_mqtt_topicpair_t, message->subscribe.topics, state );
+
+            XI_CHECK_STATE( state = xi_mqtt_parser_take_string(
+                                data, &offset, &message->subscribe.topics->name ) );
+
+            message->subscribe.topics->xi_mqtt_topic_pair_payload_u.qos =
+                ( xi_mqtt_qos_t )data[offset];
+            break;
+        case XI_MQTT_TYPE_SUBACK:
+            message->suback.message_id = xi_mqtt_parser_peek_uint16( data + offset );
+            offset += 2;
+
+            XI_ALLOC_AT( xi_mqtt_topicpair_t, message->suback.topics, state );
+
+            XI_CHECK_STATE( state = xi_mqtt_parse_suback_response(
+                                &message->suback.topics->xi_mqtt_topic_pair_payload_u
+                                     .status,
+                                data[offset] ) );
+            break;
+        default:
+            break;
+    }
+
+    src->curr_pos += packet_length;
+
+err_handling:
+    return state;
+}
+
 xi_state_t xi_mqtt_parser_execute( xi_mqtt_parser_t* parser,
                                    xi_mqtt_message_t* message,
                                    xi_data_desc_t* data_buffer_desc )
 {
-    xi_data_desc_t* src           = data_buffer_desc;
-    static xi_state_t local_state = XI_STATE_OK;
+    xi_data_desc_t* src = data_buffer_desc;
+
+    if ( !XI_CR_IS_RUNNING( parser->cs ) )
+    {
+        size_t header_length    = 0;
+        size_t remaining_length = 0;
+        size_t packet_length    = 0;
+
+        if ( 0 != xi_mqtt_parser_measure_buffered( parser, message,
+                                                   src->data_ptr + src->curr_pos,
+                                                   src->length - src->curr_pos,
+                                                   &header_length, &remaining_length,
+                                                   &packet_length ) )
+        {
+            return xi_mqtt_parser_execute_buffered( message, src, header_length,
+                                                    remaining_length, packet_length );
+        }
+    }
 
     XI_CR_START( parser->cs );
 
-    local_state = XI_STATE_OK;
+    parser->local_state = XI_STATE_OK;
 
     XI_CR_YIELD_ON( parser->cs, ( ( src->curr_pos - src->length ) == 0 ),
                     XI_STATE_WANT_READ );
@@ -342,12 +705,48 @@ xi_state_t xi_mqtt_parser_execute( xi_mqtt_parser_t* parser,
         }
 
         parser->str_length = ( parser->remaining_length + 2 ) - parser->data_length;
+        message->publish.content_total_length = parser->str_length;
 
-        if ( parser->str_length > 0 )
+        if ( 0 == parser->payload_chunk_size ||
+             parser->str_length <= parser->payload_chunk_size )
         {
-            READ_DATA( &message->publish.content );
+            if ( parser->str_length > 0 )
+            {
+                READ_DATA( &message->publish.content );
+            }
+
+            XI_CR_EXIT( parser->cs, XI_STATE_OK );
         }
 
+        /* the payload is returned in parts of payload_chunk_size, each one in a message
+         * of its own that gets the header of the first one */
+        parser->payload_length = parser->str_length;
+        parser->part_header    = message->common.common_u.common_value;
+        parser->part_msg_id    = message->publish.message_id;
+
+        do
+        {
+            parser->str_length =
+                XI_MIN( parser->payload_chunk_size,
+                        parser->payload_length - parser->payload_offset );
+
+            READ_DATA( &message->publish.content );
+
+            message->publish.content_offset       = parser->payload_offset;
+            message->publish.content_total_length = parser->payload_length;
+
+            parser->payload_offset += parser->str_length;
+
+            if ( parser->payload_offset < parser->payload_length )
+            {
+                XI_CR_YIELD( parser->cs, XI_STATE_OK );
+
+                message->common.common_u.common_value = parser->part_header;
+                message->common.remaining_length      = parser->remaining_length;
+                message->publish.message_id           = parser->part_msg_id;
+            }
+        } while ( parser->payload_offset < parser->payload_length );
+
         XI_CR_EXIT( parser->cs, XI_STATE_OK );
     }
     else if ( message->common.common_u.common_bits.type == XI_MQTT_TYPE_PUBACK )
@@ -441,7 +840,8 @@ xi_state_t xi_mqtt_parser_execute( xi_mqtt_parser_t* parser,
         XI_CR_YIELD_ON( parser->cs, ( ( src->curr_pos - src->length ) == 0 ),
                         XI_STATE_WANT_READ );
 
-        XI_ALLOC_AT( xi_mqtt_topicpair_t, message->subscribe.topics, local_state );
+        XI_ALLOC_AT( xi_mqtt_topicpair_t, message->subscribe.topics,
+                     parser->local_state );
 
         READ_STRING( &message->subscribe.topics->name );
 
@@ -474,11 +874,12 @@ xi_state_t xi_mqtt_parser_execute( xi_mqtt_parser_t* parser,
         XI_CR_YIELD_ON( parser->cs, ( ( src->curr_pos - src->length ) == 0 ),
                         XI_STATE_WANT_READ );
 
-        XI_ALLOC_AT( xi_mqtt_topicpair_t, message->suback.topics, local_state );
+        XI_ALLOC_AT( xi_mqtt_topicpair_t, message->suback.topics, parser->local_state );
 
-        XI_CHECK_STATE( local_state = xi_mqtt_parse_suback_response(
-                            &message->suback.topics->xi_mqtt_topic_pair_payload_u.status,
-                            src->data_ptr[src->curr_pos] ) );
+        XI_CHECK_STATE(
+            parser->local_state = xi_mqtt_parse_suback_response(
+                &message->suback.topics->xi_mqtt_topic_pair_payload_u.status,
+                src->data_ptr[src->curr_pos] ) );
 
         src->curr_pos += 1;
         parser->data_length += 1;
@@ -504,7 +905,7 @@ xi_state_t xi_mqtt_parser_execute( xi_mqtt_parser_t* parser,
     }
 
 err_handling:
-    XI_CR_EXIT( parser->cs, local_state );
+    XI_CR_EXIT( parser->cs, parser->local_state );
 
     XI_CR_END();
 }
@@ -27,11 +27,17 @@ typedef enum xi_mqtt_parser_rc_e {
     XI_MQTT_PARSER_RC_WANT_MEMORY,
 } xi_mqtt_parser_rc_t;
 
+/*
+ * Everything the parser keeps between two xi_mqtt_parser_execute calls lives here, so
+ * each connection can parse on its own thread without sharing anything.
+ */
 typedef struct xi_mqtt_parser_s
 {
     xi_mqtt_error_t error;
     uint16_t cs;
     uint16_t read_cs;
+    /* result of the last read_string/read_data step, checked again after resuming */
+    xi_state_t local_state;
     char buffer_pending;
     uint8_t* buffer;
     size_t buffer_length;
@@ -40,9 +46,38 @@ typedef struct xi_mqtt_parser_s
     size_t remaining_length;
     size_t str_length;
     size_t data_length;
+    /* PUBLISH payloads larger than this are returned in parts, 0 means never */
+    size_t payload_chunk_size;
+    size_t payload_length;
+    size_t payload_offset;
+    uint8_t part_header;
+    uint16_t part_msg_id;
 } xi_mqtt_parser_t;
 
 extern void xi_mqtt_parser_init( xi_mqtt_parser_t* parser );
+/**
+ * @brief xi_mqtt_parser_chunk_payload
+ *
+ * Makes the parser return a PUBLISH payload longer than payload_chunk_size in parts
+ * instead of accumulating it. Every part is returned with XI_STATE_OK in the message
+ * passed to that call, the first one with the topic, all of them with the fixed header,
+ * the message id, the part as content and its offset within the payload. The parser
+ * must not be initialised again until the last part is returned, see
+ * xi_mqtt_parser_has_pending_part.
+ *
+ * Must be called after xi_mqtt_parser_init, 0 switches it off.
+ */
+extern void
+xi_mqtt_parser_chunk_payload( xi_mqtt_parser_t* parser, size_t payload_chunk_size );
+
+/**
+ * @brief xi_mqtt_parser_has_pending_part
+ *
+ * @return 1 if the last message returned is a part of a PUBLISH payload and more parts
+ * follow, 0 otherwise
+ */
+extern uint8_t xi_mqtt_parser_has_pending_part( const xi_mqtt_parser_t* parser );
+
 extern void
 xi_mqtt_parser_buffer( xi_mqtt_parser_t* parser, uint8_t* buffer, size_t buffer_length );
 
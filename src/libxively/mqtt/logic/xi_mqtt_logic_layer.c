@@ -51,6 +51,13 @@ uint8_t xi_mqtt_logic_layer_task_should_be_stored_predicate( void* context,
         return 1;
     }
 
+    /* publishes held back by the window are sent after the reconnect */
+    if ( is_waiting_publish_task( task, NULL ) &&
+         task->session_state != XI_MQTT_LOGIC_TASK_SESSION_DO_NOT_STORE )
+    {
+        return 1;
+    }
+
     return 0;
 }
 
@@ -108,15 +115,15 @@ xi_state_t xi_mqtt_logic_layer_push( void* context, void* data, xi_state_t in_ou
             xi_mqtt_message_class_t msg_class =
                 xi_mqtt_class_msg_type_sending( msg_type );
 
-            xi_mqtt_logic_task_t* task_queue = NULL;
+            const xi_mqtt_logic_task_index_t* task_index = NULL;
 
             switch ( msg_class )
             {
                 case XI_MQTT_MESSAGE_CLASS_FROM_SERVER:
-                    task_queue = layer_data->q12_recv_tasks_queue;
+                    task_index = &layer_data->q12_recv_tasks_index;
                     break;
                 case XI_MQTT_MESSAGE_CLASS_TO_SERVER:
-                    task_queue = layer_data->q12_tasks_queue;
+                    task_index = &layer_data->q12_tasks_index;
                     break;
                 case XI_MQTT_MESSAGE_CLASS_UNKNOWN:
                     in_out_state = XI_MQTT_MESSAGE_CLASS_UNKNOWN_ERROR;
@@ -127,8 +134,7 @@ xi_state_t xi_mqtt_logic_layer_push( void* context, void* data, xi_state_t in_ou
             }
 
             /* it is one of the qos12 task, find a proper task */
-            XI_LIST_FIND( xi_mqtt_logic_task_t, task_queue, CMP_TASK_MSG_ID, msg_id,
-                          task_to_be_called );
+            task_to_be_called = xi_mqtt_logic_task_index_find( task_index, msg_id );
         }
 
         /* restart layer keepalive - centralized for every successful send */
@@ -294,8 +300,8 @@ xi_state_t xi_mqtt_logic_layer_pull( void* context, void* data, xi_state_t in_ou
          * otherway we are going to use the current qos_0 task */
         if ( msg_id > 0 )
         {
-            xi_mqtt_logic_task_t* task       = 0;
-            xi_mqtt_logic_task_t* task_queue = 0;
+            xi_mqtt_logic_task_t* task                   = 0;
+            const xi_mqtt_logic_task_index_t* task_index = 0;
 
             /** store the msg class */
             xi_mqtt_message_class_t msg_class = xi_mqtt_class_msg_type_receiving(
@@ -305,10 +311,10 @@ xi_state_t xi_mqtt_logic_layer_pull( void* context, void* data, xi_state_t in_ou
             switch ( msg_class )
             {
                 case XI_MQTT_MESSAGE_CLASS_FROM_SERVER:
-                    task_queue = layer_data->q12_recv_tasks_queue;
+                    task_index = &layer_data->q12_recv_tasks_index;
                     break;
                 case XI_MQTT_MESSAGE_CLASS_TO_SERVER:
-                    task_queue = layer_data->q12_tasks_queue;
+                    task_index = &layer_data->q12_tasks_index;
                     break;
                 case XI_MQTT_MESSAGE_CLASS_UNKNOWN:
                 default:
@@ -316,10 +322,7 @@ xi_state_t xi_mqtt_logic_layer_pull( void* context, void* data, xi_state_t in_ou
                     goto err_handling;
             }
 
-            XI_LIST_FIND( xi_mqtt_logic_task_t, task_queue, CMP_TASK_MSG_ID,
-                          msg_id, /* this can be optimized through
-                                   * the structure optimization */
-                          task );
+            task = xi_mqtt_logic_task_index_find( task_index, msg_id );
 
             if ( task != 0 ) /* got the task let's call the proper handler */
             {
@@ -360,6 +363,52 @@ err_handling:
     return in_out_state;
 }
 
+/* on failure the index is left empty and the queue untouched */
+static xi_state_t xi_mqtt_logic_task_index_rebuild( xi_mqtt_logic_task_index_t* index,
+                                                    xi_mqtt_logic_task_t* task_queue )
+{
+    xi_mqtt_logic_task_index_clear( index );
+
+    for ( ; NULL != task_queue; task_queue = task_queue->__next )
+    {
+        const xi_state_t state = xi_mqtt_logic_task_index_insert( index, task_queue );
+
+        if ( XI_STATE_OK != state )
+        {
+            xi_mqtt_logic_task_index_clear( index );
+            return state;
+        }
+    }
+
+    return XI_STATE_OK;
+}
+
+/* on failure the trie is left empty and the subscriptions untouched */
+static xi_state_t xi_mqtt_topic_trie_rebuild( xi_mqtt_topic_trie_t* trie,
+                                              const xi_vector_t* subscriptions )
+{
+    xi_mqtt_topic_trie_clear( trie );
+
+    xi_vector_index_type_t i = 0;
+    for ( ; NULL != subscriptions && i < subscriptions->elem_no; ++i )
+    {
+        xi_mqtt_task_specific_data_t* subscription =
+            ( xi_mqtt_task_specific_data_t* )subscriptions->array[i]
+                .selector_t.ptr_value;
+
+        const xi_state_t state = xi_mqtt_topic_trie_insert(
+            trie, subscription->subscribe.topic, subscription );
+
+        if ( XI_STATE_OK != state )
+        {
+            xi_mqtt_topic_trie_clear( trie );
+            return state;
+        }
+    }
+
+    return XI_STATE_OK;
+}
+
 xi_state_t xi_mqtt_logic_layer_init( void* context, void* data, xi_state_t in_out_state )
 {
     XI_LAYER_FUNCTION_PRINT_FUNCTION_DIGEST();
@@ -392,8 +441,17 @@ xi_state_t xi_mqtt_logic_layer_init( void* context, void* data, xi_state_t in_ou
             XI_THIS_LAYER( context )->context_data->copy_of_handlers_for_topics;
         XI_THIS_LAYER( context )->context_data->copy_of_handlers_for_topics = NULL;
 
+        in_out_state = xi_mqtt_topic_trie_rebuild( &layer_data->handlers_for_topics_trie,
+                                                   layer_data->handlers_for_topics );
+        XI_CHECK_STATE( in_out_state );
+
         /* same story goes with the qos1&2 unacked messages what we have to do is to
          * re-plug them into the queue and connect task will restart the tasks */
+        in_out_state = xi_mqtt_logic_task_index_rebuild(
+            &layer_data->q12_tasks_index,
+            XI_THIS_LAYER( context )->context_data->copy_of_q12_unacked_messages_queue );
+        XI_CHECK_STATE( in_out_state );
+
         layer_data->q12_tasks_queue =
             XI_THIS_LAYER( context )->context_data->copy_of_q12_unacked_messages_queue;
         XI_THIS_LAYER( context )->context_data->copy_of_q12_unacked_messages_queue = NULL;
@@ -402,6 +460,9 @@ xi_state_t xi_mqtt_logic_layer_init( void* context, void* data, xi_state_t in_ou
         layer_data->last_msg_id =
             XI_THIS_LAYER( context )->context_data->copy_of_last_msg_id;
         XI_THIS_LAYER( context )->context_data->copy_of_last_msg_id = 0;
+
+        /* the restored publishes keep their place in the publish window */
+        xi_mqtt_logic_layer_count_q12_publishes( context );
     }
     else
     {
@@ -422,6 +483,8 @@ xi_state_t xi_mqtt_logic_layer_init( void* context, void* data, xi_state_t in_ou
                 ->context_data->copy_of_q12_unacked_messages_queue;
         xi_mqtt_logic_task_queue_shutdown( &saved_unacked_qos_12_queue );
         XI_THIS_LAYER( context )->context_data->copy_of_q12_unacked_messages_queue = NULL;
+
+        XI_MQTT_LOGIC_STORE_PUBLISHES_OUTSTANDING( XI_CONTEXT_DATA( context ), 0 );
     }
 
     /* if there was no copy or this is the fresh (re)start */
@@ -438,6 +501,39 @@ xi_state_t xi_mqtt_logic_layer_init( void* context, void* data, xi_state_t in_ou
     return XI_PROCESS_INIT_ON_PREV_LAYER( context, data, in_out_state );
 
 err_handling:
+    if ( NULL != layer_data )
+    {
+        xi_mqtt_logic_task_index_clear( &layer_data->q12_tasks_index );
+        xi_mqtt_topic_trie_clear( &layer_data->handlers_for_topics_trie );
+
+        /* give back what was taken over from the last session so the next connect
+         * can still continue it */
+        if ( XI_SESSION_CONTINUE ==
+             XI_CONTEXT_DATA( context )->connection_data->session_type )
+        {
+            if ( NULL != layer_data->q12_tasks_queue )
+            {
+                XI_THIS_LAYER( context )
+                    ->context_data->copy_of_q12_unacked_messages_queue =
+                    layer_data->q12_tasks_queue;
+                layer_data->q12_tasks_queue = NULL;
+            }
+
+            if ( NULL != layer_data->handlers_for_topics )
+            {
+                XI_THIS_LAYER( context )->context_data->copy_of_handlers_for_topics =
+                    layer_data->handlers_for_topics;
+                layer_data->handlers_for_topics = NULL;
+            }
+
+            if ( 0 == XI_THIS_LAYER( context )->context_data->copy_of_last_msg_id )
+            {
+                XI_THIS_LAYER( context )->context_data->copy_of_last_msg_id =
+                    layer_data->last_msg_id;
+            }
+        }
+    }
+
     XI_SAFE_FREE( XI_THIS_LAYER( context )->user_data );
     return in_out_state;
 }
@@ -480,9 +576,8 @@ xi_mqtt_logic_layer_post_connect( void* context, void* data, xi_state_t in_out_s
     }
 
     /* set new context and send timeout which will make the qos12 tasks to  continue they
-     * work just where they were stopped */
-    XI_LIST_FOREACH_WITH_ARG( xi_mqtt_logic_task_t, layer_data->q12_tasks_queue,
-                              set_new_context_and_call_resend, context );
+     * work just where they were stopped, then start the publishes that waited */
+    xi_mqtt_logic_layer_resume_q12_tasks( context );
 
     return xi_layer_default_post_connect( context, data, in_out_state );
 }
@@ -549,6 +644,9 @@ xi_mqtt_logic_layer_close_externally( void* context, void* data, xi_state_t in_o
 
     xi_update_backoff_penalty( in_out_state );
 
+    /* the publishes kept for the next session still use the publish window */
+    uint16_t publishes_kept = 0;
+
     /* disable timeouts of all tasks */
     XI_LIST_FOREACH_WITH_ARG( xi_mqtt_logic_task_t, layer_data->q12_tasks_queue,
                               cancel_task_timeout, context );
@@ -591,8 +689,15 @@ xi_mqtt_logic_layer_close_externally( void* context, void* data, xi_state_t in_o
 
         XI_LIST_FOREACH( xi_mqtt_logic_task_t, unacked_list,
                          xi_mqtt_logic_layer_task_make_context_null );
+
+        for ( ; NULL != unacked_list; unacked_list = unacked_list->__next )
+        {
+            publishes_kept += is_publish_task( unacked_list );
+        }
     }
 
+    XI_MQTT_LOGIC_STORE_PUBLISHES_OUTSTANDING( context_data, publishes_kept );
+
     /* if the handlers for topics are left alone than it means
      * that it has to be freed */
     if ( layer_data->handlers_for_topics != NULL )
@@ -625,6 +730,11 @@ xi_mqtt_logic_layer_close_externally( void* context, void* data, xi_state_t in_o
     xi_mqtt_logic_task_t* q12_recv_queue = layer_data->q12_recv_tasks_queue;
     xi_mqtt_logic_task_t* q0_queue       = layer_data->q0_tasks_queue;
 
+    xi_mqtt_logic_task_index_clear( &layer_data->q12_tasks_index );
+    xi_mqtt_logic_task_index_clear( &layer_data->q12_recv_tasks_index );
+    xi_mqtt_topic_trie_clear( &layer_data->handlers_for_topics_trie );
+    xi_mqtt_message_free( &layer_data->publish_in_parts );
+
     /* destroy user's data */
     XI_SAFE_FREE( XI_THIS_LAYER( context )->user_data );
 
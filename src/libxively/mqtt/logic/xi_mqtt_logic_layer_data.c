@@ -4,14 +4,35 @@
  * it is licensed under the BSD 3-Clause license.
  */
 
+#include "xi_critical_section.h"
+#include "xi_critical_section_def.h"
 #include "xi_helpers.h"
 #include "xi_macros.h"
+#include "xi_memory_pool.h"
 #include "xi_mqtt_logic_layer_data.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* empty and so bypassed until xi_mqtt_logic_task_pool_resize gives them a size */
+static xi_memory_pool_t xi_mqtt_logic_task_pool     = xi_make_memory_pool( 0 );
+static xi_memory_pool_t xi_mqtt_task_spec_data_pool = xi_make_memory_pool( 0 );
+
+/* static initialisation of the critical section, publish tasks are made on the
+ * application's threads and released on the event loop's */
+static struct xi_critical_section_s xi_mqtt_logic_task_pool_cs = {0};
+
+void xi_mqtt_logic_task_pool_resize( uint16_t max_free_count )
+{
+    xi_lock_critical_section( &xi_mqtt_logic_task_pool_cs );
+
+    xi_memory_pool_resize( &xi_mqtt_logic_task_pool, max_free_count );
+    xi_memory_pool_resize( &xi_mqtt_task_spec_data_pool, max_free_count );
+
+    xi_unlock_critical_section( &xi_mqtt_logic_task_pool_cs );
+}
+
 xi_mqtt_logic_task_t* xi_mqtt_logic_make_publish_task( const char* topic,
                                                        xi_data_desc_t* data,
                                                        const xi_mqtt_qos_t qos,
@@ -24,14 +45,20 @@ xi_mqtt_logic_task_t* xi_mqtt_logic_make_publish_task( const char* topic,
 
     xi_state_t state = XI_STATE_OK;
 
-    XI_ALLOC( xi_mqtt_logic_task_t, task, state );
+    xi_mqtt_logic_task_t* task = ( xi_mqtt_logic_task_t* )xi_memory_pool_alloc(
+        &xi_mqtt_logic_task_pool, &xi_mqtt_logic_task_pool_cs,
+        sizeof( xi_mqtt_logic_task_t ) );
+    XI_CHECK_MEMORY( task, state );
 
     task->data.mqtt_settings.scenario = XI_MQTT_PUBLISH;
     task->data.mqtt_settings.qos      = qos;
 
     task->callback = callback;
 
-    XI_ALLOC_AT( xi_mqtt_task_specific_data_t, task->data.data_u, state );
+    task->data.data_u = ( xi_mqtt_task_specific_data_t* )xi_memory_pool_alloc(
+        &xi_mqtt_task_spec_data_pool, &xi_mqtt_logic_task_pool_cs,
+        sizeof( xi_mqtt_task_specific_data_t ) );
+    XI_CHECK_MEMORY( task->data.data_u, state );
 
     task->data.data_u->publish.retain = retain;
     task->data.data_u->publish.topic  = xi_str_dup( topic );
@@ -104,7 +131,15 @@ void xi_mqtt_task_spec_data_free_publish_data( xi_mqtt_task_specific_data_t** da
 
     xi_free_desc( &( *data )->publish.data );
     XI_SAFE_FREE( ( *data )->publish.topic );
-    XI_SAFE_FREE( ( *data ) );
+
+    if ( XI_EVENT_HANDLE_UNSET != ( *data )->publish.release_handler.handle_type )
+    {
+        xi_evtd_execute_handle( &( *data )->publish.release_handler );
+    }
+
+    xi_memory_pool_release( &xi_mqtt_task_spec_data_pool, &xi_mqtt_logic_task_pool_cs,
+                            *data );
+    *data = NULL;
 }
 
 void xi_mqtt_task_spec_data_free_subscribe_data( xi_mqtt_task_specific_data_t** data )
@@ -163,7 +198,9 @@ xi_mqtt_logic_task_t* xi_mqtt_logic_free_task( xi_mqtt_logic_task_t** task )
             xi_mqtt_logic_free_task_data( *task );
         }
 
-        XI_SAFE_FREE( *task );
+        xi_memory_pool_release( &xi_mqtt_logic_task_pool, &xi_mqtt_logic_task_pool_cs,
+                                *task );
+        *task = NULL;
     }
 
     return 0;
@@ -11,6 +11,8 @@
 #include "xi_data_desc.h"
 #include "xi_event_dispatcher_api.h"
 #include "xi_mqtt_message.h"
+#include "xi_mqtt_logic_layer_task_index.h"
+#include "xi_mqtt_logic_layer_topic_trie.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,13 +27,15 @@ typedef enum xi_scenario_e {
     XI_MQTT_SHUTDOWN
 } xi_scenario_t;
 
-typedef union {
+typedef union xi_mqtt_task_specific_data_u {
     struct data_t_publish_t
     {
         char* topic;
         xi_data_desc_t* data;
         xi_mqtt_retain_t retain;
         xi_mqtt_dup_t dup;
+        /* set if data is borrowed, hands it back once the task is released */
+        xi_event_handle_t release_handler;
     } publish;
 
     struct data_t_subscribe_t
@@ -39,6 +43,8 @@ typedef union {
         char* topic;
         xi_event_handle_t handler;
         xi_mqtt_qos_t qos;
+        /* the handler gets the parts of a payload received in parts one by one */
+        uint8_t streamed;
     } subscribe;
 
     struct data_t_shutdown_t
@@ -94,13 +100,60 @@ typedef struct
     /* handle to the user idle function that suppose to */
     xi_mqtt_logic_task_t* q12_tasks_queue;
     xi_mqtt_logic_task_t* q12_recv_tasks_queue;
+    /* msg_id lookup of the tasks kept on the two queues above */
+    xi_mqtt_logic_task_index_t q12_tasks_index;
+    xi_mqtt_logic_task_index_t q12_recv_tasks_index;
     xi_mqtt_logic_task_t* q0_tasks_queue;
     xi_mqtt_logic_task_t* current_q0_task;
     xi_vector_t* handlers_for_topics;
+    /* topic lookup of the subscriptions owned by the vector above */
+    xi_mqtt_topic_trie_t handlers_for_topics_trie;
+    /* PUBLISH received in parts being put together for a subscription that is not
+     * streamed, see xi_mqtt_parser_chunk_payload */
+    xi_mqtt_message_t* publish_in_parts;
     xi_time_event_handle_t keepalive_event;
     uint16_t last_msg_id;
+    /* QoS1 PUBLISHes on q12_tasks_queue started and not finalized yet, and the ones
+     * held back there because the publish window is full */
+    uint16_t q12_publishes_in_flight;
+    uint16_t q12_publishes_waiting;
 } xi_mqtt_logic_layer_data_t;
 
+/* q12_publishes_outstanding of the context data is written on the event loop but the
+ * xi_publish* calls read it on the application's thread, with threading both sides have
+ * to be atomic */
+#ifdef XI_MODULE_THREAD_ENABLED
+#define XI_MQTT_LOGIC_LOAD_PUBLISHES_OUTSTANDING( context_data )                         \
+    __atomic_load_n( &( context_data )->q12_publishes_outstanding, __ATOMIC_RELAXED )
+#define XI_MQTT_LOGIC_STORE_PUBLISHES_OUTSTANDING( context_data, value )                 \
+    __atomic_store_n( &( context_data )->q12_publishes_outstanding, value,               \
+                      __ATOMIC_RELAXED )
+#else
+#define XI_MQTT_LOGIC_LOAD_PUBLISHES_OUTSTANDING( context_data )                         \
+    ( ( context_data )->q12_publishes_outstanding )
+#define XI_MQTT_LOGIC_STORE_PUBLISHES_OUTSTANDING( context_data, value )                 \
+    ( ( context_data )->q12_publishes_outstanding = ( value ) )
+#endif
+
+/* number of released publish tasks kept for reuse while a context exists, the topic and
+ * the payload they point to are not kept */
+#ifndef XI_MQTT_LOGIC_TASK_POOL_SIZE
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_MQTT_LOGIC_TASK_POOL_SIZE 16
+#else
+#define XI_MQTT_LOGIC_TASK_POOL_SIZE 2
+#endif
+#endif
+
+/**
+ * @brief xi_mqtt_logic_task_pool_resize
+ *
+ * Sets how many released tasks and publish task data are kept for reuse instead of
+ * being freed, the ones above the new size are freed right away. 0, the initial size,
+ * turns the reuse off.
+ */
+extern void xi_mqtt_logic_task_pool_resize( uint16_t max_free_count );
+
 /* pseudo constructors */
 extern xi_mqtt_logic_task_t*
 xi_mqtt_logic_make_publish_task( const char* topic,
@@ -15,24 +15,6 @@
 extern "C" {
 #endif
 
-static inline int8_t
-cmp_topics( const union xi_vector_selector_u* a, const union xi_vector_selector_u* b )
-{
-    const xi_mqtt_task_specific_data_t* ca =
-        ( const xi_mqtt_task_specific_data_t* )
-            a->ptr_value; /* this suppose to be the one from the vector */
-    const xi_data_desc_t* cb = ( const xi_data_desc_t* )b->ptr_value; /* this suppose to
-                                                                         be the one from
-                                                                         the msg */
-
-    if ( memcmp( ca->subscribe.topic, cb->data_ptr, cb->length ) == 0 )
-    {
-        return 0;
-    }
-
-    return 1;
-}
-
 static inline xi_state_t fill_with_pingreq_data( xi_mqtt_message_t* msg )
 {
     memset( msg, 0, sizeof( xi_mqtt_message_t ) );
@@ -33,22 +33,15 @@ call_topic_handler( void* context, /* should be the context of the logic layer *
     // pre-conditions
     assert( NULL != msg_memory );
 
-    xi_vector_index_type_t index = 0;
-
     xi_debug_format( "[m.id[%d]] looking for publish message handler",
                      xi_mqtt_get_message_id( msg_memory ) );
 
-    index = xi_vector_find(
-        layer_data->handlers_for_topics,
-        XI_VEC_CONST_VALUE_PARAM( XI_VEC_VALUE_PTR( msg_memory->publish.topic_name ) ),
-        cmp_topics );
+    xi_mqtt_task_specific_data_t* subscribe_data = xi_mqtt_topic_trie_match(
+        &layer_data->handlers_for_topics_trie, msg_memory->publish.topic_name->data_ptr,
+        msg_memory->publish.topic_name->length );
 
-    if ( index != -1 )
+    if ( NULL != subscribe_data )
     {
-        xi_mqtt_task_specific_data_t* subscribe_data =
-            ( xi_mqtt_task_specific_data_t* )layer_data->handlers_for_topics->array[index]
-                .selector_t.ptr_value;
-
         subscribe_data->subscribe.handler.handlers.h3.a2 = msg_memory;
         subscribe_data->subscribe.handler.handlers.h3.a3 = XI_STATE_OK;
 
@@ -129,18 +122,18 @@ on_publish_q1_recieved( void* context /* should be the context of the logic laye
 
         task->msg_id = msg_id;
 
-/* @TODO change this into debug only compilation */
-#if 1
-        {
-            xi_mqtt_logic_task_t* test_task = NULL;
+        // there must not be similar tasks
+        assert( NULL == xi_mqtt_logic_task_index_find( &layer_data->q12_recv_tasks_index,
+                                                       task->msg_id ) );
 
-            XI_LIST_FIND( xi_mqtt_logic_task_t, layer_data->q12_recv_tasks_queue,
-                          CMP_TASK_MSG_ID, task->msg_id, test_task );
+        state =
+            xi_mqtt_logic_task_index_insert( &layer_data->q12_recv_tasks_index, task );
 
-            // there must not be similar tasks
-            assert( NULL == test_task );
+        if ( XI_STATE_OK != state )
+        {
+            xi_mqtt_logic_free_task( &task );
+            goto err_handling;
         }
-#endif
 
         XI_LIST_PUSH_BACK( xi_mqtt_logic_task_t, layer_data->q12_recv_tasks_queue, task );
     }
@@ -170,6 +163,7 @@ on_publish_q1_recieved( void* context /* should be the context of the logic laye
 
     /* clean the created task data */
     XI_LIST_DROP( xi_mqtt_logic_task_t, layer_data->q12_recv_tasks_queue, task );
+    xi_mqtt_logic_task_index_remove( &layer_data->q12_recv_tasks_index, task );
 
     xi_mqtt_logic_free_task( &task );
 
@@ -191,6 +185,87 @@ err_handling:
     return state;
 }
 
+static inline size_t xi_mqtt_logic_publish_part_end( const xi_mqtt_message_t* msg )
+{
+    return msg->publish.content_offset +
+           ( ( NULL == msg->publish.content ) ? 0 : msg->publish.content->length );
+}
+
+/**
+ * @brief xi_mqtt_logic_collect_publish_part
+ *
+ * Takes a part of a payload that is received in parts. A streamed subscription gets the
+ * parts one by one, for any other the payload is put together here and the message is
+ * handled as if it was received whole.
+ *
+ * @return the message to go on with, NULL until the last part of a payload that is
+ * put together
+ */
+static inline xi_mqtt_message_t*
+xi_mqtt_logic_collect_publish_part( xi_mqtt_logic_layer_data_t* layer_data,
+                                    xi_mqtt_message_t* msg,
+                                    xi_state_t* state )
+{
+    xi_mqtt_message_t* whole = layer_data->publish_in_parts;
+
+    if ( 0 == msg->publish.content_offset )
+    {
+        const xi_mqtt_task_specific_data_t* subscribe_data = xi_mqtt_topic_trie_match(
+            &layer_data->handlers_for_topics_trie, msg->publish.topic_name->data_ptr,
+            msg->publish.topic_name->length );
+
+        /* nothing to put together for a streamed or an unknown topic */
+        if ( NULL == subscribe_data || 0 != subscribe_data->subscribe.streamed )
+        {
+            return msg;
+        }
+
+        assert( NULL == whole );
+
+        /* the buffer is sized once for the whole payload, the parts are copied in */
+        xi_data_desc_t* content =
+            xi_make_empty_desc_alloc_uninitialized( msg->publish.content_total_length );
+
+        if ( NULL == content )
+        {
+            xi_mqtt_message_free( &msg );
+            *state = XI_OUT_OF_MEMORY;
+            return NULL;
+        }
+
+        xi_data_desc_append_data( content, msg->publish.content );
+        xi_free_desc( &msg->publish.content );
+        msg->publish.content = content;
+
+        layer_data->publish_in_parts = msg;
+        return NULL;
+    }
+
+    if ( NULL == whole )
+    {
+        return msg;
+    }
+
+    *state = xi_data_desc_append_data( whole->publish.content, msg->publish.content );
+
+    xi_mqtt_message_free( &msg );
+
+    if ( XI_STATE_OK != *state )
+    {
+        xi_mqtt_message_free( &layer_data->publish_in_parts );
+        return NULL;
+    }
+
+    if ( whole->publish.content->length < whole->publish.content_total_length )
+    {
+        return NULL;
+    }
+
+    layer_data->publish_in_parts = NULL;
+
+    return whole;
+}
+
 static inline xi_state_t on_publish_recieved(
     xi_layer_connectivity_t* context, /* should be the context of the logic layer */
     xi_mqtt_message_t* msg_memory,
@@ -205,6 +280,25 @@ static inline xi_state_t on_publish_recieved(
         return XI_STATE_OK;
     }
 
+    if ( xi_mqtt_logic_publish_part_end( msg_memory ) <
+             msg_memory->publish.content_total_length ||
+         0 < msg_memory->publish.content_offset )
+    {
+        msg_memory = xi_mqtt_logic_collect_publish_part( layer_data, msg_memory, &state );
+
+        if ( NULL == msg_memory )
+        {
+            return state;
+        }
+
+        /* a streamed message is acknowledged along with its last part */
+        if ( xi_mqtt_logic_publish_part_end( msg_memory ) <
+             msg_memory->publish.content_total_length )
+        {
+            return on_publish_q0_recieved( context, 0, state, msg_memory );
+        }
+    }
+
     switch ( msg_memory->common.common_u.common_bits.qos )
     {
         case XI_MQTT_QOS_AT_MOST_ONCE:
@@ -167,6 +167,18 @@ do_mqtt_subscribe( void* ctx, void* data, xi_state_t state, void* msg )
                                              XI_VEC_VALUE_PARAM( XI_VEC_VALUE_PTR(
                                                  task->data.data_u ) ) ),
                              state );
+
+            state = xi_mqtt_topic_trie_insert( &layer_data->handlers_for_topics_trie,
+                                               task->data.data_u->subscribe.topic,
+                                               task->data.data_u );
+
+            if ( XI_STATE_OK != state )
+            {
+                /* give the ownership back so the task releases the data */
+                xi_vector_del( layer_data->handlers_for_topics,
+                               layer_data->handlers_for_topics->elem_no - 1 );
+                goto err_handling;
+            }
         }
 
         XI_CHECK_MEMORY(
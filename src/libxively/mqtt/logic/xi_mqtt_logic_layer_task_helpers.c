@@ -63,6 +63,99 @@ xi_state_t xi_mqtt_logic_layer_run_next_q0_task( void* data )
     return XI_STATE_OK;
 }
 
+xi_state_t xi_mqtt_logic_layer_run_waiting_publishes( xi_layer_connectivity_t* context )
+{
+    xi_mqtt_logic_layer_data_t* layer_data =
+        ( xi_mqtt_logic_layer_data_t* )XI_THIS_LAYER( context )->user_data;
+
+    xi_state_t state = XI_STATE_OK;
+
+    if ( NULL == layer_data || XI_CONTEXT_DATA( context )->connection_data
+                                       ->connection_state != XI_CONNECTION_STATE_OPENED )
+    {
+        return state;
+    }
+
+    while ( 0 < layer_data->q12_publishes_waiting &&
+            !is_publish_window_full( layer_data ) )
+    {
+        xi_mqtt_logic_task_t* task = NULL;
+
+        /* the oldest one first, so they go out in the order they were made */
+        XI_LIST_FIND( xi_mqtt_logic_task_t, layer_data->q12_tasks_queue,
+                      is_waiting_publish_task, NULL, task );
+
+        assert( NULL != task && "waiting publish missing from the queue" );
+
+        if ( NULL == task )
+        {
+            layer_data->q12_publishes_waiting = 0;
+            update_publishes_outstanding( context );
+            break;
+        }
+
+        /* the sum stays the same, no need to update the outstanding count */
+        --layer_data->q12_publishes_waiting;
+        ++layer_data->q12_publishes_in_flight;
+
+        state = xi_evtd_execute_handle( &task->logic );
+    }
+
+    return state;
+}
+
+void xi_mqtt_logic_layer_count_q12_publishes( xi_layer_connectivity_t* context )
+{
+    xi_mqtt_logic_layer_data_t* layer_data =
+        ( xi_mqtt_logic_layer_data_t* )XI_THIS_LAYER( context )->user_data;
+
+    assert( NULL != layer_data );
+
+    layer_data->q12_publishes_in_flight = 0;
+    layer_data->q12_publishes_waiting   = 0;
+
+    xi_mqtt_logic_task_t* task = layer_data->q12_tasks_queue;
+    for ( ; NULL != task; task = task->__next )
+    {
+        if ( is_publish_task( task ) )
+        {
+            if ( 0 == task->cs )
+            {
+                ++layer_data->q12_publishes_waiting;
+            }
+            else
+            {
+                ++layer_data->q12_publishes_in_flight;
+            }
+        }
+    }
+
+    update_publishes_outstanding( context );
+}
+
+void xi_mqtt_logic_layer_resume_q12_tasks( xi_layer_connectivity_t* context )
+{
+    xi_mqtt_logic_layer_data_t* layer_data =
+        ( xi_mqtt_logic_layer_data_t* )XI_THIS_LAYER( context )->user_data;
+
+    assert( NULL != layer_data );
+
+    /* count before resending, a resent task may be finalized right away */
+    xi_mqtt_logic_layer_count_q12_publishes( context );
+
+    xi_mqtt_logic_task_t* task = layer_data->q12_tasks_queue;
+    for ( ; NULL != task; task = task->__next )
+    {
+        task->logic.handlers.h4.a1 = context;
+    }
+
+    /* the unacked ones go first, in their original order, then the ones that waited */
+    XI_LIST_FOREACH_WITH_ARG( xi_mqtt_logic_task_t, layer_data->q12_tasks_queue,
+                              set_new_context_and_call_resend, context );
+
+    xi_mqtt_logic_layer_run_waiting_publishes( context );
+}
+
 void xi_mqtt_logic_task_defer_users_callback( void* context,
                                               xi_mqtt_logic_task_t* task,
                                               xi_state_t state )
@@ -103,11 +196,27 @@ xi_state_t xi_mqtt_logic_layer_finalize_task( xi_layer_connectivity_t* context,
     }
     else /* I left it for better code readability */
     {
+        const uint8_t publish = is_publish_task( task );
+
         /* detach the task from the qos 1 and 2 queue */
         XI_LIST_DROP( xi_mqtt_logic_task_t, layer_data->q12_tasks_queue, task );
+        xi_mqtt_logic_task_index_remove( &layer_data->q12_tasks_index, task );
 
         /* release task's memory */
         xi_mqtt_logic_free_task( &task );
+
+        /* its place in the window goes to the next waiting publish */
+        if ( publish )
+        {
+            if ( 0 < layer_data->q12_publishes_in_flight )
+            {
+                --layer_data->q12_publishes_in_flight;
+            }
+
+            update_publishes_outstanding( context );
+
+            return xi_mqtt_logic_layer_run_waiting_publishes( context );
+        }
     }
 
     return XI_STATE_OK;
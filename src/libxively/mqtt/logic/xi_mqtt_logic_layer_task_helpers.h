@@ -23,12 +23,16 @@ xi_state_t xi_mqtt_logic_layer_finalize_task( xi_layer_connectivity_t* context,
 
 xi_state_t xi_mqtt_logic_layer_run_next_q0_task( void* data );
 
+xi_state_t xi_mqtt_logic_layer_run_waiting_publishes( xi_layer_connectivity_t* context );
+
+void xi_mqtt_logic_layer_count_q12_publishes( xi_layer_connectivity_t* context );
+
+void xi_mqtt_logic_layer_resume_q12_tasks( xi_layer_connectivity_t* context );
+
 void xi_mqtt_logic_task_defer_users_callback( void* context,
                                               xi_mqtt_logic_task_t* task,
                                               xi_state_t state );
 
-#define CMP_TASK_MSG_ID( task, id ) ( task->msg_id == id )
-
 static inline void
 cancel_task_timeout( xi_mqtt_logic_task_t* task, xi_layer_connectivity_t* context )
 {
@@ -94,6 +98,38 @@ set_new_context_and_call_resend( xi_mqtt_logic_task_t* task, void* context )
     }
 }
 
+static inline uint8_t is_publish_task( const xi_mqtt_logic_task_t* task )
+{
+    return XI_MQTT_PUBLISH == task->data.mqtt_settings.scenario;
+}
+
+/* a QoS1 PUBLISH that has been queued but not started, it has not yielded yet */
+static inline uint8_t
+is_waiting_publish_task( const xi_mqtt_logic_task_t* task, const void* unused )
+{
+    XI_UNUSED( unused );
+    return is_publish_task( task ) && 0 == task->cs;
+}
+
+static inline uint8_t
+is_publish_window_full( const xi_mqtt_logic_layer_data_t* layer_data )
+{
+    return 0 < xi_globals.publish_window &&
+           xi_globals.publish_window <= layer_data->q12_publishes_in_flight;
+}
+
+/* lets xi_publish* see how much of the publish window is used without reaching into
+ * the layer, see q12_publishes_outstanding */
+static inline void update_publishes_outstanding( xi_layer_connectivity_t* context )
+{
+    const xi_mqtt_logic_layer_data_t* layer_data =
+        ( xi_mqtt_logic_layer_data_t* )XI_THIS_LAYER( context )->user_data;
+
+    XI_MQTT_LOGIC_STORE_PUBLISHES_OUTSTANDING(
+        XI_CONTEXT_DATA( context ),
+        layer_data->q12_publishes_in_flight + layer_data->q12_publishes_waiting );
+}
+
 static inline xi_state_t
 run_task( xi_layer_connectivity_t* context, xi_mqtt_logic_task_t* task )
 {
@@ -131,25 +167,43 @@ run_task( xi_layer_connectivity_t* context, xi_mqtt_logic_task_t* task )
          * and to demultiplex msgs */
         task->msg_id = ++layer_data->last_msg_id;
 
-#ifdef XI_DEBUG_EXTRA_INFO
-        xi_mqtt_logic_task_t* needle = NULL;
-        XI_LIST_FIND(
-            xi_mqtt_logic_task_t, layer_data->q12_tasks_queue, CMP_TASK_MSG_ID,
-            task->msg_id, /* this is linear search so we have O(n) complexity it can be
-                             optimized but for the small n it is acceptable complexity */
-            needle );
-        assert( NULL == needle && "task with the same id already exist" );
-#endif
+        assert( NULL == xi_mqtt_logic_task_index_find( &layer_data->q12_tasks_index,
+                                                       task->msg_id ) &&
+                "task with the same id already exist" );
+
+        /* the index demultiplexes msg ids, the queue keeps the order for resend */
+        const xi_state_t state =
+            xi_mqtt_logic_task_index_insert( &layer_data->q12_tasks_index, task );
+
+        if ( XI_STATE_OK != state )
+        {
+            xi_mqtt_logic_free_task( &task );
+            return state;
+        }
 
-        /* add it to the queue which is really a multiplexer of message id's */
         XI_LIST_PUSH_BACK( xi_mqtt_logic_task_t, layer_data->q12_tasks_queue, task );
 
-        /* execute it immediately
-         * @TODO concider a different strategy of execution in order to minimize the
-         * device overload we could execute only a certain amount per one loop
-         *  but let's keep it simple for now */
-        if ( XI_CONTEXT_DATA( context )->connection_data->connection_state ==
-             XI_CONNECTION_STATE_OPENED )
+        const uint8_t opened =
+            XI_CONTEXT_DATA( context )->connection_data->connection_state ==
+            XI_CONNECTION_STATE_OPENED;
+
+        /* publishes over the window wait on the queue in their order, each finalized
+         * one starts the next, see xi_mqtt_logic_layer_run_waiting_publishes */
+        if ( is_publish_task( task ) )
+        {
+            if ( !opened || is_publish_window_full( layer_data ) )
+            {
+                ++layer_data->q12_publishes_waiting;
+                update_publishes_outstanding( context );
+                return XI_STATE_OK;
+            }
+
+            ++layer_data->q12_publishes_in_flight;
+            update_publishes_outstanding( context );
+        }
+
+        /* execute it immediately */
+        if ( opened )
         {
             return xi_evtd_execute_handle( &task->logic );
         }
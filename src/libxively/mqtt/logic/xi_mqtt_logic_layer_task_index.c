@@ -0,0 +1,177 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include "xi_macros.h"
+#include "xi_mqtt_logic_layer_data.h"
+#include "xi_mqtt_logic_layer_task_index.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* msg ids are handed out sequentially so plain masking spreads them evenly */
+static inline uint32_t
+xi_mqtt_logic_task_index_home( const xi_mqtt_logic_task_index_t* index, uint16_t msg_id )
+{
+    return ( uint32_t )msg_id & ( index->capacity - 1 );
+}
+
+static void xi_mqtt_logic_task_index_place( xi_mqtt_logic_task_index_t* index,
+                                            xi_mqtt_logic_task_t* task )
+{
+    uint32_t slot = xi_mqtt_logic_task_index_home( index, task->msg_id );
+
+    while ( NULL != index->slots[slot] )
+    {
+        slot = ( slot + 1 ) & ( index->capacity - 1 );
+    }
+
+    index->slots[slot] = task;
+    index->count += 1;
+}
+
+static xi_state_t xi_mqtt_logic_task_index_grow( xi_mqtt_logic_task_index_t* index )
+{
+    xi_state_t state = XI_STATE_OK;
+
+    const uint32_t old_capacity      = index->capacity;
+    xi_mqtt_logic_task_t** old_slots = index->slots;
+    xi_mqtt_logic_task_t** new_slots = NULL;
+
+    const uint32_t new_capacity = ( 0 == old_capacity )
+                                      ? XI_MQTT_LOGIC_TASK_INDEX_INITIAL_CAPACITY
+                                      : old_capacity * 2;
+
+    XI_ALLOC_BUFFER_AT( xi_mqtt_logic_task_t*, new_slots,
+                        sizeof( xi_mqtt_logic_task_t* ) * new_capacity, state );
+
+    index->slots    = new_slots;
+    index->capacity = new_capacity;
+    index->count    = 0;
+
+    uint32_t i = 0;
+    for ( ; i < old_capacity; ++i )
+    {
+        if ( NULL != old_slots[i] )
+        {
+            xi_mqtt_logic_task_index_place( index, old_slots[i] );
+        }
+    }
+
+    XI_SAFE_FREE( old_slots );
+
+err_handling:
+    return state;
+}
+
+xi_state_t xi_mqtt_logic_task_index_insert( xi_mqtt_logic_task_index_t* index,
+                                            xi_mqtt_logic_task_t* task )
+{
+    assert( NULL != index );
+    assert( NULL != task );
+
+    /* keep at least a quarter of the slots free so the probe sequences stay short */
+    if ( ( index->count + 1 ) * 4 > index->capacity * 3 )
+    {
+        const xi_state_t state = xi_mqtt_logic_task_index_grow( index );
+
+        if ( XI_STATE_OK != state )
+        {
+            return state;
+        }
+    }
+
+    xi_mqtt_logic_task_index_place( index, task );
+
+    return XI_STATE_OK;
+}
+
+xi_mqtt_logic_task_t*
+xi_mqtt_logic_task_index_find( const xi_mqtt_logic_task_index_t* index,
+                               uint16_t msg_id )
+{
+    assert( NULL != index );
+
+    if ( 0 == index->count )
+    {
+        return NULL;
+    }
+
+    uint32_t slot = xi_mqtt_logic_task_index_home( index, msg_id );
+
+    while ( NULL != index->slots[slot] )
+    {
+        if ( msg_id == index->slots[slot]->msg_id )
+        {
+            return index->slots[slot];
+        }
+
+        slot = ( slot + 1 ) & ( index->capacity - 1 );
+    }
+
+    return NULL;
+}
+
+void xi_mqtt_logic_task_index_remove( xi_mqtt_logic_task_index_t* index,
+                                      const xi_mqtt_logic_task_t* task )
+{
+    assert( NULL != index );
+    assert( NULL != task );
+
+    if ( 0 == index->count )
+    {
+        return;
+    }
+
+    const uint32_t mask = index->capacity - 1;
+    uint32_t slot       = xi_mqtt_logic_task_index_home( index, task->msg_id );
+
+    while ( task != index->slots[slot] )
+    {
+        if ( NULL == index->slots[slot] )
+        {
+            return;
+        }
+
+        slot = ( slot + 1 ) & mask;
+    }
+
+    index->slots[slot] = NULL;
+    index->count -= 1;
+
+    /* backward shift the rest of the cluster so no lookup stops at the new hole */
+    uint32_t hole = slot;
+    slot          = ( slot + 1 ) & mask;
+
+    while ( NULL != index->slots[slot] )
+    {
+        const uint32_t home =
+            xi_mqtt_logic_task_index_home( index, index->slots[slot]->msg_id );
+
+        /* the entry may move to the hole only if the hole lies on its probe path */
+        if ( ( ( slot - home ) & mask ) >= ( ( slot - hole ) & mask ) )
+        {
+            index->slots[hole] = index->slots[slot];
+            index->slots[slot] = NULL;
+            hole               = slot;
+        }
+
+        slot = ( slot + 1 ) & mask;
+    }
+}
+
+void xi_mqtt_logic_task_index_clear( xi_mqtt_logic_task_index_t* index )
+{
+    assert( NULL != index );
+
+    XI_SAFE_FREE( index->slots );
+    index->capacity = 0;
+    index->count    = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,77 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#ifndef __XI_MQTT_LOGIC_LAYER_TASK_INDEX_H__
+#define __XI_MQTT_LOGIC_LAYER_TASK_INDEX_H__
+
+#include <stdint.h>
+
+#include "xi_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct xi_mqtt_logic_task_s;
+
+/*
+ * Open addressing ( linear probing ) table of in-flight QoS1 tasks keyed by their
+ * msg_id. The tasks stay on the FIFO queues, the index only replaces the linear
+ * search done on every PUBACK and send confirmation. A zeroed structure is a valid
+ * empty index.
+ */
+typedef struct xi_mqtt_logic_task_index_s
+{
+    struct xi_mqtt_logic_task_s** slots;
+    uint32_t capacity; /* zero or a power of two */
+    uint32_t count;
+} xi_mqtt_logic_task_index_t;
+
+/* initial number of slots, doubled whenever the table gets three quarters full */
+#ifndef XI_MQTT_LOGIC_TASK_INDEX_INITIAL_CAPACITY
+#define XI_MQTT_LOGIC_TASK_INDEX_INITIAL_CAPACITY 16
+#endif
+
+/**
+ * @brief xi_mqtt_logic_task_index_insert
+ *
+ * Adds the task under its msg_id. A task inserted later with an msg_id already in use
+ * is found only after the earlier one is removed, same as with the queue search.
+ *
+ * @return XI_STATE_OK or XI_OUT_OF_MEMORY if the table could not grow
+ */
+xi_state_t xi_mqtt_logic_task_index_insert( xi_mqtt_logic_task_index_t* index,
+                                            struct xi_mqtt_logic_task_s* task );
+
+/**
+ * @brief xi_mqtt_logic_task_index_find
+ *
+ * @return the task with the given msg_id or NULL if there is none
+ */
+struct xi_mqtt_logic_task_s*
+xi_mqtt_logic_task_index_find( const xi_mqtt_logic_task_index_t* index,
+                               uint16_t msg_id );
+
+/**
+ * @brief xi_mqtt_logic_task_index_remove
+ *
+ * Removes this very task from the index, does nothing if it is not indexed.
+ */
+void xi_mqtt_logic_task_index_remove( xi_mqtt_logic_task_index_t* index,
+                                      const struct xi_mqtt_logic_task_s* task );
+
+/**
+ * @brief xi_mqtt_logic_task_index_clear
+ *
+ * Releases the table memory, the tasks are not touched.
+ */
+void xi_mqtt_logic_task_index_clear( xi_mqtt_logic_task_index_t* index );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __XI_MQTT_LOGIC_LAYER_TASK_INDEX_H__ */
@@ -0,0 +1,369 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include <string.h>
+
+#include "xi_macros.h"
+#include "xi_mqtt_logic_layer_data.h"
+#include "xi_mqtt_logic_layer_topic_trie.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct xi_mqtt_topic_trie_node_s
+{
+    struct xi_mqtt_topic_trie_node_s** children; /* literal levels, sorted */
+    uint32_t children_count;
+    uint32_t children_capacity;
+    struct xi_mqtt_topic_trie_node_s* single_level_child; /* '+' */
+    struct xi_mqtt_topic_trie_node_s* multi_level_child;  /* '#' */
+    xi_mqtt_task_specific_data_t* subscription;
+    size_t level_length;
+    uint8_t level[]; /* allocated together with the node */
+} xi_mqtt_topic_trie_node_t;
+
+static int xi_mqtt_topic_trie_cmp_level( const xi_mqtt_topic_trie_node_t* node,
+                                         const uint8_t* level,
+                                         size_t level_length )
+{
+    if ( node->level_length != level_length )
+    {
+        return ( node->level_length < level_length ) ? -1 : 1;
+    }
+
+    return memcmp( node->level, level, level_length );
+}
+
+/* returns the position of the child with the given level or where it should go */
+static uint32_t xi_mqtt_topic_trie_lower_bound( const xi_mqtt_topic_trie_node_t* node,
+                                                const uint8_t* level,
+                                                size_t level_length )
+{
+    uint32_t begin = 0;
+    uint32_t end   = node->children_count;
+
+    while ( begin < end )
+    {
+        const uint32_t middle = begin + ( end - begin ) / 2;
+
+        if ( xi_mqtt_topic_trie_cmp_level( node->children[middle], level,
+                                           level_length ) < 0 )
+        {
+            begin = middle + 1;
+        }
+        else
+        {
+            end = middle;
+        }
+    }
+
+    return begin;
+}
+
+static xi_mqtt_topic_trie_node_t*
+xi_mqtt_topic_trie_find_child( const xi_mqtt_topic_trie_node_t* node,
+                               const uint8_t* level,
+                               size_t level_length )
+{
+    const uint32_t position =
+        xi_mqtt_topic_trie_lower_bound( node, level, level_length );
+
+    if ( position < node->children_count &&
+         0 == xi_mqtt_topic_trie_cmp_level( node->children[position], level,
+                                            level_length ) )
+    {
+        return node->children[position];
+    }
+
+    return NULL;
+}
+
+static xi_mqtt_topic_trie_node_t*
+xi_mqtt_topic_trie_make_node( const uint8_t* level, size_t level_length )
+{
+    xi_state_t state                = XI_STATE_OK;
+    xi_mqtt_topic_trie_node_t* node = NULL;
+
+    XI_ALLOC_BUFFER_AT( xi_mqtt_topic_trie_node_t, node,
+                        sizeof( xi_mqtt_topic_trie_node_t ) + level_length, state );
+
+    if ( 0 < level_length )
+    {
+        memcpy( node->level, level, level_length );
+    }
+
+    node->level_length = level_length;
+
+err_handling:
+    return node;
+}
+
+static xi_mqtt_topic_trie_node_t*
+xi_mqtt_topic_trie_get_or_add_child( xi_mqtt_topic_trie_node_t* node,
+                                     const uint8_t* level,
+                                     size_t level_length )
+{
+    const uint32_t position =
+        xi_mqtt_topic_trie_lower_bound( node, level, level_length );
+
+    if ( position < node->children_count &&
+         0 == xi_mqtt_topic_trie_cmp_level( node->children[position], level,
+                                            level_length ) )
+    {
+        return node->children[position];
+    }
+
+    if ( node->children_count == node->children_capacity )
+    {
+        const uint32_t capacity =
+            ( 0 == node->children_capacity ) ? 4 : node->children_capacity * 2;
+
+        xi_mqtt_topic_trie_node_t** children = ( xi_mqtt_topic_trie_node_t** )xi_alloc(
+            sizeof( xi_mqtt_topic_trie_node_t* ) * capacity );
+
+        if ( NULL == children )
+        {
+            return NULL;
+        }
+
+        if ( 0 < node->children_count )
+        {
+            memcpy( children, node->children,
+                    sizeof( xi_mqtt_topic_trie_node_t* ) * node->children_count );
+        }
+
+        XI_SAFE_FREE( node->children );
+
+        node->children          = children;
+        node->children_capacity = capacity;
+    }
+
+    xi_mqtt_topic_trie_node_t* child =
+        xi_mqtt_topic_trie_make_node( level, level_length );
+
+    if ( NULL == child )
+    {
+        return NULL;
+    }
+
+    memmove( node->children + position + 1, node->children + position,
+             sizeof( xi_mqtt_topic_trie_node_t* ) * ( node->children_count - position ) );
+
+    node->children[position] = child;
+    node->children_count += 1;
+
+    return child;
+}
+
+static xi_mqtt_topic_trie_node_t**
+xi_mqtt_topic_trie_wildcard_slot( xi_mqtt_topic_trie_node_t* node,
+                                  const uint8_t* level,
+                                  size_t level_length )
+{
+    if ( 1 == level_length && '+' == level[0] )
+    {
+        return &node->single_level_child;
+    }
+
+    if ( 1 == level_length && '#' == level[0] )
+    {
+        return &node->multi_level_child;
+    }
+
+    return NULL;
+}
+
+xi_state_t xi_mqtt_topic_trie_insert( xi_mqtt_topic_trie_t* trie,
+                                      const char* topic_filter,
+                                      xi_mqtt_task_specific_data_t* subscription )
+{
+    if ( NULL == trie || NULL == topic_filter || NULL == subscription )
+    {
+        return XI_INVALID_PARAMETER;
+    }
+
+    if ( NULL == trie->root )
+    {
+        trie->root = xi_mqtt_topic_trie_make_node( NULL, 0 );
+
+        if ( NULL == trie->root )
+        {
+            return XI_OUT_OF_MEMORY;
+        }
+    }
+
+    const uint8_t* level            = ( const uint8_t* )topic_filter;
+    xi_mqtt_topic_trie_node_t* node = trie->root;
+
+    for ( ;; )
+    {
+        const uint8_t* level_end = ( const uint8_t* )strchr( ( const char* )level, '/' );
+        const size_t level_length =
+            ( NULL == level_end ) ? strlen( ( const char* )level )
+                                  : ( size_t )( level_end - level );
+
+        xi_mqtt_topic_trie_node_t** wildcard_slot =
+            xi_mqtt_topic_trie_wildcard_slot( node, level, level_length );
+
+        /* '#' has to be the last level of the filter */
+        if ( &node->multi_level_child == wildcard_slot && NULL != level_end )
+        {
+            return XI_INVALID_PARAMETER;
+        }
+
+        if ( NULL != wildcard_slot )
+        {
+            if ( NULL == *wildcard_slot )
+            {
+                *wildcard_slot = xi_mqtt_topic_trie_make_node( level, level_length );
+            }
+
+            node = *wildcard_slot;
+        }
+        else
+        {
+            node = xi_mqtt_topic_trie_get_or_add_child( node, level, level_length );
+        }
+
+        if ( NULL == node )
+        {
+            return XI_OUT_OF_MEMORY;
+        }
+
+        if ( NULL == level_end )
+        {
+            break;
+        }
+
+        level = level_end + 1;
+    }
+
+    if ( NULL == node->subscription )
+    {
+        node->subscription = subscription;
+    }
+
+    return XI_STATE_OK;
+}
+
+static xi_mqtt_task_specific_data_t*
+xi_mqtt_topic_trie_match_node( const xi_mqtt_topic_trie_node_t* node,
+                               const uint8_t* level,
+                               const uint8_t* topic_end,
+                               uint8_t is_first_level );
+
+static xi_mqtt_task_specific_data_t*
+xi_mqtt_topic_trie_match_child( const xi_mqtt_topic_trie_node_t* child,
+                                const uint8_t* next_level,
+                                const uint8_t* topic_end )
+{
+    if ( NULL == child )
+    {
+        return NULL;
+    }
+
+    if ( NULL != next_level )
+    {
+        return xi_mqtt_topic_trie_match_node( child, next_level, topic_end, 0 );
+    }
+
+    /* 'a/#' matches 'a' as well */
+    if ( NULL == child->subscription && NULL != child->multi_level_child )
+    {
+        return child->multi_level_child->subscription;
+    }
+
+    return child->subscription;
+}
+
+static xi_mqtt_task_specific_data_t*
+xi_mqtt_topic_trie_match_node( const xi_mqtt_topic_trie_node_t* node,
+                               const uint8_t* level,
+                               const uint8_t* topic_end,
+                               uint8_t is_first_level )
+{
+    const uint8_t* level_end =
+        ( const uint8_t* )memchr( level, '/', ( size_t )( topic_end - level ) );
+    const uint8_t* next_level = ( NULL == level_end ) ? NULL : level_end + 1;
+
+    if ( NULL == level_end )
+    {
+        level_end = topic_end;
+    }
+
+    const size_t level_length = ( size_t )( level_end - level );
+
+    xi_mqtt_task_specific_data_t* matched = xi_mqtt_topic_trie_match_child(
+        xi_mqtt_topic_trie_find_child( node, level, level_length ), next_level,
+        topic_end );
+
+    if ( NULL != matched )
+    {
+        return matched;
+    }
+
+    /* topics like $SYS are not matched by wildcards on the first level */
+    if ( 1 == is_first_level && 0 < level_length && '$' == level[0] )
+    {
+        return NULL;
+    }
+
+    matched =
+        xi_mqtt_topic_trie_match_child( node->single_level_child, next_level, topic_end );
+
+    if ( NULL != matched )
+    {
+        return matched;
+    }
+
+    return ( NULL != node->multi_level_child ) ? node->multi_level_child->subscription
+                                               : NULL;
+}
+
+xi_mqtt_task_specific_data_t* xi_mqtt_topic_trie_match( const xi_mqtt_topic_trie_t* trie,
+                                                        const uint8_t* topic,
+                                                        size_t topic_length )
+{
+    if ( NULL == trie || NULL == trie->root || NULL == topic )
+    {
+        return NULL;
+    }
+
+    return xi_mqtt_topic_trie_match_node( trie->root, topic, topic + topic_length, 1 );
+}
+
+static void xi_mqtt_topic_trie_free_node( xi_mqtt_topic_trie_node_t* node )
+{
+    if ( NULL == node )
+    {
+        return;
+    }
+
+    uint32_t i = 0;
+    for ( ; i < node->children_count; ++i )
+    {
+        xi_mqtt_topic_trie_free_node( node->children[i] );
+    }
+
+    xi_mqtt_topic_trie_free_node( node->single_level_child );
+    xi_mqtt_topic_trie_free_node( node->multi_level_child );
+
+    XI_SAFE_FREE( node->children );
+    XI_SAFE_FREE( node );
+}
+
+void xi_mqtt_topic_trie_clear( xi_mqtt_topic_trie_t* trie )
+{
+    assert( NULL != trie );
+
+    xi_mqtt_topic_trie_free_node( trie->root );
+    trie->root = NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
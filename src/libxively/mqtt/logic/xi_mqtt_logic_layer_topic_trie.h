@@ -0,0 +1,74 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#ifndef __XI_MQTT_LOGIC_LAYER_TOPIC_TRIE_H__
+#define __XI_MQTT_LOGIC_LAYER_TOPIC_TRIE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xi_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+union xi_mqtt_task_specific_data_u;
+struct xi_mqtt_topic_trie_node_s;
+
+/*
+ * Subscriptions organised by topic levels. Every node stands for one level of a topic
+ * filter, the literal children are kept sorted so each level of an incoming topic is
+ * resolved with a binary search, the '+' and '#' children are kept aside. The trie
+ * only references the subscriptions, their memory is owned by handlers_for_topics. A
+ * zeroed structure is a valid empty trie.
+ */
+typedef struct xi_mqtt_topic_trie_s
+{
+    struct xi_mqtt_topic_trie_node_s* root;
+} xi_mqtt_topic_trie_t;
+
+/**
+ * @brief xi_mqtt_topic_trie_insert
+ *
+ * Registers the subscription under its topic filter, which may contain the '+' and
+ * '#' wildcards. If the very same filter is already registered the earlier
+ * subscription is kept.
+ *
+ * @return XI_STATE_OK, XI_INVALID_PARAMETER for a malformed filter or
+ * XI_OUT_OF_MEMORY
+ */
+xi_state_t xi_mqtt_topic_trie_insert( xi_mqtt_topic_trie_t* trie,
+                                      const char* topic_filter,
+                                      union xi_mqtt_task_specific_data_u* subscription );
+
+/**
+ * @brief xi_mqtt_topic_trie_match
+ *
+ * Finds the subscription for a topic a PUBLISH arrived on. If more than one filter
+ * matches, the most specific one wins: on each level a literal match is preferred over
+ * '+' which is preferred over '#'. As in MQTT, wildcards on the first level do not
+ * match topics starting with '$'.
+ *
+ * @return the matching subscription or NULL
+ */
+union xi_mqtt_task_specific_data_u*
+xi_mqtt_topic_trie_match( const xi_mqtt_topic_trie_t* trie,
+                          const uint8_t* topic,
+                          size_t topic_length );
+
+/**
+ * @brief xi_mqtt_topic_trie_clear
+ *
+ * Releases all the nodes, the subscriptions are not touched.
+ */
+void xi_mqtt_topic_trie_clear( xi_mqtt_topic_trie_t* trie );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __XI_MQTT_LOGIC_LAYER_TOPIC_TRIE_H__ */
@@ -4,9 +4,51 @@
  * it is licensed under the BSD 3-Clause license.
  */
 
+#include <unistd.h>
+
 #include "xi_thread_threadpool.h"
 #include <xi_thread_posix_workerthread.h>
 
+/* wakes the owner of the any-thread queue up, or another workerthread to steal the new
+ * handle if the owner is busy */
+static xi_state_t
+xi_threadpool_on_new_anythread_event( void* threadpool_ptr, void* workerthread_ptr )
+{
+    xi_threadpool_t* threadpool     = ( xi_threadpool_t* )threadpool_ptr;
+    xi_workerthread_t* workerthread = ( xi_workerthread_t* )workerthread_ptr;
+
+    /* the workerthreads are being destroyed, see xi_threadpool_destroy_instance */
+    if ( !xi_evtd_dispatcher_continue( workerthread->thread_evtd_secondary ) ||
+         xi_workerthread_wake_up( workerthread ) )
+    {
+        return XI_STATE_OK;
+    }
+
+    xi_vector_index_type_t counter_workerthread = 0;
+    for ( ; counter_workerthread < threadpool->workerthreads->elem_no;
+          ++counter_workerthread )
+    {
+        xi_workerthread_t* other_workerthread =
+            ( xi_workerthread_t* )threadpool->workerthreads->array[counter_workerthread]
+                .selector_t.ptr_value;
+
+        if ( other_workerthread != workerthread &&
+             xi_workerthread_wake_up( other_workerthread ) )
+        {
+            break;
+        }
+    }
+
+    return XI_STATE_OK;
+}
+
+uint8_t xi_threadpool_get_num_of_cores( void )
+{
+    const long num_of_cores = sysconf( _SC_NPROCESSORS_ONLN );
+
+    return ( uint8_t )XI_MIN( XI_MAX( num_of_cores, 1 ), XI_THREADPOOL_MAXNUMOFTHREADS );
+}
+
 xi_threadpool_t* xi_threadpool_create_instance( uint8_t num_of_threads )
 {
     num_of_threads = XI_MIN( XI_MAX( num_of_threads, 1 ), XI_THREADPOOL_MAXNUMOFTHREADS );
@@ -14,11 +56,6 @@ xi_threadpool_t* xi_threadpool_create_instance( uint8_t num_of_threads )
     xi_state_t state = XI_STATE_OK;
     XI_ALLOC( xi_threadpool_t, threadpool, state );
 
-    threadpool->threadpool_evtd = xi_evtd_create_instance();
-
-    XI_CHECK_CND_DBGMESSAGE( threadpool->threadpool_evtd == NULL, XI_OUT_OF_MEMORY, state,
-                             "could not create event dispatcher for threadpool" );
-
     threadpool->workerthreads = xi_vector_create();
 
     XI_CHECK_CND_DBGMESSAGE( threadpool->workerthreads == NULL, XI_OUT_OF_MEMORY, state,
@@ -30,11 +67,25 @@ xi_threadpool_t* xi_threadpool_create_instance( uint8_t num_of_threads )
         result == 0, XI_OUT_OF_MEMORY, state,
         "could not reserve enough space in vector for workerthreads" );
 
+    /* all queues have to exist before the first workerthread starts stealing */
     uint8_t counter_workerthread = 0;
     for ( ; counter_workerthread < num_of_threads; ++counter_workerthread )
+    {
+        threadpool->anythread_evtds[counter_workerthread] = xi_evtd_create_instance();
+
+        XI_CHECK_CND_DBGMESSAGE( threadpool->anythread_evtds[counter_workerthread] ==
+                                     NULL,
+                                 XI_OUT_OF_MEMORY, state,
+                                 "could not create event dispatcher for threadpool" );
+    }
+
+    for ( counter_workerthread = 0; counter_workerthread < num_of_threads;
+          ++counter_workerthread )
     {
         xi_workerthread_t* new_workerthread =
-            xi_workerthread_create_instance( threadpool->threadpool_evtd );
+            xi_workerthread_create_instance_in_threadpool(
+                threadpool->anythread_evtds[counter_workerthread],
+                threadpool->anythread_evtds, num_of_threads );
 
         XI_CHECK_CND_DBGMESSAGE( new_workerthread == NULL, XI_OUT_OF_MEMORY, state,
                                  "could not allocate a workerthread" );
@@ -44,9 +95,21 @@ xi_threadpool_t* xi_threadpool_create_instance( uint8_t num_of_threads )
             XI_VEC_CONST_VALUE_PARAM( XI_VEC_VALUE_PTR( new_workerthread ) ) );
     }
 
+    for ( counter_workerthread = 0; counter_workerthread < num_of_threads;
+          ++counter_workerthread )
+    {
+        xi_evtd_notify_on_new_event(
+            threadpool->anythread_evtds[counter_workerthread],
+            xi_make_handle( &xi_threadpool_on_new_anythread_event, threadpool,
+                            threadpool->workerthreads->array[counter_workerthread]
+                                .selector_t.ptr_value ) );
+    }
+
     return threadpool;
 
 err_handling:
+    xi_threadpool_destroy_instance( &threadpool );
+
     return NULL;
 }
 
@@ -57,11 +120,24 @@ void xi_threadpool_destroy_instance( xi_threadpool_t** threadpool )
 
     xi_threadpool_t* threadpool_ptr = *threadpool;
 
+    uint8_t counter_evtd = 0;
+
     if ( threadpool_ptr->workerthreads != NULL )
     {
+        /* no more wake ups nor stealing, the remaining any-thread handlers are
+         * executed below */
+        for ( counter_evtd = 0; counter_evtd < XI_THREADPOOL_MAXNUMOFTHREADS;
+              ++counter_evtd )
+        {
+            if ( threadpool_ptr->anythread_evtds[counter_evtd] != NULL )
+            {
+                xi_evtd_stop( threadpool_ptr->anythread_evtds[counter_evtd] );
+            }
+        }
+
         /* stop all workerthreads in advance their destroy to avoid summing up join
          * times at destruction with that all thread exits are done parallelly */
-        uint8_t counter_workerthread = 0;
+        xi_vector_index_type_t counter_workerthread = 0;
         for ( ; counter_workerthread < threadpool_ptr->workerthreads->elem_no;
               ++counter_workerthread )
         {
@@ -81,27 +157,36 @@ void xi_threadpool_destroy_instance( xi_threadpool_t** threadpool )
                     .selector_t.ptr_value );
         }
 
-        if ( threadpool_ptr->threadpool_evtd != NULL )
+        xi_vector_destroy( threadpool_ptr->workerthreads );
+    }
+
+    for ( counter_evtd = 0; counter_evtd < XI_THREADPOOL_MAXNUMOFTHREADS; ++counter_evtd )
+    {
+        if ( threadpool_ptr->anythread_evtds[counter_evtd] != NULL )
         {
             /* ensure all any-thread handlers are executed before destroy */
-            xi_evtd_step( threadpool_ptr->threadpool_evtd, time( 0 ) );
+            xi_evtd_step_ticks( threadpool_ptr->anythread_evtds[counter_evtd],
+                                xi_evtd_get_current_time_ticks() );
+            xi_evtd_destroy_instance( threadpool_ptr->anythread_evtds[counter_evtd] );
         }
-
-        xi_vector_destroy( threadpool_ptr->workerthreads );
     }
 
-    xi_evtd_destroy_instance( threadpool_ptr->threadpool_evtd );
-
     XI_SAFE_FREE( *threadpool );
 }
 
 xi_event_handle_queue_t*
 xi_threadpool_execute( xi_threadpool_t* threadpool, xi_event_handle_t handle )
 {
-    if ( threadpool == NULL || threadpool->threadpool_evtd == NULL )
+    if ( threadpool == NULL || threadpool->workerthreads == NULL ||
+         threadpool->workerthreads->elem_no == 0 )
         return NULL;
 
-    return xi_evtd_execute( threadpool->threadpool_evtd, handle );
+    /* spread the handles over the queues, idle workerthreads steal from busy ones */
+    const uint32_t id_anythread_evtd =
+        __sync_fetch_and_add( &threadpool->next_anythread_evtd, 1 ) %
+        threadpool->workerthreads->elem_no;
+
+    return xi_evtd_execute( threadpool->anythread_evtds[id_anythread_evtd], handle );
 }
 
 xi_event_handle_queue_t* xi_threadpool_execute_on_thread( xi_threadpool_t* threadpool,
@@ -6,12 +6,101 @@
 
 #include <unistd.h>
 #include <errno.h>
+#include <time.h>
 
 #include <xi_thread_posix_workerthread.h>
 
-#define XI_THREAD_WORKERTHREAD_RESTTIME_IN_NANOSECONDS 10000000;         // 1/100 sec
 #define XI_THREAD_WORKERTHREAD_WAITFORSYNCTIME_IN_NANOSECONDS 100000000; // 1/10 sec
 
+/* the longest the thread sleeps without being woken up, only matters for the events of
+ * a secondary evtd whose owner does not call xi_workerthread_wake_up */
+#define XI_THREAD_WORKERTHREAD_MAX_SLEEPTIME_IN_MILLISECONDS 100
+
+static xi_state_t xi_workerthread_on_new_event( xi_event_handle_arg1_t ctx )
+{
+    xi_workerthread_wake_up( ( xi_workerthread_t* )ctx );
+
+    return XI_STATE_OK;
+}
+
+/* sleeps until the thread is woken up or the earliest time event of its primary evtd
+ * is due, whichever comes first */
+static void xi_workerthread_sleep( xi_workerthread_t* workerthread )
+{
+    xi_time_t sleep_ms             = XI_THREAD_WORKERTHREAD_MAX_SLEEPTIME_IN_MILLISECONDS;
+    xi_time_t earliest_event_ticks = 0;
+
+    if ( XI_STATE_OK == xi_evtd_get_time_of_earliest_event( workerthread->thread_evtd,
+                                                             &earliest_event_ticks ) )
+    {
+        const xi_time_t now_ticks = xi_evtd_get_current_time_ticks();
+
+        sleep_ms = ( earliest_event_ticks <= now_ticks )
+                       ? 0
+                       : XI_MIN( sleep_ms, XI_EVTD_TICKS_TO_MILLISECONDS(
+                                               earliest_event_ticks - now_ticks ) );
+    }
+
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    struct timespec deadline;
+    deadline.tv_sec  = now.tv_sec + sleep_ms / 1000;
+    deadline.tv_nsec = now.tv_nsec + ( sleep_ms % 1000 ) * 1000000;
+
+    if ( deadline.tv_nsec >= 1000000000 )
+    {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock( &workerthread->wakeup_mutex );
+
+    workerthread->sleeping = 1;
+
+    int ret_wait = 0;
+    while ( 0 == workerthread->wakeup_pending && 0 < sleep_ms && ETIMEDOUT != ret_wait )
+    {
+        ret_wait = pthread_cond_timedwait( &workerthread->wakeup_cond,
+                                           &workerthread->wakeup_mutex, &deadline );
+    }
+
+    /* anything added from now on is seen by the next step */
+    workerthread->wakeup_pending = 0;
+    workerthread->sleeping       = 0;
+
+    pthread_mutex_unlock( &workerthread->wakeup_mutex );
+}
+
+/* executes a single handle of the first steal evtd having one, starting after the one
+ * stolen from last time, returns 1 if there was a handle */
+static uint8_t xi_workerthread_steal( xi_workerthread_t* workerthread )
+{
+    uint8_t counter_steal_evtd = 0;
+    for ( ; counter_steal_evtd < workerthread->steal_evtds_count; ++counter_steal_evtd )
+    {
+        const uint8_t id_steal_evtd =
+            ( workerthread->steal_evtds_next + counter_steal_evtd ) %
+            workerthread->steal_evtds_count;
+
+        xi_evtd_instance_t* steal_evtd = workerthread->steal_evtds[id_steal_evtd];
+
+        if ( steal_evtd == workerthread->thread_evtd_secondary ||
+             !xi_evtd_dispatcher_continue( steal_evtd ) )
+        {
+            continue;
+        }
+
+        if ( xi_evtd_single_step_ticks( steal_evtd, xi_evtd_get_current_time_ticks() ) )
+        {
+            workerthread->steal_evtds_next = id_steal_evtd;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 void* xi_workerthread_start_routine( void* ctx )
 {
     xi_state_t state = XI_STATE_OK;
@@ -25,35 +114,69 @@ void* xi_workerthread_start_routine( void* ctx )
     corresponding_workerthread->sync_start_flag = 1;
     xi_debug_format( "[%p] sync point passed", pthread_self() );
 
-    struct timespec deltatime;
-    deltatime.tv_sec  = 0;
-    deltatime.tv_nsec = XI_THREAD_WORKERTHREAD_RESTTIME_IN_NANOSECONDS;
-
-    /* simple event loop impl, just executes all handlers in event dispatcher
-     * in each 1/100 sec */
+    /* simple event loop impl, executes all handlers in event dispatcher and sleeps
+     * until there is something new to do */
     while ( xi_evtd_dispatcher_continue( corresponding_workerthread->thread_evtd ) )
     {
         /* consume all handles of evtd */
-        xi_evtd_step( corresponding_workerthread->thread_evtd, time( 0 ) );
+        xi_evtd_step_ticks( corresponding_workerthread->thread_evtd,
+                            xi_evtd_get_current_time_ticks() );
+
+        uint8_t secondary_handle_executed = 0;
+
         /* consume a single handle of secondary evtd */
         if ( xi_evtd_dispatcher_continue(
                  corresponding_workerthread->thread_evtd_secondary ) )
         {
-            xi_evtd_single_step( corresponding_workerthread->thread_evtd_secondary,
-                                 time( 0 ) );
+            secondary_handle_executed = xi_evtd_single_step_ticks(
+                corresponding_workerthread->thread_evtd_secondary,
+                xi_evtd_get_current_time_ticks() );
+        }
+
+        /* help out the other threads of the threadpool */
+        if ( 0 == secondary_handle_executed )
+        {
+            secondary_handle_executed =
+                xi_workerthread_steal( corresponding_workerthread );
+        }
+
+        /* the secondary evtds may have more handles, go on without sleeping */
+        if ( 0 == secondary_handle_executed )
+        {
+            xi_workerthread_sleep( corresponding_workerthread );
         }
-        /* let thread rest a little */
-        nanosleep( &deltatime, NULL );
     }
 
     /* ensuring execution of handlers added right before turning of event dispatcher */
-    xi_evtd_step( corresponding_workerthread->thread_evtd, time( 0 ) );
+    xi_evtd_step_ticks( corresponding_workerthread->thread_evtd,
+                        xi_evtd_get_current_time_ticks() );
 
 err_handling:
     return NULL;
 }
 
+uint8_t xi_workerthread_wake_up( xi_workerthread_t* workerthread )
+{
+    pthread_mutex_lock( &workerthread->wakeup_mutex );
+
+    const uint8_t was_sleeping   = workerthread->sleeping;
+    workerthread->wakeup_pending = 1;
+    pthread_cond_signal( &workerthread->wakeup_cond );
+
+    pthread_mutex_unlock( &workerthread->wakeup_mutex );
+
+    return was_sleeping;
+}
+
 xi_workerthread_t* xi_workerthread_create_instance( xi_evtd_instance_t* evtd_secondary )
+{
+    return xi_workerthread_create_instance_in_threadpool( evtd_secondary, NULL, 0 );
+}
+
+xi_workerthread_t* xi_workerthread_create_instance_in_threadpool(
+    xi_evtd_instance_t* evtd_secondary,
+    xi_evtd_instance_t** steal_evtds,
+    uint8_t steal_evtds_count )
 {
     xi_state_t state = XI_STATE_OK;
     XI_ALLOC( xi_workerthread_t, new_workerthread_instance, state );
@@ -65,6 +188,21 @@ xi_workerthread_t* xi_workerthread_create_instance( xi_evtd_instance_t* evtd_sec
         "could not create event dispatcher for new xi_workerthread instance" );
 
     new_workerthread_instance->thread_evtd_secondary = evtd_secondary;
+    new_workerthread_instance->steal_evtds           = steal_evtds;
+    new_workerthread_instance->steal_evtds_count     = steal_evtds_count;
+
+    pthread_mutex_init( &new_workerthread_instance->wakeup_mutex, NULL );
+
+    /* the sleep deadline is taken from the same monotonic clock as the evtd ticks */
+    pthread_condattr_t wakeup_cond_attr;
+    pthread_condattr_init( &wakeup_cond_attr );
+    pthread_condattr_setclock( &wakeup_cond_attr, CLOCK_MONOTONIC );
+    pthread_cond_init( &new_workerthread_instance->wakeup_cond, &wakeup_cond_attr );
+    pthread_condattr_destroy( &wakeup_cond_attr );
+
+    xi_evtd_notify_on_new_event(
+        new_workerthread_instance->thread_evtd,
+        xi_make_handle( &xi_workerthread_on_new_event, new_workerthread_instance ) );
 
     const int ret_pthread_create =
         pthread_create( &new_workerthread_instance->thread, NULL,
@@ -74,6 +212,9 @@ xi_workerthread_t* xi_workerthread_create_instance( xi_evtd_instance_t* evtd_sec
     {
         xi_debug_format( "creation of pthread instance failed with error: %d",
                          ret_pthread_create );
+
+        pthread_cond_destroy( &new_workerthread_instance->wakeup_cond );
+        pthread_mutex_destroy( &new_workerthread_instance->wakeup_mutex );
         goto err_handling;
     }
 
@@ -103,6 +244,9 @@ void xi_workerthread_destroy_instance( xi_workerthread_t** workerthread )
         xi_evtd_destroy_instance( ( *workerthread )->thread_evtd );
     }
 
+    pthread_cond_destroy( &( *workerthread )->wakeup_cond );
+    pthread_mutex_destroy( &( *workerthread )->wakeup_mutex );
+
     XI_SAFE_FREE( *workerthread );
 }
 
@@ -15,8 +15,32 @@ typedef struct xi_workerthread_s
     xi_evtd_instance_t* thread_evtd;
     xi_evtd_instance_t* thread_evtd_secondary;
 
+    /* evtds the thread takes single handles from while its own evtds are empty, its
+     * secondary evtd may be one of them */
+    xi_evtd_instance_t** steal_evtds;
+    uint8_t steal_evtds_count;
+    uint8_t steal_evtds_next;
+
     pthread_t thread;
     uint8_t sync_start_flag;
+
+    /* the thread sleeps on wakeup_cond until wakeup_pending is set or its earliest
+     * time event is due, both are guarded by wakeup_mutex */
+    pthread_mutex_t wakeup_mutex;
+    pthread_cond_t wakeup_cond;
+    uint8_t wakeup_pending;
+    uint8_t sleeping;
 } xi_workerthread_t;
 
+/**
+ * @brief creates a workerthread of a threadpool
+ *
+ * Same as xi_workerthread_create_instance, in addition the thread steals from the
+ * steal_evtds, none of which is owned by the workerthread. The array has to outlive it.
+ */
+xi_workerthread_t* xi_workerthread_create_instance_in_threadpool(
+    xi_evtd_instance_t* evtd_secondary,
+    xi_evtd_instance_t** steal_evtds,
+    uint8_t steal_evtds_count );
+
 #endif /* __XI_THREAD_POSIX_WORKERTHREAD_H__ */
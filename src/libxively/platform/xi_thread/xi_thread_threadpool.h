@@ -13,15 +13,29 @@
 #include <xi_event_dispatcher_api.h>
 #include <xi_vector.h>
 
+#ifndef XI_THREADPOOL_MAXNUMOFTHREADS
 #define XI_THREADPOOL_MAXNUMOFTHREADS 10
+#endif
+
+/* the number of workerthreads of the library's threadpool, 0 means one per online
+ * core, both are capped at XI_THREADPOOL_MAXNUMOFTHREADS */
+#ifndef XI_THREADPOOL_NUMOFTHREADS
+#define XI_THREADPOOL_NUMOFTHREADS 1
+#endif
 
 /**
  * @brief threadpool, owns workerthreads, coordinates event executions
+ *
+ * Every workerthread has its own queue of any-thread events in anythread_evtds, at the
+ * same index as in workerthreads. The events are spread over the queues and a
+ * workerthread running out of events takes them from the other queues.
  */
 typedef struct xi_threadpool_s
 {
     xi_vector_t* workerthreads;
-    xi_evtd_instance_t* threadpool_evtd;
+    xi_evtd_instance_t* anythread_evtds[XI_THREADPOOL_MAXNUMOFTHREADS];
+    /* the queue of the next any-thread event, modulo the number of workerthreads */
+    uint32_t next_anythread_evtd;
 } xi_threadpool_t;
 
 /**
@@ -33,6 +47,12 @@ typedef struct xi_threadpool_s
  */
 xi_threadpool_t* xi_threadpool_create_instance( uint8_t num_of_threads );
 
+/**
+ * @brief the number of online cores, at least 1 and at most
+ * XI_THREADPOOL_MAXNUMOFTHREADS
+ */
+uint8_t xi_threadpool_get_num_of_cores( void );
+
 /**
  * @brief destroys a threadpool instance
  *
@@ -16,7 +16,10 @@ struct xi_workerthread_s;
  *
  * @param evtd_secondary secondary event source. Workerthread does not own this evtd
  * neither ensures all event processing upon destruction. Workerthread simply
- * consumes a SINGLE event of this secondary evtd in each loop.
+ * consumes a SINGLE event of this secondary evtd in each loop. Events added to the
+ * primary evtd wake the thread up, the owner of the secondary evtd has to call
+ * xi_workerthread_wake_up for its events, otherwise they are only noticed when the
+ * thread wakes up for another reason.
  */
 struct xi_workerthread_s*
 xi_workerthread_create_instance( xi_evtd_instance_t* evtd_secondary );
@@ -40,5 +43,16 @@ void xi_workerthread_destroy_instance( struct xi_workerthread_s** workerthread )
  */
 uint8_t xi_workerthread_wait_sync_point( struct xi_workerthread_s* workerthread );
 
+/**
+ * @brief wakes the workerthread up
+ *
+ * The workerthread sleeps while both of its evtds are empty and until its earliest
+ * time event is due. It checks both evtds once after this call, safe to call from
+ * any thread.
+ *
+ * @retval 1 the workerthread was sleeping
+ * @retval 0 the workerthread was busy
+ */
+uint8_t xi_workerthread_wake_up( struct xi_workerthread_s* workerthread );
 
 #endif /* __XI_THREAD_WORKERTHREAD_H__ */
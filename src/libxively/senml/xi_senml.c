@@ -53,6 +53,22 @@ err_handling:
     return state;
 }
 
+xi_state_t xi_senml_serialize_to_buffer( xi_senml_t* senml_structure,
+                                         uint8_t* buffer,
+                                         uint32_t buffer_size,
+                                         uint32_t* out_size )
+{
+    if ( NULL == out_size )
+    {
+        return XI_INVALID_PARAMETER;
+    }
+
+    *out_size = 0;
+
+    return xi_senml_json_serialize_to_buffer( senml_structure, buffer, buffer_size,
+                                              out_size );
+}
+
 xi_state_t xi_senml_free_buffer( uint8_t** buffer )
 {
     if ( NULL == buffer )
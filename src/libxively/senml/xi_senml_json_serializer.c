@@ -35,17 +35,442 @@ static const char xi_senml_pat_entry_time[]            = "\"t\":";
 static const char xi_senml_pat_entry_update_time[]     = "\"ut\":";
 static const char xi_senml_pat_entry_close[]           = "}";
 
+/* length of a pattern without the terminating zero */
+#define XI_SENML_PAT_LEN( pat ) ( sizeof( pat ) - 1 )
+
+/* fits the longest number printed: "-2147483648" or e.g. "-1.1755e-38" */
+#define XI_SENML_NUMBER_BUF_SIZE 16
+
+/* significant digits of the floats, same as printf's "%.5g" */
+#define XI_SENML_FLOAT_DIGITS 5
+
+/*
+ * A descriptor without a buffer doesn't store what is appended to it only counts its
+ * length, that is how xi_senml_json_serialize learns the size to allocate.
+ */
+static xi_state_t
+xi_senml_json_append( xi_data_desc_t* out, const char* const data, const size_t len )
+{
+    if ( NULL == out->data_ptr )
+    {
+        out->length += len;
+        return XI_STATE_OK;
+    }
+
+    return xi_data_desc_append_data_resize( out, data, len );
+}
+
+/* unsigned integer big enough for every float scaled to 5 digits, least significant
+ * limb first */
+typedef struct xi_senml_json_bignum_s
+{
+    uint32_t limbs[8];
+    size_t size;
+} xi_senml_json_bignum_t;
+
+static void xi_senml_json_bignum_trim( xi_senml_json_bignum_t* n )
+{
+    while ( 0 < n->size && 0 == n->limbs[n->size - 1] )
+    {
+        --n->size;
+    }
+}
+
+static void xi_senml_json_bignum_mul_small( xi_senml_json_bignum_t* n, uint32_t factor )
+{
+    uint64_t carry = 0;
+    size_t i       = 0;
+
+    for ( ; i < n->size; ++i )
+    {
+        carry        = ( uint64_t )n->limbs[i] * factor + carry;
+        n->limbs[i]  = ( uint32_t )carry;
+        carry      >>= 32;
+    }
+
+    if ( 0 != carry )
+    {
+        assert( n->size < XI_ARRAYSIZE( n->limbs ) );
+        n->limbs[n->size++] = ( uint32_t )carry;
+    }
+}
+
+/* returns the remainder */
+static uint32_t
+xi_senml_json_bignum_div_small( xi_senml_json_bignum_t* n, uint32_t divisor )
+{
+    uint64_t remainder = 0;
+    size_t i           = n->size;
+
+    while ( i-- > 0 )
+    {
+        remainder   = ( remainder << 32 ) | n->limbs[i];
+        n->limbs[i] = ( uint32_t )( remainder / divisor );
+        remainder  %= divisor;
+    }
+
+    xi_senml_json_bignum_trim( n );
+
+    return ( uint32_t )remainder;
+}
+
+static void xi_senml_json_bignum_shift_left( xi_senml_json_bignum_t* n, size_t bits )
+{
+    const size_t limb_shift = bits / 32;
+    const size_t bit_shift  = bits % 32;
+    size_t i                = n->size + limb_shift + 1;
+
+    assert( i <= XI_ARRAYSIZE( n->limbs ) );
+
+    while ( i-- > 0 )
+    {
+        const uint32_t high = ( i >= limb_shift && i - limb_shift < n->size )
+                                  ? n->limbs[i - limb_shift]
+                                  : 0;
+        const uint32_t low = ( 0 != bit_shift && i > limb_shift &&
+                               i - limb_shift - 1 < n->size )
+                                 ? n->limbs[i - limb_shift - 1] >> ( 32 - bit_shift )
+                                 : 0;
+
+        n->limbs[i] = ( 0 != bit_shift ? high << bit_shift : high ) | low;
+    }
+
+    n->size += limb_shift + 1;
+    xi_senml_json_bignum_trim( n );
+}
+
+/* returns the bit shifted out last, sets *sticky if any other shifted out bit was set */
+static uint32_t xi_senml_json_bignum_shift_right( xi_senml_json_bignum_t* n,
+                                                  size_t bits,
+                                                  uint8_t* sticky )
+{
+    const size_t limb_shift = bits / 32;
+    const size_t bit_shift  = bits % 32;
+    const size_t last_limb  = ( bits - 1 ) / 32;
+    const uint32_t last_pos = ( bits - 1 ) % 32;
+    uint32_t last_bit       = 0;
+    size_t i                = 0;
+
+    assert( 0 < bits );
+
+    if ( last_limb < n->size )
+    {
+        last_bit = ( n->limbs[last_limb] >> last_pos ) & 1;
+
+        if ( 0 != ( n->limbs[last_limb] & ( ( 1u << last_pos ) - 1 ) ) )
+        {
+            *sticky = 1;
+        }
+    }
+
+    for ( i = 0; i < last_limb && i < n->size; ++i )
+    {
+        if ( 0 != n->limbs[i] )
+        {
+            *sticky = 1;
+        }
+    }
+
+    for ( i = 0; i + limb_shift < n->size; ++i )
+    {
+        const uint32_t low = n->limbs[i + limb_shift];
+        const uint32_t high =
+            ( 0 != bit_shift && i + limb_shift + 1 < n->size )
+                ? n->limbs[i + limb_shift + 1] << ( 32 - bit_shift )
+                : 0;
+
+        n->limbs[i] = ( low >> bit_shift ) | high;
+    }
+
+    n->size = ( limb_shift < n->size ) ? n->size - limb_shift : 0;
+    xi_senml_json_bignum_trim( n );
+
+    return last_bit;
+}
+
+/**
+ * @brief divides mantissa * 2^exponent * 10^scale to the integer part and returns how
+ * the remainder relates to the half of the divisor: -1 less, 0 equal, 1 greater
+ *
+ * Exact for any float so the rounding is the same as printf's.
+ **/
+static int xi_senml_json_float_scale( uint32_t mantissa,
+                                      int exponent,
+                                      int scale,
+                                      uint64_t* integer_part )
+{
+    xi_senml_json_bignum_t n = {{mantissa}, 1};
+    uint32_t top_removed     = 0;
+    uint8_t sticky           = 0;
+    size_t i                 = 0;
+
+    if ( 0 < exponent )
+    {
+        xi_senml_json_bignum_shift_left( &n, exponent );
+    }
+
+    for ( ; scale >= 9; scale -= 9 )
+    {
+        xi_senml_json_bignum_mul_small( &n, 1000000000 );
+    }
+
+    for ( ; scale > 0; --scale )
+    {
+        xi_senml_json_bignum_mul_small( &n, 10 );
+    }
+
+    if ( 0 > exponent )
+    {
+        top_removed = xi_senml_json_bignum_shift_right( &n, -exponent, &sticky );
+    }
+
+    if ( 0 > scale )
+    {
+        /* bits shifted out above are less than a unit of the last digit removed */
+        sticky = sticky || 0 != top_removed;
+
+        for ( ; scale < -9; scale += 9 )
+        {
+            if ( 0 != xi_senml_json_bignum_div_small( &n, 1000000000 ) )
+            {
+                sticky = 1;
+            }
+        }
+
+        for ( ; scale < -1; ++scale )
+        {
+            if ( 0 != xi_senml_json_bignum_div_small( &n, 10 ) )
+            {
+                sticky = 1;
+            }
+        }
+
+        /* the most significant digit removed, halves are 5 here */
+        top_removed = xi_senml_json_bignum_div_small( &n, 10 );
+        top_removed = ( 5 < top_removed ) ? 2 : ( 5 == top_removed ) ? 1 : 0;
+    }
+
+    *integer_part = 0;
+
+    for ( i = 0; i < n.size; ++i )
+    {
+        if ( 2 <= i )
+        {
+            *integer_part = UINT64_MAX;
+            break;
+        }
+
+        *integer_part |= ( uint64_t )n.limbs[i] << ( 32 * i );
+    }
+
+    if ( 2 == top_removed || ( 1 == top_removed && sticky ) )
+    {
+        return 1;
+    }
+
+    return ( 1 == top_removed ) ? 0 : -1;
+}
+
+/* prints the value as "%d" would, returns the length */
+static size_t xi_senml_json_format_int( char* buf, const int32_t value )
+{
+    char digits[10];
+    size_t digits_count = 0;
+    size_t len          = 0;
+    uint32_t magnitude  = ( uint32_t )value;
+
+    if ( 0 > value )
+    {
+        buf[len++] = '-';
+        magnitude  = 0u - magnitude;
+    }
+
+    do
+    {
+        digits[digits_count++] = ( char )( '0' + magnitude % 10 );
+        magnitude /= 10;
+    } while ( 0 != magnitude );
+
+    while ( 0 < digits_count )
+    {
+        buf[len++] = digits[--digits_count];
+    }
+
+    return len;
+}
+
+/* prints the value as "%.5g" would, returns the length */
+static size_t xi_senml_json_format_float( char* buf, const float value )
+{
+    static const uint64_t lower_bound = 10000; /* 10^(XI_SENML_FLOAT_DIGITS - 1) */
+    static const uint64_t upper_bound = 100000;
+
+    char digits[XI_SENML_FLOAT_DIGITS];
+    uint32_t bits          = 0;
+    uint64_t integer_part  = 0;
+    int remainder_vs_half  = 0;
+    int decimal_exponent   = 0;
+    int last_digit         = XI_SENML_FLOAT_DIGITS - 1;
+    size_t len             = 0;
+    int i                  = 0;
+
+    memcpy( &bits, &value, sizeof( bits ) );
+
+    const uint32_t biased_exponent = ( bits >> 23 ) & 0xff;
+    uint32_t mantissa              = bits & 0x7fffff;
+    int exponent                   = -149;
+
+    if ( 0 != ( bits >> 31 ) )
+    {
+        buf[len++] = '-';
+    }
+
+    if ( 0xff == biased_exponent )
+    {
+        memcpy( buf + len, ( 0 != mantissa ) ? "nan" : "inf", 3 );
+        return len + 3;
+    }
+
+    if ( 0 == biased_exponent && 0 == mantissa )
+    {
+        buf[len++] = '0';
+        return len;
+    }
+
+    if ( 0 != biased_exponent )
+    {
+        mantissa |= 0x800000;
+        exponent = ( int )biased_exponent - 150;
+    }
+
+    /* log10(2) ~ 77/256 puts the estimate of the decimal exponent off by one at most */
+    {
+        int binary_exponent = exponent + 23;
+
+        while ( 0 == ( mantissa & 0x800000 ) )
+        {
+            mantissa <<= 1;
+            --exponent;
+            --binary_exponent;
+        }
+
+        decimal_exponent = ( binary_exponent * 77 ) >> 8;
+    }
+
+    /* scale to five digits, the first estimate may be one off either way */
+    for ( ;; )
+    {
+        remainder_vs_half = xi_senml_json_float_scale(
+            mantissa, exponent, XI_SENML_FLOAT_DIGITS - 1 - decimal_exponent,
+            &integer_part );
+
+        if ( integer_part >= upper_bound )
+        {
+            ++decimal_exponent;
+        }
+        else if ( integer_part < lower_bound )
+        {
+            --decimal_exponent;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    /* round half to even */
+    if ( 0 < remainder_vs_half || ( 0 == remainder_vs_half && ( integer_part & 1 ) ) )
+    {
+        ++integer_part;
+
+        if ( upper_bound == integer_part )
+        {
+            integer_part = lower_bound;
+            ++decimal_exponent;
+        }
+    }
+
+    for ( i = XI_SENML_FLOAT_DIGITS - 1; i >= 0; --i )
+    {
+        digits[i] = ( char )( '0' + integer_part % 10 );
+        integer_part /= 10;
+    }
+
+    /* trailing zeros are not printed */
+    while ( 0 < last_digit && '0' == digits[last_digit] )
+    {
+        --last_digit;
+    }
+
+    if ( decimal_exponent < -4 || decimal_exponent >= XI_SENML_FLOAT_DIGITS )
+    {
+        buf[len++] = digits[0];
+
+        if ( 0 < last_digit )
+        {
+            buf[len++] = '.';
+            memcpy( buf + len, digits + 1, last_digit );
+            len += last_digit;
+        }
+
+        buf[len++] = 'e';
+        buf[len++] = ( 0 > decimal_exponent ) ? '-' : '+';
+
+        if ( 0 > decimal_exponent )
+        {
+            decimal_exponent = -decimal_exponent;
+        }
+
+        /* the exponent has two digits at least */
+        if ( 10 > decimal_exponent )
+        {
+            buf[len++] = '0';
+        }
+
+        len += xi_senml_json_format_int( buf + len, decimal_exponent );
+    }
+    else if ( 0 > decimal_exponent )
+    {
+        buf[len++] = '0';
+        buf[len++] = '.';
+
+        for ( i = -1; i > decimal_exponent; --i )
+        {
+            buf[len++] = '0';
+        }
+
+        memcpy( buf + len, digits, last_digit + 1 );
+        len += last_digit + 1;
+    }
+    else
+    {
+        memcpy( buf + len, digits, decimal_exponent + 1 );
+        len += decimal_exponent + 1;
+
+        if ( last_digit > decimal_exponent )
+        {
+            buf[len++] = '.';
+            memcpy( buf + len, digits + decimal_exponent + 1,
+                    last_digit - decimal_exponent );
+            len += last_digit - decimal_exponent;
+        }
+    }
+
+    return len;
+}
+
 xi_state_t xi_senml_json_serialize_init( xi_data_desc_t* out )
 {
     assert( out != 0 );
 
-    return xi_data_desc_append_data_resize( out, xi_senml_pat_open,
-                                            sizeof( xi_senml_pat_open ) - 1 );
+    return xi_senml_json_append( out, xi_senml_pat_open,
+                                 XI_SENML_PAT_LEN( xi_senml_pat_open ) );
 }
 
-xi_state_t xi_senml_json_serialize_key( xi_data_desc_t* out,
-                                        const char* const key,
-                                        uint16_t elem_count )
+static xi_state_t xi_senml_json_serialize_key_with_length( xi_data_desc_t* out,
+                                                           const char* const key,
+                                                           const size_t key_length,
+                                                           uint16_t elem_count )
 {
     assert( out != 0 );
     assert( key != 0 );
@@ -54,17 +479,31 @@ xi_state_t xi_senml_json_serialize_key( xi_data_desc_t* out,
 
     if ( elem_count > 0 )
     {
-        XI_CHECK_STATE( ret_state = xi_data_desc_append_data_resize(
-                            out, xi_senml_pat_coln, sizeof( xi_senml_pat_coln ) - 1 ) );
+        XI_CHECK_STATE( ret_state = xi_senml_json_append(
+                            out, xi_senml_pat_coln,
+                            XI_SENML_PAT_LEN( xi_senml_pat_coln ) ) );
     }
 
-    XI_CHECK_STATE( ret_state =
-                        xi_data_desc_append_data_resize( out, key, strlen( key ) ) );
+    XI_CHECK_STATE( ret_state = xi_senml_json_append( out, key, key_length ) );
 
 err_handling:
     return ret_state;
 }
 
+/* the keys are the patterns above so their lengths are known at compile time */
+#define XI_SENML_JSON_SERIALIZE_PAT_KEY( out, pat, elem_count )                          \
+    xi_senml_json_serialize_key_with_length( out, pat, XI_SENML_PAT_LEN( pat ),          \
+                                             elem_count )
+
+xi_state_t xi_senml_json_serialize_key( xi_data_desc_t* out,
+                                        const char* const key,
+                                        uint16_t elem_count )
+{
+    assert( key != 0 );
+
+    return xi_senml_json_serialize_key_with_length( out, key, strlen( key ), elem_count );
+}
+
 xi_state_t xi_senml_json_serialize_string( xi_data_desc_t* out, const char* const string )
 {
     assert( out != 0 );
@@ -72,14 +511,13 @@ xi_state_t xi_senml_json_serialize_string( xi_data_desc_t* out, const char* cons
 
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_CHECK_STATE( ret_state = xi_data_desc_append_data_resize(
-                        out, xi_senml_pat_quot, sizeof( xi_senml_pat_quot ) - 1 ) );
+    XI_CHECK_STATE( ret_state = xi_senml_json_append(
+                        out, xi_senml_pat_quot, XI_SENML_PAT_LEN( xi_senml_pat_quot ) ) );
 
-    XI_CHECK_STATE(
-        ret_state = xi_data_desc_append_data_resize( out, string, strlen( string ) ) );
+    XI_CHECK_STATE( ret_state = xi_senml_json_append( out, string, strlen( string ) ) );
 
-    XI_CHECK_STATE( ret_state = xi_data_desc_append_data_resize(
-                        out, xi_senml_pat_quot, sizeof( xi_senml_pat_quot ) - 1 ) );
+    XI_CHECK_STATE( ret_state = xi_senml_json_append(
+                        out, xi_senml_pat_quot, XI_SENML_PAT_LEN( xi_senml_pat_quot ) ) );
 
 err_handling:
     return ret_state;
@@ -89,46 +527,23 @@ xi_state_t xi_senml_json_serialize_float( xi_data_desc_t* out, const float value
 {
     assert( out != 0 );
 
-    char buf[32] = {'\0'};
-
-    int ret = snprintf( buf, sizeof( buf ), "%.5g", value );
-
-    if ( ret <= 0 )
-    {
-        return XI_SERIALIZATION_ERROR;
-    }
+    char buf[XI_SENML_NUMBER_BUF_SIZE];
 
-#if 0 /* @TODO to further discussion */
-    if( ret <= sizeof( buf ) )
-    {
-        return XI_TRUNCATION_WARNING;
-    }
-#endif
+    const size_t len = xi_senml_json_format_float( buf, value );
 
-    return xi_data_desc_append_data_resize( out, buf, ret );
+    return xi_senml_json_append( out, buf, len );
 }
 
 xi_state_t xi_senml_json_serialize_int( xi_data_desc_t* out, const uint32_t value )
 {
     assert( out != 0 );
 
-    char buf[32] = {'\0'};
+    char buf[XI_SENML_NUMBER_BUF_SIZE];
 
-    int ret = snprintf( buf, sizeof( buf ), "%d", value );
+    /* printed as signed, the times are passed in here */
+    const size_t len = xi_senml_json_format_int( buf, ( int32_t )value );
 
-    if ( ret <= 0 )
-    {
-        return XI_SERIALIZATION_ERROR;
-    }
-
-#if 0 /* @TODO to further discussion */
-    if( ret <= sizeof( buf ) )
-    {
-        return XI_TRUNCATION_WARNING;
-    }
-#endif
-
-    return xi_data_desc_append_data_resize( out, buf, ret );
+    return xi_senml_json_append( out, buf, len );
 }
 
 xi_state_t xi_senml_json_serialize_boolean( xi_data_desc_t* out, const uint8_t boolean )
@@ -137,12 +552,12 @@ xi_state_t xi_senml_json_serialize_boolean( xi_data_desc_t* out, const uint8_t b
 
     if ( boolean > 0 )
     {
-        return xi_data_desc_append_data_resize( out, xi_senml_pat_true,
-                                                sizeof( xi_senml_pat_true ) - 1 );
+        return xi_senml_json_append( out, xi_senml_pat_true,
+                                 XI_SENML_PAT_LEN( xi_senml_pat_true ) );
     }
 
-    return xi_data_desc_append_data_resize( out, xi_senml_pat_false,
-                                            sizeof( xi_senml_pat_false ) - 1 );
+    return xi_senml_json_append( out, xi_senml_pat_false,
+                                 XI_SENML_PAT_LEN( xi_senml_pat_false ) );
 }
 
 xi_state_t
@@ -154,8 +569,8 @@ xi_senml_json_serialize_name( xi_data_desc_t* out, const char* name, uint16_t el
     xi_state_t ret_state = XI_STATE_OK;
 
     /* elem_count part serialize the key value */
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key( out, xi_senml_pat_entry_name,
-                                                             elem_count ) );
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
+                        out, xi_senml_pat_entry_name, elem_count ) );
 
     /* then the value itself */
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_string( out, name ) );
@@ -172,7 +587,7 @@ xi_state_t xi_senml_json_serialize_float_value( xi_data_desc_t* out,
 
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key(
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
                         out, xi_senml_pat_entry_float_value, elem_count ) );
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_float( out, value ) );
 
@@ -189,7 +604,7 @@ xi_state_t xi_senml_json_serialize_string_value( xi_data_desc_t* out,
 
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key(
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
                         out, xi_senml_pat_entry_string_value, elem_count ) );
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_string( out, string ) );
 
@@ -205,7 +620,7 @@ xi_state_t xi_senml_json_serialize_boolean_value( xi_data_desc_t* out,
 
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key(
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
                         out, xi_senml_pat_entry_boolean_value, elem_count ) );
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_boolean( out, boolean ) );
 
@@ -222,7 +637,7 @@ xi_state_t xi_senml_json_serialize_units( xi_data_desc_t* out,
 
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key(
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
                         out, xi_senml_pat_entry_units, elem_count ) );
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_string( out, units ) );
 
@@ -237,8 +652,8 @@ xi_senml_json_serialize_time( xi_data_desc_t* out, int32_t time, uint16_t elem_c
 
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key( out, xi_senml_pat_entry_time,
-                                                             elem_count ) );
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
+                        out, xi_senml_pat_entry_time, elem_count ) );
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_int( out, time ) );
 
 err_handling:
@@ -253,7 +668,7 @@ xi_state_t xi_senml_json_serialize_update_time( xi_data_desc_t* out,
 
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key(
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
                         out, xi_senml_pat_entry_update_time, elem_count ) );
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_int( out, time ) );
 
@@ -271,8 +686,8 @@ xi_state_t xi_senml_json_serialize_base_name( xi_data_desc_t* out,
     xi_state_t ret_state = XI_STATE_OK;
 
     /* elem_count part serialize the key value */
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key( out, xi_senml_pat_base_name,
-                                                             elem_count ) );
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
+                        out, xi_senml_pat_base_name, elem_count ) );
 
     /* then the value itself */
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_string( out, base_name ) );
@@ -290,8 +705,8 @@ xi_state_t xi_senml_json_serialize_base_units( xi_data_desc_t* out,
 
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key( out, xi_senml_pat_base_units,
-                                                             elem_count ) );
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
+                        out, xi_senml_pat_base_units, elem_count ) );
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_string( out, base_units ) );
 
 err_handling:
@@ -306,8 +721,8 @@ xi_state_t xi_senml_json_serialize_base_time( xi_data_desc_t* out,
 
     xi_state_t ret_state = XI_STATE_OK;
 
-    XI_CHECK_STATE( ret_state = xi_senml_json_serialize_key( out, xi_senml_pat_base_time,
-                                                             elem_count ) );
+    XI_CHECK_STATE( ret_state = XI_SENML_JSON_SERIALIZE_PAT_KEY(
+                        out, xi_senml_pat_base_time, elem_count ) );
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_int( out, base_time ) );
 
 err_handling:
@@ -318,16 +733,16 @@ xi_state_t xi_senml_json_serialize_close( xi_data_desc_t* out )
 {
     assert( out != 0 );
 
-    return xi_data_desc_append_data_resize( out, xi_senml_pat_close,
-                                            sizeof( xi_senml_pat_close ) - 1 );
+    return xi_senml_json_append( out, xi_senml_pat_close,
+                                 XI_SENML_PAT_LEN( xi_senml_pat_close ) );
 }
 
 xi_state_t xi_senml_json_serialize_close_entries( xi_data_desc_t* out )
 {
     assert( out != 0 );
 
-    return xi_data_desc_append_data_resize( out, xi_senml_pat_entries_close,
-                                            sizeof( xi_senml_pat_entries_close ) - 1 );
+    return xi_senml_json_append( out, xi_senml_pat_entries_close,
+                                 XI_SENML_PAT_LEN( xi_senml_pat_entries_close ) );
 }
 
 xi_state_t xi_senml_json_serialize_value_set( xi_data_desc_t* out,
@@ -361,15 +776,15 @@ xi_state_t xi_senml_json_serialize_entry( xi_data_desc_t* out,
     /* open either with coln or without */
     if ( entry_count > 0 )
     {
-        XI_CHECK_STATE( ret_state = xi_data_desc_append_data_resize(
+        XI_CHECK_STATE( ret_state = xi_senml_json_append(
                             out, xi_senml_pat_entry_open_next,
-                            sizeof( xi_senml_pat_entry_open_next ) - 1 ) );
+                            XI_SENML_PAT_LEN( xi_senml_pat_entry_open_next ) ) );
     }
     else
     {
-        XI_CHECK_STATE( ret_state = xi_data_desc_append_data_resize(
+        XI_CHECK_STATE( ret_state = xi_senml_json_append(
                             out, xi_senml_pat_entry_open_elem_count,
-                            sizeof( xi_senml_pat_entry_open_elem_count ) - 1 ) );
+                            XI_SENML_PAT_LEN( xi_senml_pat_entry_open_elem_count ) ) );
     }
 
     if ( entry->set.name_set == 1 )
@@ -406,30 +821,20 @@ xi_state_t xi_senml_json_serialize_entry( xi_data_desc_t* out,
                             out, entry->update_time, fields_count++ ) );
     }
 
-    XI_CHECK_STATE(
-        ret_state = xi_data_desc_append_data_resize(
-            out, xi_senml_pat_entry_close, sizeof( xi_senml_pat_entry_close ) - 1 ) );
+    XI_CHECK_STATE( ret_state = xi_senml_json_append(
+                        out, xi_senml_pat_entry_close,
+                        XI_SENML_PAT_LEN( xi_senml_pat_entry_close ) ) );
 
 err_handling:
     return ret_state;
 }
 
-xi_state_t
-xi_senml_json_serialize( xi_data_desc_t** out_buffer, xi_senml_t* senml_structure )
+/* appends the whole document, also used to measure it */
+static xi_state_t
+xi_senml_json_serialize_document( xi_data_desc_t* dst, xi_senml_t* senml_structure )
 {
-    /* we are going to start with some 32 bytes allocation */
-    static const uint32_t start_size = 32;
-
     xi_state_t ret_state = XI_STATE_OK;
 
-    if ( out_buffer == 0 || senml_structure == 0 )
-    {
-        return XI_INVALID_PARAMETER;
-    }
-
-    xi_data_desc_t* dst = *out_buffer = xi_make_empty_desc_alloc( start_size );
-    XI_CHECK_MEMORY( dst, ret_state );
-
     /* initialization of the senml buffer */
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_init( dst ) );
 
@@ -440,8 +845,8 @@ xi_senml_json_serialize( xi_data_desc_t** out_buffer, xi_senml_t* senml_structur
 
         while ( entry )
         {
-            XI_CHECK_STATE( ret_state = xi_senml_json_serialize_entry( *out_buffer, entry,
-                                                                       entries_count ) );
+            XI_CHECK_STATE(
+                ret_state = xi_senml_json_serialize_entry( dst, entry, entries_count ) );
             entry = entry->__next;
             ++entries_count;
         }
@@ -453,20 +858,20 @@ xi_senml_json_serialize( xi_data_desc_t** out_buffer, xi_senml_t* senml_structur
 
     if ( senml_structure->set.base_name_set == 1 )
     {
-        xi_senml_json_serialize_base_name( dst, senml_structure->base_name,
-                                           elements_count++ );
+        XI_CHECK_STATE( ret_state = xi_senml_json_serialize_base_name(
+                            dst, senml_structure->base_name, elements_count++ ) );
     }
 
     if ( senml_structure->set.base_time_set == 1 )
     {
-        xi_senml_json_serialize_base_time( dst, senml_structure->base_time,
-                                           elements_count++ );
+        XI_CHECK_STATE( ret_state = xi_senml_json_serialize_base_time(
+                            dst, senml_structure->base_time, elements_count++ ) );
     }
 
     if ( senml_structure->set.base_units_set == 1 )
     {
-        xi_senml_json_serialize_base_units( dst, senml_structure->base_units,
-                                            elements_count++ );
+        XI_CHECK_STATE( ret_state = xi_senml_json_serialize_base_units(
+                            dst, senml_structure->base_units, elements_count++ ) );
     }
 
     XI_CHECK_STATE( ret_state = xi_senml_json_serialize_close( dst ) );
@@ -475,6 +880,84 @@ err_handling:
     return ret_state;
 }
 
+xi_state_t
+xi_senml_json_serialized_length( xi_senml_t* senml_structure, uint32_t* out_length )
+{
+    /* a descriptor without a buffer, see xi_senml_json_append */
+    xi_data_desc_t counter = {NULL, NULL, 0, 0, 0, XI_MEMORY_TYPE_UNMANAGED};
+
+    if ( out_length == 0 || senml_structure == 0 )
+    {
+        return XI_INVALID_PARAMETER;
+    }
+
+    const xi_state_t ret_state =
+        xi_senml_json_serialize_document( &counter, senml_structure );
+
+    *out_length = counter.length;
+
+    return ret_state;
+}
+
+xi_state_t xi_senml_json_serialize_to_buffer( xi_senml_t* senml_structure,
+                                              uint8_t* buffer,
+                                              uint32_t buffer_size,
+                                              uint32_t* out_size )
+{
+    uint32_t length      = 0;
+    xi_state_t ret_state = XI_STATE_OK;
+
+    XI_CHECK_STATE( ret_state =
+                        xi_senml_json_serialized_length( senml_structure, &length ) );
+
+    *out_size = length;
+
+    if ( buffer == 0 || buffer_size < length )
+    {
+        return XI_BUFFER_OVERFLOW;
+    }
+
+    {
+        /* it fits so appending never tries to grow the caller's buffer */
+        xi_data_desc_t dst = {buffer, NULL, buffer_size, 0, 0, XI_MEMORY_TYPE_UNMANAGED};
+
+        XI_CHECK_STATE( ret_state =
+                            xi_senml_json_serialize_document( &dst, senml_structure ) );
+    }
+
+err_handling:
+    return ret_state;
+}
+
+xi_state_t
+xi_senml_json_serialize( xi_data_desc_t** out_buffer, xi_senml_t* senml_structure )
+{
+    uint32_t length      = 0;
+    xi_state_t ret_state = XI_STATE_OK;
+
+    if ( out_buffer == 0 || senml_structure == 0 )
+    {
+        return XI_INVALID_PARAMETER;
+    }
+
+    XI_CHECK_STATE( ret_state =
+                        xi_senml_json_serialized_length( senml_structure, &length ) );
+
+    /* allocated once with the exact size, the extra byte only zero terminates it */
+    xi_data_desc_t* dst = *out_buffer =
+        xi_make_empty_desc_alloc_uninitialized( length + 1 );
+    XI_CHECK_MEMORY( dst, ret_state );
+
+    XI_CHECK_STATE( ret_state =
+                        xi_senml_json_serialize_document( dst, senml_structure ) );
+
+    assert( dst->length == length );
+    dst->data_ptr[dst->length] = '\0';
+
+err_handling:
+    return ret_state;
+}
+
 #ifdef __cplusplus
 }
 #endif
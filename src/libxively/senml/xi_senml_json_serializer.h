@@ -83,6 +83,17 @@ extern xi_state_t xi_senml_json_serialize_entry( xi_data_desc_t* out,
                                                  xi_senml_entry_t* entry,
                                                  uint32_t entry_count );
 
+/* length of the document xi_senml_json_serialize makes, without a terminating zero */
+extern xi_state_t
+xi_senml_json_serialized_length( xi_senml_t* senml_structure, uint32_t* out_length );
+
+/* writes the document into the buffer, XI_BUFFER_OVERFLOW if it doesn't fit, *out_size
+ * is set to the length of the document in both cases */
+extern xi_state_t xi_senml_json_serialize_to_buffer( xi_senml_t* senml_structure,
+                                                     uint8_t* buffer,
+                                                     uint32_t buffer_size,
+                                                     uint32_t* out_size );
+
 extern xi_state_t
 xi_senml_json_serialize( xi_data_desc_t** out_buffer, xi_senml_t* senml_structure );
 
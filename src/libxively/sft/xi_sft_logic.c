@@ -63,9 +63,7 @@ xi_state_t xi_sft_free_context( xi_sft_context_t** context )
 {
     if ( NULL != context && NULL != *context )
     {
-        xi_sft_on_message_file_chunk_checksum_final( *context );
-
-        xi_bsp_io_fs_close( ( *context )->update_file_handle );
+        xi_sft_on_message_file_chunk_reset( *context );
 
         xi_control_message_free( &( *context )->update_message_fua );
         XI_SAFE_FREE( ( *context )->updateable_files_download_order );
@@ -229,8 +227,7 @@ xi_sft_on_message( xi_sft_context_t* context, xi_control_message_t* sft_message_
                     }
                 }
 
-                const uint32_t all_downloaded_bytes =
-                    sft_message_in->file_chunk.offset + sft_message_in->file_chunk.length;
+                const uint32_t all_downloaded_bytes = context->checksummed_bytes;
 
 #if 0
                 printf( "         === === === downloading file: %s, %d / %d, [%d%%], "
@@ -245,12 +242,10 @@ xi_sft_on_message( xi_sft_context_t* context, xi_control_message_t* sft_message_
                 /* Secure File Transfer (SFT) flow management */
                 if ( all_downloaded_bytes < context->update_current_file->size_in_bytes )
                 {
-                    /* SFT flow: file is not downloaded yet, continue with this file */
+                    /* SFT flow: file is not downloaded yet, continue with this file
+                     * keeping the window of requests full */
 
-                    _xi_sft_send_file_get_chunk(
-                        context, all_downloaded_bytes,
-                        context->update_current_file->size_in_bytes -
-                            all_downloaded_bytes );
+                    _xi_sft_request_file_chunks( context );
                 }
                 else
                 {
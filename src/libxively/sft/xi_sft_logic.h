@@ -11,9 +11,25 @@
 #include <xi_control_message.h>
 #include <xi_bsp_io_fs.h>
 #include <xively_types.h>
+#include <xi_config.h>
 
 typedef xi_state_t ( *fn_send_control_message_t )( void*, xi_control_message_t* );
 
+/* a FILE_CHUNK that arrived before the ones preceding it */
+typedef struct xi_sft_pending_chunk_s
+{
+    uint8_t* chunk;
+    uint32_t offset;
+    uint32_t length;
+} xi_sft_pending_chunk_t;
+
+/* a FILE_GET_CHUNK waiting for its FILE_CHUNK, length 0 marks a free slot */
+typedef struct xi_sft_chunk_request_s
+{
+    uint32_t offset;
+    uint32_t length;
+} xi_sft_chunk_request_t;
+
 typedef struct
 {
     fn_send_control_message_t fn_send_message;
@@ -30,6 +46,19 @@ typedef struct
 
     void* checksum_context;
 
+    /* MQTT download of update_current_file: the bytes asked for so far, the bytes
+     * passed to the checksum, which takes them in order, and the FILE_GET_CHUNK
+     * requests not answered yet */
+    uint32_t requested_bytes;
+    uint32_t checksummed_bytes;
+    uint16_t chunks_in_flight;
+    xi_sft_chunk_request_t chunk_requests[XI_SFT_FILE_CHUNK_WINDOW];
+    xi_sft_pending_chunk_t pending_chunks[XI_SFT_FILE_CHUNK_WINDOW];
+
+    /* length of the next FILE_GET_CHUNK, between XI_SFT_FILE_CHUNK_SIZE and
+     * XI_SFT_FILE_CHUNK_SIZE_MAX */
+    uint32_t chunk_size;
+
 } xi_sft_context_t;
 
 
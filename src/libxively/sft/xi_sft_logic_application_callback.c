@@ -59,8 +59,7 @@ _xi_sft_on_file_downloaded_task( void* sft_context_void,
         if ( 0 != context->update_current_file->flag_mqtt_download_also_supported )
         {
             /* fallback to MQTT: starting the internal MQTT file download process */
-            _xi_sft_send_file_get_chunk( context, 0,
-                                         context->update_current_file->size_in_bytes );
+            _xi_sft_start_file_chunk_download( context );
         }
     }
 
@@ -11,15 +11,120 @@
 #include <xi_bsp_io_fs.h>
 #include <xi_bsp_fwu.h>
 #include <xi_fs_bsp_to_xi_mapping.h>
+#include <xi_macros.h>
+#include <xi_sft_logic_internal_methods.h>
+
+static xi_sft_pending_chunk_t*
+_xi_sft_find_pending_chunk( xi_sft_context_t* context, uint32_t offset )
+{
+    uint16_t i = 0;
+    for ( ; i < XI_SFT_FILE_CHUNK_WINDOW; ++i )
+    {
+        if ( NULL != context->pending_chunks[i].chunk &&
+             offset == context->pending_chunks[i].offset )
+        {
+            return &context->pending_chunks[i];
+        }
+    }
+
+    return NULL;
+}
+
+static xi_sft_pending_chunk_t*
+_xi_sft_find_free_pending_chunk( xi_sft_context_t* context )
+{
+    uint16_t i = 0;
+    for ( ; i < XI_SFT_FILE_CHUNK_WINDOW; ++i )
+    {
+        if ( NULL == context->pending_chunks[i].chunk )
+        {
+            return &context->pending_chunks[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* frees the slot of the request the chunk at offset answers, its length is returned,
+ * 0 if the chunk was not asked for */
+static uint32_t _xi_sft_take_chunk_request( xi_sft_context_t* context, uint32_t offset )
+{
+    uint16_t i = 0;
+    for ( ; i < XI_SFT_FILE_CHUNK_WINDOW; ++i )
+    {
+        if ( 0 < context->chunk_requests[i].length &&
+             offset == context->chunk_requests[i].offset )
+        {
+            const uint32_t length             = context->chunk_requests[i].length;
+            context->chunk_requests[i].length = 0;
+            return length;
+        }
+    }
+
+    return 0;
+}
+
+void xi_sft_on_message_file_chunk_reset( xi_sft_context_t* context )
+{
+    if ( XI_BSP_IO_FS_INVALID_RESOURCE_HANDLE != context->update_file_handle )
+    {
+        xi_bsp_io_fs_close( context->update_file_handle );
+        context->update_file_handle = XI_BSP_IO_FS_INVALID_RESOURCE_HANDLE;
+    }
+
+    if ( NULL != context->checksum_context )
+    {
+        uint8_t* fingerprint     = NULL;
+        uint16_t fingerprint_len = 0;
+
+        xi_bsp_fwu_checksum_final( &context->checksum_context, &fingerprint,
+                                   &fingerprint_len );
+    }
+
+    uint16_t i = 0;
+    for ( ; i < XI_SFT_FILE_CHUNK_WINDOW; ++i )
+    {
+        XI_SAFE_FREE( context->pending_chunks[i].chunk );
+    }
+
+    memset( context->chunk_requests, 0, sizeof( context->chunk_requests ) );
+
+    context->requested_bytes   = 0;
+    context->checksummed_bytes = 0;
+    context->chunks_in_flight  = 0;
+    context->chunk_size        = XI_SFT_FILE_CHUNK_SIZE;
+}
 
 xi_control_message__sft_file_status_code_t
 xi_sft_on_message_file_chunk_process_file_chunk( xi_sft_context_t* context,
                                                  xi_control_message_t* sft_message_in )
 {
-    xi_state_t state = XI_STATE_OK;
+    xi_state_t state                      = XI_STATE_OK;
+    xi_sft_pending_chunk_t* pending_chunk = NULL;
 
-    /* at first chunk open file */
-    if ( 0 == sft_message_in->file_chunk.offset )
+    const uint32_t offset = sft_message_in->file_chunk.offset;
+    const uint32_t length = sft_message_in->file_chunk.length;
+
+    /* a chunk received earlier, the broker answered the same request twice */
+    if ( offset < context->checksummed_bytes ||
+         NULL != _xi_sft_find_pending_chunk( context, offset ) )
+    {
+        return XI_CONTROL_MESSAGE__SFT_FILE_STATUS_CODE_SUCCESS;
+    }
+
+    /* arrived ahead of the checksum, it has to wait for the ones before it */
+    if ( offset != context->checksummed_bytes )
+    {
+        pending_chunk = _xi_sft_find_free_pending_chunk( context );
+
+        if ( NULL == pending_chunk )
+        {
+            return XI_CONTROL_MESSAGE__SFT_FILE_STATUS_CODE_ERROR__UNEXPECTED_FILE_CHUNK;
+        }
+    }
+
+    /* open the file with the first chunk that arrives */
+    if ( XI_BSP_IO_FS_INVALID_RESOURCE_HANDLE == context->update_file_handle )
     {
         state = xi_fs_bsp_io_fs_2_xi_state( xi_bsp_io_fs_open(
             sft_message_in->file_chunk.name, context->update_current_file->size_in_bytes,
@@ -38,17 +143,61 @@ xi_sft_on_message_file_chunk_process_file_chunk( xi_sft_context_t* context,
 
     state = xi_fs_bsp_io_fs_2_xi_state(
         xi_bsp_io_fs_write( context->update_file_handle, sft_message_in->file_chunk.chunk,
-                            sft_message_in->file_chunk.length,
-                            sft_message_in->file_chunk.offset, &bytes_written ) );
+                            length, offset, &bytes_written ) );
 
     if ( XI_STATE_OK != state )
     {
         return XI_CONTROL_MESSAGE__SFT_FILE_STATUS_CODE_ERROR__FILE_WRITE;
     }
 
+    if ( 0 < context->chunks_in_flight )
+    {
+        --context->chunks_in_flight;
+    }
+
+    const uint32_t requested_length = _xi_sft_take_chunk_request( context, offset );
+
+    if ( 0 < length && length < requested_length )
+    {
+        /* the broker sends less than asked for, the rest is asked for again and the
+         * following requests are smaller */
+        _xi_sft_request_file_chunk( context, offset + length, requested_length - length );
+
+        context->chunk_size = XI_MAX( context->chunk_size / 2, XI_SFT_FILE_CHUNK_SIZE );
+    }
+    else if ( 0 < requested_length && length == requested_length )
+    {
+        /* answered in full, the following requests may be larger */
+        context->chunk_size =
+            XI_MIN( context->chunk_size * 2, XI_SFT_FILE_CHUNK_SIZE_MAX );
+    }
+
+    if ( NULL != pending_chunk )
+    {
+        /* taking over the chunk's memory until the gap before it is filled */
+        pending_chunk->chunk  = sft_message_in->file_chunk.chunk;
+        pending_chunk->offset = offset;
+        pending_chunk->length = length;
+
+        sft_message_in->file_chunk.chunk = NULL;
+
+        return XI_CONTROL_MESSAGE__SFT_FILE_STATUS_CODE_SUCCESS;
+    }
+
     xi_bsp_fwu_checksum_update( context->checksum_context,
-                                sft_message_in->file_chunk.chunk,
-                                sft_message_in->file_chunk.length );
+                                sft_message_in->file_chunk.chunk, length );
+    context->checksummed_bytes += length;
+
+    /* the chunks held back may follow now */
+    while ( NULL != ( pending_chunk = _xi_sft_find_pending_chunk(
+                          context, context->checksummed_bytes ) ) )
+    {
+        xi_bsp_fwu_checksum_update( context->checksum_context, pending_chunk->chunk,
+                                    pending_chunk->length );
+        context->checksummed_bytes += pending_chunk->length;
+
+        XI_SAFE_FREE( pending_chunk->chunk );
+    }
 
     return XI_CONTROL_MESSAGE__SFT_FILE_STATUS_CODE_SUCCESS;
 }
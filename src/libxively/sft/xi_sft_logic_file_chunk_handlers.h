@@ -10,6 +10,12 @@
 #include <xi_sft_logic.h>
 #include <xi_control_message.h>
 
+/* drops what is left of the previous MQTT file download: open file, checksum and
+ * the chunks held back, must precede the first FILE_GET_CHUNK of a file */
+void xi_sft_on_message_file_chunk_reset( xi_sft_context_t* context );
+
+/* writes the chunk at its offset, which may be ahead of the ones not arrived yet,
+ * the checksum is updated in order, holding back the chunks arriving early */
 xi_control_message__sft_file_status_code_t
 xi_sft_on_message_file_chunk_process_file_chunk( xi_sft_context_t* context,
                                                  xi_control_message_t* sft_message_in );
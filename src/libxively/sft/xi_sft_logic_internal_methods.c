@@ -11,6 +11,11 @@
 #include <xi_bsp_fwu.h>
 #include <xi_sft_logic_application_callback.h>
 #include <xi_debug.h>
+#include <xi_sft_logic_file_chunk_handlers.h>
+
+#ifdef XI_MEMORY_LIMITER_ENABLED
+#include <xi_memory_limiter.h>
+#endif
 
 #include <stdio.h>
 
@@ -44,13 +49,90 @@ void _xi_sft_send_file_get_chunk( xi_sft_context_t* context,
             xi_control_message_create_file_get_chunk(
                 context->update_current_file->name,
                 context->update_current_file->revision, offset,
-                XI_MIN( XI_SFT_FILE_CHUNK_SIZE, length ) );
+                XI_MIN( XI_SFT_FILE_CHUNK_SIZE_MAX, length ) );
 
         ( *context->fn_send_message )( context->send_message_user_data,
                                        message_file_get_chunk );
     }
 }
 
+void _xi_sft_request_file_chunk( xi_sft_context_t* context,
+                                 uint32_t offset,
+                                 uint32_t length )
+{
+    uint16_t i = 0;
+    for ( ; 0 < length && i < XI_SFT_FILE_CHUNK_WINDOW; ++i )
+    {
+        if ( 0 == context->chunk_requests[i].length )
+        {
+            context->chunk_requests[i].offset = offset;
+            context->chunk_requests[i].length = length;
+            break;
+        }
+    }
+
+    _xi_sft_send_file_get_chunk( context, offset, length );
+    ++context->chunks_in_flight;
+}
+
+/* the replies to a full window of requests are held twice on their way up, as MQTT
+ * payload and as decoded chunk, the chunk size is halved until they fit */
+static void _xi_sft_fit_chunk_size_to_memory( xi_sft_context_t* context )
+{
+#ifdef XI_MEMORY_LIMITER_ENABLED
+    const size_t memory_left = xi_memory_limiter_get_current_limit(
+        XI_MEMORY_LIMITER_ALLOCATION_TYPE_APPLICATION );
+
+    while ( XI_SFT_FILE_CHUNK_SIZE < context->chunk_size &&
+            memory_left < 2 * XI_SFT_FILE_CHUNK_WINDOW * ( size_t )context->chunk_size )
+    {
+        context->chunk_size = XI_MAX( context->chunk_size / 2, XI_SFT_FILE_CHUNK_SIZE );
+    }
+#else
+    XI_UNUSED( context );
+#endif
+}
+
+void _xi_sft_request_file_chunks( xi_sft_context_t* context )
+{
+    if ( NULL == context || NULL == context->update_current_file )
+    {
+        return;
+    }
+
+    const uint32_t size_in_bytes = context->update_current_file->size_in_bytes;
+
+    /* an empty file is asked for once too, its FILE_CHUNK creates it */
+    if ( 0 == size_in_bytes && 0 == context->chunks_in_flight )
+    {
+        _xi_sft_request_file_chunk( context, 0, 0 );
+    }
+
+    _xi_sft_fit_chunk_size_to_memory( context );
+
+    while ( context->chunks_in_flight < XI_SFT_FILE_CHUNK_WINDOW &&
+            context->requested_bytes < size_in_bytes )
+    {
+        const uint32_t length =
+            XI_MIN( context->chunk_size, size_in_bytes - context->requested_bytes );
+
+        _xi_sft_request_file_chunk( context, context->requested_bytes, length );
+
+        context->requested_bytes += length;
+    }
+}
+
+void _xi_sft_start_file_chunk_download( xi_sft_context_t* context )
+{
+    if ( NULL == context )
+    {
+        return;
+    }
+
+    xi_sft_on_message_file_chunk_reset( context );
+    _xi_sft_request_file_chunks( context );
+}
+
 static void _xi_sft_download_current_file( xi_sft_context_t* context )
 {
     if ( NULL == context || NULL == context->update_current_file )
@@ -100,8 +182,7 @@ static void _xi_sft_download_current_file( xi_sft_context_t* context )
     {
         /* external URL download failed to start: fallback on the internal MQTT file
          * download */
-        _xi_sft_send_file_get_chunk( context, 0,
-                                     context->update_current_file->size_in_bytes );
+        _xi_sft_start_file_chunk_download( context );
     }
 }
 
@@ -19,6 +19,18 @@ void _xi_sft_send_file_get_chunk( xi_sft_context_t* context,
                                   uint32_t offset,
                                   uint32_t length );
 
+/* starts the MQTT download of update_current_file */
+void _xi_sft_start_file_chunk_download( xi_sft_context_t* context );
+
+/* sends a FILE_GET_CHUNK and keeps track of it until its FILE_CHUNK arrives */
+void _xi_sft_request_file_chunk( xi_sft_context_t* context,
+                                 uint32_t offset,
+                                 uint32_t length );
+
+/* keeps XI_SFT_FILE_CHUNK_WINDOW FILE_GET_CHUNK requests of context->chunk_size bytes
+ * in flight until the whole file is requested */
+void _xi_sft_request_file_chunks( xi_sft_context_t* context );
+
 void _xi_sft_current_file_revision_handling( xi_sft_context_t* context );
 
 void _xi_sft_continue_package_download( xi_sft_context_t* context );
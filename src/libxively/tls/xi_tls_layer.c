@@ -5,8 +5,10 @@
  */
 
 #include "xi_fs_filenames.h"
+#include "xi_globals.h"
 #include "xi_layer_api.h"
 #include "xi_resource_manager.h"
+#include <xi_bsp_time.h>
 #include <xi_bsp_tls.h>
 #include <xi_connection_data.h>
 #include <xi_coroutine.h>
@@ -32,29 +34,40 @@ xi_bsp_tls_recv_callback( char* buf, int sz, void* context, int* bytes_read )
     xi_tls_layer_state_t* layer_data =
         ( xi_tls_layer_state_t* )XI_THIS_LAYER( context )->user_data;
 
-    xi_data_desc_t* recvd = layer_data->raw_buffer;
-
     /* if there is no buffer in the queue just leave with WANT_READ state */
-    if ( NULL != recvd )
+    if ( NULL != layer_data->raw_buffer )
     {
-        /* calculate how much data left in the buffer and copy as much as it's possible */
-        const int recvd_data_length_available = recvd->length - recvd->curr_pos;
-        assert( recvd_data_length_available > 0 );
-
-        const int bytes_to_copy = XI_MIN( sz, recvd_data_length_available );
-        memcpy( buf, ( recvd->data_ptr + recvd->curr_pos ), bytes_to_copy );
-        recvd->curr_pos += bytes_to_copy;
+        int bytes_copied = 0;
 
-        /* if we'ver emptied the buffer let it go */
-        if ( recvd->curr_pos == recvd->length )
+        /* fill as much of the TLS library's buffer as the queued buffers allow so that a
+         * record split between two reads doesn't take another call */
+        while ( bytes_copied < sz && NULL != layer_data->raw_buffer )
         {
-            xi_data_desc_t* tmp = NULL;
-            XI_LIST_POP( xi_data_desc_t, layer_data->raw_buffer, tmp );
-            xi_free_desc( &tmp );
+            xi_data_desc_t* recvd = layer_data->raw_buffer;
+
+            /* calculate how much data left in the buffer and copy as much as it's
+             * possible */
+            const int recvd_data_length_available = recvd->length - recvd->curr_pos;
+            assert( recvd_data_length_available > 0 );
+
+            const int bytes_to_copy =
+                XI_MIN( sz - bytes_copied, recvd_data_length_available );
+            memcpy( buf + bytes_copied, ( recvd->data_ptr + recvd->curr_pos ),
+                    bytes_to_copy );
+            recvd->curr_pos += bytes_to_copy;
+            bytes_copied += bytes_to_copy;
+
+            /* if we'ver emptied the buffer let it go */
+            if ( recvd->curr_pos == recvd->length )
+            {
+                xi_data_desc_t* tmp = NULL;
+                XI_LIST_POP( xi_data_desc_t, layer_data->raw_buffer, tmp );
+                xi_free_desc( &tmp );
+            }
         }
 
         /* set the return argument value */
-        *bytes_read = bytes_to_copy;
+        *bytes_read = bytes_copied;
 
         /* success */
         return XI_BSP_TLS_STATE_OK;
@@ -129,6 +142,37 @@ err_handling:
     return XI_BSP_TLS_STATE_WRITE_ERROR;
 }
 
+static void xi_tls_layer_session_free_wrap( void** session )
+{
+    xi_bsp_tls_session_free( session );
+}
+
+/**
+ * @brief keeps the session of the finished handshake in the context data replacing the
+ * previous one, the next connection of the context offers it to the server
+ **/
+static void xi_tls_layer_save_session( void* context, xi_tls_layer_state_t* layer_data )
+{
+    xi_context_data_t* context_data = XI_CONTEXT_DATA( context );
+    xi_bsp_tls_session_t* session   = NULL;
+
+    if ( XI_BSP_TLS_STATE_OK !=
+         xi_bsp_tls_save_session( layer_data->tls_context, &session ) )
+    {
+        xi_debug_logger( "failed to save the TLS session, next connection will do a "
+                         "full handshake" );
+        return;
+    }
+
+    if ( NULL != context_data->copy_of_tls_session )
+    {
+        xi_bsp_tls_session_free( &context_data->copy_of_tls_session );
+    }
+
+    context_data->copy_of_tls_session          = session;
+    context_data->copy_of_tls_session_dtor_ptr = &xi_tls_layer_session_free_wrap;
+}
+
 static xi_state_t connect_handler( void* context, void* data, xi_state_t in_out_state )
 {
     XI_LAYER_FUNCTION_PRINT_FUNCTION_DIGEST();
@@ -168,6 +212,14 @@ static xi_state_t connect_handler( void* context, void* data, xi_state_t in_out_
         }
     } while ( bsp_tls_state != XI_BSP_TLS_STATE_OK );
 
+    /* compare the ones with a saved session offered to the full handshakes */
+    xi_debug_format( "TLS handshake done in %ld ms, saved session offered: %d",
+                     ( long )( xi_bsp_time_getmonotonictime_milliseconds() -
+                               layer_data->handshake_started_at ),
+                     NULL != XI_CONTEXT_DATA( context )->copy_of_tls_session );
+
+    xi_tls_layer_save_session( context, layer_data );
+
     /* connection done we can restore the logic handlers */
     layer_data->tls_layer_logic_recv_handler = &recv_handler;
     layer_data->tls_layer_logic_send_handler = &send_handler;
@@ -210,11 +262,15 @@ static xi_state_t send_handler( void* context, void* data, xi_state_t in_out_sta
     }
 
     /* cook temporary data before entering the coroutine scope */
-    xi_bsp_tls_state_t ret = XI_BSP_TLS_STATE_WRITE_ERROR;
-    int bytes_written      = 0;
-    const size_t offset    = layer_data->to_write_buffer->curr_pos;
-    const size_t size_left =
-        layer_data->to_write_buffer->capacity - layer_data->to_write_buffer->curr_pos;
+    xi_bsp_tls_state_t ret   = XI_BSP_TLS_STATE_WRITE_ERROR;
+    int bytes_written        = 0;
+    xi_data_desc_t* to_write = layer_data->to_write_buffer;
+
+    /* the buffer can be a chain of descriptors, skip the ones already written */
+    while ( NULL != to_write->__next && to_write->curr_pos == to_write->capacity )
+    {
+        to_write = to_write->__next;
+    }
 
     /* coroutine scope begins */
     XI_CR_START( layer_data->tls_layer_send_cs );
@@ -224,12 +280,12 @@ static xi_state_t send_handler( void* context, void* data, xi_state_t in_out_sta
     {
         /* passes data and a size to bsp tls write function */
         ret = xi_bsp_tls_write( layer_data->tls_context,
-                                layer_data->to_write_buffer->data_ptr + offset, size_left,
-                                &bytes_written );
+                                to_write->data_ptr + to_write->curr_pos,
+                                to_write->capacity - to_write->curr_pos, &bytes_written );
 
         if ( bytes_written > 0 )
         {
-            layer_data->to_write_buffer->curr_pos += bytes_written;
+            to_write->curr_pos += bytes_written;
         }
 
         /* while bsp tls is unable to read let's exit the coroutine */
@@ -242,10 +298,22 @@ static xi_state_t send_handler( void* context, void* data, xi_state_t in_out_sta
             goto err_handling;
         }
 
+        /* a single write may take only a part of the descriptor, e.g. one record,
+         * write the rest before moving on to the next descriptor of the chain */
+        if ( to_write->curr_pos < to_write->capacity )
+        {
+            ret = XI_BSP_TLS_STATE_WANT_WRITE;
+        }
+        else if ( NULL != to_write->__next )
+        {
+            to_write = to_write->__next;
+            ret      = XI_BSP_TLS_STATE_WANT_WRITE;
+        }
+
     } while ( ret != XI_BSP_TLS_STATE_OK );
 
     /* free the memory */
-    xi_free_desc( &layer_data->to_write_buffer );
+    xi_free_desc_chain( &layer_data->to_write_buffer );
 
     /* exit the coroutine scope */
     XI_CR_EXIT( layer_data->tls_layer_send_cs,
@@ -257,7 +325,7 @@ err_handling:
     /* coroutine reset */
     XI_CR_RESET( layer_data->tls_layer_send_cs );
     /* free the memory */
-    xi_free_desc( &layer_data->to_write_buffer );
+    xi_free_desc_chain( &layer_data->to_write_buffer );
     return XI_PROCESS_PUSH_ON_NEXT_LAYER( context, NULL, XI_STATE_FAILED_WRITING );
 }
 
@@ -284,7 +352,8 @@ static xi_state_t recv_handler( void* context, void* data, xi_state_t in_out_sta
     /* if recv buffer is empty than create one */
     if ( NULL == layer_data->decoded_buffer )
     {
-        layer_data->decoded_buffer = xi_make_empty_desc_alloc( XI_IO_BUFFER_SIZE );
+        layer_data->decoded_buffer =
+            xi_make_empty_desc_alloc_uninitialized( xi_globals.io_buffer_size );
         XI_CHECK_MEMORY( layer_data->decoded_buffer, in_out_state );
     }
 
@@ -309,6 +378,14 @@ static xi_state_t recv_handler( void* context, void* data, xi_state_t in_out_sta
             layer_data->decoded_buffer->length += bytes_read;
         }
 
+        /* whatever has been decrypted so far goes up now instead of waiting for the
+         * rest of the next record */
+        if ( ret == XI_BSP_TLS_STATE_WANT_READ &&
+             0 < layer_data->decoded_buffer->length )
+        {
+            break;
+        }
+
         XI_CR_YIELD_UNTIL( layer_data->tls_layer_recv_cs,
                            ( ret == XI_BSP_TLS_STATE_WANT_READ ), XI_STATE_WANT_READ );
 
@@ -318,7 +395,13 @@ static xi_state_t recv_handler( void* context, void* data, xi_state_t in_out_sta
             goto err_handling;
         }
 
-    } while ( ret != XI_BSP_TLS_STATE_OK );
+        /* decrypt the records already received into the same buffer so that they go up
+         * the chain as one slice rather than one pull and one allocation per record */
+    } while ( 0 == layer_data->decoded_buffer->length ||
+              ( layer_data->decoded_buffer->length <
+                    layer_data->decoded_buffer->capacity &&
+                ( NULL != layer_data->raw_buffer ||
+                  xi_bsp_tls_pending( layer_data->tls_context ) > 0 ) ) );
 
 #if 0 /* leave it for future use */
     xi_debug_data_logger( "recved", buffer_desc );
@@ -367,7 +450,7 @@ xi_state_t xi_tls_layer_push( void* context, void* data, xi_state_t in_out_state
         xi_debug_logger( "XI_THIS_LAYER_NOT_OPERATIONAL" );
 
         /* cleaning of not finished requests */
-        xi_free_desc( &buffer );
+        xi_free_desc_chain( &buffer );
 
         return XI_STATE_OK;
     }
@@ -441,6 +524,20 @@ err_handling:
     return XI_PROCESS_CLOSE_ON_THIS_LAYER( context, NULL, in_out_state );
 }
 
+static void xi_tls_layer_make_init_params( xi_bsp_tls_init_params_t* init_params,
+                                           void* context,
+                                           const xi_connection_data_t* connection_data )
+{
+    memset( init_params, 0, sizeof( *init_params ) );
+
+    init_params->xively_io_callback_context = context;
+    init_params->fp_xively_alloc            = xi_alloc_ptr;
+    init_params->fp_xively_calloc           = xi_calloc_ptr;
+    init_params->fp_xively_free             = xi_free_ptr;
+    init_params->fp_xively_realloc          = xi_realloc_ptr;
+    init_params->domain_name                = connection_data->host;
+}
+
 xi_state_t xi_tls_layer_init( void* context, void* data, xi_state_t in_out_state )
 {
     XI_LAYER_FUNCTION_PRINT_FUNCTION_DIGEST();
@@ -463,85 +560,142 @@ xi_state_t xi_tls_layer_init( void* context, void* data, xi_state_t in_out_state
     /* let's use the connection coroutine state */
     XI_CR_START( layer_data->tls_layer_conn_cs );
 
-    /* make the resource manager context */
-    in_out_state = xi_resource_manager_make_context( NULL, &layer_data->rm_context );
-
-    if ( XI_STATE_OK != in_out_state )
+    /* the CA certificate is read and parsed by the first connection only, the other ones
+     * and the reconnects use the shared configuration made from it */
+    if ( NULL == xi_globals.tls_config )
     {
-        xi_debug_format( "failed to create a resource manager context, reason: %d",
-                         in_out_state );
-        in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
-        goto err_handling;
-    }
+        /* make the resource manager context */
+        in_out_state = xi_resource_manager_make_context( NULL, &layer_data->rm_context );
 
-    in_out_state = xi_resource_manager_open(
-        layer_data->rm_context,
-        xi_make_handle( &xi_tls_layer_init, context, data, in_out_state ),
-        XI_FS_CERTIFICATE, XI_GLOBAL_CERTIFICATE_FILE_NAME, XI_FS_OPEN_READ, NULL );
+        if ( XI_STATE_OK != in_out_state )
+        {
+            xi_debug_format( "failed to create a resource manager context, reason: %d",
+                             in_out_state );
+            in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
+            goto err_handling;
+        }
 
-    if ( XI_STATE_OK != in_out_state )
-    {
-        xi_debug_format( "failed to start open on CA certificate using resource manager "
-                         "context, reason: %d",
-                         in_out_state );
-        in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
-        goto err_handling;
-    }
+        in_out_state = xi_resource_manager_open(
+            layer_data->rm_context,
+            xi_make_handle( &xi_tls_layer_init, context, data, in_out_state ),
+            XI_FS_CERTIFICATE, XI_GLOBAL_CERTIFICATE_FILE_NAME, XI_FS_OPEN_READ, NULL );
 
-    XI_CR_YIELD( layer_data->tls_layer_conn_cs, XI_STATE_OK );
+        if ( XI_STATE_OK != in_out_state )
+        {
+            xi_debug_format( "failed to start open on CA certificate using resource "
+                             "manager context, reason: %d",
+                             in_out_state );
+            in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
+            goto err_handling;
+        }
 
-    if ( XI_STATE_OK != in_out_state )
-    {
-        xi_debug_format( "failed to open CA certificate from filesystem, reason: %d",
-                         in_out_state );
-        in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
-        goto err_handling;
-    }
+        XI_CR_YIELD( layer_data->tls_layer_conn_cs, XI_STATE_OK );
 
-    in_out_state = xi_resource_manager_read(
-        layer_data->rm_context,
-        xi_make_handle( &xi_tls_layer_init, context, data, in_out_state ), NULL );
+        if ( XI_STATE_OK != in_out_state )
+        {
+            xi_debug_format( "failed to open CA certificate from filesystem, reason: %d",
+                             in_out_state );
+            in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
+            goto err_handling;
+        }
 
+        in_out_state = xi_resource_manager_read(
+            layer_data->rm_context,
+            xi_make_handle( &xi_tls_layer_init, context, data, in_out_state ), NULL );
 
-    if ( XI_STATE_OK != in_out_state )
-    {
-        xi_debug_format(
-            "failed to start read on CA certificate using resource manager, reason: %d",
-            in_out_state );
-        in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
-        goto err_handling;
-    }
 
-    /* here the resource manager will start reading the resource content from a choosen
-     * filesystem */
-    XI_CR_YIELD( layer_data->tls_layer_conn_cs, XI_STATE_OK );
-    /* here the resource manager finished reading the resource content from a choosen
-     * filesystem */
+        if ( XI_STATE_OK != in_out_state )
+        {
+            xi_debug_format( "failed to start read on CA certificate using resource "
+                             "manager, reason: %d",
+                             in_out_state );
+            in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
+            goto err_handling;
+        }
 
-    if ( XI_STATE_OK != in_out_state )
-    {
-        xi_debug_format( "failed to read CA certificate from filesystem, reason: %d",
-                         in_out_state );
-        in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
-        goto err_handling;
-    }
+        /* here the resource manager will start reading the resource content from a
+         * choosen filesystem */
+        XI_CR_YIELD( layer_data->tls_layer_conn_cs, XI_STATE_OK );
+        /* here the resource manager finished reading the resource content from a
+         * choosen filesystem */
+
+        if ( XI_STATE_OK != in_out_state )
+        {
+            xi_debug_format( "failed to read CA certificate from filesystem, reason: %d",
+                             in_out_state );
+            in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
+            goto err_handling;
+        }
+
+        /* POST/PRE-CONDITIONS */
+        assert( NULL != layer_data->rm_context->data_buffer->data_ptr );
+        assert( 0 < layer_data->rm_context->data_buffer->length );
+
+        /* another connection might have made it while this one was reading */
+        if ( NULL == xi_globals.tls_config )
+        {
+            xi_bsp_tls_init_params_t init_params;
+            xi_tls_layer_make_init_params( &init_params, context, connection_data );
+
+            init_params.ca_cert_pem_buf = layer_data->rm_context->data_buffer->data_ptr;
+            init_params.ca_cert_pem_buf_length =
+                layer_data->rm_context->data_buffer->length;
+
+#if XI_DEBUG_OUTPUT
+            const xi_time_t config_started_at =
+                xi_bsp_time_getmonotonictime_milliseconds();
+#endif
+
+            const xi_bsp_tls_state_t bsp_tls_state =
+                xi_bsp_tls_config_create( &xi_globals.tls_config, &init_params );
+
+            if ( XI_BSP_TLS_STATE_OK != bsp_tls_state )
+            {
+                in_out_state = XI_BSP_TLS_STATE_CERT_ERROR == bsp_tls_state
+                                   ? XI_TLS_FAILED_LOADING_CERTIFICATE
+                                   : XI_TLS_INITALIZATION_ERROR;
+                xi_debug_logger( "ERROR: during BSP TLS configuration" );
+                goto err_handling;
+            }
+
+            /* the time the later connections and reconnects save */
+            xi_debug_format( "BSP TLS configuration made in %ld ms",
+                             ( long )( xi_bsp_time_getmonotonictime_milliseconds() -
+                                       config_started_at ) );
+        }
+
+        in_out_state = xi_resource_manager_close(
+            layer_data->rm_context,
+            xi_make_handle( &xi_tls_layer_init, context, data, in_out_state ), NULL );
 
-    /* POST/PRE-CONDITIONS */
-    assert( NULL != layer_data->rm_context->data_buffer->data_ptr );
-    assert( 0 < layer_data->rm_context->data_buffer->length );
+        /* here the resource manger will start the close action */
+        XI_CR_YIELD( layer_data->tls_layer_conn_cs, XI_STATE_OK );
+        /* here the resource manger finished closing this resource */
+
+        if ( XI_STATE_OK != in_out_state )
+        {
+            xi_debug_format( "failed to close the CA certificate resource, reason: %d",
+                             in_out_state );
+            in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
+            goto err_handling;
+        }
+
+        in_out_state = xi_resource_manager_free_context( &layer_data->rm_context );
+
+        if ( XI_STATE_OK != in_out_state )
+        {
+            xi_debug_format( "failed to free the context memory, reason: %d",
+                             in_out_state );
+            in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
+            goto err_handling;
+        }
+    }
 
     { /* initialisation block for bsp tls init function */
         xi_bsp_tls_init_params_t init_params;
-        memset( &init_params, 0, sizeof( init_params ) );
+        xi_tls_layer_make_init_params( &init_params, context, connection_data );
 
-        init_params.xively_io_callback_context = context;
-        init_params.fp_xively_alloc            = xi_alloc_ptr;
-        init_params.fp_xively_calloc           = xi_calloc_ptr;
-        init_params.fp_xively_free             = xi_free_ptr;
-        init_params.fp_xively_realloc          = xi_realloc_ptr;
-        init_params.domain_name                = connection_data->host;
-        init_params.ca_cert_pem_buf = layer_data->rm_context->data_buffer->data_ptr;
-        init_params.ca_cert_pem_buf_length = layer_data->rm_context->data_buffer->length;
+        init_params.tls_config = xi_globals.tls_config;
 
         /* bsp init function call */
         const xi_bsp_tls_state_t bsp_tls_state =
@@ -558,32 +712,21 @@ xi_state_t xi_tls_layer_init( void* context, void* data, xi_state_t in_out_state
         }
     }
 
-    xi_debug_logger( "BSP TLS initialization successfull" );
-
-    in_out_state = xi_resource_manager_close(
-        layer_data->rm_context,
-        xi_make_handle( &xi_tls_layer_init, context, data, in_out_state ), NULL );
-
-    /* here the resource manger will start the close action */
-    XI_CR_YIELD( layer_data->tls_layer_conn_cs, XI_STATE_OK );
-    /* here the resource manger finished closing this resource */
-
-    if ( XI_STATE_OK != in_out_state )
+    /* on reconnect try to resume the previous session, a full handshake is done if it
+     * can't be */
+    if ( NULL != XI_CONTEXT_DATA( context )->copy_of_tls_session &&
+         XI_BSP_TLS_STATE_OK != xi_bsp_tls_restore_session(
+                                    layer_data->tls_context,
+                                    XI_CONTEXT_DATA( context )->copy_of_tls_session ) )
     {
-        xi_debug_format( "failed to close the CA certificate resource, reason: %d",
-                         in_out_state );
-        in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
-        goto err_handling;
+        xi_debug_logger( "failed to restore the TLS session" );
     }
 
-    in_out_state = xi_resource_manager_free_context( &layer_data->rm_context );
+#if XI_DEBUG_OUTPUT
+    layer_data->handshake_started_at = xi_bsp_time_getmonotonictime_milliseconds();
+#endif
 
-    if ( XI_STATE_OK != in_out_state )
-    {
-        xi_debug_format( "failed to free the context memory, reason: %d", in_out_state );
-        in_out_state = XI_TLS_FAILED_LOADING_CERTIFICATE;
-        goto err_handling;
-    }
+    xi_debug_logger( "BSP TLS initialization successfull" );
 
     /* setup the logic handlers for connection purposes */
     layer_data->tls_layer_logic_recv_handler = &connect_handler;
@@ -697,7 +840,7 @@ xi_tls_layer_close_externally( void* context, void* data, xi_state_t in_out_stat
         if ( layer_data->to_write_buffer )
         {
             xi_debug_logger( "cleaning to write buffer" );
-            xi_free_desc( &layer_data->to_write_buffer );
+            xi_free_desc_chain( &layer_data->to_write_buffer );
         }
 
         /* user data removed */
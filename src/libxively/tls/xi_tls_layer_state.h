@@ -8,6 +8,7 @@
 #define __XI_TLS_LAYER_STATE_H__
 
 #include <xi_bsp_tls.h>
+#include <xively_time.h>
 #include <xi_resource_manager.h>
 
 typedef enum xi_tls_layer_data_write_state_e {
@@ -36,6 +37,11 @@ typedef struct xi_tls_layer_state_s
 
     xi_tls_layer_data_write_state_t tls_layer_write_state;
 
+#if XI_DEBUG_OUTPUT
+    /* when the handshake began, to log how long it took */
+    xi_time_t handshake_started_at;
+#endif
+
 } xi_tls_layer_state_t;
 
 #endif /* __XI_TLS_LAYER_STATE_H__ */
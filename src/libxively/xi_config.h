@@ -11,9 +11,15 @@
 #include "xi_config_mbed.h"
 #endif
 
+/* default size of the buffer a single socket read is done into, it can be changed at
+ * run-time with xi_set_io_buffer_size */
 #ifndef XI_IO_BUFFER_SIZE
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_IO_BUFFER_SIZE 1024 * 16
+#else
 #define XI_IO_BUFFER_SIZE 32
 #endif
+#endif
 
 #ifndef XI_BACKOFF_CHECK_TIME
 #define XI_BACKOFF_CHECK_TIME 60
@@ -23,6 +29,28 @@
 #define XI_MQTT_MAX_PAYLOAD_SIZE 1024 * 128
 #endif
 
+/* received PUBLISH payloads longer than this are passed on in parts of this size, a
+ * subscription made with xi_subscribe_streamed gets them one by one */
+#ifndef XI_MQTT_INBOUND_PAYLOAD_CHUNK_SIZE
+#define XI_MQTT_INBOUND_PAYLOAD_CHUNK_SIZE 1024 * 4
+#endif
+
+/* messages waiting to be sent are serialised into a single buffer of at most this many
+ * bytes and written at once, 0 sends them one by one */
+#ifndef XI_MQTT_OUTBOUND_BATCH_SIZE
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_MQTT_OUTBOUND_BATCH_SIZE 1024 * 4
+#else
+#define XI_MQTT_OUTBOUND_BATCH_SIZE 0
+#endif
+#endif
+
+/* default number of QoS1 PUBLISHes sent and waiting for their PUBACK at the same time,
+ * it can be changed at run-time with xi_set_publish_window, 0 means no limit */
+#ifndef XI_MQTT_PUBLISH_WINDOW
+#define XI_MQTT_PUBLISH_WINDOW 0
+#endif
+
 #ifndef XI_CBOR_MESSAGE_MIN_BUFFER_SIZE
 #define XI_CBOR_MESSAGE_MIN_BUFFER_SIZE 128
 #endif
@@ -31,10 +59,32 @@
 #define XI_CBOR_MESSAGE_MAX_BUFFER_SIZE XI_MQTT_MAX_PAYLOAD_SIZE
 #endif
 
+/* the size of the first FILE_GET_CHUNK requests of a file and the smallest size the
+ * requests shrink to, it grows up to XI_SFT_FILE_CHUNK_SIZE_MAX while the chunks arrive
+ * whole */
 #ifndef XI_SFT_FILE_CHUNK_SIZE
 #define XI_SFT_FILE_CHUNK_SIZE 1024
 #endif
 
+/* has to leave room for the CBOR and MQTT framing within XI_MQTT_MAX_PAYLOAD_SIZE */
+#ifndef XI_SFT_FILE_CHUNK_SIZE_MAX
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_SFT_FILE_CHUNK_SIZE_MAX ( 16 * 1024 )
+#else
+#define XI_SFT_FILE_CHUNK_SIZE_MAX XI_SFT_FILE_CHUNK_SIZE
+#endif
+#endif
+
+/* number of FILE_GET_CHUNK requests of a file download waiting for their FILE_CHUNK at
+ * the same time, chunks arriving ahead of the checksum are held until it catches up */
+#ifndef XI_SFT_FILE_CHUNK_WINDOW
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_SFT_FILE_CHUNK_WINDOW 8
+#else
+#define XI_SFT_FILE_CHUNK_WINDOW 1
+#endif
+#endif
+
 #ifndef XI_DEFAULT_IDLE_TIMEOUT
 #define XI_DEFAULT_IDLE_TIMEOUT 1
 #endif
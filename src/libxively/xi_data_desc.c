@@ -6,8 +6,27 @@
 
 #include "xi_data_desc.h"
 #include "xi_allocator.h"
+#include "xi_critical_section.h"
+#include "xi_critical_section_def.h"
 #include "xi_macros.h"
 #include "xi_helpers.h"
+#include "xi_memory_pool.h"
+
+/* empty and so bypassed until xi_data_desc_pool_resize gives it a size */
+static xi_memory_pool_t xi_data_desc_pool = xi_make_memory_pool( 0 );
+
+/* static initialisation of the critical section, descriptors are made on the
+ * application's threads and released on the event loop's */
+static struct xi_critical_section_s xi_data_desc_pool_cs = {0};
+
+void xi_data_desc_pool_resize( uint16_t max_free_count )
+{
+    xi_lock_critical_section( &xi_data_desc_pool_cs );
+
+    xi_memory_pool_resize( &xi_data_desc_pool, max_free_count );
+
+    xi_unlock_critical_section( &xi_data_desc_pool_cs );
+}
 
 xi_data_desc_t* xi_make_empty_desc_alloc( size_t capacity )
 {
@@ -15,7 +34,9 @@ xi_data_desc_t* xi_make_empty_desc_alloc( size_t capacity )
 
     xi_state_t state = XI_STATE_OK;
 
-    XI_ALLOC( xi_data_desc_t, data_desc, state );
+    xi_data_desc_t* data_desc = ( xi_data_desc_t* )xi_memory_pool_alloc(
+        &xi_data_desc_pool, &xi_data_desc_pool_cs, sizeof( xi_data_desc_t ) );
+    XI_CHECK_MEMORY( data_desc, state );
 
     XI_ALLOC_BUFFER_AT( unsigned char, data_desc->data_ptr, capacity, state );
 
@@ -30,13 +51,40 @@ err_handling:
     return 0;
 }
 
+xi_data_desc_t* xi_make_empty_desc_alloc_uninitialized( size_t capacity )
+{
+    assert( capacity > 0 );
+
+    xi_state_t state = XI_STATE_OK;
+
+    xi_data_desc_t* data_desc = ( xi_data_desc_t* )xi_memory_pool_alloc(
+        &xi_data_desc_pool, &xi_data_desc_pool_cs, sizeof( xi_data_desc_t ) );
+    XI_CHECK_MEMORY( data_desc, state );
+
+    /* skips the memset of XI_ALLOC_BUFFER_AT, the content is written before read */
+    data_desc->data_ptr = ( uint8_t* )xi_alloc( capacity );
+    XI_CHECK_MEMORY( data_desc->data_ptr, state );
+
+    data_desc->length      = 0;
+    data_desc->capacity    = capacity;
+    data_desc->memory_type = XI_MEMORY_TYPE_MANAGED;
+
+    return data_desc;
+
+err_handling:
+    xi_free_desc( &data_desc );
+    return 0;
+}
+
 xi_data_desc_t* xi_make_desc_from_buffer_copy( unsigned const char* buffer, size_t len )
 {
     assert( buffer != 0 );
 
     xi_state_t state = XI_STATE_OK;
 
-    XI_ALLOC( xi_data_desc_t, data_desc, state );
+    xi_data_desc_t* data_desc = ( xi_data_desc_t* )xi_memory_pool_alloc(
+        &xi_data_desc_pool, &xi_data_desc_pool_cs, sizeof( xi_data_desc_t ) );
+    XI_CHECK_MEMORY( data_desc, state );
     XI_ALLOC_BUFFER_AT( unsigned char, data_desc->data_ptr, len, state );
 
     memcpy( data_desc->data_ptr, buffer, len );
@@ -58,7 +106,9 @@ xi_data_desc_t* xi_make_desc_from_buffer_share( unsigned char* buffer, size_t le
 
     xi_state_t state = XI_STATE_OK;
 
-    XI_ALLOC( xi_data_desc_t, data_desc, state );
+    xi_data_desc_t* data_desc = ( xi_data_desc_t* )xi_memory_pool_alloc(
+        &xi_data_desc_pool, &xi_data_desc_pool_cs, sizeof( xi_data_desc_t ) );
+    XI_CHECK_MEMORY( data_desc, state );
 
     data_desc->capacity    = len;
     data_desc->length      = data_desc->capacity;
@@ -82,7 +132,9 @@ xi_data_desc_t* xi_make_desc_from_string_copy( const char* str )
     xi_state_t state = XI_STATE_OK;
     const size_t len = strlen( str );
 
-    XI_ALLOC( xi_data_desc_t, data_desc, state );
+    xi_data_desc_t* data_desc = ( xi_data_desc_t* )xi_memory_pool_alloc(
+        &xi_data_desc_pool, &xi_data_desc_pool_cs, sizeof( xi_data_desc_t ) );
+    XI_CHECK_MEMORY( data_desc, state );
 
     XI_ALLOC_BUFFER_AT( unsigned char, data_desc->data_ptr, len, state );
     memcpy( data_desc->data_ptr, str, len );
@@ -109,7 +161,9 @@ xi_data_desc_t* xi_make_desc_from_string_share( const char* str )
 
     const size_t len = strlen( str );
 
-    XI_ALLOC( xi_data_desc_t, data_desc, state );
+    xi_data_desc_t* data_desc = ( xi_data_desc_t* )xi_memory_pool_alloc(
+        &xi_data_desc_pool, &xi_data_desc_pool_cs, sizeof( xi_data_desc_t ) );
+    XI_CHECK_MEMORY( data_desc, state );
 
     data_desc->data_ptr    = ( uint8_t* )str;
     data_desc->capacity    = len;
@@ -132,7 +186,9 @@ xi_data_desc_t* xi_make_desc_from_float_copy( const float value )
     xi_state_t state = XI_STATE_OK;
     size_t i         = 0;
 
-    XI_ALLOC( xi_data_desc_t, data_desc, state );
+    xi_data_desc_t* data_desc = ( xi_data_desc_t* )xi_memory_pool_alloc(
+        &xi_data_desc_pool, &xi_data_desc_pool_cs, sizeof( xi_data_desc_t ) );
+    XI_CHECK_MEMORY( data_desc, state );
     XI_ALLOC_BUFFER_AT( unsigned char, data_desc->data_ptr, 4, state );
 
     for ( i = 0; i < 4; ++i )
@@ -163,7 +219,23 @@ void xi_free_desc( xi_data_desc_t** desc )
             XI_SAFE_FREE( ( *desc )->data_ptr );
         }
 
-        XI_SAFE_FREE( ( *desc ) );
+        xi_memory_pool_release( &xi_data_desc_pool, &xi_data_desc_pool_cs, *desc );
+        *desc = NULL;
+    }
+}
+
+void xi_free_desc_chain( xi_data_desc_t** desc )
+{
+    if ( desc != NULL )
+    {
+        while ( *desc != NULL )
+        {
+            xi_data_desc_t* tmp = *desc;
+            *desc               = tmp->__next;
+
+            tmp->__next = NULL;
+            xi_free_desc( &tmp );
+        }
     }
 }
 
@@ -30,8 +30,30 @@ typedef struct data_desc_s
 
 typedef uint32_t( xi_data_desc_realloc_strategy_t )( uint32_t, uint32_t );
 
+/* number of released descriptors kept for reuse while a context exists, the buffers
+ * they point to are not kept */
+#ifndef XI_DATA_DESC_POOL_SIZE
+#ifdef XI_PLATFORM_BASE_POSIX
+#define XI_DATA_DESC_POOL_SIZE 32
+#else
+#define XI_DATA_DESC_POOL_SIZE 4
+#endif
+#endif
+
+/**
+ * @brief xi_data_desc_pool_resize
+ *
+ * Sets how many released descriptors are kept for reuse instead of being freed, the
+ * ones above the new size are freed right away. 0, the initial size, turns the reuse
+ * off.
+ */
+extern void xi_data_desc_pool_resize( uint16_t max_free_count );
+
 extern xi_data_desc_t* xi_make_empty_desc_alloc( size_t capacity );
 
+/* same as xi_make_empty_desc_alloc but the buffer is left uninitialized */
+extern xi_data_desc_t* xi_make_empty_desc_alloc_uninitialized( size_t capacity );
+
 extern xi_data_desc_t*
 xi_make_desc_from_buffer_copy( unsigned const char* buffer, size_t len );
 
@@ -46,6 +68,9 @@ extern xi_data_desc_t* xi_make_desc_from_float_copy( const float value );
 
 extern void xi_free_desc( xi_data_desc_t** desc );
 
+/* frees the descriptor and all the descriptors linked to it through __next */
+extern void xi_free_desc_chain( xi_data_desc_t** desc );
+
 extern uint8_t xi_data_desc_will_it_fit( const xi_data_desc_t* const, size_t len );
 
 uint32_t xi_data_desc_pow2_realloc_strategy( uint32_t original, uint32_t desired );
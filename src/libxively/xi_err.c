@@ -76,7 +76,14 @@ const char* xi_error_string[XI_ERROR_COUNT] = {
     "XI_EVENT_PROCESS_STOPPED",              /* 59 XI_EVENT_PROCESS_STOPPED */
     "XI_STATE_RESEND",                       /* 60 XI_STATE_RESEND */
     "XI_NULL_HOST",                          /* 61 XI_STATE_RESEND */
-    "XI_TLS_FAILED_CERT_ERROR"               /* 62 XI_TLS_FAILED_CERT_ERROR */
+    "XI_TLS_FAILED_CERT_ERROR",              /* 62 XI_TLS_FAILED_CERT_ERROR */
+    "XI_FS_OPEN_ERROR",                      /* 63 XI_FS_OPEN_ERROR */
+    "XI_FS_OPEN_READ_ONLY",                  /* 64 XI_FS_OPEN_READ_ONLY */
+    "XI_FS_READ_ERROR",                      /* 65 XI_FS_READ_ERROR */
+    "XI_FS_WRITE_ERROR",                     /* 66 XI_FS_WRITE_ERROR */
+    "XI_FS_CLOSE_ERROR",                     /* 67 XI_FS_CLOSE_ERROR */
+    "XI_FS_REMOVE_ERROR",                    /* 68 XI_FS_REMOVE_ERROR */
+    "Too many QoS1 messages wait for a PUBACK", /* 69 XI_MQTT_PUBLISH_WINDOW_FULL */
 };
 #else
 const char empty_sting[] = "";
@@ -5,8 +5,11 @@
  */
 
 #include "xi_globals.h"
+#include "xi_config.h"
 
 xi_globals_t xi_globals = {.network_timeout        = 1500,
+                           .io_buffer_size         = XI_IO_BUFFER_SIZE,
+                           .publish_window         = XI_MQTT_PUBLISH_WINDOW,
                            .globals_ref_count      = 0,
                            .evtd_instance          = NULL,
                            .default_context        = NULL,
@@ -19,10 +19,16 @@ extern "C" {
 
 #include "xi_event_dispatcher_api.h"
 
+#ifndef XI_NO_TLS_LAYER
+#include <xi_bsp_tls.h>
+#endif
+
 /* This struct is used for run-time config */
 typedef struct
 {
     uint32_t network_timeout;
+    uint32_t io_buffer_size;
+    uint16_t publish_window;
     uint8_t globals_ref_count;
     xi_evtd_instance_t* evtd_instance;
     xi_context_t* default_context;
@@ -33,6 +39,11 @@ typedef struct
     char* str_account_id;
     char* str_device_unique_id;
     xi_backoff_status_t backoff_status;
+#ifndef XI_NO_TLS_LAYER
+    /* made by the first TLS connection, used by the others and released along with the
+     * last context */
+    xi_bsp_tls_config_t* tls_config;
+#endif
 } xi_globals_t;
 
 extern xi_globals_t xi_globals;
@@ -24,7 +24,14 @@ static inline int8_t xi_compare_context_pointers( const union xi_vector_selector
 void* xi_object_for_handle( xi_vector_t* vector, xi_handle_t handle )
 {
     assert( vector != NULL );
-    return xi_vector_get( vector, handle );
+
+    /* handles that don't fit into the vector index type can't be valid */
+    if ( handle < 0 || handle > XI_VECTOR_INDEX_TYPE_MAX )
+    {
+        return NULL;
+    }
+
+    return xi_vector_get( vector, ( xi_vector_index_type_t )handle );
 }
 
 xi_state_t
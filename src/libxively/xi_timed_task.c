@@ -18,7 +18,7 @@ typedef struct xi_timed_task_data_s
     void* data;
     xi_time_event_handle_t delayed_event;
     xi_evtd_instance_t* dispatcher;
-    xi_time_t seconds_repeat;
+    xi_time_t ticks_repeat;
     xi_timed_task_state_e state;
 } xi_timed_task_data_t;
 
@@ -52,7 +52,7 @@ xi_timed_task_handle_t xi_add_timed_task( xi_timed_task_container_t* container,
                                           xi_evtd_instance_t* dispatcher,
                                           xi_context_handle_t context_handle,
                                           xi_user_task_callback_t* callback,
-                                          xi_time_t seconds_from_now,
+                                          xi_time_t ticks_from_now,
                                           const uint8_t repeats_forever,
                                           void* data )
 {
@@ -70,7 +70,7 @@ xi_timed_task_handle_t xi_add_timed_task( xi_timed_task_container_t* container,
     task->callback       = callback;
     task->data           = data;
     task->dispatcher     = dispatcher;
-    task->seconds_repeat = ( repeats_forever ) ? seconds_from_now : 0;
+    task->ticks_repeat   = ( repeats_forever ) ? ticks_from_now : 0;
     task->state          = XI_TTS_SCHEDULED;
 
     xi_lock_critical_section( container->cs );
@@ -81,10 +81,10 @@ xi_timed_task_handle_t xi_add_timed_task( xi_timed_task_container_t* container,
                                                        task, &task_handle ) );
     xi_unlock_critical_section( container->cs );
 
-    state = xi_evtd_execute_in( dispatcher,
-                                xi_make_handle( &xi_timed_task_callback_wrapper,
-                                                ( void* )task, ( void* )container ),
-                                seconds_from_now, &task->delayed_event );
+    state = xi_evtd_execute_in_ticks( dispatcher,
+                                      xi_make_handle( &xi_timed_task_callback_wrapper,
+                                                      ( void* )task, ( void* )container ),
+                                      ticks_from_now, &task->delayed_event );
 
     XI_CHECK_STATE( state );
 
@@ -159,7 +159,7 @@ xi_state_t xi_timed_task_callback_wrapper( void* void_task, void* void_scheduler
 
         xi_lock_critical_section( container->cs );
 
-        if ( 0 == task->seconds_repeat || XI_TTS_DELETABLE == task->state )
+        if ( 0 == task->ticks_repeat || XI_TTS_DELETABLE == task->state )
         {
             xi_state_t del_state =
                 xi_delete_handle_for_object( container->timed_tasks_vector, task );
@@ -173,10 +173,10 @@ xi_state_t xi_timed_task_callback_wrapper( void* void_task, void* void_scheduler
         }
         else
         {
-            state = xi_evtd_execute_in(
+            state = xi_evtd_execute_in_ticks(
                 task->dispatcher, xi_make_handle( &xi_timed_task_callback_wrapper,
                                                   ( void* )task, ( void* )container ),
-                task->seconds_repeat, &task->delayed_event );
+                task->ticks_repeat, &task->delayed_event );
             assert( XI_STATE_OK == state );
             task->state = XI_TTS_SCHEDULED;
         }
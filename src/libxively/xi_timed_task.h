@@ -22,11 +22,12 @@ xi_timed_task_container_t* xi_make_timed_task_container();
 
 void xi_destroy_timed_task_container( xi_timed_task_container_t* container );
 
+/* ticks_from_now is given in the event dispatcher ticks, see XI_EVTD_TICKS_PER_SECOND */
 xi_timed_task_handle_t xi_add_timed_task( xi_timed_task_container_t* container,
                                           xi_evtd_instance_t* dispatcher,
                                           xi_context_handle_t context_handle,
                                           xi_user_task_callback_t* callback,
-                                          xi_time_t seconds_from_now,
+                                          xi_time_t ticks_from_now,
                                           const uint8_t repeats_forever,
                                           void* data );
 
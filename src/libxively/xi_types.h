@@ -52,6 +52,9 @@ typedef struct xi_context_data_s
                             solution to the problem of not binding xively interface with
                             layers directly */
     uint16_t copy_of_last_msg_id; /* value of the msg_id for continious session */
+    /* QoS1 PUBLISHes the logic layer has in flight or waiting for the publish window,
+     * it keeps them up to date for xi_publish* which checks the window against them */
+    uint16_t q12_publishes_outstanding;
 #endif
     /* this is the common part */
     xi_time_event_handle_t connect_handler;
@@ -65,6 +68,11 @@ typedef struct xi_context_data_s
     char** updateable_files;
     uint16_t updateable_files_count;
     xi_sft_url_handler_callback_t* sft_url_handler_callback;
+
+    /* TLS session of the last connection offered on reconnect so that it can be resumed
+     * without a full handshake, void* and a dstr for the same reason as above */
+    void* copy_of_tls_session;
+    void ( *copy_of_tls_session_dtor_ptr )( void** );
 } xi_context_data_t;
 
 typedef struct xi_context_s
@@ -10,6 +10,7 @@
 #include "xi_handle.h"
 #include "xi_mqtt_logic_layer_data.h"
 #include "xi_globals.h"
+#include "xi_macros.h"
 
 xi_state_t xi_user_sub_call_wrapper( void* context,
                                      void* data,
@@ -75,6 +76,16 @@ xi_state_t xi_user_sub_call_wrapper( void* context,
                 msg->publish.content ? msg->publish.content->length : 0;
             params.message.topic = ( const char* )sub_data->subscribe.topic;
 
+            params.message.payload_offset = msg->publish.content_offset;
+            params.message.payload_total_length =
+                XI_MAX( msg->publish.content_total_length,
+                        params.message.payload_offset +
+                            params.message.temporary_payload_data_length );
+            params.message.is_final_chunk =
+                ( params.message.payload_offset +
+                      params.message.temporary_payload_data_length ==
+                  params.message.payload_total_length );
+
             in_state = xi_mqtt_convert_to_qos( msg->common.common_u.common_bits.qos,
                                                &params.message.qos );
             XI_CHECK_STATE( in_state );
@@ -88,7 +99,9 @@ xi_state_t xi_user_sub_call_wrapper( void* context,
             XI_CHECK_STATE( in_state );
 
             ( ( xi_user_subscription_callback_t* )( client_callback ) )(
-                context_handle, XI_SUB_CALL_MESSAGE, &params, in_state, user_data );
+                context_handle, sub_data->subscribe.streamed ? XI_SUB_CALL_MESSAGE_CHUNK
+                                                             : XI_SUB_CALL_MESSAGE,
+                &params, in_state, user_data );
         }
         break;
         default:
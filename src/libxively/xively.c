@@ -86,6 +86,33 @@ uint32_t xi_get_network_timeout( void )
     return xi_globals.network_timeout;
 }
 
+xi_state_t xi_set_io_buffer_size( uint32_t size )
+{
+    if ( 0 == size )
+    {
+        return XI_INVALID_PARAMETER;
+    }
+
+    xi_globals.io_buffer_size = size;
+
+    return XI_STATE_OK;
+}
+
+uint32_t xi_get_io_buffer_size( void )
+{
+    return xi_globals.io_buffer_size;
+}
+
+void xi_set_publish_window( uint16_t window )
+{
+    xi_globals.publish_window = window;
+}
+
+uint16_t xi_get_publish_window( void )
+{
+    return xi_globals.publish_window;
+}
+
 /* indentifies characters that would break the
  * csv format, ie {,\n\r}.  Also checks the length of the string
  * to ensure that it's within the acceptible bounds of the Timeseries
@@ -204,10 +231,16 @@ xi_state_t xi_create_context_with_custom_layers_and_evtd(
         XI_CHECK_MEMORY( xi_globals.evtd_instance, state );
 
         /* note: this is NULL if thread module is disabled */
-        xi_globals.main_threadpool = xi_threadpool_create_instance( 1 );
+        xi_globals.main_threadpool = xi_threadpool_create_instance(
+            ( 0 == XI_THREADPOOL_NUMOFTHREADS ) ? xi_threadpool_get_num_of_cores()
+                                                : XI_THREADPOOL_NUMOFTHREADS );
 
         xi_globals.context_handles_vector = xi_vector_create();
         xi_globals.timed_tasks_container  = xi_make_timed_task_container();
+
+        xi_data_desc_pool_resize( XI_DATA_DESC_POOL_SIZE );
+        xi_mqtt_logic_task_pool_resize( XI_MQTT_LOGIC_TASK_POOL_SIZE );
+        xi_mqtt_codec_layer_task_pool_resize( XI_MQTT_CODEC_LAYER_TASK_POOL_SIZE );
     }
 
     /* allocate the structure to store new context */
@@ -330,6 +363,12 @@ static void xi_free_context_data( xi_context_t* context )
             &context_data->copy_of_q12_unacked_messages_queue );
     }
 
+    if ( context_data->copy_of_tls_session )
+    {
+        assert( NULL != context_data->copy_of_tls_session_dtor_ptr );
+        context_data->copy_of_tls_session_dtor_ptr( &context_data->copy_of_tls_session );
+    }
+
     {
         uint16_t id_file = 0;
         for ( ; id_file < context_data->updateable_files_count; ++id_file )
@@ -387,6 +426,14 @@ xi_state_t xi_delete_context_with_custom_layers( xi_context_t** context,
 
         xi_destroy_timed_task_container( xi_globals.timed_tasks_container );
         xi_globals.timed_tasks_container = NULL;
+
+        xi_data_desc_pool_resize( 0 );
+        xi_mqtt_logic_task_pool_resize( 0 );
+        xi_mqtt_codec_layer_task_pool_resize( 0 );
+
+#ifndef XI_NO_TLS_LAYER
+        xi_bsp_tls_config_release( &xi_globals.tls_config );
+#endif
     }
 
     return XI_STATE_OK;
@@ -728,7 +775,8 @@ xi_state_t xi_publish_data_impl( xi_context_handle_t xih,
                                  const xi_mqtt_qos_t qos,
                                  const xi_mqtt_retain_t retain,
                                  xi_user_callback_t* callback,
-                                 void* user_data )
+                                 void* user_data,
+                                 xi_event_handle_t release_handler )
 {
     /* PRE-CONDITIONS */
     assert( XI_INVALID_CONTEXT_HANDLE < xih );
@@ -761,16 +809,23 @@ xi_state_t xi_publish_data_impl( xi_context_handle_t xih,
     xi_state_t state           = XI_STATE_OK;
     xi_layer_t* input_layer    = xi->layer_chain.top;
 
-    xi_mqtt_logic_layer_data_t* layer_data =
-        ( xi_mqtt_logic_layer_data_t* )input_layer->user_data;
-
-    XI_UNUSED( layer_data );
+    /* the task is pushed to the logic layer asynchronously, so a burst made within one
+     * loop iteration can queue a few more than the window before this takes effect */
+    if ( XI_MQTT_QOS_AT_MOST_ONCE != effective_qos && 0 < xi_globals.publish_window &&
+         xi_globals.publish_window <=
+             XI_MQTT_LOGIC_LOAD_PUBLISHES_OUTSTANDING( &xi->context_data ) )
+    {
+        xi_free_desc( &data );
+        return XI_MQTT_PUBLISH_WINDOW_FULL;
+    }
 
     task = xi_mqtt_logic_make_publish_task( topic, data, effective_qos, retain,
                                             event_handle );
 
     XI_CHECK_MEMORY( task, state );
 
+    task->data.data_u->publish.release_handler = release_handler;
+
     return XI_PROCESS_PUSH_ON_THIS_LAYER( &input_layer->layer_connection, task,
                                           XI_STATE_OK );
 
@@ -802,7 +857,7 @@ xi_state_t xi_publish( xi_context_handle_t xih,
     XI_CHECK_MEMORY( data_desc, state );
 
     return xi_publish_data_impl( xih, topic, data_desc, qos, retain, callback,
-                                 user_data );
+                                 user_data, xi_make_empty_handle() );
 
 err_handling:
     return state;
@@ -824,7 +879,7 @@ xi_state_t xi_publish_timeseries( xi_context_handle_t xih,
     XI_CHECK_MEMORY( data_desc, state );
 
     return xi_publish_data_impl( xih, topic, data_desc, qos, XI_MQTT_RETAIN_FALSE,
-                                 callback, user_data );
+                                 callback, user_data, xi_make_empty_handle() );
 
 err_handling:
     return state;
@@ -980,7 +1035,7 @@ xi_state_t xi_publish_formatted_timeseries( xi_context_handle_t xih,
     XI_CHECK_MEMORY( data_desc, state );
 
     state = xi_publish_data_impl( xih, topic, data_desc, qos, XI_MQTT_RETAIN_FALSE,
-                                  callback, user_data );
+                                  callback, user_data, xi_make_empty_handle() );
 
 err_handling:
 
@@ -1012,17 +1067,66 @@ xi_state_t xi_publish_data( xi_context_handle_t xih,
     XI_CHECK_MEMORY( data_desc, state );
 
     return xi_publish_data_impl( xih, topic, data_desc, qos, retain, callback,
-                                 user_data );
+                                 user_data, xi_make_empty_handle() );
 
 err_handling:
     return state;
 }
 
-xi_state_t xi_subscribe( xi_context_handle_t xih,
-                         const char* topic,
-                         const xi_mqtt_qos_t qos,
-                         xi_user_subscription_callback_t* callback,
-                         void* user_data )
+static xi_state_t xi_buffer_release_callback_wrapper( void* buffer,
+                                                      void* user_data,
+                                                      xi_state_t in_state,
+                                                      void* release_callback )
+{
+    XI_UNUSED( in_state );
+
+    assert( NULL != release_callback );
+
+    ( ( xi_buffer_release_callback_t* )( release_callback ) )( ( const uint8_t* )buffer,
+                                                               user_data );
+
+    return XI_STATE_OK;
+}
+
+xi_state_t xi_publish_data_borrowed( xi_context_handle_t xih,
+                                     const char* topic,
+                                     const uint8_t* data,
+                                     size_t data_len,
+                                     const xi_mqtt_qos_t qos,
+                                     const xi_mqtt_retain_t retain,
+                                     xi_user_callback_t* callback,
+                                     xi_buffer_release_callback_t* release_callback,
+                                     void* user_data )
+{
+    /* PRE-CONDITIONS */
+    assert( NULL != topic );
+    assert( NULL != data );
+    assert( 0 != data_len );
+    assert( NULL != release_callback );
+
+    xi_state_t state = XI_STATE_OK;
+
+    /* the payload is not copied, it is sent straight from the application's buffer */
+    xi_data_desc_t* data_desc =
+        xi_make_desc_from_buffer_share( ( unsigned char* )data, data_len );
+
+    XI_CHECK_MEMORY( data_desc, state );
+
+    return xi_publish_data_impl(
+        xih, topic, data_desc, qos, retain, callback, user_data,
+        xi_make_handle( &xi_buffer_release_callback_wrapper, ( void* )data, user_data,
+                        XI_STATE_OK, ( void* )release_callback ) );
+
+err_handling:
+    return state;
+}
+
+static xi_state_t xi_subscribe_impl( xi_context_handle_t xih,
+                                     const char* topic,
+                                     const xi_mqtt_qos_t qos,
+                                     xi_user_subscription_callback_t* callback,
+                                     void* user_data,
+                                     uint8_t streamed )
 {
     if ( ( XI_INVALID_CONTEXT_HANDLE == xih ) || ( NULL == topic ) ||
          ( NULL == callback ) )
@@ -1066,6 +1170,8 @@ xi_state_t xi_subscribe( xi_context_handle_t xih,
     task = xi_mqtt_logic_make_subscribe_task( internal_topic, qos, event_handle );
     XI_CHECK_MEMORY( task, state );
 
+    task->data.data_u->subscribe.streamed = streamed;
+
     /* pass the partial ownership of the task data to the handler ( in case of
      * subscription failure it will release the memory ) */
     task->data.data_u->subscribe.handler.handlers.h6.a6 = task->data.data_u;
@@ -1084,6 +1190,24 @@ err_handling:
     return state;
 }
 
+xi_state_t xi_subscribe( xi_context_handle_t xih,
+                         const char* topic,
+                         const xi_mqtt_qos_t qos,
+                         xi_user_subscription_callback_t* callback,
+                         void* user_data )
+{
+    return xi_subscribe_impl( xih, topic, qos, callback, user_data, 0 );
+}
+
+xi_state_t xi_subscribe_streamed( xi_context_handle_t xih,
+                                  const char* topic,
+                                  const xi_mqtt_qos_t qos,
+                                  xi_user_subscription_callback_t* callback,
+                                  void* user_data )
+{
+    return xi_subscribe_impl( xih, topic, qos, callback, user_data, 1 );
+}
+
 xi_state_t xi_shutdown_connection( xi_context_handle_t xih )
 {
     assert( XI_INVALID_CONTEXT_HANDLE < xih );
@@ -1150,7 +1274,20 @@ xi_timed_task_handle_t xi_schedule_timed_task( xi_context_handle_t xih,
                                                void* data )
 {
     return xi_add_timed_task( xi_globals.timed_tasks_container, xi_globals.evtd_instance,
-                              xih, callback, seconds_from_now, repeats_forever, data );
+                              xih, callback, XI_EVTD_SECONDS_TO_TICKS( seconds_from_now ),
+                              repeats_forever, data );
+}
+
+xi_timed_task_handle_t xi_schedule_timed_task_ms( xi_context_handle_t xih,
+                                                  xi_user_task_callback_t* callback,
+                                                  const xi_time_t milliseconds_from_now,
+                                                  const uint8_t repeats_forever,
+                                                  void* data )
+{
+    return xi_add_timed_task( xi_globals.timed_tasks_container, xi_globals.evtd_instance,
+                              xih, callback,
+                              XI_EVTD_MILLISECONDS_TO_TICKS( milliseconds_from_now ),
+                              repeats_forever, data );
 }
 
 void xi_cancel_timed_task( xi_timed_task_handle_t timed_task_handle )
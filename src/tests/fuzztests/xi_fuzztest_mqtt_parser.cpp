@@ -1,48 +1,178 @@
 #include <memory.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <xi_mqtt_parser.h>
 #include <xi_mqtt_message.h>
 #include <xi_macros.h>
 
-const static size_t XI_BUFFER_SIZE = 32;
+/* upper bound of the messages compared from a single input */
+const static size_t XI_MAX_MESSAGES = 16;
 
-/* This is the fuzzer signature, and we cannot change it */
-extern "C" int LLVMFuzzerTestOneInput( const uint8_t* data, size_t size )
+/*
+ * Parses the input handing it to the parser in chunks of chunk_size bytes. With chunks
+ * of a single byte no packet is ever whole in the buffer so every one of them goes
+ * through the coroutine, with the whole input as one chunk each complete packet takes
+ * the fast path.
+ */
+static size_t xi_fuzztest_parse( const uint8_t* data,
+                                 size_t size,
+                                 size_t chunk_size,
+                                 xi_mqtt_message_t** messages,
+                                 xi_state_t* last_state )
 {
     xi_mqtt_parser_t parser;
     xi_state_t local_state = XI_STATE_OK;
     xi_mqtt_message_t* msg = NULL;
+    size_t messages_count  = 0;
+    size_t size_eaten      = 0;
 
-    size_t size_eaten = 0;
+    *last_state = XI_STATE_WANT_READ;
 
     XI_ALLOC_AT( xi_mqtt_message_t, msg, local_state );
     xi_mqtt_parser_init( &parser );
 
-    while ( size_eaten != size )
+    while ( size_eaten != size && messages_count < XI_MAX_MESSAGES )
     {
-        const size_t copied_buffer_size = XI_MIN( XI_BUFFER_SIZE, ( size - size_eaten ) );
+        const size_t copied_buffer_size = XI_MIN( chunk_size, ( size - size_eaten ) );
 
         xi_data_desc_t* data_desc =
             xi_make_desc_from_buffer_copy( data + size_eaten, copied_buffer_size );
 
-        local_state = xi_mqtt_parser_execute( &parser, msg, data_desc );
-
-        if ( local_state == XI_STATE_OK || local_state == XI_MQTT_PARSER_ERROR )
+        if ( NULL == data_desc )
         {
-            xi_mqtt_message_free( &msg );
-            XI_ALLOC_AT( xi_mqtt_message_t, msg, local_state );
+            break;
         }
 
-        size_eaten += copied_buffer_size - ( data_desc->length - data_desc->curr_pos );
+        *last_state = xi_mqtt_parser_execute( &parser, msg, data_desc );
+
+        size_eaten += data_desc->curr_pos;
 
         xi_free_desc( &data_desc );
+
+        if ( *last_state == XI_STATE_OK )
+        {
+            messages[messages_count++] = msg;
+            msg                        = NULL;
+
+            XI_ALLOC_AT( xi_mqtt_message_t, msg, local_state );
+            xi_mqtt_parser_init( &parser );
+        }
+        else if ( *last_state != XI_STATE_WANT_READ )
+        {
+            break;
+        }
     }
 
+err_handling:
     xi_mqtt_message_free( &msg );
 
-err_handling:
+    return messages_count;
+}
+
+static bool xi_fuzztest_desc_equal( const xi_data_desc_t* a, const xi_data_desc_t* b )
+{
+    if ( NULL == a || NULL == b )
+    {
+        return a == b;
+    }
+
+    return a->length == b->length && 0 == memcmp( a->data_ptr, b->data_ptr, a->length );
+}
+
+static bool xi_fuzztest_message_equal( const xi_mqtt_message_t* a,
+                                       const xi_mqtt_message_t* b )
+{
+    if ( a->common.common_u.common_value != b->common.common_u.common_value ||
+         a->common.remaining_length != b->common.remaining_length )
+    {
+        return false;
+    }
+
+    switch ( a->common.common_u.common_bits.type )
+    {
+        case XI_MQTT_TYPE_CONNECT:
+            return xi_fuzztest_desc_equal( a->connect.protocol_name,
+                                           b->connect.protocol_name ) &&
+                   a->connect.protocol_version == b->connect.protocol_version &&
+                   a->connect.flags_u.flags_value == b->connect.flags_u.flags_value &&
+                   a->connect.keepalive == b->connect.keepalive &&
+                   xi_fuzztest_desc_equal( a->connect.client_id, b->connect.client_id ) &&
+                   xi_fuzztest_desc_equal( a->connect.will_topic,
+                                           b->connect.will_topic ) &&
+                   xi_fuzztest_desc_equal( a->connect.will_message,
+                                           b->connect.will_message ) &&
+                   xi_fuzztest_desc_equal( a->connect.username, b->connect.username ) &&
+                   xi_fuzztest_desc_equal( a->connect.password, b->connect.password );
+        case XI_MQTT_TYPE_CONNACK:
+            return a->connack._unused == b->connack._unused &&
+                   a->connack.return_code == b->connack.return_code;
+        case XI_MQTT_TYPE_PUBLISH:
+            return xi_fuzztest_desc_equal( a->publish.topic_name,
+                                           b->publish.topic_name ) &&
+                   a->publish.message_id == b->publish.message_id &&
+                   xi_fuzztest_desc_equal( a->publish.content, b->publish.content );
+        case XI_MQTT_TYPE_PUBACK:
+        case XI_MQTT_TYPE_PUBREC:
+        case XI_MQTT_TYPE_PUBREL:
+        case XI_MQTT_TYPE_PUBCOMP:
+            return a->puback.message_id == b->puback.message_id;
+        case XI_MQTT_TYPE_SUBSCRIBE:
+            return a->subscribe.message_id == b->subscribe.message_id &&
+                   xi_fuzztest_desc_equal( a->subscribe.topics->name,
+                                           b->subscribe.topics->name ) &&
+                   a->subscribe.topics->xi_mqtt_topic_pair_payload_u.qos ==
+                       b->subscribe.topics->xi_mqtt_topic_pair_payload_u.qos;
+        case XI_MQTT_TYPE_SUBACK:
+            return a->suback.message_id == b->suback.message_id &&
+                   a->suback.topics->xi_mqtt_topic_pair_payload_u.status ==
+                       b->suback.topics->xi_mqtt_topic_pair_payload_u.status;
+        default:
+            return true;
+    }
+}
+
+/* This is the fuzzer signature, and we cannot change it */
+extern "C" int LLVMFuzzerTestOneInput( const uint8_t* data, size_t size )
+{
+    xi_mqtt_message_t* coroutine_messages[XI_MAX_MESSAGES] = {NULL};
+    xi_mqtt_message_t* fast_path_messages[XI_MAX_MESSAGES] = {NULL};
+    xi_state_t coroutine_state                             = XI_STATE_OK;
+    xi_state_t fast_path_state                             = XI_STATE_OK;
+
+    const size_t coroutine_count =
+        xi_fuzztest_parse( data, size, 1, coroutine_messages, &coroutine_state );
+    const size_t fast_path_count =
+        xi_fuzztest_parse( data, size, size, fast_path_messages, &fast_path_state );
+
+    /* the coroutine waits for one more byte after a packet ending with an empty
+     * string or payload, the fast path returns it right away */
+    const bool counts_match =
+        coroutine_count == fast_path_count ||
+        ( coroutine_count + 1 == fast_path_count &&
+          coroutine_state == XI_STATE_WANT_READ );
+
+    if ( !counts_match )
+    {
+        abort();
+    }
+
+    size_t i = 0;
+    for ( ; i < coroutine_count; ++i )
+    {
+        if ( !xi_fuzztest_message_equal( coroutine_messages[i], fast_path_messages[i] ) )
+        {
+            abort();
+        }
+    }
+
+    for ( i = 0; i < XI_MAX_MESSAGES; ++i )
+    {
+        xi_mqtt_message_free( &coroutine_messages[i] );
+        xi_mqtt_message_free( &fast_path_messages[i] );
+    }
+
     return 0;
 }
@@ -25,6 +25,25 @@ extern xi_context_t* xi_context_mockbroker; // test mock broker context
 /************************************************************************************
  * mock broker primary layer ********************************************************
 ************************************************************************************/
+/* copies the data of a descriptor chain, e.g. a PUBLISH header and its payload, into a
+ * single descriptor as if it arrived from the network */
+static xi_data_desc_t* xi_mock_broker_copy_desc_chain( const xi_data_desc_t* chain )
+{
+    xi_data_desc_t* copy =
+        xi_make_desc_from_buffer_copy( chain->data_ptr, chain->length );
+
+    for ( chain = chain->__next; NULL != copy && NULL != chain; chain = chain->__next )
+    {
+        if ( XI_STATE_OK != xi_data_desc_append_data_resize(
+                                copy, ( const char* )chain->data_ptr, chain->length ) )
+        {
+            xi_free_desc( &copy );
+        }
+    }
+
+    return copy;
+}
+
 xi_state_t xi_mock_broker_layer_push__ERROR_CHANNEL()
 {
     return mock_type( xi_state_t );
@@ -61,7 +80,7 @@ xi_state_t xi_mock_broker_layer_push( void* context, void* data, xi_state_t in_o
     if ( control != CONTROL_CONTINUE )
     {
         xi_data_desc_t* buffer = ( xi_data_desc_t* )data;
-        xi_free_desc( &buffer );
+        xi_free_desc_chain( &buffer );
 
         in_out_state = xi_mock_broker_layer_push__ERROR_CHANNEL();
 
@@ -72,11 +91,11 @@ xi_state_t xi_mock_broker_layer_push( void* context, void* data, xi_state_t in_o
     {
         /* duplicate the received data since it will forwarded into two directions */
         xi_data_desc_t* orig = ( xi_data_desc_t* )data;
-        xi_data_desc_t* copy =
-            xi_make_desc_from_buffer_copy( orig->data_ptr, orig->length );
+        xi_data_desc_t* copy = xi_mock_broker_copy_desc_chain( orig );
 
-        /* forward to mockbroker layerchain, note the PUSH to PULL conversion */
-        xi_evtd_execute_in(
+        /* forward to mockbroker layerchain, note the PUSH to PULL conversion, the
+         * network takes a tick */
+        xi_evtd_execute_in_ticks(
             xi_globals.evtd_instance,
             xi_make_handle( xi_itest_find_layer( xi_context_mockbroker,
                                                  XI_LAYER_TYPE_MOCKBROKER_MQTT_CODEC )
@@ -106,12 +125,20 @@ xi_state_t xi_mock_broker_layer_push( void* context, void* data, xi_state_t in_o
             xi_mock_broker_data_t* layer_data =
                 ( xi_mock_broker_data_t* )layer->user_data;
 
-            if ( NULL != layer_data )
+            xi_mqtt_written_data_t* written_data = ( xi_mqtt_written_data_t* )data;
+
+            /* replies are written in the order they were pushed, the oldest payload
+             * is the one of this PUBLISH */
+            if ( NULL != layer_data && NULL != written_data &&
+                 XI_MQTT_TYPE_PUBLISH == written_data->a2 &&
+                 NULL != layer_data->outgoing_publish_content )
             {
-                xi_free_desc( &layer_data->outgoing_publish_content );
+                xi_data_desc_t* written_content = layer_data->outgoing_publish_content;
+                layer_data->outgoing_publish_content = written_content->__next;
+                written_content->__next              = NULL;
+                xi_free_desc( &written_content );
             }
 
-            xi_mqtt_written_data_t* written_data = ( xi_mqtt_written_data_t* )data;
             XI_SAFE_FREE_TUPLE( written_data );
         }
 
@@ -119,6 +146,68 @@ xi_state_t xi_mock_broker_layer_push( void* context, void* data, xi_state_t in_o
     }
 }
 
+/* the client's codec splits large PUBLISH payloads the same way for the broker's chain,
+ * the parts received so far are put together here */
+static xi_mqtt_message_t* xi_mock_broker_publish_in_parts = NULL;
+
+/* returns the whole PUBLISH once its last part arrived, NULL before that */
+static xi_mqtt_message_t*
+xi_mock_broker_collect_publish_part( xi_mqtt_message_t* msg, xi_state_t* state )
+{
+    const size_t offset   = msg->publish.content_offset;
+    const size_t part_end =
+        offset + ( NULL != msg->publish.content ? msg->publish.content->length : 0 );
+
+    if ( 0 == offset && part_end >= msg->publish.content_total_length )
+    {
+        return msg;
+    }
+
+    if ( 0 == offset )
+    {
+        xi_mqtt_message_free( &xi_mock_broker_publish_in_parts );
+
+        /* sized once for the whole payload, like the client's logic layer does */
+        xi_data_desc_t* content =
+            xi_make_empty_desc_alloc_uninitialized( msg->publish.content_total_length );
+
+        if ( NULL == content )
+        {
+            xi_mqtt_message_free( &msg );
+            *state = XI_OUT_OF_MEMORY;
+            return NULL;
+        }
+
+        xi_data_desc_append_data( content, msg->publish.content );
+        xi_free_desc( &msg->publish.content );
+        msg->publish.content = content;
+
+        xi_mock_broker_publish_in_parts = msg;
+        return NULL;
+    }
+
+    xi_mqtt_message_t* whole = xi_mock_broker_publish_in_parts;
+    assert( NULL != whole );
+
+    *state = xi_data_desc_append_data( whole->publish.content, msg->publish.content );
+
+    xi_mqtt_message_free( &msg );
+
+    if ( XI_STATE_OK != *state || part_end < whole->publish.content_total_length )
+    {
+        if ( XI_STATE_OK != *state )
+        {
+            xi_mqtt_message_free( &xi_mock_broker_publish_in_parts );
+        }
+
+        return NULL;
+    }
+
+    xi_mock_broker_publish_in_parts = NULL;
+
+    return whole;
+}
+
 xi_state_t xi_mock_broker_layer_pull( void* context, void* data, xi_state_t in_out_state )
 {
     XI_LAYER_FUNCTION_PRINT_FUNCTION_DIGEST();
@@ -145,6 +234,16 @@ xi_state_t xi_mock_broker_layer_pull( void* context, void* data, xi_state_t in_o
     {
         assert( NULL != recvd_msg ); // sanity check
 
+        if ( XI_MQTT_TYPE_PUBLISH == recvd_msg->common.common_u.common_bits.type )
+        {
+            recvd_msg = xi_mock_broker_collect_publish_part( recvd_msg, &in_out_state );
+
+            if ( NULL == recvd_msg )
+            {
+                return in_out_state;
+            }
+        }
+
         // const uint16_t msg_id = xi_mqtt_get_message_id( recvd_msg );
         const xi_mqtt_type_t recvd_msg_type = recvd_msg->common.common_u.common_bits.type;
 
@@ -215,6 +314,20 @@ xi_state_t xi_mock_broker_layer_pull( void* context, void* data, xi_state_t in_o
                                         msg_puback, recvd_msg->publish.message_id ) );
 
                     xi_mqtt_message_free( &recvd_msg );
+
+                    if ( NULL != layer_data && 0 < layer_data->puback_latency_ticks )
+                    {
+                        xi_layer_t* codec_layer = xi_itest_find_layer(
+                            xi_context_mockbroker, XI_LAYER_TYPE_MOCKBROKER_MQTT_CODEC );
+
+                        return xi_evtd_execute_in_ticks(
+                            xi_globals.evtd_instance,
+                            xi_make_handle( codec_layer->layer_funcs->push,
+                                            &codec_layer->layer_connection, msg_puback,
+                                            in_out_state ),
+                            layer_data->puback_latency_ticks, NULL );
+                    }
+
                     return XI_PROCESS_PUSH_ON_PREV_LAYER( context, msg_puback,
                                                           in_out_state );
                 }
@@ -243,7 +356,15 @@ xi_state_t xi_mock_broker_layer_pull( void* context, void* data, xi_state_t in_o
                             recvd_msg->common.common_u.common_bits.dup,
                             recvd_msg->publish.message_id );
 
-                        layer_data->outgoing_publish_content = reply_sft_cbor_encoded;
+                        /* the payload is shared with the message until it is written,
+                         * several replies may be on their way at the same time */
+                        xi_data_desc_t** last_content =
+                            &layer_data->outgoing_publish_content;
+                        while ( NULL != *last_content )
+                        {
+                            last_content = &( *last_content )->__next;
+                        }
+                        *last_content = reply_sft_cbor_encoded;
 
                         xi_mqtt_message_free( &recvd_msg );
 
@@ -285,6 +406,7 @@ xi_mock_broker_layer_close( void* context, void* data, xi_state_t in_out_state )
     xi_mock_broker_data_t* layer_data = ( xi_mock_broker_data_t* )layer->user_data;
 
     XI_SAFE_FREE( layer_data );
+    xi_mqtt_message_free( &xi_mock_broker_publish_in_parts );
 
     return XI_PROCESS_CLOSE_ON_PREV_LAYER( context, data, in_out_state );
 }
@@ -359,7 +481,7 @@ xi_mock_broker_secondary_layer_push( void* context, void* data, xi_state_t in_ou
     if ( control == CONTROL_ERROR )
     {
         xi_data_desc_t* buffer = ( xi_data_desc_t* )data;
-        xi_free_desc( &buffer );
+        xi_free_desc_chain( &buffer );
 
         in_out_state = mock_type( xi_state_t );
 
@@ -382,15 +504,14 @@ xi_mock_broker_secondary_layer_push( void* context, void* data, xi_state_t in_ou
          * network as well. This is required for PUBLISH payloads which are not copied
          * between layers */
         xi_data_desc_t* orig = ( xi_data_desc_t* )data;
-        xi_data_desc_t* copy =
-            xi_make_desc_from_buffer_copy( orig->data_ptr, orig->length );
+        xi_data_desc_t* copy = xi_mock_broker_copy_desc_chain( orig );
 
         /* data_desc deallocation is done by the real IO layer too */
-        xi_free_desc( &orig );
+        xi_free_desc_chain( &orig );
 
         /* jump to SUT libxively's codec layer pull function, mimicing incoming
-         * encoded message */
-        xi_evtd_execute_in(
+         * encoded message, the network takes a tick */
+        xi_evtd_execute_in_ticks(
             xi_globals.evtd_instance,
             xi_make_handle(
                 xi_itest_find_layer( xi_context, XI_LAYER_TYPE_MQTT_CODEC_SUT )
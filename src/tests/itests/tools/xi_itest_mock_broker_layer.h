@@ -24,7 +24,11 @@ typedef struct xi_mock_broker_data_s
     const char* control_topic_name_broker_in;
     const char* control_topic_name_broker_out;
 
+    /* payloads of the PUBLISH replies not written yet, oldest first, linked by __next */
     xi_data_desc_t* outgoing_publish_content;
+
+    /* PUBACKs are held back this long to mimic a distant broker, 0 sends them at once */
+    xi_time_t puback_latency_ticks;
 } xi_mock_broker_data_t;
 
 /**
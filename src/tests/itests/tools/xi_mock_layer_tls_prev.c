@@ -42,7 +42,7 @@ xi_mock_layer_tls_prev_push( void* context, void* data, xi_state_t in_out_state
         mock_type( xi_mock_layer_tls_prev_control_t );
 
     xi_data_desc_t* data_desc = ( xi_data_desc_t* )data;
-    xi_free_desc( &data_desc );
+    xi_free_desc_chain( &data_desc );
 
     switch ( mock_control_directive )
     {
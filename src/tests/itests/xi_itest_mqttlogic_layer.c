@@ -136,6 +136,34 @@ xi_state_t xi_itest_mqttlogic_call_subscribe( xi_context_handle_t xih,
                          &xi_itest_mqttlogic_subscribe_callback, NULL );
 }
 
+typedef struct xi_itest_mqttlogic_release_count_s
+{
+    const uint8_t* buffer;
+    int count;
+} xi_itest_mqttlogic_release_count_t;
+
+void xi_itest_mqttlogic_release_callback( const uint8_t* buffer, void* user_data )
+{
+    xi_itest_mqttlogic_release_count_t* release = user_data;
+
+    assert_ptr_equal( release->buffer, buffer );
+    release->count += 1;
+}
+
+static void xi_itest_mqttlogic_expect_publish_written( xi_mqtt_qos_t qos )
+{
+    expect_value( xi_mock_layer_mqttlogic_next_push, in_out_state, XI_STATE_OK );
+    expect_value( xi_mock_layer_mqttlogic_prev_push, in_out_state, XI_STATE_OK );
+    expect_check( xi_mock_layer_mqttlogic_prev_push, data, check_msg,
+                  xi_itest_mqttlogic_make_msg_test_matrix(
+                      ( xi_itest_mqttlogic_test_msg_what_to_check_t ){
+                          .retain = 0, .qos = 1, .dup = 0, .type = 1},
+                      ( xi_itest_mqttlogic_test_msg_common_bits_check_values_t ){
+                          .retain = 0, .qos = qos, .dup = 0,
+                          .type = XI_MQTT_TYPE_PUBLISH} ) );
+    will_return( xi_mock_layer_mqttlogic_prev_push, XI_STATE_OK );
+}
+
 static const xi_itest_mqttlogic_persistant_session_test_sample_t
     XI_ITEST_MQTTLOGIC_PERSISTANT_SESSION_TEST_DATA[] = {
         {XI_MQTT_TYPE_PUBLISH, &xi_itest_mqttlogic_call_publish},
@@ -923,3 +951,185 @@ void xi_itest_mqtt_logic_layer__persistant_session__success_unacked_messages_are
 err_handling:
     xi_itest_mqttlogic_shutdown_and_disconnect( context_handle );
 }
+
+void xi_itest_mqtt_logic_layer__publish_window_full__next_publish_waits_for_puback(
+    void** state )
+{
+    XI_UNUSED( state );
+
+    xi_state_t local_state             = XI_STATE_OK;
+    xi_mqtt_message_t* puback          = NULL;
+    xi_context_handle_t context_handle = XI_INVALID_CONTEXT_HANDLE;
+    const uint16_t publish_window      = xi_get_publish_window();
+
+    /* initialisation of the layer chain */
+    xi_layer_t* top_layer = xi_context__itest_mqttlogic_layer->layer_chain.top;
+    xi_itest_mqttlogic_prepare_init_and_connect_layer( top_layer, XI_SESSION_CLEAN, 0 );
+    xi_itest_mqttlogic_layer_act();
+
+    XI_CHECK_STATE( local_state = xi_find_handle_for_object(
+                        xi_globals.context_handles_vector,
+                        xi_context__itest_mqttlogic_layer, &context_handle ) );
+
+    xi_set_publish_window( 1 );
+
+    /* both are made before the event loop runs, so both are accepted */
+    assert_int_equal( XI_STATE_OK, xi_itest_mqttlogic_call_publish(
+                                        context_handle, "test_topic", "first" ) );
+    assert_int_equal( XI_STATE_OK, xi_itest_mqttlogic_call_publish(
+                                        context_handle, "test_topic", "second" ) );
+
+    /* the first one fits the window and goes out right away, the second one is queued,
+     * the prev layer must not see it yet */
+    expect_value( xi_mock_layer_mqttlogic_next_push, in_out_state, XI_STATE_OK );
+    expect_value( xi_mock_layer_mqttlogic_next_push, in_out_state, XI_STATE_OK );
+    expect_value( xi_mock_layer_mqttlogic_prev_push, in_out_state, XI_STATE_OK );
+    expect_check( xi_mock_layer_mqttlogic_prev_push, data, check_msg,
+                  xi_itest_mqttlogic_make_msg_test_matrix(
+                      ( xi_itest_mqttlogic_test_msg_what_to_check_t ){
+                          .retain = 0, .qos = 1, .dup = 1, .type = 1},
+                      ( xi_itest_mqttlogic_test_msg_common_bits_check_values_t ){
+                          .retain = 0, .qos = 1, .dup = 0,
+                          .type = XI_MQTT_TYPE_PUBLISH} ) );
+    will_return( xi_mock_layer_mqttlogic_prev_push, XI_STATE_OK );
+
+    xi_itest_mqttlogic_layer_act();
+
+    /* one in flight and one queued fill the window, the caller is pushed back */
+    assert_int_equal(
+        XI_MQTT_PUBLISH_WINDOW_FULL,
+        xi_itest_mqttlogic_call_publish( context_handle, "test_topic", "third" ) );
+
+    /* the PUBACK of the first publish makes room for the second one */
+    XI_ALLOC_AT( xi_mqtt_message_t, puback, local_state );
+    XI_CHECK_STATE( local_state = fill_with_puback_data( puback, 1 ) );
+    XI_PROCESS_PULL_ON_PREV_LAYER( &top_layer->layer_connection, puback, XI_STATE_OK );
+
+    expect_value( xi_mock_layer_mqttlogic_prev_push, in_out_state, XI_STATE_OK );
+    expect_check( xi_mock_layer_mqttlogic_prev_push, data, check_msg,
+                  xi_itest_mqttlogic_make_msg_test_matrix(
+                      ( xi_itest_mqttlogic_test_msg_what_to_check_t ){
+                          .retain = 0, .qos = 1, .dup = 1, .type = 1},
+                      ( xi_itest_mqttlogic_test_msg_common_bits_check_values_t ){
+                          .retain = 0, .qos = 1, .dup = 0,
+                          .type = XI_MQTT_TYPE_PUBLISH} ) );
+    will_return( xi_mock_layer_mqttlogic_prev_push, XI_STATE_OK );
+
+    xi_itest_mqttlogic_layer_act();
+
+    xi_set_publish_window( publish_window );
+    xi_itest_mqttlogic_shutdown_and_disconnect( context_handle );
+
+    return;
+err_handling:
+    xi_mqtt_message_free( &puback );
+    xi_set_publish_window( publish_window );
+    xi_itest_mqttlogic_shutdown_and_disconnect( context_handle );
+}
+
+void xi_itest_mqtt_logic_layer__borrowed_publish_delivered__buffer_released_once(
+    void** state )
+{
+    XI_UNUSED( state );
+
+    xi_state_t local_state             = XI_STATE_OK;
+    xi_mqtt_message_t* puback          = NULL;
+    xi_context_handle_t context_handle = XI_INVALID_CONTEXT_HANDLE;
+
+    const uint8_t payload_q0[] = "borrowed qos0";
+    const uint8_t payload_q1[] = "borrowed qos1";
+
+    xi_itest_mqttlogic_release_count_t release_q0 = {payload_q0, 0};
+    xi_itest_mqttlogic_release_count_t release_q1 = {payload_q1, 0};
+
+    xi_layer_t* top_layer = xi_context__itest_mqttlogic_layer->layer_chain.top;
+    xi_itest_mqttlogic_prepare_init_and_connect_layer( top_layer, XI_SESSION_CLEAN, 0 );
+    xi_itest_mqttlogic_layer_act();
+
+    XI_CHECK_STATE( local_state = xi_find_handle_for_object(
+                        xi_globals.context_handles_vector,
+                        xi_context__itest_mqttlogic_layer, &context_handle ) );
+
+    /* QoS0 hands the buffer back as soon as it is written */
+    assert_int_equal( XI_STATE_OK,
+                      xi_publish_data_borrowed(
+                          context_handle, "test_topic", payload_q0, sizeof( payload_q0 ),
+                          XI_MQTT_QOS_AT_MOST_ONCE, XI_MQTT_RETAIN_FALSE, NULL,
+                          &xi_itest_mqttlogic_release_callback, &release_q0 ) );
+
+    xi_itest_mqttlogic_expect_publish_written( XI_MQTT_QOS_AT_MOST_ONCE );
+    xi_itest_mqttlogic_layer_act();
+
+    assert_int_equal( 1, release_q0.count );
+
+    /* QoS1 keeps it until the PUBACK, a resend would need it */
+    assert_int_equal( XI_STATE_OK,
+                      xi_publish_data_borrowed(
+                          context_handle, "test_topic", payload_q1, sizeof( payload_q1 ),
+                          XI_MQTT_QOS_AT_LEAST_ONCE, XI_MQTT_RETAIN_FALSE, NULL,
+                          &xi_itest_mqttlogic_release_callback, &release_q1 ) );
+
+    xi_itest_mqttlogic_expect_publish_written( XI_MQTT_QOS_AT_LEAST_ONCE );
+    xi_itest_mqttlogic_layer_act();
+
+    assert_int_equal( 0, release_q1.count );
+
+    XI_ALLOC_AT( xi_mqtt_message_t, puback, local_state );
+    XI_CHECK_STATE( local_state = fill_with_puback_data( puback, 1 ) );
+    XI_PROCESS_PULL_ON_PREV_LAYER( &top_layer->layer_connection, puback, XI_STATE_OK );
+
+    xi_itest_mqttlogic_layer_act();
+
+    assert_int_equal( 1, release_q1.count );
+
+    xi_itest_mqttlogic_shutdown_and_disconnect( context_handle );
+
+    assert_int_equal( 1, release_q0.count );
+    assert_int_equal( 1, release_q1.count );
+
+    return;
+err_handling:
+    xi_mqtt_message_free( &puback );
+    xi_itest_mqttlogic_shutdown_and_disconnect( context_handle );
+}
+
+void xi_itest_mqtt_logic_layer__borrowed_publish_dropped__buffer_released_once(
+    void** state )
+{
+    XI_UNUSED( state );
+
+    xi_state_t local_state             = XI_STATE_OK;
+    xi_context_handle_t context_handle = XI_INVALID_CONTEXT_HANDLE;
+
+    const uint8_t payload[] = "borrowed qos1";
+
+    xi_itest_mqttlogic_release_count_t release = {payload, 0};
+
+    xi_layer_t* top_layer = xi_context__itest_mqttlogic_layer->layer_chain.top;
+    xi_itest_mqttlogic_prepare_init_and_connect_layer( top_layer, XI_SESSION_CLEAN, 0 );
+    xi_itest_mqttlogic_layer_act();
+
+    XI_CHECK_STATE( local_state = xi_find_handle_for_object(
+                        xi_globals.context_handles_vector,
+                        xi_context__itest_mqttlogic_layer, &context_handle ) );
+
+    assert_int_equal( XI_STATE_OK,
+                      xi_publish_data_borrowed(
+                          context_handle, "test_topic", payload, sizeof( payload ),
+                          XI_MQTT_QOS_AT_LEAST_ONCE, XI_MQTT_RETAIN_FALSE, NULL,
+                          &xi_itest_mqttlogic_release_callback, &release ) );
+
+    xi_itest_mqttlogic_expect_publish_written( XI_MQTT_QOS_AT_LEAST_ONCE );
+    xi_itest_mqttlogic_layer_act();
+
+    assert_int_equal( 0, release.count );
+
+    /* no PUBACK comes, the clean session drops the message at disconnect */
+    xi_itest_mqttlogic_shutdown_and_disconnect( context_handle );
+
+    assert_int_equal( 1, release.count );
+
+    return;
+err_handling:
+    xi_itest_mqttlogic_shutdown_and_disconnect( context_handle );
+}
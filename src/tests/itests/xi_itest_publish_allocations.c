@@ -0,0 +1,243 @@
+/* Copyright (c) 2003-2017, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include "xi_itest_publish_allocations.h"
+#include "xi_itest_helpers.h"
+#include "xi_backoff_status_api.h"
+
+#include "xi_globals.h"
+#include "xi_handle.h"
+
+#include "xi_bsp_time.h"
+#include "xi_memory_checks.h"
+#include "xi_itest_layerchain_ct_ml_mc.h"
+#include "xi_itest_mock_broker_layerchain.h"
+
+/*
+ * Publishes QoS1 messages one after the other to the mock broker, the same layer setup
+ * as xi_itest_publish_window.c:
+ *
+ *        CT - ML - MC - MB - TLSPREV
+ *                       |
+ *                       MC
+ *                       |
+ *                       MBSecondary
+ *
+ * Once the first few messages have warmed up the pools, it reports the number of calls
+ * to the platform allocator and the wall clock time per message. Both cover the mock
+ * broker's side of the exchange as well, the allocation count is only available with
+ * the memory limiter.
+ */
+
+/* Depends on the xi_itest_tls_error.c */
+extern xi_context_t* xi_context;
+extern xi_context_handle_t xi_context_handle;
+extern xi_context_t* xi_context_mockbroker;
+/* end of dependency */
+
+#define XI_ITEST_PUBLISH_ALLOCATIONS__WARM_UP_COUNT 8
+#define XI_ITEST_PUBLISH_ALLOCATIONS__MESSAGE_COUNT 1024
+
+typedef struct xi_itest_publish_allocations__progress_s
+{
+    uint8_t connected;
+    uint8_t closed;
+    uint16_t acked;
+} xi_itest_publish_allocations__progress_t;
+
+static xi_itest_publish_allocations__progress_t xi_itest_publish_allocations__progress;
+
+/*********************************************************************************
+ * setup / teardown **************************************************************
+ ********************************************************************************/
+int xi_itest_publish_allocations_setup( void** fixture_void )
+{
+    XI_UNUSED( fixture_void );
+
+    /* clear the external dependencies */
+    xi_context            = NULL;
+    xi_context_handle     = XI_INVALID_CONTEXT_HANDLE;
+    xi_context_mockbroker = NULL;
+
+    xi_memory_limiter_tearup();
+
+    xi_globals.backoff_status.backoff_lut_i = 0;
+    xi_cancel_backoff_event();
+
+    xi_initialize( "xi_itest_publish_allocations_account_id",
+                   "xi_itest_publish_allocations_device_id" );
+
+    XI_CHECK_STATE( xi_create_context_with_custom_layers(
+        &xi_context, itest_ct_ml_mc_layer_chain, XI_LAYER_CHAIN_CT_ML_MC,
+        XI_LAYER_CHAIN_SCHEME_LENGTH( XI_LAYER_CHAIN_CT_ML_MC ) ) );
+
+    xi_find_handle_for_object( xi_globals.context_handles_vector, xi_context,
+                               &xi_context_handle );
+
+    XI_CHECK_STATE( xi_create_context_with_custom_layers(
+        &xi_context_mockbroker, itest_mock_broker_codec_layer_chain,
+        XI_LAYER_CHAIN_MOCK_BROKER_CODEC,
+        XI_LAYER_CHAIN_SCHEME_LENGTH( XI_LAYER_CHAIN_MOCK_BROKER_CODEC ) ) );
+
+    return 0;
+
+err_handling:
+    fail();
+
+    return 1;
+}
+
+int xi_itest_publish_allocations_teardown( void** fixture_void )
+{
+    XI_UNUSED( fixture_void );
+
+    xi_delete_context_with_custom_layers(
+        &xi_context, itest_ct_ml_mc_layer_chain,
+        XI_LAYER_CHAIN_SCHEME_LENGTH( XI_LAYER_CHAIN_CT_ML_MC ) );
+
+    xi_delete_context_with_custom_layers(
+        &xi_context_mockbroker, itest_mock_broker_codec_layer_chain,
+        XI_LAYER_CHAIN_SCHEME_LENGTH( XI_LAYER_CHAIN_MOCK_BROKER_CODEC ) );
+
+    xi_shutdown();
+
+    return !xi_memory_limiter_teardown();
+}
+
+static void _xi_itest_publish_allocations__on_connection_state_changed(
+    xi_context_handle_t in_context_handle, void* data, xi_state_t state )
+{
+    XI_UNUSED( in_context_handle );
+    XI_UNUSED( state );
+
+    const xi_connection_data_t* connection_data = ( xi_connection_data_t* )data;
+
+    xi_itest_publish_allocations__progress.connected =
+        ( XI_CONNECTION_STATE_OPENED == connection_data->connection_state );
+    xi_itest_publish_allocations__progress.closed =
+        ( XI_CONNECTION_STATE_CLOSED == connection_data->connection_state );
+}
+
+static void _xi_itest_publish_allocations__on_publish_finished(
+    xi_context_handle_t in_context_handle, void* data, xi_state_t state )
+{
+    XI_UNUSED( in_context_handle );
+    XI_UNUSED( data );
+
+    if ( XI_STATE_OK == state )
+    {
+        ++xi_itest_publish_allocations__progress.acked;
+    }
+}
+
+/*********************************************************************************
+ * test cases ********************************************************************
+ ********************************************************************************/
+void xi_itest_publish_allocations__steady_state__allocations_and_time_per_publish(
+    void** fixture_void )
+{
+    XI_UNUSED( fixture_void );
+
+    /* turn off LAYER and MQTT LEVEL expectation checks, only the PUBACKs are counted */
+    will_return_always( xi_mock_broker_layer__check_expected__LAYER_LEVEL,
+                        CONTROL_SKIP_CHECK_EXPECTED );
+
+    will_return_always( xi_mock_broker_layer__check_expected__MQTT_LEVEL,
+                        CONTROL_SKIP_CHECK_EXPECTED );
+
+    will_return_always( xi_mock_layer_tls_prev__check_expected__LAYER_LEVEL,
+                        CONTROL_SKIP_CHECK_EXPECTED );
+
+    const uint16_t total_count = XI_ITEST_PUBLISH_ALLOCATIONS__WARM_UP_COUNT +
+                                 XI_ITEST_PUBLISH_ALLOCATIONS__MESSAGE_COUNT;
+
+    xi_itest_publish_allocations__progress =
+        ( xi_itest_publish_allocations__progress_t ){0, 0, 0};
+
+    xi_state_t state = XI_STATE_OK;
+
+    XI_ALLOC( xi_mock_broker_data_t, broker_data, state );
+
+    /* the mock broker layer chain takes over the broker data */
+    XI_PROCESS_INIT_ON_THIS_LAYER(
+        &xi_context_mockbroker->layer_chain.top->layer_connection, broker_data,
+        XI_STATE_OK );
+
+    xi_time_t now = XI_EVTD_SECONDS_TO_TICKS( xi_bsp_time_getcurrenttime_seconds() );
+    xi_evtd_step_ticks( xi_globals.evtd_instance, now );
+
+    xi_connect( xi_context_handle, "itest_username", "itest_password", 20, 0xFFFF,
+                XI_SESSION_CLEAN,
+                &_xi_itest_publish_allocations__on_connection_state_changed );
+
+    uint16_t published         = 0;
+    uint8_t finished           = 0;
+    xi_time_t started_at_ms    = 0;
+    xi_time_t finished_at_ms   = 0;
+    const xi_time_t give_up_at = now + XI_EVTD_SECONDS_TO_TICKS( 600 );
+#ifdef XI_MEMORY_LIMITER_ENABLED
+    size_t allocations_at_start = 0;
+    size_t allocations_at_end   = 0;
+#endif
+
+    while ( xi_evtd_dispatcher_continue( xi_globals.evtd_instance ) == 1 &&
+            0 == xi_itest_publish_allocations__progress.closed && now < give_up_at )
+    {
+        if ( 1 == xi_itest_publish_allocations__progress.connected && 0 == finished &&
+             published == xi_itest_publish_allocations__progress.acked )
+        {
+            if ( XI_ITEST_PUBLISH_ALLOCATIONS__WARM_UP_COUNT == published )
+            {
+#ifdef XI_MEMORY_LIMITER_ENABLED
+                allocations_at_start = xi_memory_limiter_get_allocation_count();
+#endif
+                started_at_ms = xi_bsp_time_getmonotonictime_milliseconds();
+            }
+
+            if ( total_count == published )
+            {
+#ifdef XI_MEMORY_LIMITER_ENABLED
+                allocations_at_end = xi_memory_limiter_get_allocation_count();
+#endif
+                finished_at_ms = xi_bsp_time_getmonotonictime_milliseconds();
+                finished       = 1;
+
+                xi_shutdown_connection( xi_context_handle );
+            }
+            else if ( XI_STATE_OK ==
+                      xi_publish( xi_context_handle, "test/topic", "telemetry",
+                                  XI_MQTT_QOS_AT_LEAST_ONCE, XI_MQTT_RETAIN_FALSE,
+                                  &_xi_itest_publish_allocations__on_publish_finished,
+                                  NULL ) )
+            {
+                ++published;
+            }
+        }
+
+        xi_evtd_step_ticks( xi_globals.evtd_instance, ++now );
+    }
+
+    /* let the mock broker layer chain close as well */
+    xi_evtd_step_ticks( xi_globals.evtd_instance, now + XI_EVTD_SECONDS_TO_TICKS( 2 ) );
+
+    assert_int_equal( total_count, xi_itest_publish_allocations__progress.acked );
+    assert_int_equal( 1, finished );
+
+    printf( "steady state QoS1 publish: %u ns per message\n",
+            ( unsigned )( ( finished_at_ms - started_at_ms ) * 1000000 /
+                          XI_ITEST_PUBLISH_ALLOCATIONS__MESSAGE_COUNT ) );
+
+#ifdef XI_MEMORY_LIMITER_ENABLED
+    printf( "steady state QoS1 publish: %u allocations per message\n",
+            ( unsigned )( ( allocations_at_end - allocations_at_start ) /
+                          XI_ITEST_PUBLISH_ALLOCATIONS__MESSAGE_COUNT ) );
+#endif
+
+    return;
+
+err_handling:
+    fail();
+}
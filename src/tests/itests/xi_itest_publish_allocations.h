@@ -0,0 +1,23 @@
+/* Copyright (c) 2003-2017, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#ifndef __XI_ITEST_PUBLISH_ALLOCATIONS_H__
+#define __XI_ITEST_PUBLISH_ALLOCATIONS_H__
+
+extern int xi_itest_publish_allocations_setup( void** state );
+extern int xi_itest_publish_allocations_teardown( void** state );
+
+extern void xi_itest_publish_allocations__steady_state__allocations_and_time_per_publish(
+    void** state );
+
+#ifdef XI_MOCK_TEST_PREPROCESSOR_RUN
+struct CMUnitTest xi_itests_publish_allocations[] = {cmocka_unit_test_setup_teardown(
+    xi_itest_publish_allocations__steady_state__allocations_and_time_per_publish,
+    xi_itest_publish_allocations_setup,
+    xi_itest_publish_allocations_teardown )};
+#endif
+
+#endif /* __XI_ITEST_PUBLISH_ALLOCATIONS_H__ */
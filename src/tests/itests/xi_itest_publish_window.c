@@ -0,0 +1,254 @@
+/* Copyright (c) 2003-2017, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include "xi_itest_publish_window.h"
+#include "xi_itest_helpers.h"
+#include "xi_backoff_status_api.h"
+
+#include "xi_globals.h"
+#include "xi_handle.h"
+
+#include "xi_bsp_time.h"
+#include "xi_memory_checks.h"
+#include "xi_itest_layerchain_ct_ml_mc.h"
+#include "xi_itest_mock_broker_layerchain.h"
+
+/*
+ * The SUT layer chain publishes QoS1 messages to a mock broker which holds every PUBACK
+ * back for 200 ms, the same layer setup as xi_itest_sft.c:
+ *
+ *        CT - ML - MC - MB - TLSPREV
+ *                       |
+ *                       MC
+ *                       |
+ *                       MBSecondary
+ *
+ * Time is stepped one event dispatcher tick at a time, so the reported rate depends on
+ * the publish window and the ack latency only, not on the speed of the test machine.
+ */
+
+/* Depends on the xi_itest_tls_error.c */
+extern xi_context_t* xi_context;
+extern xi_context_handle_t xi_context_handle;
+extern xi_context_t* xi_context_mockbroker;
+/* end of dependency */
+
+#define XI_ITEST_PUBLISH_WINDOW__ACK_LATENCY_MS 200
+#define XI_ITEST_PUBLISH_WINDOW__MESSAGE_COUNT 32
+
+typedef struct xi_itest_publish_window__progress_s
+{
+    uint8_t connected;
+    uint8_t closed;
+    uint16_t acked;
+} xi_itest_publish_window__progress_t;
+
+static xi_itest_publish_window__progress_t xi_itest_publish_window__progress;
+
+/*********************************************************************************
+ * setup / teardown **************************************************************
+ ********************************************************************************/
+int xi_itest_publish_window_setup( void** fixture_void )
+{
+    XI_UNUSED( fixture_void );
+
+    /* clear the external dependencies */
+    xi_context            = NULL;
+    xi_context_handle     = XI_INVALID_CONTEXT_HANDLE;
+    xi_context_mockbroker = NULL;
+
+    xi_memory_limiter_tearup();
+
+    xi_globals.backoff_status.backoff_lut_i = 0;
+    xi_cancel_backoff_event();
+
+    xi_initialize( "xi_itest_publish_window_account_id",
+                   "xi_itest_publish_window_device_id" );
+
+    XI_CHECK_STATE( xi_create_context_with_custom_layers(
+        &xi_context, itest_ct_ml_mc_layer_chain, XI_LAYER_CHAIN_CT_ML_MC,
+        XI_LAYER_CHAIN_SCHEME_LENGTH( XI_LAYER_CHAIN_CT_ML_MC ) ) );
+
+    xi_find_handle_for_object( xi_globals.context_handles_vector, xi_context,
+                               &xi_context_handle );
+
+    XI_CHECK_STATE( xi_create_context_with_custom_layers(
+        &xi_context_mockbroker, itest_mock_broker_codec_layer_chain,
+        XI_LAYER_CHAIN_MOCK_BROKER_CODEC,
+        XI_LAYER_CHAIN_SCHEME_LENGTH( XI_LAYER_CHAIN_MOCK_BROKER_CODEC ) ) );
+
+    return 0;
+
+err_handling:
+    fail();
+
+    return 1;
+}
+
+int xi_itest_publish_window_teardown( void** fixture_void )
+{
+    XI_UNUSED( fixture_void );
+
+    xi_delete_context_with_custom_layers(
+        &xi_context, itest_ct_ml_mc_layer_chain,
+        XI_LAYER_CHAIN_SCHEME_LENGTH( XI_LAYER_CHAIN_CT_ML_MC ) );
+
+    xi_delete_context_with_custom_layers(
+        &xi_context_mockbroker, itest_mock_broker_codec_layer_chain,
+        XI_LAYER_CHAIN_SCHEME_LENGTH( XI_LAYER_CHAIN_MOCK_BROKER_CODEC ) );
+
+    xi_shutdown();
+
+    return !xi_memory_limiter_teardown();
+}
+
+static void _xi_itest_publish_window__on_connection_state_changed(
+    xi_context_handle_t in_context_handle, void* data, xi_state_t state )
+{
+    XI_UNUSED( in_context_handle );
+    XI_UNUSED( state );
+
+    const xi_connection_data_t* connection_data = ( xi_connection_data_t* )data;
+
+    xi_itest_publish_window__progress.connected =
+        ( XI_CONNECTION_STATE_OPENED == connection_data->connection_state );
+    xi_itest_publish_window__progress.closed =
+        ( XI_CONNECTION_STATE_CLOSED == connection_data->connection_state );
+}
+
+static void _xi_itest_publish_window__on_publish_finished(
+    xi_context_handle_t in_context_handle, void* data, xi_state_t state )
+{
+    XI_UNUSED( in_context_handle );
+    XI_UNUSED( data );
+
+    if ( XI_STATE_OK == state )
+    {
+        ++xi_itest_publish_window__progress.acked;
+    }
+}
+
+/*********************************************************************************
+ * act ***************************************************************************
+ ********************************************************************************/
+/* publishes XI_ITEST_PUBLISH_WINDOW__MESSAGE_COUNT QoS1 messages as fast as the window
+ * lets through and returns how many of them were acknowledged per second */
+static uint32_t _xi_itest_publish_window__messages_per_second( uint16_t publish_window )
+{
+    xi_state_t state = XI_STATE_OK;
+
+    xi_itest_publish_window__progress =
+        ( xi_itest_publish_window__progress_t ){0, 0, 0};
+
+    XI_ALLOC( xi_mock_broker_data_t, broker_data, state );
+    broker_data->puback_latency_ticks =
+        XI_EVTD_MILLISECONDS_TO_TICKS( XI_ITEST_PUBLISH_WINDOW__ACK_LATENCY_MS );
+
+    /* the mock broker layer chain takes over the broker data */
+    XI_PROCESS_INIT_ON_THIS_LAYER(
+        &xi_context_mockbroker->layer_chain.top->layer_connection, broker_data,
+        XI_STATE_OK );
+
+    xi_time_t now = XI_EVTD_SECONDS_TO_TICKS( xi_bsp_time_getcurrenttime_seconds() );
+    xi_evtd_step_ticks( xi_globals.evtd_instance, now );
+
+    xi_set_publish_window( publish_window );
+
+    xi_connect( xi_context_handle, "itest_username", "itest_password", 20, 0xFFFF,
+                XI_SESSION_CLEAN,
+                &_xi_itest_publish_window__on_connection_state_changed );
+
+    uint16_t published         = 0;
+    xi_time_t started_at       = 0;
+    xi_time_t finished_at      = 0;
+    const xi_time_t give_up_at = now + XI_EVTD_SECONDS_TO_TICKS( 60 );
+
+    while ( xi_evtd_dispatcher_continue( xi_globals.evtd_instance ) == 1 &&
+            0 == xi_itest_publish_window__progress.closed && now < give_up_at )
+    {
+        if ( 1 == xi_itest_publish_window__progress.connected )
+        {
+            if ( 0 == published )
+            {
+                started_at = now;
+            }
+
+            /* the caller is pushed back once the window is full */
+            while ( XI_ITEST_PUBLISH_WINDOW__MESSAGE_COUNT > published &&
+                    XI_STATE_OK ==
+                        xi_publish( xi_context_handle, "test/topic", "telemetry",
+                                    XI_MQTT_QOS_AT_LEAST_ONCE, XI_MQTT_RETAIN_FALSE,
+                                    &_xi_itest_publish_window__on_publish_finished,
+                                    NULL ) )
+            {
+                ++published;
+            }
+
+            if ( 0 == finished_at && XI_ITEST_PUBLISH_WINDOW__MESSAGE_COUNT ==
+                                         xi_itest_publish_window__progress.acked )
+            {
+                finished_at = now;
+                xi_shutdown_connection( xi_context_handle );
+            }
+        }
+
+        xi_evtd_step_ticks( xi_globals.evtd_instance, ++now );
+    }
+
+    /* let the mock broker layer chain close as well */
+    xi_evtd_step_ticks( xi_globals.evtd_instance, now + XI_EVTD_SECONDS_TO_TICKS( 2 ) );
+
+    assert_int_equal( XI_ITEST_PUBLISH_WINDOW__MESSAGE_COUNT,
+                      xi_itest_publish_window__progress.acked );
+    assert_true( started_at < finished_at );
+
+    const uint32_t messages_per_second =
+        ( uint32_t )( XI_ITEST_PUBLISH_WINDOW__MESSAGE_COUNT * 1000 /
+                      XI_EVTD_TICKS_TO_MILLISECONDS( finished_at - started_at ) );
+
+    printf( "publish window %u, %d ms ack latency: %u messages/sec\n", publish_window,
+            XI_ITEST_PUBLISH_WINDOW__ACK_LATENCY_MS, messages_per_second );
+
+    return messages_per_second;
+
+err_handling:
+    fail();
+
+    return 0;
+}
+
+/*********************************************************************************
+ * test cases ********************************************************************
+ ********************************************************************************/
+void xi_itest_publish_window__200ms_ack_latency__wider_window_more_messages_per_second(
+    void** fixture_void )
+{
+    XI_UNUSED( fixture_void );
+
+    /* turn off LAYER and MQTT LEVEL expectation checks, only the PUBACKs are counted */
+    will_return_always( xi_mock_broker_layer__check_expected__LAYER_LEVEL,
+                        CONTROL_SKIP_CHECK_EXPECTED );
+
+    will_return_always( xi_mock_broker_layer__check_expected__MQTT_LEVEL,
+                        CONTROL_SKIP_CHECK_EXPECTED );
+
+    will_return_always( xi_mock_layer_tls_prev__check_expected__LAYER_LEVEL,
+                        CONTROL_SKIP_CHECK_EXPECTED );
+
+    const uint16_t publish_window = xi_get_publish_window();
+
+    const uint32_t one_in_flight   = _xi_itest_publish_window__messages_per_second( 1 );
+    const uint32_t eight_in_flight = _xi_itest_publish_window__messages_per_second( 8 );
+
+    xi_set_publish_window( publish_window );
+
+    /* a single message in flight is bound by the round trip */
+    assert_true( 0 < one_in_flight );
+    assert_true( one_in_flight <= 1000 / XI_ITEST_PUBLISH_WINDOW__ACK_LATENCY_MS );
+
+    /* eight of them share it */
+    assert_true( 4 * one_in_flight <= eight_in_flight );
+}
@@ -0,0 +1,24 @@
+/* Copyright (c) 2003-2017, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#ifndef __XI_ITEST_PUBLISH_WINDOW_H__
+#define __XI_ITEST_PUBLISH_WINDOW_H__
+
+extern int xi_itest_publish_window_setup( void** state );
+extern int xi_itest_publish_window_teardown( void** state );
+
+extern void
+xi_itest_publish_window__200ms_ack_latency__wider_window_more_messages_per_second(
+    void** state );
+
+#ifdef XI_MOCK_TEST_PREPROCESSOR_RUN
+struct CMUnitTest xi_itests_publish_window[] = {cmocka_unit_test_setup_teardown(
+    xi_itest_publish_window__200ms_ack_latency__wider_window_more_messages_per_second,
+    xi_itest_publish_window_setup,
+    xi_itest_publish_window_teardown )};
+#endif
+
+#endif /* __XI_ITEST_PUBLISH_WINDOW_H__ */
@@ -47,11 +47,47 @@ extern xi_context_handle_t xi_context_handle;
 extern xi_context_t* xi_context_mockbroker;
 /* end of dependency */
 
+/* replays the client's requests for a file of the mock broker: a window of
+ * XI_SFT_FILE_CHUNK_WINDOW requests, every chunk arriving in full doubles the size of the
+ * following requests up to XI_SFT_FILE_CHUNK_SIZE_MAX */
+static size_t _xi_itest_sft__number_of_file_chunks( uint32_t file_size )
+{
+    uint32_t requested_bytes = 0;
+    uint32_t chunk_size      = XI_SFT_FILE_CHUNK_SIZE;
+    size_t chunks_in_flight  = 0;
+    size_t requests_sent     = 0;
+
+    do
+    {
+        if ( 0 < chunks_in_flight )
+        {
+            --chunks_in_flight;
+            chunk_size = XI_MIN( chunk_size * 2, XI_SFT_FILE_CHUNK_SIZE_MAX );
+        }
+
+        while ( chunks_in_flight < XI_SFT_FILE_CHUNK_WINDOW &&
+                requested_bytes < file_size )
+        {
+            requested_bytes += XI_MIN( chunk_size, file_size - requested_bytes );
+
+            ++chunks_in_flight;
+            ++requests_sent;
+        }
+    } while ( 0 < chunks_in_flight );
+
+    return requests_sent;
+}
+
 #define XI_ITEST_SFT__NUMBER_OF_FILE_CHUNKS( mock_broker_size_multiplier )               \
-    ( mock_broker_size_multiplier * XI_MOCK_BROKER_SFT__FILE_CHUNK_STEP_SIZE /           \
-          XI_SFT_FILE_CHUNK_SIZE +                                                       \
-      ( ( XI_MOCK_BROKER_SFT__FILE_CHUNK_STEP_SIZE % XI_SFT_FILE_CHUNK_SIZE ) ? 1        \
-                                                                              : 0 ) )
+    _xi_itest_sft__number_of_file_chunks( mock_broker_size_multiplier *                  \
+                                          XI_MOCK_BROKER_SFT__FILE_CHUNK_STEP_SIZE )
+
+/* the client asks for this many chunks of a file before the first one arrives */
+#define XI_ITEST_SFT__NUMBER_OF_FIRST_FILE_GET_CHUNKS( mock_broker_size_multiplier )     \
+    XI_MIN( XI_SFT_FILE_CHUNK_WINDOW,                                                    \
+            ( mock_broker_size_multiplier * XI_MOCK_BROKER_SFT__FILE_CHUNK_STEP_SIZE +   \
+              XI_SFT_FILE_CHUNK_SIZE - 1 ) /                                             \
+                XI_SFT_FILE_CHUNK_SIZE )
 
 #define expect_file_status_phase_and_code( _phase, _code )                               \
     expect_value( xi_mock_broker_sft_logic_on_file_status,                               \
@@ -367,13 +403,16 @@ void xi_itest_sft__broker_replies_FILE_INFO_on_FILE_GET_CHUNK__client_does_not_c
     expect_value( xi_mock_broker_sft_logic_on_message, control_message->common.msgtype,
                   XI_CONTROL_MESSAGE_CS__SFT_FILE_INFO );
 
-    /* 1st file */
+    /* 1st file, the chunks requested together with the one answered with FILE_INFO
+     * are held until the first chunk arrives, which never happens */
     expect_value_count( xi_mock_broker_sft_logic_on_message,
                         control_message->common.msgtype,
-                        XI_CONTROL_MESSAGE_CS__SFT_FILE_GET_CHUNK, 1 );
+                        XI_CONTROL_MESSAGE_CS__SFT_FILE_GET_CHUNK,
+                        XI_ITEST_SFT__NUMBER_OF_FIRST_FILE_GET_CHUNKS( 1 ) );
 
     expect_string_count( xi_mock_broker_sft_logic_on_file_get_chunk,
-                         control_message->file_get_chunk.name, "file1", 1 );
+                         control_message->file_get_chunk.name, "file1",
+                         XI_ITEST_SFT__NUMBER_OF_FIRST_FILE_GET_CHUNKS( 1 ) );
 
     /* ACT */
     xi_itest_sft__act( fixture_void, 1, ( const char* [] ){"file1"}, 1, NULL );
@@ -418,10 +457,12 @@ void xi_itest_sft__broker_replies_FUA_on_FILE_GET_CHUNK__client_processes_2nd_FU
     /* 1st file */
     expect_value_count( xi_mock_broker_sft_logic_on_message,
                         control_message->common.msgtype,
-                        XI_CONTROL_MESSAGE_CS__SFT_FILE_GET_CHUNK, 1 );
+                        XI_CONTROL_MESSAGE_CS__SFT_FILE_GET_CHUNK,
+                        XI_ITEST_SFT__NUMBER_OF_FIRST_FILE_GET_CHUNKS( 1 ) );
 
     expect_string_count( xi_mock_broker_sft_logic_on_file_get_chunk,
-                         control_message->file_get_chunk.name, "file1", 1 );
+                         control_message->file_get_chunk.name, "file1",
+                         XI_ITEST_SFT__NUMBER_OF_FIRST_FILE_GET_CHUNKS( 1 ) );
 
     /* new file */
     expect_value_count( xi_mock_broker_sft_logic_on_message,
@@ -431,6 +472,23 @@ void xi_itest_sft__broker_replies_FUA_on_FILE_GET_CHUNK__client_processes_2nd_FU
     expect_string_count( xi_mock_broker_sft_logic_on_file_get_chunk,
                          control_message->file_get_chunk.name, "file2", 1 );
 
+    /* chunks of the 1st file requested together with the one answered with the FUA
+     * arrive after the download of the new file started */
+    const size_t stale_file_chunks =
+        XI_ITEST_SFT__NUMBER_OF_FIRST_FILE_GET_CHUNKS( 1 ) - 1;
+
+    size_t i = 0;
+    for ( ; i < stale_file_chunks; ++i )
+    {
+        expect_value( xi_mock_broker_sft_logic_on_message,
+                      control_message->common.msgtype,
+                      XI_CONTROL_MESSAGE_CS__SFT_FILE_STATUS );
+
+        expect_file_status_phase_and_code(
+            XI_CONTROL_MESSAGE__SFT_FILE_STATUS_PHASE_DOWNLOADED,
+            XI_CONTROL_MESSAGE__SFT_FILE_STATUS_CODE_ERROR__UNEXPECTED_FILE_CHUNK );
+    }
+
     expect_value_count( xi_mock_broker_sft_logic_on_message,
                         control_message->common.msgtype,
                         XI_CONTROL_MESSAGE_CS__SFT_FILE_STATUS, 2 );
@@ -325,12 +325,7 @@ void xi_itest_tls_error__tls_pull_PUBACK_errors__graceful_error_handling(
             will_return( xi_mock_broker_secondary_layer_push, CONTROL_CONTINUE );
             expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_WRITTEN );
 
-            /* PUBLISH HEADER*/
-            expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_OK );
-            expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_WRITTEN );
-            expect_value( xi_mock_layer_tls_prev_push, in_out_state, XI_STATE_OK );
-
-            /* PUBLISH PAYLOAD*/
+            /* PUBLISH, header and payload are pushed together*/
             expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_OK );
             expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_WRITTEN );
             expect_value( xi_mock_layer_tls_prev_push, in_out_state, XI_STATE_OK );
@@ -840,11 +835,6 @@ void xi_itest_tls_error__tls_push_PUBLISH_errors__graceful_error_handling(
             expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_WRITTEN );
             expect_value( xi_mock_layer_tls_prev_push, in_out_state, XI_STATE_OK );
 
-            expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_OK );
-            will_return_count( xi_mock_broker_layer_push, CONTROL_CONTINUE, 2 );
-            expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_WRITTEN );
-            expect_value( xi_mock_layer_tls_prev_push, in_out_state, XI_STATE_OK );
-
             /* PUBLISH message arrives at mock broker*/
             expect_value( xi_mock_broker_layer_pull, in_out_state, XI_STATE_OK );
             expect_value( xi_mock_broker_layer_pull, recvd_msg_type,
@@ -985,12 +975,7 @@ void xi_itest_tls_error__connection_flow__basic_checks( void** fixture_void )
     expect_value( xi_mock_broker_secondary_layer_push, in_out_state, XI_STATE_OK );
     expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_WRITTEN );
 
-    /* PUBLISH*/
-    expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_OK );
-    expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_WRITTEN );
-    expect_value( xi_mock_layer_tls_prev_push, in_out_state, XI_STATE_OK );
-
-    /* PUBLISH PAYLOAD*/
+    /* PUBLISH, header and payload are pushed together*/
     expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_OK );
     expect_value( xi_mock_broker_layer_push, in_out_state, XI_STATE_WRITTEN );
     expect_value( xi_mock_layer_tls_prev_push, in_out_state, XI_STATE_OK );
@@ -12,6 +12,8 @@
 #include "xi_itest_tls_layer.h"
 #endif
 #include "xi_itest_mqttlogic_layer.h"
+#include "xi_itest_publish_window.h"
+#include "xi_itest_publish_allocations.h"
 #ifdef XI_CONTROL_TOPIC_ENABLED
 #include "xi_itest_sft.h"
 #endif
@@ -27,6 +29,8 @@ struct CMGroupTest groups[] = {cmocka_test_group( xi_itests_clean_session ),
 #endif
                                cmocka_test_group( xi_itests_mqttlogic_layer ),
                                cmocka_test_group( xi_itests_connect_error ),
+                               cmocka_test_group( xi_itests_publish_window ),
+                               cmocka_test_group( xi_itests_publish_allocations ),
 #ifdef XI_CONTROL_TOPIC_ENABLED
 #ifdef XI_SECURE_FILE_TRANSFER_ENABLED
                                cmocka_test_group( xi_itests_sft ),
@@ -11,8 +11,67 @@
 
 #include "xi_critical_section_def.h"
 
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
 
+#define XI_UTEST_EVTD_PRODUCERS 4
+#define XI_UTEST_EVTD_HANDLES_PER_PRODUCER 1000
+
+typedef struct xi_utest_evtd_producer_s
+{
+    pthread_t thread;
+    /* posts still refused by then count as lost instead of spinning forever */
+    time_t give_up_time;
+    size_t lost_handles;
+    /* the sequence number of the next handle the consumer expects */
+    intptr_t next_handle;
+    uint8_t out_of_order;
+} xi_utest_evtd_producer_t;
+
+xi_state_t consume_produced_handle( void* producer_ptr, void* sequence_number )
+{
+    xi_utest_evtd_producer_t* producer = ( xi_utest_evtd_producer_t* )producer_ptr;
+
+    if ( producer->next_handle != ( intptr_t )sequence_number )
+    {
+        producer->out_of_order = 1;
+    }
+
+    producer->next_handle += 1;
+
+    return XI_STATE_OK;
+}
+
+void* produce_handles( void* producer_ptr )
+{
+    xi_utest_evtd_producer_t* producer = ( xi_utest_evtd_producer_t* )producer_ptr;
+
+    intptr_t counter_handle = 0;
+    for ( ; counter_handle < XI_UTEST_EVTD_HANDLES_PER_PRODUCER; ++counter_handle )
+    {
+        /* with the memory limiter the queue nodes may run out while the consumer lags
+         * behind, back off until it has freed some instead of dropping the post */
+        while ( NULL == xi_evtd_execute( evtd_g_i,
+                                         xi_make_handle( &consume_produced_handle,
+                                                         producer_ptr,
+                                                         ( void* )counter_handle ) ) )
+        {
+            if ( time( 0 ) >= producer->give_up_time )
+            {
+                producer->lost_handles += 1;
+                break;
+            }
+
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
 xi_state_t register_evtd_handle( xi_event_handle_arg1_t a )
 {
     tt_want_int_op( evtd_g_i->cs->cs_state, ==, 0 );
@@ -137,3 +196,55 @@ XI_TT_TESTCASE(
 
     end:;
     } )
+
+XI_TT_TESTCASE(
+    utest__xi_evtd_execute__many_producers_one_consumer__all_handles_executed_in_order, {
+        evtd_g_i = xi_evtd_create_instance();
+
+        xi_utest_evtd_producer_t producers[XI_UTEST_EVTD_PRODUCERS];
+        memset( producers, 0, sizeof( producers ) );
+
+        // consume while the producers are still pushing, give up after 10 seconds
+        const time_t give_up_time = time( 0 ) + 10;
+
+        size_t counter_producer = 0;
+        for ( ; counter_producer < XI_UTEST_EVTD_PRODUCERS; ++counter_producer )
+        {
+            producers[counter_producer].give_up_time = give_up_time;
+
+            tt_int_op( 0, ==, pthread_create( &producers[counter_producer].thread, NULL,
+                                              &produce_handles,
+                                              &producers[counter_producer] ) );
+        }
+
+        size_t handles_executed = 0;
+        while ( handles_executed <
+                    XI_UTEST_EVTD_PRODUCERS * XI_UTEST_EVTD_HANDLES_PER_PRODUCER &&
+                time( 0 ) < give_up_time )
+        {
+            xi_evtd_step( evtd_g_i, 0 );
+
+            handles_executed = 0;
+            for ( counter_producer = 0; counter_producer < XI_UTEST_EVTD_PRODUCERS;
+                  ++counter_producer )
+            {
+                handles_executed += producers[counter_producer].next_handle;
+            }
+        }
+
+        for ( counter_producer = 0; counter_producer < XI_UTEST_EVTD_PRODUCERS;
+              ++counter_producer )
+        {
+            pthread_join( producers[counter_producer].thread, NULL );
+
+            tt_want_int_op( 0, ==, producers[counter_producer].lost_handles );
+            tt_want_int_op( XI_UTEST_EVTD_HANDLES_PER_PRODUCER, ==,
+                            producers[counter_producer].next_handle );
+            tt_want_int_op( 0, ==, producers[counter_producer].out_of_order );
+        }
+
+        tt_want_int_op( 1, ==, xi_evtd_is_call_queue_empty( evtd_g_i ) );
+
+    end:
+        xi_evtd_destroy_instance( evtd_g_i );
+    } )
@@ -174,8 +174,7 @@ XI_TT_TESTCASE(
                 ( xi_event_handle_arg1_t )&value_shared_between_threads,
                 nb_handler_additions[id_handler_adds] );
 
-            while ( !XI_LIST_EMPTY( xi_event_handle_t,
-                                    workerthread->thread_evtd_secondary->call_queue ) )
+            while ( !xi_evtd_is_call_queue_empty( workerthread->thread_evtd_secondary ) )
             {
                 XI_TIME_MILLISLEEP( 10, deltatime );
             }
@@ -226,8 +225,7 @@ XI_TT_TESTCASE(
                 ( xi_event_handle_arg1_t )&value_shared_between_threads,
                 nb_handler_additions[id_handler_adds] );
 
-            while ( !XI_LIST_EMPTY( xi_event_handle_t,
-                                    workerthread->thread_evtd_secondary->call_queue ) )
+            while ( !xi_evtd_is_call_queue_empty( workerthread->thread_evtd_secondary ) )
             {
                 XI_TIME_MILLISLEEP( 10, deltatime );
             }
@@ -598,11 +598,13 @@ XI_TT_TESTCASE_WITH_SETUP(
 
             xi_backoff_lut_index_t curr_index = xi_globals.backoff_status.backoff_lut_i;
 
-            xi_evtd_step( event_dispatcher,
-                          event_dispatcher->current_step +
-                              xi_globals.backoff_status.decay_lut->array[curr_index]
-                                  .selector_t.ui32_value +
-                              1 );
+            xi_evtd_step_ticks(
+                event_dispatcher,
+                event_dispatcher->current_step +
+                    XI_EVTD_SECONDS_TO_TICKS(
+                        xi_globals.backoff_status.decay_lut->array[curr_index]
+                            .selector_t.ui32_value +
+                        1 ) );
 
             tt_int_op( xi_globals.backoff_status.backoff_lut_i, ==, curr_index );
 
@@ -665,11 +667,13 @@ XI_TT_TESTCASE_WITH_SETUP(
 
             xi_backoff_lut_index_t curr_index = xi_globals.backoff_status.backoff_lut_i;
 
-            xi_evtd_step( event_dispatcher,
-                          event_dispatcher->current_step +
-                              xi_globals.backoff_status.decay_lut->array[curr_index]
-                                  .selector_t.ui32_value +
-                              1 );
+            xi_evtd_step_ticks(
+                event_dispatcher,
+                event_dispatcher->current_step +
+                    XI_EVTD_SECONDS_TO_TICKS(
+                        xi_globals.backoff_status.decay_lut->array[curr_index]
+                            .selector_t.ui32_value +
+                        1 ) );
 
             if ( curr_test_case->data_len > 1 )
             {
@@ -0,0 +1,244 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "tinytest.h"
+#include "tinytest_macros.h"
+#include "xi_tt_testcase_management.h"
+#include "xi_utest_basic_testcase_frame.h"
+#include "xi_memory_checks.h"
+
+#include "xi_bsp_mem.h"
+#include "xi_bsp_mem_arena.h"
+
+#ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+
+/* number of blocks the soak test keeps alive at the same time */
+#define XI_UTEST_ARENA_SOAK_SLOTS 256
+
+/* number of random allocations and frees the soak test makes */
+#define XI_UTEST_ARENA_SOAK_ITERATIONS 200000
+
+typedef struct xi_utest_arena_slot_s
+{
+    uint8_t* ptr;
+    size_t size;
+    uint8_t pattern;
+} xi_utest_arena_slot_t;
+
+static xi_utest_arena_slot_t xi_utest_arena_slots[XI_UTEST_ARENA_SOAK_SLOTS];
+
+/* xorshift, deterministic so a failing run can be repeated */
+static uint32_t xi_utest_arena_random( uint32_t* seed )
+{
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    return *seed;
+}
+
+/* mostly small blocks as the library allocates them, now and then a buffer */
+static size_t xi_utest_arena_random_size( uint32_t* seed )
+{
+    const uint32_t r = xi_utest_arena_random( seed );
+
+    if ( 0 == r % 64 )
+    {
+        return 1 + r % ( 16 * 1024 );
+    }
+
+    return 1 + r % 512;
+}
+
+static int xi_utest_arena_slot_is_intact( const xi_utest_arena_slot_t* slot )
+{
+    size_t i = 0;
+    for ( ; i < slot->size; ++i )
+    {
+        if ( slot->ptr[i] != slot->pattern )
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+#endif
+
+XI_TT_TESTGROUP_BEGIN( utest_bsp_mem_arena )
+
+XI_TT_TESTCASE(
+    utest__xi_bsp_mem_alloc__too_large__null_and_failure_counted,
+    {
+        xi_bsp_mem_arena_stats_t before;
+        xi_bsp_mem_arena_stats_t after;
+
+        xi_bsp_mem_arena_get_stats( &before );
+
+        tt_ptr_op( NULL, ==, xi_bsp_mem_alloc( XI_BSP_MEM_ARENA_SIZE ) );
+
+        xi_bsp_mem_arena_get_stats( &after );
+
+        tt_int_op( before.failed_allocation_count + 1, ==, after.failed_allocation_count );
+        tt_int_op( before.bytes_in_use, ==, after.bytes_in_use );
+    end:;
+    } )
+
+XI_TT_TESTCASE(
+    utest__xi_bsp_mem_realloc__grow_and_shrink__content_preserved,
+    {
+        uint8_t* ptr = xi_bsp_mem_alloc( 24 );
+        tt_assert( NULL != ptr );
+
+        memset( ptr, 0xA5, 24 );
+
+        /* fits the same block, stays in place */
+        uint8_t* same = xi_bsp_mem_realloc( ptr, 8 );
+        tt_ptr_op( ptr, ==, same );
+
+        ptr = xi_bsp_mem_realloc( same, 4000 );
+        tt_assert( NULL != ptr );
+
+        size_t i = 0;
+        for ( ; i < 8; ++i )
+        {
+            tt_int_op( 0xA5, ==, ptr[i] );
+        }
+
+    end:
+        xi_bsp_mem_free( ptr );
+    } )
+
+XI_TT_TESTCASE(
+    utest__xi_bsp_mem_free__all_blocks_released__arena_coalesced,
+    {
+        xi_bsp_mem_arena_stats_t before;
+        xi_bsp_mem_arena_stats_t during;
+        xi_bsp_mem_arena_stats_t after;
+        void* ptrs[64] = {NULL};
+
+        xi_bsp_mem_arena_get_stats( &before );
+
+        size_t i = 0;
+        for ( ; i < 64; ++i )
+        {
+            ptrs[i] = xi_bsp_mem_alloc( 40 + i );
+            tt_assert( NULL != ptrs[i] );
+        }
+
+        xi_bsp_mem_arena_get_stats( &during );
+        tt_int_op( before.allocation_count + 64, ==, during.allocation_count );
+        tt_int_op( during.bytes_in_use - before.bytes_in_use, >=,
+                   during.requested_bytes_in_use - before.requested_bytes_in_use );
+
+        /* every other one first, nothing can merge until the rest is released */
+        for ( i = 0; i < 64; i += 2 )
+        {
+            xi_bsp_mem_free( ptrs[i] );
+            ptrs[i] = NULL;
+        }
+
+        for ( i = 1; i < 64; i += 2 )
+        {
+            xi_bsp_mem_free( ptrs[i] );
+            ptrs[i] = NULL;
+        }
+
+        xi_bsp_mem_arena_get_stats( &after );
+        tt_int_op( before.bytes_in_use, ==, after.bytes_in_use );
+        tt_int_op( before.largest_free_block, ==, after.largest_free_block );
+        tt_int_op( before.external_fragmentation_percent, ==,
+                   after.external_fragmentation_percent );
+
+    end:
+        for ( i = 0; i < 64; ++i )
+        {
+            xi_bsp_mem_free( ptrs[i] );
+        }
+    } )
+
+XI_TT_TESTCASE(
+    utest__xi_bsp_mem_alloc__random_soak__no_overlap_and_no_fragmentation_left,
+    {
+        xi_bsp_mem_arena_stats_t before;
+        xi_bsp_mem_arena_stats_t after;
+        uint32_t seed   = 0x2545F491;
+        size_t failures = 0;
+
+        memset( xi_utest_arena_slots, 0, sizeof( xi_utest_arena_slots ) );
+        xi_bsp_mem_arena_get_stats( &before );
+
+        uint32_t i = 0;
+        for ( ; i < XI_UTEST_ARENA_SOAK_ITERATIONS; ++i )
+        {
+            xi_utest_arena_slot_t* slot =
+                &xi_utest_arena_slots[xi_utest_arena_random( &seed ) %
+                                      XI_UTEST_ARENA_SOAK_SLOTS];
+
+            if ( NULL != slot->ptr )
+            {
+                /* a block handed out twice would have been overwritten by now */
+                tt_assert( xi_utest_arena_slot_is_intact( slot ) );
+
+                xi_bsp_mem_free( slot->ptr );
+                slot->ptr = NULL;
+                continue;
+            }
+
+            slot->size    = xi_utest_arena_random_size( &seed );
+            slot->pattern = ( uint8_t )i;
+            slot->ptr     = xi_bsp_mem_alloc( slot->size );
+
+            if ( NULL == slot->ptr )
+            {
+                ++failures;
+                continue;
+            }
+
+            memset( slot->ptr, slot->pattern, slot->size );
+        }
+
+        /* the live set stays far below the arena size, every request has to succeed */
+        tt_int_op( 0, ==, failures );
+
+        for ( i = 0; i < XI_UTEST_ARENA_SOAK_SLOTS; ++i )
+        {
+            if ( NULL != xi_utest_arena_slots[i].ptr )
+            {
+                tt_assert( xi_utest_arena_slot_is_intact( &xi_utest_arena_slots[i] ) );
+                xi_bsp_mem_free( xi_utest_arena_slots[i].ptr );
+                xi_utest_arena_slots[i].ptr = NULL;
+            }
+        }
+
+        xi_bsp_mem_arena_get_stats( &after );
+
+        /* the buddies merged back, the arena is as fragmented as before the soak */
+        tt_int_op( before.bytes_in_use, ==, after.bytes_in_use );
+        tt_int_op( before.requested_bytes_in_use, ==, after.requested_bytes_in_use );
+        tt_int_op( before.allocation_count, ==, after.allocation_count );
+        tt_int_op( before.largest_free_block, ==, after.largest_free_block );
+        tt_int_op( before.external_fragmentation_percent, ==,
+                   after.external_fragmentation_percent );
+
+    end:
+        for ( i = 0; i < XI_UTEST_ARENA_SOAK_SLOTS; ++i )
+        {
+            xi_bsp_mem_free( xi_utest_arena_slots[i].ptr );
+            xi_utest_arena_slots[i].ptr = NULL;
+        }
+    } )
+
+XI_TT_TESTGROUP_END
+
+#ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#define XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#include __FILE__
+#undef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#endif
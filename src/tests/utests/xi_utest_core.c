@@ -15,6 +15,7 @@
 #include "xi_helpers.h"
 #include "xi_memory_checks.h"
 #include "xi_types.h"
+#include "xi_config.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -184,6 +185,19 @@ XI_TT_TESTCASE( test_make_handles, {
 end:;
 } )
 
+XI_TT_TESTCASE( test_set_io_buffer_size, {
+    const uint32_t default_size = xi_get_io_buffer_size();
+    tt_want_int_op( default_size, ==, XI_IO_BUFFER_SIZE );
+
+    tt_want_int_op( xi_set_io_buffer_size( 0 ), ==, XI_INVALID_PARAMETER );
+    tt_want_int_op( xi_get_io_buffer_size(), ==, default_size );
+
+    tt_want_int_op( xi_set_io_buffer_size( 1024 * 64 ), ==, XI_STATE_OK );
+    tt_want_int_op( xi_get_io_buffer_size(), ==, 1024 * 64 );
+
+    xi_set_io_buffer_size( default_size );
+} )
+
 XI_TT_TESTCASE( test_version_major, {
     tt_assert( XI_MAJOR == xi_major );
     tt_assert( 0 != xi_major );
@@ -335,6 +335,41 @@ XI_TT_TESTCASE( utest__xi_data_desc_realloc__valid_data__data_copied, {
     tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
 } )
 
+XI_TT_TESTCASE( utest__xi_make_empty_desc_alloc_uninitialized__valid_data__empty_desc, {
+    xi_data_desc_t* desc = xi_make_empty_desc_alloc_uninitialized( 1024 * 16 );
+
+    tt_assert( NULL != desc );
+    tt_assert( NULL != desc->data_ptr );
+    tt_want_int_op( desc->capacity, ==, 1024 * 16 );
+    tt_want_int_op( desc->length, ==, 0 );
+    tt_want_int_op( desc->curr_pos, ==, 0 );
+    tt_want_int_op( desc->memory_type, ==, XI_MEMORY_TYPE_MANAGED );
+
+end:
+    xi_free_desc( &desc );
+
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
+XI_TT_TESTCASE( utest__xi_free_desc_chain__header_and_shared_payload__all_released, {
+    unsigned char payload[32] = {'\0'};
+
+    xi_data_desc_t* header = xi_make_empty_desc_alloc( 4 );
+    tt_assert( NULL != header );
+
+    header->__next = xi_make_desc_from_buffer_share( payload, sizeof( payload ) );
+    tt_assert( NULL != header->__next );
+
+    xi_free_desc_chain( &header );
+
+    tt_want_ptr_op( header, ==, NULL );
+
+end:
+    xi_free_desc_chain( &header );
+
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
 XI_TT_TESTCASE( utest__xi_data_desc_realloc__valid_data__size_not_changed, {
     xi_data_desc_t* desc = xi_make_empty_desc_alloc( 32 );
 
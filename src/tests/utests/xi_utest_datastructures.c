@@ -10,8 +10,13 @@
 #include "xi_utest_basic_testcase_frame.h"
 
 #include "xi_vector.h"
+#include "xi_memory_pool.h"
 #include "xi_memory_checks.h"
 
+#ifdef XI_MEMORY_LIMITER_ENABLED
+#include "xi_memory_limiter.h"
+#endif
+
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -447,6 +452,118 @@ XI_TT_TESTCASE( test_vector_remove_if_PTR, {
     tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
 } )
 
+#if XI_VECTOR_INDEX_TYPE_MAX >= 100000
+XI_TT_TESTCASE( utest__xi_vector_push_find_del__100k_elements__all_elements_reachable, {
+    const xi_vector_index_type_t test_no_elements = 100000;
+
+#ifdef XI_MEMORY_LIMITER_ENABLED
+    /* make room for the vector's array which exceeds default memory limit */
+    xi_memory_limiter_set_limit( 16 * 1024 * 1024 );
+#endif
+
+    xi_vector_t* sv = xi_vector_create();
+    tt_assert( NULL != sv );
+
+    xi_vector_index_type_t i = 0;
+    for ( ; i < test_no_elements; ++i )
+    {
+        tt_assert( NULL != xi_vector_push( sv, XI_VEC_CONST_VALUE_PARAM(
+                                                   XI_VEC_VALUE_I32( i ) ) ) );
+    }
+
+    tt_want_int_op( sv->elem_no, ==, test_no_elements );
+    tt_want_int_op( sv->capacity, >=, test_no_elements );
+
+    /* elements at the end of the vector are reachable by the index */
+    tt_want_int_op( xi_vector_find( sv, XI_VEC_CONST_VALUE_PARAM( XI_VEC_VALUE_I32(
+                                            test_no_elements - 1 ) ),
+                                    &utest_datastructures_cmp_vector_i32 ),
+                    ==, test_no_elements - 1 );
+
+    for ( i = test_no_elements - 1; i >= 0; --i )
+    {
+        tt_want_int_op( sv->array[i].selector_t.i32_value, ==, i );
+        xi_vector_del( sv, i );
+    }
+
+    tt_want_int_op( sv->elem_no, ==, 0 );
+
+end:
+    if ( NULL != sv )
+    {
+        xi_vector_destroy( sv );
+    }
+
+#ifdef XI_MEMORY_LIMITER_ENABLED
+    xi_memory_limiter_set_limit( XI_MEMORY_LIMITER_APPLICATION_MEMORY_LIMIT +
+                                 XI_MEMORY_LIMITER_SYSTEM_MEMORY_LIMIT );
+#endif
+
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+#endif
+
+XI_TT_TESTCASE( utest__xi_memory_pool_give__pool_full__object_released, {
+    xi_memory_pool_t pool = xi_make_memory_pool( 2 );
+    void* objects[3]      = {NULL, NULL, NULL};
+
+    int i = 0;
+    for ( ; i < 3; ++i )
+    {
+        objects[i] = xi_alloc( sizeof( void* ) * 4 );
+        tt_assert( NULL != objects[i] );
+    }
+
+    for ( i = 0; i < 3; ++i )
+    {
+        xi_memory_pool_give( &pool, objects[i] );
+    }
+
+    tt_want_int_op( pool.free_count, ==, 2 );
+
+    /* most recently given back objects are taken first */
+    tt_want_ptr_op( xi_memory_pool_take( &pool ), ==, objects[1] );
+    xi_memory_pool_give( &pool, objects[1] );
+
+    xi_memory_pool_drain( &pool );
+
+    tt_want_int_op( pool.free_count, ==, 0 );
+    tt_want_ptr_op( xi_memory_pool_take( &pool ), ==, NULL );
+
+end:
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
+XI_TT_TESTCASE( utest__xi_memory_pool_resize__smaller__objects_above_released, {
+    xi_memory_pool_t pool = xi_make_memory_pool( 0 );
+
+    /* a pool of size 0 keeps nothing */
+    xi_memory_pool_give( &pool, xi_alloc( sizeof( void* ) ) );
+    tt_want_int_op( pool.free_count, ==, 0 );
+
+    xi_memory_pool_resize( &pool, 3 );
+
+    int i = 0;
+    for ( ; i < 3; ++i )
+    {
+        xi_memory_pool_give( &pool, xi_alloc( sizeof( void* ) ) );
+    }
+
+    tt_want_int_op( pool.free_count, ==, 3 );
+
+    xi_memory_pool_resize( &pool, 1 );
+
+    tt_want_int_op( pool.free_count, ==, 1 );
+    tt_want_int_op( pool.max_free_count, ==, 1 );
+
+    xi_memory_pool_resize( &pool, 0 );
+
+    tt_want_int_op( pool.free_count, ==, 0 );
+    tt_want_ptr_op( xi_memory_pool_take( &pool ), ==, NULL );
+
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
 XI_TT_TESTGROUP_END
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
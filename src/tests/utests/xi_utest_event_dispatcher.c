@@ -17,6 +17,7 @@
 #include "xi_tt_testcase_management.h"
 
 #include "xi_event_dispatcher_api.h"
+#include "xi_event_loop.h"
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
 
@@ -55,6 +56,46 @@ xi_state_t continuation1_5( xi_event_handle_arg1_t a )
 static xi_evtd_instance_t* evtd_g_i = 0;
 static xi_event_handle_t evtd_handle_g;
 
+/* lateness of each timer fired by the event loop, see the jitter test below */
+typedef struct xi_utest_jitter_s
+{
+    xi_time_t scheduled_at;
+    xi_time_t max_late;
+    xi_time_t sum_late;
+    xi_time_t min_late;
+    uint32_t fired;
+} xi_utest_jitter_t;
+
+#define XI_UTEST_JITTER_PERIOD_MS 15
+#define XI_UTEST_JITTER_SAMPLES 40
+
+xi_state_t jitter_sample( xi_event_handle_arg1_t a )
+{
+    xi_utest_jitter_t* jitter = ( xi_utest_jitter_t* )a;
+    const xi_time_t late_ms   = XI_EVTD_TICKS_TO_MILLISECONDS(
+        xi_evtd_get_current_time_ticks() - jitter->scheduled_at );
+
+    jitter->max_late = XI_MAX( jitter->max_late, late_ms );
+    jitter->min_late =
+        ( 0 == jitter->fired ) ? late_ms : XI_MIN( jitter->min_late, late_ms );
+    jitter->sum_late += late_ms;
+    jitter->fired += 1;
+
+    if ( XI_UTEST_JITTER_SAMPLES == jitter->fired )
+    {
+        xi_evtd_stop( evtd_g_i );
+        return 0;
+    }
+
+    /* execute_in counts from the step the loop is processing */
+    jitter->scheduled_at = evtd_g_i->current_step +
+                           XI_EVTD_MILLISECONDS_TO_TICKS( XI_UTEST_JITTER_PERIOD_MS );
+    xi_evtd_execute_in_ticks( evtd_g_i, xi_make_handle( &jitter_sample, jitter ),
+                              XI_EVTD_MILLISECONDS_TO_TICKS( XI_UTEST_JITTER_PERIOD_MS ),
+                              NULL );
+    return 0;
+}
+
 xi_state_t proc_loop( xi_event_handle_arg1_t a )
 {
     *( ( uint32_t* )a ) -= 1;
@@ -198,6 +239,109 @@ end:
 
 } )
 
+XI_TT_TESTCASE( utest__execute_in_ticks__sub_second_delay__executed_not_earlier, {
+    evtd_g_i = xi_evtd_create_instance();
+
+    uint32_t counter = 0;
+
+    xi_event_handle_t evtd_handle = {
+        XI_EVENT_HANDLE_ARGC1,
+        .handlers.h1 = {&continuation1_1, ( xi_event_handle_arg1_t )&counter}};
+
+    xi_evtd_execute_in_ticks( evtd_g_i, evtd_handle,
+                              XI_EVTD_MILLISECONDS_TO_TICKS( 1500 ), NULL );
+
+    xi_evtd_step_ticks( evtd_g_i, XI_EVTD_MILLISECONDS_TO_TICKS( 1000 ) );
+    tt_int_op( counter, ==, 0 );
+
+    xi_evtd_step_ticks( evtd_g_i, XI_EVTD_MILLISECONDS_TO_TICKS( 1500 ) );
+    tt_int_op( counter, ==, 1 );
+
+end:
+    xi_evtd_destroy_instance( evtd_g_i );
+} )
+
+#if XI_EVTD_TICKS_PER_SECOND == 1000
+XI_TT_TESTCASE( utest__execute_in__seconds_delay__executed_with_millisecond_precision, {
+    evtd_g_i = xi_evtd_create_instance();
+
+    uint32_t counter = 0;
+
+    xi_event_handle_t evtd_handle = {
+        XI_EVENT_HANDLE_ARGC1,
+        .handlers.h1 = {&continuation1_1, ( xi_event_handle_arg1_t )&counter}};
+
+    /* the delay counts from the current millisecond, not from a whole second */
+    xi_evtd_step_ticks( evtd_g_i, 10250 );
+    xi_evtd_execute_in( evtd_g_i, evtd_handle, 1, NULL );
+
+    xi_evtd_step_ticks( evtd_g_i, 11249 );
+    tt_int_op( counter, ==, 0 );
+
+    xi_evtd_step_ticks( evtd_g_i, 11250 );
+    tt_int_op( counter, ==, 1 );
+
+end:
+    xi_evtd_destroy_instance( evtd_g_i );
+} )
+#endif
+
+XI_TT_TESTCASE( utest__event_loop_calculate_timeout__time_event_pending__timeout_in_ms, {
+    evtd_g_i = xi_evtd_create_instance();
+
+    xi_event_handle_t evtd_handle = {
+        XI_EVENT_HANDLE_ARGC1,
+        .handlers.h1 = {&continuation1_1, ( xi_event_handle_arg1_t )NULL}};
+
+    tt_int_op( xi_event_loop_calculate_timeout( &evtd_g_i, 1 ), ==,
+               XI_DEFAULT_IDLE_TIMEOUT * 1000 );
+
+    xi_evtd_step_ticks( evtd_g_i, xi_evtd_get_current_time_ticks() );
+    xi_evtd_execute_in_ticks( evtd_g_i, evtd_handle, XI_EVTD_MILLISECONDS_TO_TICKS( 200 ),
+                              NULL );
+
+    const xi_time_t timeout_ms =
+        XI_EVTD_TICKS_TO_MILLISECONDS( XI_EVTD_MILLISECONDS_TO_TICKS( 200 ) );
+
+    tt_int_op( xi_event_loop_calculate_timeout( &evtd_g_i, 1 ), <=, timeout_ms );
+
+end:
+    xi_evtd_destroy_instance( evtd_g_i );
+} )
+
+#if XI_EVTD_TICKS_PER_SECOND == 1000
+XI_TT_TESTCASE( utest__event_loop__periodic_timer__jitter_measured, {
+    evtd_g_i = xi_evtd_create_instance();
+
+    xi_utest_jitter_t jitter;
+    memset( &jitter, 0, sizeof( jitter ) );
+
+    /* current_step is the base of execute_in, the event loop keeps it up to date */
+    xi_evtd_step_ticks( evtd_g_i, xi_evtd_get_current_time_ticks() );
+
+    jitter.scheduled_at = evtd_g_i->current_step +
+                          XI_EVTD_MILLISECONDS_TO_TICKS( XI_UTEST_JITTER_PERIOD_MS );
+    xi_evtd_execute_in_ticks( evtd_g_i, xi_make_handle( &jitter_sample, &jitter ),
+                              XI_EVTD_MILLISECONDS_TO_TICKS( XI_UTEST_JITTER_PERIOD_MS ),
+                              NULL );
+
+    tt_int_op( XI_STATE_OK, ==, xi_event_loop_with_evtds( 0, &evtd_g_i, 1 ) );
+
+    printf( "timer jitter over %u samples of %d ms: min %ld ms, avg %ld ms, max %ld ms\n",
+            ( unsigned int )jitter.fired, XI_UTEST_JITTER_PERIOD_MS,
+            ( long )jitter.min_late, ( long )( jitter.sum_late / jitter.fired ),
+            ( long )jitter.max_late );
+
+    tt_int_op( jitter.fired, ==, XI_UTEST_JITTER_SAMPLES );
+    /* never early; with one second ticks every sample was up to 1000 ms late */
+    tt_int_op( jitter.min_late, >=, 0 );
+    tt_int_op( jitter.max_late, <, 250 );
+
+end:
+    xi_evtd_destroy_instance( evtd_g_i );
+} )
+#endif
+
 XI_TT_TESTCASE( utest__register_fd, {
     evtd_g_i = xi_evtd_create_instance();
 
@@ -353,6 +497,43 @@ end:
     xi_evtd_destroy_instance( evtd_g_i );
 } )
 
+XI_TT_TESTCASE( utest__xi_evtd_execute__after_step__queue_elem_and_time_event_reused, {
+    evtd_g_i = xi_evtd_create_instance();
+
+    uint32_t counter = 0;
+
+    const xi_event_handle_queue_t* queue_elem =
+        xi_evtd_execute( evtd_g_i, xi_make_handle( &continuation1_1, &counter ) );
+
+    tt_assert( NULL != queue_elem );
+    tt_want_int_op( xi_evtd_single_step( evtd_g_i, 0 ), ==, 1 );
+
+    tt_want_ptr_op( xi_evtd_execute( evtd_g_i,
+                                     xi_make_handle( &continuation1_1, &counter ) ),
+                    ==, queue_elem );
+    tt_want_int_op( xi_evtd_single_step( evtd_g_i, 0 ), ==, 1 );
+
+    xi_time_event_handle_t time_event_handle = xi_make_empty_time_event_handle();
+
+    xi_evtd_execute_in( evtd_g_i, xi_make_handle( &continuation1_1, &counter ), 1,
+                        &time_event_handle );
+
+    const xi_vector_index_type_t* position = time_event_handle.ptr_to_position;
+
+    xi_evtd_step( evtd_g_i, 1 );
+
+    xi_evtd_execute_in( evtd_g_i, xi_make_handle( &continuation1_1, &counter ), 1,
+                        &time_event_handle );
+
+    tt_want_ptr_op( time_event_handle.ptr_to_position, ==, position );
+
+    xi_evtd_step( evtd_g_i, 2 );
+    tt_want_int_op( counter, ==, 4 );
+
+end:
+    xi_evtd_destroy_instance( evtd_g_i );
+} )
+
 /* skipped because this feature is not yet implemented */
 SKIP_XI_TT_TESTCASE(
     utest__xi_evtd__events_to_call_added__overlap_timer__proper_events_executed,
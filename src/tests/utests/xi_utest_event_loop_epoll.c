@@ -0,0 +1,204 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "tinytest.h"
+#include "tinytest_macros.h"
+#include "xi_tt_testcase_management.h"
+#include "xi_utest_basic_testcase_frame.h"
+#include "xi_memory_checks.h"
+
+#include "xi_event_loop.h"
+#include "xi_event_dispatcher_api.h"
+
+#ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+
+typedef struct xi_utest_epoll_socket_s
+{
+    xi_evtd_instance_t* evtd;
+    int fds[2]; /* fds[0] is registered, fds[1] is the peer */
+    struct xi_utest_epoll_socket_s* other;
+    uint32_t read_count;
+    uint32_t write_count;
+} xi_utest_epoll_socket_t;
+
+static xi_state_t xi_utest_epoll_on_read( xi_event_handle_arg1_t arg )
+{
+    xi_utest_epoll_socket_t* socket = ( xi_utest_epoll_socket_t* )arg;
+
+    char byte = 0;
+    if ( 1 == read( socket->fds[0], &byte, 1 ) )
+    {
+        socket->read_count += 1;
+    }
+
+    return XI_STATE_OK;
+}
+
+static xi_state_t xi_utest_epoll_on_write( xi_event_handle_arg1_t arg )
+{
+    xi_utest_epoll_socket_t* socket = ( xi_utest_epoll_socket_t* )arg;
+    socket->write_count += 1;
+
+    return XI_STATE_OK;
+}
+
+static xi_state_t xi_utest_epoll_on_read_unregister_other( xi_event_handle_arg1_t arg )
+{
+    xi_utest_epoll_socket_t* socket = ( xi_utest_epoll_socket_t* )arg;
+    socket->read_count += 1;
+
+    xi_evtd_unregister_socket_fd( socket->evtd, socket->other->fds[0] );
+
+    return XI_STATE_OK;
+}
+
+static xi_state_t xi_utest_epoll_noop( void )
+{
+    return XI_STATE_OK;
+}
+
+static int xi_utest_epoll_socket_open( xi_utest_epoll_socket_t* socket,
+                                       xi_evtd_instance_t* evtd )
+{
+    socket->evtd = evtd;
+    return socketpair( AF_UNIX, SOCK_STREAM, 0, socket->fds );
+}
+
+static void xi_utest_epoll_socket_close( xi_utest_epoll_socket_t* socket )
+{
+    close( socket->fds[0] );
+    close( socket->fds[1] );
+}
+
+#endif
+
+XI_TT_TESTGROUP_BEGIN( utest_event_loop_epoll )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_event_loop_with_evtds__socket_readable__read_handle_executed_once,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_evtd_instance_t* evtd        = xi_evtd_create_instance();
+        xi_utest_epoll_socket_t socket = {0};
+
+        tt_assert( NULL != evtd );
+        tt_assert( 0 == xi_utest_epoll_socket_open( &socket, evtd ) );
+
+        xi_evtd_register_socket_fd(
+            evtd, socket.fds[0], xi_make_handle( &xi_utest_epoll_on_read, &socket ) );
+
+        tt_assert( 1 == write( socket.fds[1], "x", 1 ) );
+
+        tt_assert( XI_STATE_OK == xi_event_loop_with_evtds( 1, &evtd, 1 ) );
+        tt_want_int_op( socket.read_count, ==, 1 );
+
+        /* nothing left to read, a due time event keeps the loop from blocking */
+        xi_evtd_execute_in( evtd, xi_make_handle( &xi_utest_epoll_noop ), 0, NULL );
+
+        tt_assert( XI_STATE_OK == xi_event_loop_with_evtds( 1, &evtd, 1 ) );
+        tt_want_int_op( socket.read_count, ==, 1 );
+
+    end:
+        xi_evtd_unregister_socket_fd( evtd, socket.fds[0] );
+        xi_utest_epoll_socket_close( &socket );
+        xi_evtd_destroy_instance( evtd );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_event_loop_with_evtds__want_write_then_default__interest_updated,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_evtd_instance_t* evtd        = xi_evtd_create_instance();
+        xi_utest_epoll_socket_t socket = {0};
+
+        tt_assert( NULL != evtd );
+        tt_assert( 0 == xi_utest_epoll_socket_open( &socket, evtd ) );
+
+        xi_evtd_register_socket_fd(
+            evtd, socket.fds[0], xi_make_handle( &xi_utest_epoll_on_read, &socket ) );
+
+        /* the registration is synced first, the write interest is a later change */
+        xi_evtd_execute_in( evtd, xi_make_handle( &xi_utest_epoll_noop ), 0, NULL );
+        tt_assert( XI_STATE_OK == xi_event_loop_with_evtds( 1, &evtd, 1 ) );
+
+        xi_evtd_continue_when_evt_on_socket(
+            evtd, XI_EVENT_WANT_WRITE,
+            xi_make_handle( &xi_utest_epoll_on_write, &socket ), socket.fds[0] );
+
+        tt_assert( XI_STATE_OK == xi_event_loop_with_evtds( 1, &evtd, 1 ) );
+        tt_want_int_op( socket.write_count, ==, 1 );
+        tt_want_int_op( socket.read_count, ==, 0 );
+
+        /* back to the read handle, the socket is still writable but not readable */
+        xi_evtd_execute_in( evtd, xi_make_handle( &xi_utest_epoll_noop ), 0, NULL );
+        tt_assert( XI_STATE_OK == xi_event_loop_with_evtds( 1, &evtd, 1 ) );
+        tt_want_int_op( socket.write_count, ==, 1 );
+        tt_want_int_op( socket.read_count, ==, 0 );
+
+        tt_assert( 1 == write( socket.fds[1], "x", 1 ) );
+
+        tt_assert( XI_STATE_OK == xi_event_loop_with_evtds( 1, &evtd, 1 ) );
+        tt_want_int_op( socket.write_count, ==, 1 );
+        tt_want_int_op( socket.read_count, ==, 1 );
+
+    end:
+        xi_evtd_unregister_socket_fd( evtd, socket.fds[0] );
+        xi_utest_epoll_socket_close( &socket );
+        xi_evtd_destroy_instance( evtd );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_event_loop_with_evtds__socket_unregistered_within_batch__not_dispatched,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_evtd_instance_t* evtd           = xi_evtd_create_instance();
+        xi_utest_epoll_socket_t sockets[2] = {{0}, {0}};
+
+        tt_assert( NULL != evtd );
+        tt_assert( 0 == xi_utest_epoll_socket_open( &sockets[0], evtd ) );
+        tt_assert( 0 == xi_utest_epoll_socket_open( &sockets[1], evtd ) );
+
+        sockets[0].other = &sockets[1];
+        sockets[1].other = &sockets[0];
+
+        int i = 0;
+        for ( ; i < 2; ++i )
+        {
+            xi_evtd_register_socket_fd(
+                evtd, sockets[i].fds[0],
+                xi_make_handle( &xi_utest_epoll_on_read_unregister_other, &sockets[i] ) );
+
+            tt_assert( 1 == write( sockets[i].fds[1], "x", 1 ) );
+        }
+
+        /* both are ready in the same batch, whichever runs first drops the other */
+        tt_assert( XI_STATE_OK == xi_event_loop_with_evtds( 1, &evtd, 1 ) );
+        tt_want_int_op( sockets[0].read_count + sockets[1].read_count, ==, 1 );
+
+    end:
+        xi_evtd_unregister_socket_fd( evtd, sockets[0].fds[0] );
+        xi_evtd_unregister_socket_fd( evtd, sockets[1].fds[0] );
+        xi_utest_epoll_socket_close( &sockets[0] );
+        xi_utest_epoll_socket_close( &sockets[1] );
+        xi_evtd_destroy_instance( evtd );
+    } )
+
+XI_TT_TESTGROUP_END
+
+#ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#define XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#include __FILE__
+#undef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#endif
@@ -14,6 +14,8 @@
 #include "xi_data_desc.h"
 #include "xi_mqtt_logic_layer_data_helpers.h"
 #include "xi_mqtt_codec_layer_data.h"
+#include "xi_mqtt_parser.h"
+#include "xi_list.h"
 
 #include "xi_memory_checks.h"
 
@@ -25,6 +27,60 @@
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
 
+/* payload of the telemetry publishes, the messages share it */
+static uint8_t xi_utest_codec_payload[64];
+
+/* queues a QoS 0 publish of the 64 bytes payload followed by a PUBACK, times times */
+static xi_state_t xi_utest_codec_queue_messages( xi_mqtt_codec_layer_task_t** queue,
+                                                 size_t times )
+{
+    xi_state_t state                 = XI_STATE_OK;
+    xi_mqtt_message_t* msg           = NULL;
+    xi_mqtt_codec_layer_task_t* task = NULL;
+    xi_data_desc_t* payload          = NULL;
+
+    payload = xi_make_desc_from_buffer_share( xi_utest_codec_payload,
+                                              sizeof( xi_utest_codec_payload ) );
+    XI_CHECK_MEMORY( payload, state );
+
+    for ( ; 0 < times; --times )
+    {
+        XI_ALLOC_AT( xi_mqtt_message_t, msg, state );
+        XI_CHECK_STATE( state = fill_with_publish_data( msg, "telemetry", payload,
+                                                        XI_MQTT_QOS_AT_MOST_ONCE,
+                                                        XI_MQTT_RETAIN_FALSE,
+                                                        XI_MQTT_DUP_FALSE, 0 ) );
+
+        task = xi_mqtt_codec_layer_make_task( msg );
+        XI_CHECK_MEMORY( task, state );
+        msg = NULL;
+        XI_LIST_PUSH_BACK( xi_mqtt_codec_layer_task_t, *queue, task );
+
+        XI_ALLOC_AT( xi_mqtt_message_t, msg, state );
+        XI_CHECK_STATE( state = fill_with_puback_data( msg, ( uint16_t )times ) );
+
+        task = xi_mqtt_codec_layer_make_task( msg );
+        XI_CHECK_MEMORY( task, state );
+        msg = NULL;
+        XI_LIST_PUSH_BACK( xi_mqtt_codec_layer_task_t, *queue, task );
+    }
+
+err_handling:
+    xi_mqtt_message_free( &msg );
+    xi_free_desc( &payload );
+    return state;
+}
+
+static void xi_utest_codec_free_queue( xi_mqtt_codec_layer_task_t** queue )
+{
+    while ( NULL != *queue )
+    {
+        xi_mqtt_codec_layer_task_t* task = NULL;
+        XI_LIST_POP( xi_mqtt_codec_layer_task_t, *queue, task );
+        xi_mqtt_codec_layer_free_task( &task );
+    }
+}
+
 #endif
 
 XI_TT_TESTGROUP_BEGIN( utest_mqtt_codec_layer_data )
@@ -180,6 +236,86 @@ err_handling:
 end:;
 } )
 
+#if 0 < XI_MQTT_OUTBOUND_BATCH_SIZE
+XI_TT_TESTCASE( utest__xi_mqtt_codec_layer_serialise_batch__queue__parsed_back, {
+    xi_mqtt_codec_layer_task_t* queue = NULL;
+    xi_data_desc_t* buffer            = NULL;
+    xi_mqtt_message_t* msg            = NULL;
+    size_t batch_size                 = 0;
+    size_t i                          = 0;
+    xi_mqtt_parser_t parser;
+
+    memset( xi_utest_codec_payload, 0x5A, sizeof( xi_utest_codec_payload ) );
+
+    tt_int_op( XI_STATE_OK, ==, xi_utest_codec_queue_messages( &queue, 4 ) );
+
+    const size_t batch_length = xi_mqtt_codec_layer_measure_batch( queue, &batch_size );
+    tt_int_op( 8, ==, batch_length );
+
+    tt_int_op( XI_STATE_OK, ==, xi_mqtt_codec_layer_serialise_batch(
+                                    queue, batch_length, batch_size, &buffer ) );
+    tt_int_op( batch_size, ==, buffer->length );
+
+    /* the messages follow each other in the buffer in the order of the queue */
+    for ( ; i < batch_length; ++i )
+    {
+        xi_state_t state = XI_STATE_OK;
+        XI_ALLOC_AT( xi_mqtt_message_t, msg, state );
+        xi_mqtt_parser_init( &parser );
+
+        tt_int_op( XI_STATE_OK, ==, xi_mqtt_parser_execute( &parser, msg, buffer ) );
+
+        if ( 0 == i % 2 )
+        {
+            tt_int_op( XI_MQTT_TYPE_PUBLISH, ==, msg->common.common_u.common_bits.type );
+            tt_int_op( sizeof( xi_utest_codec_payload ), ==,
+                       msg->publish.content->length );
+            tt_int_op( 0, ==, memcmp( xi_utest_codec_payload,
+                                      msg->publish.content->data_ptr,
+                                      sizeof( xi_utest_codec_payload ) ) );
+        }
+        else
+        {
+            tt_int_op( XI_MQTT_TYPE_PUBACK, ==, msg->common.common_u.common_bits.type );
+            tt_int_op( 4 - i / 2, ==, msg->puback.message_id );
+        }
+
+        xi_mqtt_message_free( &msg );
+    }
+
+    tt_int_op( buffer->length, ==, buffer->curr_pos );
+
+err_handling:
+end:
+    xi_mqtt_message_free( &msg );
+    xi_free_desc( &buffer );
+    xi_utest_codec_free_queue( &queue );
+
+    tt_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
+XI_TT_TESTCASE( utest__xi_mqtt_codec_layer_measure_batch__over_budget__batch_cut, {
+    xi_mqtt_codec_layer_task_t* queue = NULL;
+    size_t batch_size                 = 0;
+
+    /* a publish with its header takes more than 64 bytes */
+    const size_t times = XI_MQTT_OUTBOUND_BATCH_SIZE / sizeof( xi_utest_codec_payload );
+
+    tt_int_op( XI_STATE_OK, ==, xi_utest_codec_queue_messages( &queue, times ) );
+
+    const size_t batch_length = xi_mqtt_codec_layer_measure_batch( queue, &batch_size );
+
+    tt_int_op( 0, <, batch_length );
+    tt_int_op( 2 * times, >, batch_length );
+    tt_int_op( XI_MQTT_OUTBOUND_BATCH_SIZE, >=, batch_size );
+
+end:
+    xi_utest_codec_free_queue( &queue );
+
+    tt_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+#endif
+
 XI_TT_TESTGROUP_END
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
@@ -39,6 +39,15 @@ typedef struct xi_utest_mqtt_message_details_to_uint16_t_s
     } xi_mqtt_union;
 } xi_utest_mqtt_message_details_to_uint16_t;
 
+static xi_state_t utest__release_borrowed_buffer( void* buffer, void* release_count )
+{
+    XI_UNUSED( buffer );
+
+    *( int* )release_count += 1;
+
+    return XI_STATE_OK;
+}
+
 static void utest__fill_with_pingreq_data__valid_data__pingreq_msg_help( void )
 {
     xi_state_t local_state = XI_STATE_OK;
@@ -1168,6 +1177,30 @@ end:
     xi_mqtt_message_free( &msg_matrix );
 } )
 
+XI_TT_TESTCASE( utest__xi_mqtt_logic_free_task__borrowed_publish_data__buffer_released, {
+    uint8_t payload[]    = "borrowed payload";
+    int release_count    = 0;
+    xi_data_desc_t* data = xi_make_desc_from_buffer_share( payload, sizeof( payload ) );
+
+    xi_mqtt_logic_task_t* task = xi_mqtt_logic_make_publish_task(
+        "test_topic", data, XI_MQTT_QOS_AT_LEAST_ONCE, XI_MQTT_RETAIN_FALSE,
+        xi_make_empty_handle() );
+
+    tt_assert( NULL != task );
+
+    task->data.data_u->publish.release_handler =
+        xi_make_handle( &utest__release_borrowed_buffer, payload, &release_count );
+
+    tt_want_int_op( release_count, ==, 0 );
+
+    xi_mqtt_logic_free_task( &task );
+
+    tt_want_int_op( release_count, ==, 1 );
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+
+end:;
+} )
+
 XI_TT_TESTGROUP_END
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
@@ -70,44 +70,6 @@ static xi_state_t failed_subscribe_handler( xi_context_handle_t in_context_handl
 
 XI_TT_TESTGROUP_BEGIN( utest_mqtt_logic_layer_subscribe )
 
-XI_TT_TESTCASE( utest__cmp_topics__valid_data__cmp_topics_should_return_0, {
-    xi_event_handle_t handle = xi_make_empty_handle();
-
-    char* string1 = "test_string";
-    char* string2 = "test_string";
-
-    size_t string_len = strlen( string1 );
-
-    xi_mqtt_task_specific_data_t spd = {.subscribe = {string2, handle, 0}};
-    xi_data_desc_t data = {
-        ( unsigned char* )string1, NULL, string_len, string_len, string_len,
-        XI_MEMORY_TYPE_UNMANAGED};
-
-    union xi_vector_selector_u a = {&spd};
-    union xi_vector_selector_u b = {&data};
-
-    tt_want_int_op( cmp_topics( &a, &b ), ==, 0 );
-} )
-
-XI_TT_TESTCASE( utest__cmp_topics__valid_data__cmp_topics_should_return_1, {
-    xi_event_handle_t handle = xi_make_empty_handle();
-
-    char* string1 = "test_string1";
-    char* string2 = "test_string2";
-
-    size_t string_len = strlen( string1 );
-
-    xi_mqtt_task_specific_data_t spd = {.subscribe = {string2, handle, 0}};
-    xi_data_desc_t data = {
-        ( unsigned char* )string1, NULL, string_len, string_len, string_len,
-        XI_MEMORY_TYPE_UNMANAGED};
-
-    union xi_vector_selector_u a = {&spd};
-    union xi_vector_selector_u b = {&data};
-
-    tt_want_int_op( cmp_topics( &a, &b ), ==, 1 );
-} )
-
 XI_TT_TESTCASE_WITH_SETUP(
     utest__do_mqtt_subscribe__valid_data__subscription_handler_registered_with_success,
     xi_utest_setup_basic,
@@ -150,6 +112,9 @@ XI_TT_TESTCASE_WITH_SETUP(
         XI_ALLOC_AT( xi_mqtt_task_specific_data_t, task->data.data_u, local_state );
         xi_mqtt_task_specific_data_t* data_u = task->data.data_u;
 
+        task->data.data_u->subscribe.topic = xi_str_dup( "test/topic" );
+        tt_assert( NULL != task->data.data_u->subscribe.topic );
+
         task->data.data_u->subscribe.handler = xi_make_threaded_handle(
             XI_THREADID_THREAD_0, &xi_user_sub_call_wrapper, xi_context, NULL,
             XI_STATE_OK, ( void* )&successful_subscribe_handler, ( void* )NULL,
@@ -181,6 +146,10 @@ XI_TT_TESTCASE_WITH_SETUP(
         tt_want_ptr_op(
             logic_layer_data.handlers_for_topics->array[0].selector_t.ptr_value, ==,
             data_u );
+        tt_want_ptr_op(
+            xi_mqtt_topic_trie_match( &logic_layer_data.handlers_for_topics_trie,
+                                      ( const uint8_t* )"test/topic", 10 ),
+            ==, data_u );
 
         // make the handler to be called
         xi_evtd_step( xi_globals.evtd_instance, 20 );
@@ -188,6 +157,8 @@ XI_TT_TESTCASE_WITH_SETUP(
         tt_want_int_op( global_value_to_test, ==, 1 );
         global_value_to_test = 0;
 
+        xi_mqtt_topic_trie_clear( &logic_layer_data.handlers_for_topics_trie );
+        XI_SAFE_FREE( data_u->subscribe.topic );
         XI_SAFE_FREE( data_u );
         xi_vector_del( logic_layer_data.handlers_for_topics, 0 );
 
@@ -0,0 +1,157 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include "tinytest.h"
+#include "tinytest_macros.h"
+#include "xi_tt_testcase_management.h"
+#include "xi_utest_basic_testcase_frame.h"
+#include "xi_memory_checks.h"
+
+#include "xi_mqtt_logic_layer_data.h"
+#include "xi_mqtt_logic_layer_task_index.h"
+
+#ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+
+/* number of in-flight tasks the large index test keeps outstanding */
+#define XI_UTEST_TASK_INDEX_MANY_TASKS 10000
+
+/* kept out of the limited heap, only the index memory is accounted */
+static xi_mqtt_logic_task_t xi_utest_task_index_tasks[XI_UTEST_TASK_INDEX_MANY_TASKS];
+
+#endif
+
+XI_TT_TESTGROUP_BEGIN( utest_mqtt_logic_layer_task_index )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_mqtt_logic_task_index_find__empty_index__null,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_mqtt_logic_task_index_t index = {0};
+        xi_mqtt_logic_task_t task;
+        memset( &task, 0, sizeof( task ) );
+        task.msg_id = 1;
+
+        tt_ptr_op( NULL, ==, xi_mqtt_logic_task_index_find( &index, 1 ) );
+
+        /* removing from an empty index is a no-op */
+        xi_mqtt_logic_task_index_remove( &index, &task );
+        tt_int_op( 0, ==, index.count );
+
+    end:
+        xi_mqtt_logic_task_index_clear( &index );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_mqtt_logic_task_index_remove__colliding_ids__rest_still_found,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_mqtt_logic_task_index_t index = {0};
+        xi_mqtt_logic_task_t tasks[4];
+        memset( tasks, 0, sizeof( tasks ) );
+
+        /* all of them share the home slot of the initial table */
+        const uint16_t msg_ids[4] = {
+            1, 1 + XI_MQTT_LOGIC_TASK_INDEX_INITIAL_CAPACITY,
+            1 + 2 * XI_MQTT_LOGIC_TASK_INDEX_INITIAL_CAPACITY, 2};
+
+        int i = 0;
+        for ( ; i < 4; ++i )
+        {
+            tasks[i].msg_id = msg_ids[i];
+            tt_int_op( XI_STATE_OK, ==,
+                       xi_mqtt_logic_task_index_insert( &index, &tasks[i] ) );
+        }
+
+        xi_mqtt_logic_task_index_remove( &index, &tasks[0] );
+
+        tt_int_op( 3, ==, index.count );
+        tt_ptr_op( NULL, ==, xi_mqtt_logic_task_index_find( &index, msg_ids[0] ) );
+
+        for ( i = 1; i < 4; ++i )
+        {
+            tt_ptr_op( &tasks[i], ==,
+                       xi_mqtt_logic_task_index_find( &index, msg_ids[i] ) );
+        }
+
+    end:
+        xi_mqtt_logic_task_index_clear( &index );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_mqtt_logic_task_index_insert__same_msg_id__older_task_found_first,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_mqtt_logic_task_index_t index = {0};
+        xi_mqtt_logic_task_t tasks[2];
+        memset( tasks, 0, sizeof( tasks ) );
+
+        tasks[0].msg_id = 7;
+        tasks[1].msg_id = 7;
+
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_logic_task_index_insert( &index, &tasks[0] ) );
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_logic_task_index_insert( &index, &tasks[1] ) );
+
+        tt_ptr_op( &tasks[0], ==, xi_mqtt_logic_task_index_find( &index, 7 ) );
+
+        xi_mqtt_logic_task_index_remove( &index, &tasks[0] );
+        tt_ptr_op( &tasks[1], ==, xi_mqtt_logic_task_index_find( &index, 7 ) );
+
+    end:
+        xi_mqtt_logic_task_index_clear( &index );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_mqtt_logic_task_index__many_tasks_in_flight__all_found_and_removed,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_mqtt_logic_task_index_t index = {0};
+        xi_mqtt_logic_task_t* tasks      = xi_utest_task_index_tasks;
+
+        int i = 0;
+        for ( ; i < XI_UTEST_TASK_INDEX_MANY_TASKS; ++i )
+        {
+            tasks[i].msg_id = ( uint16_t )( i + 1 );
+            tt_int_op( XI_STATE_OK, ==,
+                       xi_mqtt_logic_task_index_insert( &index, &tasks[i] ) );
+        }
+
+        tt_int_op( XI_UTEST_TASK_INDEX_MANY_TASKS, ==, index.count );
+
+        /* acks come back in a different order than the publishes went out */
+        for ( i = XI_UTEST_TASK_INDEX_MANY_TASKS - 1; i >= 0; i -= 2 )
+        {
+            tt_ptr_op( &tasks[i], ==,
+                       xi_mqtt_logic_task_index_find( &index, tasks[i].msg_id ) );
+            xi_mqtt_logic_task_index_remove( &index, &tasks[i] );
+        }
+
+        for ( i = 0; i < XI_UTEST_TASK_INDEX_MANY_TASKS; ++i )
+        {
+            tt_ptr_op( ( i % 2 == 0 ) ? &tasks[i] : NULL, ==,
+                       xi_mqtt_logic_task_index_find( &index, tasks[i].msg_id ) );
+        }
+
+    end:
+        xi_mqtt_logic_task_index_clear( &index );
+    } )
+
+XI_TT_TESTGROUP_END
+
+#ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#define XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#include __FILE__
+#undef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#endif
@@ -0,0 +1,189 @@
+/* Copyright (c) 2003-2016, LogMeIn, Inc. All rights reserved.
+ *
+ * This is part of the Xively C Client library,
+ * it is licensed under the BSD 3-Clause license.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "tinytest.h"
+#include "tinytest_macros.h"
+#include "xi_tt_testcase_management.h"
+#include "xi_utest_basic_testcase_frame.h"
+#include "xi_memory_checks.h"
+
+#include "xi_mqtt_logic_layer_data.h"
+#include "xi_mqtt_logic_layer_topic_trie.h"
+
+#ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+
+/* number of per device subscriptions the large trie test registers, with the memory
+ * limiter's per allocation bookkeeping the nodes have to fit into its 512 KB budget */
+#define XI_UTEST_TOPIC_TRIE_MANY_SUBSCRIPTIONS 500
+
+static xi_mqtt_task_specific_data_t
+    xi_utest_topic_trie_subscriptions[XI_UTEST_TOPIC_TRIE_MANY_SUBSCRIPTIONS];
+
+static xi_mqtt_task_specific_data_t*
+xi_utest_topic_trie_match( const xi_mqtt_topic_trie_t* trie, const char* topic )
+{
+    return xi_mqtt_topic_trie_match( trie, ( const uint8_t* )topic, strlen( topic ) );
+}
+
+#endif
+
+XI_TT_TESTGROUP_BEGIN( utest_mqtt_logic_layer_topic_trie )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_mqtt_topic_trie_match__literal_filters__only_whole_topic_matched,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_mqtt_topic_trie_t trie = {0};
+        xi_mqtt_task_specific_data_t subscriptions[2];
+
+        tt_ptr_op( NULL, ==, xi_utest_topic_trie_match( &trie, "a/b" ) );
+
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "a/b", &subscriptions[0] ) );
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "a/bc", &subscriptions[1] ) );
+
+        tt_ptr_op( &subscriptions[0], ==, xi_utest_topic_trie_match( &trie, "a/b" ) );
+        tt_ptr_op( &subscriptions[1], ==, xi_utest_topic_trie_match( &trie, "a/bc" ) );
+        tt_ptr_op( NULL, ==, xi_utest_topic_trie_match( &trie, "a" ) );
+        tt_ptr_op( NULL, ==, xi_utest_topic_trie_match( &trie, "a/b/c" ) );
+        tt_ptr_op( NULL, ==, xi_utest_topic_trie_match( &trie, "a/" ) );
+
+        /* the same filter again keeps the first subscription */
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "a/b", &subscriptions[1] ) );
+        tt_ptr_op( &subscriptions[0], ==, xi_utest_topic_trie_match( &trie, "a/b" ) );
+
+    end:
+        xi_mqtt_topic_trie_clear( &trie );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_mqtt_topic_trie_match__single_level_wildcard__exactly_one_level_matched,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_mqtt_topic_trie_t trie = {0};
+        xi_mqtt_task_specific_data_t subscription;
+
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "devices/+/cmd", &subscription ) );
+
+        tt_ptr_op( &subscription, ==,
+                   xi_utest_topic_trie_match( &trie, "devices/42/cmd" ) );
+        tt_ptr_op( &subscription, ==,
+                   xi_utest_topic_trie_match( &trie, "devices//cmd" ) );
+        tt_ptr_op( NULL, ==, xi_utest_topic_trie_match( &trie, "devices/42/7/cmd" ) );
+        tt_ptr_op( NULL, ==, xi_utest_topic_trie_match( &trie, "devices/42" ) );
+
+    end:
+        xi_mqtt_topic_trie_clear( &trie );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_mqtt_topic_trie_match__multi_level_wildcard__parent_and_children_matched,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_mqtt_topic_trie_t trie = {0};
+        xi_mqtt_task_specific_data_t subscription;
+
+        tt_int_op( XI_INVALID_PARAMETER, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "a/#/b", &subscription ) );
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "a/#", &subscription ) );
+
+        tt_ptr_op( &subscription, ==, xi_utest_topic_trie_match( &trie, "a" ) );
+        tt_ptr_op( &subscription, ==, xi_utest_topic_trie_match( &trie, "a/b" ) );
+        tt_ptr_op( &subscription, ==, xi_utest_topic_trie_match( &trie, "a/b/c/d" ) );
+        tt_ptr_op( NULL, ==, xi_utest_topic_trie_match( &trie, "b/a" ) );
+
+    end:
+        xi_mqtt_topic_trie_clear( &trie );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_mqtt_topic_trie_match__overlapping_filters__most_specific_matched,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_mqtt_topic_trie_t trie = {0};
+        xi_mqtt_task_specific_data_t subscriptions[4];
+
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "#", &subscriptions[0] ) );
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "a/+/c", &subscriptions[1] ) );
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "a/b/c", &subscriptions[2] ) );
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "a/b/#", &subscriptions[3] ) );
+
+        tt_ptr_op( &subscriptions[2], ==, xi_utest_topic_trie_match( &trie, "a/b/c" ) );
+        tt_ptr_op( &subscriptions[3], ==, xi_utest_topic_trie_match( &trie, "a/b/d" ) );
+        tt_ptr_op( &subscriptions[1], ==, xi_utest_topic_trie_match( &trie, "a/x/c" ) );
+        tt_ptr_op( &subscriptions[0], ==, xi_utest_topic_trie_match( &trie, "a/x/d" ) );
+
+        /* wildcards on the first level leave the system topics alone */
+        tt_ptr_op( NULL, ==, xi_utest_topic_trie_match( &trie, "$SYS/uptime" ) );
+
+    end:
+        xi_mqtt_topic_trie_clear( &trie );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_mqtt_topic_trie_match__many_subscriptions__each_topic_dispatched,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_mqtt_topic_trie_t trie = {0};
+        xi_mqtt_task_specific_data_t wildcard_subscription;
+        char topic[64]            = {0};
+
+        int i = 0;
+        for ( ; i < XI_UTEST_TOPIC_TRIE_MANY_SUBSCRIPTIONS; ++i )
+        {
+            snprintf( topic, sizeof( topic ), "devices/%d/cmd", i );
+            tt_int_op( XI_STATE_OK, ==,
+                       xi_mqtt_topic_trie_insert(
+                           &trie, topic, &xi_utest_topic_trie_subscriptions[i] ) );
+        }
+
+        tt_int_op( XI_STATE_OK, ==,
+                   xi_mqtt_topic_trie_insert( &trie, "devices/+/status",
+                                              &wildcard_subscription ) );
+
+        for ( i = XI_UTEST_TOPIC_TRIE_MANY_SUBSCRIPTIONS - 1; i >= 0; --i )
+        {
+            snprintf( topic, sizeof( topic ), "devices/%d/cmd", i );
+            tt_ptr_op( &xi_utest_topic_trie_subscriptions[i], ==,
+                       xi_utest_topic_trie_match( &trie, topic ) );
+
+            snprintf( topic, sizeof( topic ), "devices/%d/status", i );
+            tt_ptr_op( &wildcard_subscription, ==,
+                       xi_utest_topic_trie_match( &trie, topic ) );
+        }
+
+    end:
+        xi_mqtt_topic_trie_clear( &trie );
+    } )
+
+XI_TT_TESTGROUP_END
+
+#ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#define XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#include __FILE__
+#undef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+#endif
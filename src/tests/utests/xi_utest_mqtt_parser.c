@@ -16,6 +16,10 @@
 
 #include "xi_memory_checks.h"
 
+#ifdef XI_MODULE_THREAD_ENABLED
+#include "xi_thread_posix_workerthread.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -24,6 +28,152 @@
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
 
+/* PUBLISH QoS 1 on topic a/b with message id 42 and the payload hello */
+static const uint8_t xi_utest_mqtt_parser_publish[] = {
+    0x32, 0x0C, 0x00, 0x03, 'a', '/', 'b', 0x00, 0x2A, 'h', 'e', 'l', 'l', 'o'};
+
+/* PUBACK with message id 7 */
+static const uint8_t xi_utest_mqtt_parser_puback[] = {0x40, 0x02, 0x00, 0x07};
+
+/* feeds the data in chunks of chunk_size until a message is parsed or it fails */
+static xi_state_t xi_utest_mqtt_parser_parse( const uint8_t* data,
+                                              size_t size,
+                                              size_t chunk_size,
+                                              xi_mqtt_message_t* message,
+                                              size_t* consumed )
+{
+    xi_mqtt_parser_t parser;
+    xi_state_t state = XI_STATE_WANT_READ;
+
+    xi_mqtt_parser_init( &parser );
+    *consumed = 0;
+
+    while ( XI_STATE_WANT_READ == state && *consumed < size )
+    {
+        xi_data_desc_t* desc = xi_make_desc_from_buffer_copy(
+            data + *consumed, XI_MIN( chunk_size, size - *consumed ) );
+
+        if ( NULL == desc )
+        {
+            return XI_OUT_OF_MEMORY;
+        }
+
+        state = xi_mqtt_parser_execute( &parser, message, desc );
+        *consumed += desc->curr_pos;
+
+        xi_free_desc( &desc );
+    }
+
+    return state;
+}
+
+#ifdef XI_MODULE_THREAD_ENABLED
+
+/* number of parsers running at the same time, each on its own worker thread */
+#define XI_UTEST_MQTT_PARSER_STRESS_CONTEXTS 4
+
+/* the stream is a PUBLISH and a PUBACK repeated this many times */
+#define XI_UTEST_MQTT_PARSER_STRESS_REPEATS 128
+
+#define XI_UTEST_MQTT_PARSER_STRESS_PAIR_SIZE                                            \
+    ( sizeof( xi_utest_mqtt_parser_publish ) + sizeof( xi_utest_mqtt_parser_puback ) )
+
+typedef struct xi_utest_mqtt_parser_context_s
+{
+    xi_mqtt_parser_t parser;
+    xi_mqtt_message_t* message;
+    xi_evtd_instance_t* evtd;
+    const uint8_t* stream;
+    size_t stream_size;
+    size_t offset;
+    size_t step;
+    size_t id;
+    size_t parsed_count;
+    size_t error_count;
+} xi_utest_mqtt_parser_context_t;
+
+static uint8_t xi_utest_mqtt_parser_stream[XI_UTEST_MQTT_PARSER_STRESS_REPEATS *
+                                           XI_UTEST_MQTT_PARSER_STRESS_PAIR_SIZE];
+
+static uint8_t
+xi_utest_mqtt_parser_is_expected( const xi_utest_mqtt_parser_context_t* context )
+{
+    const xi_mqtt_message_t* message = context->message;
+
+    if ( 1 == context->parsed_count % 2 )
+    {
+        return XI_MQTT_TYPE_PUBACK == message->common.common_u.common_bits.type &&
+               7 == message->puback.message_id;
+    }
+
+    return XI_MQTT_TYPE_PUBLISH == message->common.common_u.common_bits.type &&
+           42 == message->publish.message_id && NULL != message->publish.content &&
+           5 == message->publish.content->length &&
+           0 == memcmp( "hello", message->publish.content->data_ptr, 5 );
+}
+
+/*
+ * Feeds one chunk of the stream to the context's parser and queues itself again on the
+ * same dispatcher until the stream is consumed. Chunk sizes differ per context and per
+ * step, so packets arrive both whole and split at every possible offset.
+ */
+static xi_state_t xi_utest_mqtt_parser_stress_step( void* arg )
+{
+    xi_utest_mqtt_parser_context_t* context = ( xi_utest_mqtt_parser_context_t* )arg;
+    xi_data_desc_t* desc                    = NULL;
+    xi_state_t state                        = XI_STATE_OK;
+
+    const size_t chunk_size = XI_MIN( 1 + ( context->step * 7 + context->id ) % 13,
+                                      context->stream_size - context->offset );
+
+    desc = xi_make_desc_from_buffer_copy( context->stream + context->offset, chunk_size );
+    XI_CHECK_MEMORY( desc, state );
+
+    ++context->step;
+
+    while ( desc->curr_pos < desc->length )
+    {
+        state = xi_mqtt_parser_execute( &context->parser, context->message, desc );
+
+        if ( XI_STATE_WANT_READ == state )
+        {
+            break;
+        }
+
+        XI_CHECK_STATE( state );
+
+        if ( !xi_utest_mqtt_parser_is_expected( context ) )
+        {
+            ++context->error_count;
+        }
+
+        ++context->parsed_count;
+
+        xi_mqtt_message_free( &context->message );
+        XI_ALLOC_AT( xi_mqtt_message_t, context->message, state );
+        xi_mqtt_parser_init( &context->parser );
+    }
+
+    context->offset += desc->curr_pos;
+    xi_free_desc( &desc );
+
+    if ( context->offset < context->stream_size )
+    {
+        xi_evtd_execute( context->evtd,
+                         xi_make_handle( &xi_utest_mqtt_parser_stress_step, context ) );
+    }
+
+    return XI_STATE_OK;
+
+err_handling:
+    ++context->error_count;
+    xi_free_desc( &desc );
+
+    return XI_STATE_OK;
+}
+
+#endif
+
 #endif
 
 XI_TT_TESTGROUP_BEGIN( utest_mqtt_parser )
@@ -88,6 +238,242 @@ XI_TT_TESTCASE( utest__parse_suback_response__invalid_data__parser_error, {
     tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
 } )
 
+XI_TT_TESTCASE( utest__xi_mqtt_parser_execute__whole_publish__payload_allocated_once, {
+    xi_mqtt_message_t* message = NULL;
+    size_t consumed            = 0;
+    xi_state_t state           = XI_STATE_OK;
+
+    XI_ALLOC_AT( xi_mqtt_message_t, message, state );
+
+    tt_want_int_op( XI_STATE_OK, ==,
+                    xi_utest_mqtt_parser_parse( xi_utest_mqtt_parser_publish,
+                                                sizeof( xi_utest_mqtt_parser_publish ),
+                                                sizeof( xi_utest_mqtt_parser_publish ),
+                                                message, &consumed ) );
+
+    tt_want_int_op( sizeof( xi_utest_mqtt_parser_publish ), ==, consumed );
+    tt_want_int_op( 42, ==, message->publish.message_id );
+    tt_want_int_op( 3, ==, message->publish.topic_name->length );
+    tt_want_int_op( 0, ==, memcmp( "a/b", message->publish.topic_name->data_ptr, 3 ) );
+    tt_want_int_op( 5, ==, message->publish.content->length );
+    tt_want_int_op( 6, ==, message->publish.content->capacity );
+    tt_want_int_op( '\0', ==, message->publish.content->data_ptr[5] );
+    tt_want_int_op( 0, ==, memcmp( "hello", message->publish.content->data_ptr, 5 ) );
+
+err_handling:
+    xi_mqtt_message_free( &message );
+
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
+XI_TT_TESTCASE( utest__xi_mqtt_parser_execute__publish_byte_by_byte__same_message, {
+    xi_mqtt_message_t* message = NULL;
+    size_t consumed            = 0;
+    xi_state_t state           = XI_STATE_OK;
+
+    XI_ALLOC_AT( xi_mqtt_message_t, message, state );
+
+    /* no chunk holds a whole packet so all of it goes through the coroutine */
+    tt_want_int_op( XI_STATE_OK, ==,
+                    xi_utest_mqtt_parser_parse( xi_utest_mqtt_parser_publish,
+                                                sizeof( xi_utest_mqtt_parser_publish ), 1,
+                                                message, &consumed ) );
+
+    tt_want_int_op( sizeof( xi_utest_mqtt_parser_publish ), ==, consumed );
+    tt_want_int_op( 42, ==, message->publish.message_id );
+    tt_want_int_op( 3, ==, message->publish.topic_name->length );
+    tt_want_int_op( 0, ==, memcmp( "a/b", message->publish.topic_name->data_ptr, 3 ) );
+    tt_want_int_op( 5, ==, message->publish.content->length );
+    tt_want_int_op( 0, ==, memcmp( "hello", message->publish.content->data_ptr, 5 ) );
+
+err_handling:
+    xi_mqtt_message_free( &message );
+
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
+XI_TT_TESTCASE( utest__xi_mqtt_parser_execute__two_packets__first_one_consumed, {
+    xi_mqtt_message_t* message = NULL;
+    xi_data_desc_t* desc       = NULL;
+    xi_mqtt_parser_t parser;
+    xi_state_t state = XI_STATE_OK;
+
+    uint8_t buffer[sizeof( xi_utest_mqtt_parser_puback ) +
+                   sizeof( xi_utest_mqtt_parser_publish )];
+
+    memcpy( buffer, xi_utest_mqtt_parser_puback, sizeof( xi_utest_mqtt_parser_puback ) );
+    memcpy( buffer + sizeof( xi_utest_mqtt_parser_puback ), xi_utest_mqtt_parser_publish,
+            sizeof( xi_utest_mqtt_parser_publish ) );
+
+    XI_ALLOC_AT( xi_mqtt_message_t, message, state );
+    desc = xi_make_desc_from_buffer_copy( buffer, sizeof( buffer ) );
+    XI_CHECK_MEMORY( desc, state );
+
+    xi_mqtt_parser_init( &parser );
+
+    tt_want_int_op( XI_STATE_OK, ==, xi_mqtt_parser_execute( &parser, message, desc ) );
+    tt_want_int_op( XI_MQTT_TYPE_PUBACK, ==, message->common.common_u.common_bits.type );
+    tt_want_int_op( 7, ==, message->puback.message_id );
+    tt_want_int_op( sizeof( xi_utest_mqtt_parser_puback ), ==, desc->curr_pos );
+
+    xi_mqtt_message_free( &message );
+    XI_ALLOC_AT( xi_mqtt_message_t, message, state );
+    xi_mqtt_parser_init( &parser );
+
+    tt_want_int_op( XI_STATE_OK, ==, xi_mqtt_parser_execute( &parser, message, desc ) );
+    tt_want_int_op( XI_MQTT_TYPE_PUBLISH, ==, message->common.common_u.common_bits.type );
+    tt_want_int_op( 5, ==, message->publish.content->length );
+    tt_want_int_op( desc->length, ==, desc->curr_pos );
+
+err_handling:
+    xi_free_desc( &desc );
+    xi_mqtt_message_free( &message );
+
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
+XI_TT_TESTCASE( utest__xi_mqtt_parser_execute__payload_over_chunk_size__parts, {
+    const char* parts[]        = {"he", "ll", "o"};
+    xi_mqtt_message_t* message = NULL;
+    xi_data_desc_t* desc       = NULL;
+    xi_mqtt_parser_t parser;
+    xi_state_t state = XI_STATE_OK;
+    size_t i         = 0;
+
+    desc = xi_make_desc_from_buffer_copy( xi_utest_mqtt_parser_publish,
+                                          sizeof( xi_utest_mqtt_parser_publish ) );
+    XI_CHECK_MEMORY( desc, state );
+
+    xi_mqtt_parser_init( &parser );
+    xi_mqtt_parser_chunk_payload( &parser, 2 );
+
+    for ( ; i < XI_ARRAYSIZE( parts ); ++i )
+    {
+        XI_ALLOC_AT( xi_mqtt_message_t, message, state );
+
+        tt_want_int_op( XI_STATE_OK, ==,
+                        xi_mqtt_parser_execute( &parser, message, desc ) );
+        tt_want_int_op( XI_MQTT_TYPE_PUBLISH, ==,
+                        message->common.common_u.common_bits.type );
+        tt_want_int_op( 1, ==, message->common.common_u.common_bits.qos );
+        tt_want_int_op( 42, ==, message->publish.message_id );
+        tt_want_int_op( 2 * i, ==, message->publish.content_offset );
+        tt_want_int_op( 5, ==, message->publish.content_total_length );
+        tt_want_int_op( strlen( parts[i] ), ==, message->publish.content->length );
+        tt_want_int_op( 0, ==, memcmp( parts[i], message->publish.content->data_ptr,
+                                       strlen( parts[i] ) ) );
+        tt_want_int_op( i + 1 < XI_ARRAYSIZE( parts ), ==,
+                        xi_mqtt_parser_has_pending_part( &parser ) );
+
+        /* only the first part carries the topic */
+        tt_want_int_op( 0 == i, ==, NULL != message->publish.topic_name );
+
+        xi_mqtt_message_free( &message );
+    }
+
+    tt_want_int_op( desc->length, ==, desc->curr_pos );
+
+err_handling:
+    xi_free_desc( &desc );
+    xi_mqtt_message_free( &message );
+
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
+XI_TT_TESTCASE( utest__xi_mqtt_parser_execute__payload_within_chunk_size__whole, {
+    xi_mqtt_message_t* message = NULL;
+    xi_data_desc_t* desc       = NULL;
+    xi_mqtt_parser_t parser;
+    xi_state_t state = XI_STATE_OK;
+
+    XI_ALLOC_AT( xi_mqtt_message_t, message, state );
+    desc = xi_make_desc_from_buffer_copy( xi_utest_mqtt_parser_publish,
+                                          sizeof( xi_utest_mqtt_parser_publish ) );
+    XI_CHECK_MEMORY( desc, state );
+
+    xi_mqtt_parser_init( &parser );
+    xi_mqtt_parser_chunk_payload( &parser, 5 );
+
+    tt_want_int_op( XI_STATE_OK, ==, xi_mqtt_parser_execute( &parser, message, desc ) );
+    tt_want_int_op( 0, ==, xi_mqtt_parser_has_pending_part( &parser ) );
+    tt_want_int_op( 0, ==, message->publish.content_offset );
+    tt_want_int_op( 5, ==, message->publish.content_total_length );
+    tt_want_int_op( 0, ==, memcmp( "hello", message->publish.content->data_ptr, 5 ) );
+
+err_handling:
+    xi_free_desc( &desc );
+    xi_mqtt_message_free( &message );
+
+    tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+} )
+
+#ifdef XI_MODULE_THREAD_ENABLED
+XI_TT_TESTCASE(
+    utest__xi_mqtt_parser_execute__parallel_fragmented_streams__every_message_parsed, {
+        xi_utest_mqtt_parser_context_t contexts[XI_UTEST_MQTT_PARSER_STRESS_CONTEXTS];
+        xi_workerthread_t* workerthreads[XI_UTEST_MQTT_PARSER_STRESS_CONTEXTS] = {NULL};
+        xi_state_t state = XI_STATE_OK;
+
+        memset( contexts, 0, sizeof( contexts ) );
+
+        size_t i = 0;
+        for ( ; i < XI_UTEST_MQTT_PARSER_STRESS_REPEATS; ++i )
+        {
+            uint8_t* pair =
+                xi_utest_mqtt_parser_stream + i * XI_UTEST_MQTT_PARSER_STRESS_PAIR_SIZE;
+
+            memcpy( pair, xi_utest_mqtt_parser_publish,
+                    sizeof( xi_utest_mqtt_parser_publish ) );
+            memcpy( pair + sizeof( xi_utest_mqtt_parser_publish ),
+                    xi_utest_mqtt_parser_puback, sizeof( xi_utest_mqtt_parser_puback ) );
+        }
+
+        for ( i = 0; i < XI_UTEST_MQTT_PARSER_STRESS_CONTEXTS; ++i )
+        {
+            workerthreads[i] = xi_workerthread_create_instance( NULL );
+            XI_CHECK_MEMORY( workerthreads[i], state );
+
+            contexts[i].evtd        = workerthreads[i]->thread_evtd;
+            contexts[i].stream      = xi_utest_mqtt_parser_stream;
+            contexts[i].stream_size = sizeof( xi_utest_mqtt_parser_stream );
+            contexts[i].id          = i;
+
+            XI_ALLOC_AT( xi_mqtt_message_t, contexts[i].message, state );
+            xi_mqtt_parser_init( &contexts[i].parser );
+        }
+
+        /* the parsers only ever meet in the memory allocator from here on */
+        for ( i = 0; i < XI_UTEST_MQTT_PARSER_STRESS_CONTEXTS; ++i )
+        {
+            xi_evtd_execute( contexts[i].evtd,
+                             xi_make_handle( &xi_utest_mqtt_parser_stress_step,
+                                             &contexts[i] ) );
+        }
+
+    err_handling:
+        /* destroying a workerthread joins it after its queue ran empty */
+        for ( i = 0; i < XI_UTEST_MQTT_PARSER_STRESS_CONTEXTS; ++i )
+        {
+            xi_workerthread_destroy_instance( &workerthreads[i] );
+        }
+
+        tt_want_int_op( XI_STATE_OK, ==, state );
+
+        for ( i = 0; i < XI_UTEST_MQTT_PARSER_STRESS_CONTEXTS; ++i )
+        {
+            tt_want_int_op( 0, ==, contexts[i].error_count );
+            tt_want_int_op( 2 * XI_UTEST_MQTT_PARSER_STRESS_REPEATS, ==,
+                            contexts[i].parsed_count );
+            tt_want_int_op( sizeof( xi_utest_mqtt_parser_stream ), ==,
+                            contexts[i].offset );
+
+            xi_mqtt_message_free( &contexts[i].message );
+        }
+
+        tt_want_int_op( xi_is_whole_memory_deallocated(), >, 0 );
+    } )
+#endif
+
 XI_TT_TESTGROUP_END
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
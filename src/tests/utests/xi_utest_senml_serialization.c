@@ -122,6 +122,32 @@ XI_TT_TESTCASE(
         xi_free_desc( &desc );
     } )
 
+XI_TT_TESTCASE(
+    utest__xi_senml_json_serialize_float__edge_values__same_as_printf_5g,
+    {
+        const float values[] = {
+            0.0f,     -0.0f,    0.0001f,   0.00001f,     0.000123456f,  1.5e-10f,
+            99999.0f, 99999.5f, 100000.0f, 123456789.0f, 3.4028235e38f, 1.4e-45f,
+            2.5f,     22.02f,   1e+10f,    -1.1754944e-38f};
+        size_t i = 0;
+
+        for ( ; i < XI_ARRAYSIZE( values ); ++i )
+        {
+            xi_data_desc_t* desc = xi_make_empty_desc_alloc( 32 );
+            char expected[32]    = {'\0'};
+
+            const int expected_length =
+                snprintf( expected, sizeof( expected ), "%.5g", values[i] );
+
+            tt_want_int_op( xi_senml_json_serialize_float( desc, values[i] ), ==,
+                            XI_STATE_OK );
+            tt_want_int_op( desc->length, ==, expected_length );
+            tt_want_int_op( memcmp( desc->data_ptr, expected, desc->length ), ==, 0 );
+
+            xi_free_desc( &desc );
+        }
+    } )
+
 XI_TT_TESTCASE(
     utest__xi_senml_json_serialize_int__valid_data__serialized_float_int_the_buffer, {
         xi_data_desc_t* desc = xi_make_empty_desc_alloc( 32 );
@@ -691,6 +717,50 @@ XI_TT_TESTCASE( utest__xi_senml_json_serialize__valid_data__create_buffer_with_j
                     return;
                 } )
 
+XI_TT_TESTCASE(
+    utest__xi_senml_serialize_to_buffer__valid_data__same_json_repr_or_buffer_overflow,
+    {
+        xi_senml_t* structure = 0;
+        xi_state_t state      = XI_STATE_OK;
+
+        XI_CREATE_SENML_STRUCT(
+            state, structure,
+            XI_SENML_BASE_NAME( "http://base.time.com/the/best/base/time/" ),
+            XI_SENML_BASE_UNITS( "V" ), XI_SENML_BASE_TIME( 23 ) );
+
+        XI_ADD_SENML_ENTRY( state, structure,
+                            XI_SENML_ENTRY_NAME( "http://test.of.name/named_measure" ),
+                            XI_SENML_ENTRY_FLOAT_VALUE( 22.02 ) );
+
+        XI_ADD_SENML_ENTRY( state, structure, XI_SENML_ENTRY_TIME( -120 ),
+                            XI_SENML_ENTRY_BOOLEAN_VALUE( 0 ) );
+
+        XI_ADD_SENML_ENTRY( state, structure, XI_SENML_ENTRY_TIME( 123 ),
+                            XI_SENML_ENTRY_STRING_VALUE( "Hakuna Matata!" ) );
+
+        uint8_t buff[sizeof( xi_senml_cmp )] = {0};
+        uint32_t size                        = 0;
+
+        /* the size needed is returned without a buffer */
+        state = xi_senml_serialize_to_buffer( structure, NULL, 0, &size );
+
+        tt_want_int_op( state, ==, XI_BUFFER_OVERFLOW );
+        tt_want_int_op( size, ==, sizeof( xi_senml_cmp ) - 1 );
+
+        state = xi_senml_serialize_to_buffer( structure, buff, size - 1, &size );
+
+        tt_want_int_op( state, ==, XI_BUFFER_OVERFLOW );
+        tt_want_int_op( buff[0], ==, 0 );
+
+        state = xi_senml_serialize_to_buffer( structure, buff, size, &size );
+
+        tt_want_int_op( state, ==, XI_STATE_OK );
+        tt_want_int_op( size, ==, sizeof( xi_senml_cmp ) - 1 );
+        tt_want_int_op( memcmp( xi_senml_cmp, buff, size ), ==, 0 );
+
+        xi_senml_destroy( &structure );
+    } )
+
 XI_TT_TESTGROUP_END
 
 #pragma GCC diagnostic pop
@@ -12,9 +12,33 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <xi_macros.h>
 #include <xi_sft_logic_internal_methods.h>
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
+
+static uint32_t xi_utest_sft_requested_lengths[XI_SFT_FILE_CHUNK_WINDOW];
+static uint16_t xi_utest_sft_requests_sent = 0;
+
+/* records the length of the FILE_GET_CHUNK messages instead of sending them */
+static xi_state_t
+xi_utest_sft_record_file_get_chunk( void* user_data, xi_control_message_t* message )
+{
+    XI_UNUSED( user_data );
+
+    if ( xi_utest_sft_requests_sent < XI_SFT_FILE_CHUNK_WINDOW )
+    {
+        xi_utest_sft_requested_lengths[xi_utest_sft_requests_sent] =
+            message->file_get_chunk.length;
+    }
+
+    ++xi_utest_sft_requests_sent;
+
+    xi_control_message_free( &message );
+
+    return XI_STATE_OK;
+}
+
 #endif
 
 XI_TT_TESTGROUP_BEGIN( utest_sft_logic_internal_methods )
@@ -60,6 +84,70 @@ XI_TT_TESTCASE_WITH_SETUP(
         _xi_sft_send_file_get_chunk( &sft_context, 0, 0 );
     } )
 
+/*********************************************
+ * _xi_sft_request_file_chunks ***************
+ *********************************************/
+XI_TT_TESTCASE_WITH_SETUP(
+    xi_utest__request_file_chunks__chunk_size_grown__window_of_grown_requests,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_control_message_file_desc_ext_t file = {.name          = "file",
+                                                   .revision      = "revision",
+                                                   .size_in_bytes = 1024 * 1024};
+
+        xi_sft_context_t sft_context = {
+            .fn_send_message     = &xi_utest_sft_record_file_get_chunk,
+            .update_current_file = &file,
+            .chunk_size          = XI_SFT_FILE_CHUNK_SIZE_MAX};
+
+        xi_utest_sft_requests_sent = 0;
+
+        _xi_sft_request_file_chunks( &sft_context );
+
+        tt_want_int_op( XI_SFT_FILE_CHUNK_WINDOW, ==, xi_utest_sft_requests_sent );
+        tt_want_int_op( XI_SFT_FILE_CHUNK_WINDOW, ==, sft_context.chunks_in_flight );
+        tt_want_int_op( XI_SFT_FILE_CHUNK_WINDOW * XI_SFT_FILE_CHUNK_SIZE_MAX, ==,
+                        sft_context.requested_bytes );
+
+        uint16_t i = 0;
+        for ( ; i < XI_SFT_FILE_CHUNK_WINDOW; ++i )
+        {
+            tt_want_int_op( XI_SFT_FILE_CHUNK_SIZE_MAX, ==,
+                            xi_utest_sft_requested_lengths[i] );
+            tt_want_int_op( XI_SFT_FILE_CHUNK_SIZE_MAX, ==,
+                            sft_context.chunk_requests[i].length );
+        }
+
+        /* a window already full is not extended */
+        _xi_sft_request_file_chunks( &sft_context );
+
+        tt_want_int_op( XI_SFT_FILE_CHUNK_WINDOW, ==, xi_utest_sft_requests_sent );
+    } )
+
+XI_TT_TESTCASE_WITH_SETUP(
+    xi_utest__request_file_chunks__end_of_file__last_request_shorter,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_control_message_file_desc_ext_t file = {
+            .name = "file", .revision = "revision", .size_in_bytes = 100};
+
+        xi_sft_context_t sft_context = {
+            .fn_send_message     = &xi_utest_sft_record_file_get_chunk,
+            .update_current_file = &file,
+            .chunk_size          = XI_SFT_FILE_CHUNK_SIZE};
+
+        xi_utest_sft_requests_sent = 0;
+
+        _xi_sft_request_file_chunks( &sft_context );
+
+        tt_want_int_op( 1, ==, xi_utest_sft_requests_sent );
+        tt_want_int_op( 100, ==, xi_utest_sft_requested_lengths[0] );
+        tt_want_int_op( 100, ==, sft_context.requested_bytes );
+    } )
 
 /*********************************************
  * _xi_sft_select_next_resource_to_download **
@@ -37,6 +37,44 @@ void xi_utest_local__add_handler__threadpool( xi_threadpool_t* threadpool,
     }
 }
 
+/* number of handles the blocking handle waits for while its workerthread is busy */
+#define XI_UTEST_THREADPOOL_STOLEN_HANDLES 20
+
+uint32_t xi_utest_local__read_value( uint32_t* value )
+{
+    xi_lock_critical_section( xi_uteset_local_action_store_cs );
+    const uint32_t ret = *value;
+    xi_unlock_critical_section( xi_uteset_local_action_store_cs );
+
+    return ret;
+}
+
+/* blocks its workerthread until the other handles are executed and adds 1000 if they
+ * were, gives up after 5 seconds */
+xi_state_t xi_utest_local_action_wait_for_stolen_handles(
+    xi_event_handle_arg1_t function_executed_communication_channel )
+{
+    uint32_t* communication_channel =
+        ( uint32_t* )function_executed_communication_channel;
+
+    size_t counter_wait = 0;
+    for ( ; counter_wait < 500; ++counter_wait )
+    {
+        if ( XI_UTEST_THREADPOOL_STOLEN_HANDLES ==
+             xi_utest_local__read_value( communication_channel ) )
+        {
+            xi_lock_critical_section( xi_uteset_local_action_store_cs );
+            *communication_channel = *communication_channel + 1000;
+            xi_unlock_critical_section( xi_uteset_local_action_store_cs );
+            break;
+        }
+
+        XI_TIME_MILLISLEEP( 10, deltatime );
+    }
+
+    return XI_STATE_OK;
+}
+
 #endif // XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
 
 XI_TT_TESTGROUP_BEGIN( utest_thread_threadpool )
@@ -246,6 +284,42 @@ XI_TT_TESTCASE( utest__xi_threadpool_execute__multievents__alleventsexecuted, {
     xi_destroy_critical_section( &xi_uteset_local_action_store_cs );
 } )
 
+XI_TT_TESTCASE(
+    utest__xi_threadpool_execute__one_workerthread_blocked__its_handles_are_stolen, {
+        xi_init_critical_section( &xi_uteset_local_action_store_cs );
+
+        xi_threadpool_t* threadpool           = xi_threadpool_create_instance( 2 );
+        uint32_t value_shared_between_threads = 0;
+
+        xi_utest_local__add_handler__threadpool(
+            threadpool, XI_THREADID_ANYTHREAD,
+            &xi_utest_local_action_wait_for_stolen_handles,
+            ( xi_event_handle_arg1_t )&value_shared_between_threads, 1 );
+
+        // half of these are queued behind the blocking one
+        xi_utest_local__add_handler__threadpool(
+            threadpool, XI_THREADID_ANYTHREAD, &xi_utest_local_action_increase_by_one,
+            ( xi_event_handle_arg1_t )&value_shared_between_threads,
+            XI_UTEST_THREADPOOL_STOLEN_HANDLES );
+
+        // destroy stops the stealing, wait for the blocking handle first
+        size_t counter_wait = 0;
+        for ( ; counter_wait < 600 &&
+                1000 + XI_UTEST_THREADPOOL_STOLEN_HANDLES !=
+                    xi_utest_local__read_value( &value_shared_between_threads );
+              ++counter_wait )
+        {
+            XI_TIME_MILLISLEEP( 10, deltatime );
+        }
+
+        xi_threadpool_destroy_instance( &threadpool );
+
+        xi_destroy_critical_section( &xi_uteset_local_action_store_cs );
+
+        tt_want_int_op( 1000 + XI_UTEST_THREADPOOL_STOLEN_HANDLES, ==,
+                        value_shared_between_threads );
+    } )
+
 XI_TT_TESTGROUP_END
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
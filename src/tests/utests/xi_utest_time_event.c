@@ -16,6 +16,10 @@
 #include "xi_time_event.h"
 #include "xively.h"
 
+#ifdef XI_MEMORY_LIMITER_ENABLED
+#include "xi_memory_limiter.h"
+#endif
+
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
 
 #define TEST_TIME_EVENT_TEST_SIZE 64
@@ -61,6 +65,42 @@ err_handling:
     return state;
 }
 
+static xi_time_event_t*
+xi_time_event_at_position( xi_vector_t* vector, xi_time_event_handle_t* handle )
+{
+    return ( xi_time_event_t* )vector->array[*handle->ptr_to_position]
+        .selector_t.ptr_value;
+}
+
+/* checks if none of the time events has a parent with greater execution time and if all
+ * of the time events know their current position */
+static int is_heap_invariant_kept( xi_vector_t* vector )
+{
+    int i = 0;
+    for ( ; i < vector->elem_no; ++i )
+    {
+        const xi_time_event_t* time_event = vector->array[i].selector_t.ptr_value;
+
+        if ( time_event->position != i )
+        {
+            return 0;
+        }
+
+        if ( i > 0 )
+        {
+            const xi_time_event_t* parent =
+                vector->array[( i - 1 ) / XI_TIME_EVENT_HEAP_ARITY].selector_t.ptr_value;
+
+            if ( parent->time_of_execution > time_event->time_of_execution )
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
 #endif
 
 XI_TT_TESTGROUP_BEGIN( utest_time_event )
@@ -165,12 +205,20 @@ XI_TT_TESTCASE_WITH_SETUP(
             tt_assert( XI_STATE_OK == ret_state );
 
             xi_time_event_t* time_event =
-                ( xi_time_event_t* )vector->array[TEST_TIME_EVENT_TEST_SIZE - 1]
-                    .selector_t.ptr_value;
+                xi_time_event_at_position( vector, &time_event_handles[original_position] );
 
+            tt_assert( time_event == &time_events[original_position] );
             tt_assert( time_event->time_of_execution == new_test_time );
-            tt_assert( time_event->position ==
-                       *time_event_handles[original_position].ptr_to_position );
+            tt_assert( 1 == is_heap_invariant_kept( vector ) );
+
+            /* restarted element has the biggest key so it has to be taken last */
+            for ( i = 0; i < TEST_TIME_EVENT_TEST_SIZE - 1; ++i )
+            {
+                tt_assert( xi_time_event_get_top( vector ) != time_event );
+            }
+
+            tt_assert( xi_time_event_get_top( vector ) == time_event );
+            tt_assert( 0 == vector->elem_no );
 
             xi_vector_destroy( vector );
         }
@@ -217,6 +265,7 @@ XI_TT_TESTCASE_WITH_SETUP(
             tt_assert( time_event->time_of_execution == new_test_time );
             tt_assert( time_event->position ==
                        *time_event_handles[original_position].ptr_to_position );
+            tt_assert( 1 == is_heap_invariant_kept( vector ) );
 
             xi_vector_destroy( vector );
         }
@@ -269,6 +318,161 @@ XI_TT_TESTCASE_WITH_SETUP(
     end:;
     } )
 
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_time_event_random_restarts_and_cancels__heap_invariant_kept,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        xi_bsp_rng_init();
+
+        xi_vector_t* vector = xi_vector_create();
+
+        xi_time_event_handle_t time_event_handles[TEST_TIME_EVENT_TEST_SIZE] = {
+            xi_make_empty_time_event_handle()};
+        xi_time_event_t time_events[TEST_TIME_EVENT_TEST_SIZE] = {
+            xi_make_empty_time_event()};
+
+        xi_state_t ret_state = fill_vector_with_heap_elements_using_generator(
+            vector, &time_events, &time_event_handles, &random_generator_0_1000 );
+
+        tt_assert( XI_STATE_OK == ret_state );
+        tt_assert( 1 == is_heap_invariant_kept( vector ) );
+
+        int i = 0;
+        for ( ; i < TEST_TIME_EVENT_TEST_SIZE; ++i )
+        {
+            ret_state = xi_time_event_restart( vector, &time_event_handles[i],
+                                               random_generator_0_1000( i ) );
+
+            tt_assert( XI_STATE_OK == ret_state );
+            tt_assert( 1 == is_heap_invariant_kept( vector ) );
+        }
+
+        /* cancel every second element */
+        for ( i = 0; i < TEST_TIME_EVENT_TEST_SIZE; i += 2 )
+        {
+            xi_time_event_t* cancelled_time_event = NULL;
+
+            ret_state = xi_time_event_cancel( vector, &time_event_handles[i],
+                                              &cancelled_time_event );
+
+            tt_assert( XI_STATE_OK == ret_state );
+            tt_assert( cancelled_time_event == &time_events[i] );
+            tt_assert( NULL == time_event_handles[i].ptr_to_position );
+            tt_assert( 1 == is_heap_invariant_kept( vector ) );
+        }
+
+        tt_assert( TEST_TIME_EVENT_TEST_SIZE / 2 == vector->elem_no );
+
+        xi_time_t last_element_value = 0;
+
+        while ( 0 != vector->elem_no )
+        {
+            xi_time_event_t* time_event = xi_time_event_get_top( vector );
+            tt_assert( time_event->time_of_execution >= last_element_value );
+            tt_assert( 1 == is_heap_invariant_kept( vector ) );
+            last_element_value = time_event->time_of_execution;
+        }
+
+        xi_vector_destroy( vector );
+    end:
+        xi_bsp_rng_shutdown();
+    } )
+
+#if XI_VECTOR_INDEX_TYPE_MAX >= 100000
+XI_TT_TESTCASE_WITH_SETUP(
+    utest__xi_time_event_add_restart_cancel__100k_time_events__heap_invariant_kept,
+    xi_utest_setup_basic,
+    xi_utest_teardown_basic,
+    NULL,
+    {
+        const int test_no_elements = 100000;
+
+        xi_state_t state                           = XI_STATE_OK;
+        xi_vector_t* vector                        = NULL;
+        xi_time_event_t* time_events               = NULL;
+        xi_time_event_handle_t* time_event_handles = NULL;
+
+        xi_bsp_rng_init();
+
+#ifdef XI_MEMORY_LIMITER_ENABLED
+        /* make room for the time events and the vector's array which exceed default
+         * memory limit */
+        xi_memory_limiter_set_limit( 32 * 1024 * 1024 );
+#endif
+
+        vector = xi_vector_create();
+        XI_CHECK_MEMORY( vector, state );
+
+        XI_ALLOC_BUFFER_AT( xi_time_event_t, time_events,
+                            sizeof( xi_time_event_t ) * test_no_elements, state );
+        XI_ALLOC_BUFFER_AT( xi_time_event_handle_t, time_event_handles,
+                            sizeof( xi_time_event_handle_t ) * test_no_elements, state );
+
+        int i = 0;
+        for ( ; i < test_no_elements; ++i )
+        {
+            time_events[i].time_of_execution = xi_bsp_rng_get() % 100000;
+            tt_assert( XI_STATE_OK ==
+                       xi_time_event_add( vector, &time_events[i], &time_event_handles[i] ) );
+        }
+
+        tt_assert( test_no_elements == vector->elem_no );
+        tt_assert( 1 == is_heap_invariant_kept( vector ) );
+
+        for ( i = 0; i < test_no_elements; ++i )
+        {
+            tt_assert( XI_STATE_OK ==
+                       xi_time_event_restart( vector, &time_event_handles[i],
+                                              xi_bsp_rng_get() % 100000 ) );
+        }
+
+        tt_assert( 1 == is_heap_invariant_kept( vector ) );
+
+        /* cancel every second element */
+        for ( i = 0; i < test_no_elements; i += 2 )
+        {
+            xi_time_event_t* cancelled_time_event = NULL;
+            tt_assert( XI_STATE_OK == xi_time_event_cancel( vector,
+                                                            &time_event_handles[i],
+                                                            &cancelled_time_event ) );
+            tt_assert( cancelled_time_event == &time_events[i] );
+        }
+
+        tt_assert( test_no_elements / 2 == vector->elem_no );
+        tt_assert( 1 == is_heap_invariant_kept( vector ) );
+
+        xi_time_t last_element_value = 0;
+
+        while ( 0 != vector->elem_no )
+        {
+            xi_time_event_t* time_event = xi_time_event_get_top( vector );
+            tt_assert( time_event->time_of_execution >= last_element_value );
+            last_element_value = time_event->time_of_execution;
+        }
+
+    end:
+    err_handling:
+        if ( NULL != vector )
+        {
+            xi_vector_destroy( vector );
+        }
+
+        XI_SAFE_FREE( time_events );
+        XI_SAFE_FREE( time_event_handles );
+
+#ifdef XI_MEMORY_LIMITER_ENABLED
+        xi_memory_limiter_set_limit( XI_MEMORY_LIMITER_APPLICATION_MEMORY_LIMIT +
+                                     XI_MEMORY_LIMITER_SYSTEM_MEMORY_LIMIT );
+#endif
+
+        tt_want( XI_STATE_OK == state );
+
+        xi_bsp_rng_shutdown();
+    } )
+#endif
+
 XI_TT_TESTGROUP_END
 
 #ifndef XI_TT_TESTCASE_ENUMERATION__SECONDPREPROCESSORRUN
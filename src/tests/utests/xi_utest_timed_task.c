@@ -217,7 +217,8 @@ XI_TT_TESTCASE( utest__recurring_timed_task__check_recurring_callbacks_by_1_time
     void* user_data = ( void* )( intptr_t )0x4242;
     xi_timed_task_handle_t task_handle =
         xi_add_timed_task( container, dispatcher, context_handle,
-                           &xi_utest_timed_task_callback, 1, 1, user_data );
+                           &xi_utest_timed_task_callback,
+                           XI_EVTD_SECONDS_TO_TICKS( 1 ), 1, user_data );
 
     tt_want_int_op( context_handle, !=, xi_utest_timed_task_last_context_handle );
     tt_want_int_op( task_handle, !=, xi_utest_timed_task_last_timed_task_handle );
@@ -264,7 +265,8 @@ XI_TT_TESTCASE( utest__recurring_timed_task__check_recurring_callbacks_by_2_time
     void* user_data = ( void* )( intptr_t )0x4242;
     xi_timed_task_handle_t task_handle =
         xi_add_timed_task( container, dispatcher, context_handle,
-                           &xi_utest_timed_task_callback, 2, 1, user_data );
+                           &xi_utest_timed_task_callback,
+                           XI_EVTD_SECONDS_TO_TICKS( 2 ), 1, user_data );
 
     tt_want_int_op( context_handle, !=, xi_utest_timed_task_last_context_handle );
     tt_want_int_op( task_handle, !=, xi_utest_timed_task_last_timed_task_handle );
@@ -323,7 +325,8 @@ XI_TT_TESTCASE( utest__remove_recurring_timed_task__wont_call_callback_after_rem
     void* user_data = ( void* )( intptr_t )0x4242;
     xi_timed_task_handle_t task_handle =
         xi_add_timed_task( container, dispatcher, context_handle,
-                           &xi_utest_timed_task_callback, 1, 1, user_data );
+                           &xi_utest_timed_task_callback,
+                           XI_EVTD_SECONDS_TO_TICKS( 1 ), 1, user_data );
 
     xi_evtd_step( dispatcher, 0 );
 
@@ -380,7 +383,8 @@ XI_TT_TESTCASE(
         void* user_data                    = ( void* )container;
         xi_timed_task_handle_t task_handle = xi_add_timed_task(
             container, dispatcher, context_handle,
-            &xi_utest_timed_task_callback_remove_timed_task, 1, 1, user_data );
+            &xi_utest_timed_task_callback_remove_timed_task,
+            XI_EVTD_SECONDS_TO_TICKS( 1 ), 1, user_data );
 
         xi_evtd_step( dispatcher, 0 );
 
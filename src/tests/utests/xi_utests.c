@@ -36,6 +36,10 @@
 #define XI_TT_RESOURCE_MANAGER                  ( XI_TT_FS << 1 )
 #define XI_TT_IO_LAYER                          ( XI_TT_RESOURCE_MANAGER << 1 )
 #define XI_TT_TIME_EVENT                        ( XI_TT_IO_LAYER << 1 )
+#define XI_TT_EVENT_LOOP_EPOLL                  ( XI_TT_TIME_EVENT << 1 )
+#define XI_TT_MQTT_LOGIC_LAYER_TASK_INDEX       ( XI_TT_EVENT_LOOP_EPOLL << 1 )
+#define XI_TT_MQTT_LOGIC_LAYER_TOPIC_TRIE       ( XI_TT_MQTT_LOGIC_LAYER_TASK_INDEX << 1 )
+#define XI_TT_BSP_MEM_ARENA                     ( XI_TT_MQTT_LOGIC_LAYER_TOPIC_TRIE << 1 )
 
 // clang-format on
 
@@ -59,6 +63,8 @@ XI_TT_TESTCASE_PREDECLARATION( utest_backoff );
 XI_TT_TESTCASE_PREDECLARATION( utest_mqtt_ctors_dtors );
 XI_TT_TESTCASE_PREDECLARATION( utest_mqtt_parser );
 XI_TT_TESTCASE_PREDECLARATION( utest_mqtt_logic_layer_subscribe );
+XI_TT_TESTCASE_PREDECLARATION( utest_mqtt_logic_layer_task_index );
+XI_TT_TESTCASE_PREDECLARATION( utest_mqtt_logic_layer_topic_trie );
 XI_TT_TESTCASE_PREDECLARATION( utest_mqtt_codec_layer_data );
 XI_TT_TESTCASE_PREDECLARATION( utest_publish );
 XI_TT_TESTCASE_PREDECLARATION( utest_fwu_checksum );
@@ -117,6 +123,14 @@ XI_TT_TESTCASE_PREDECLARATION( utest_fs_posix );
 
 XI_TT_TESTCASE_PREDECLARATION( utest_time_event );
 
+#ifdef XI_EVENT_LOOP_EPOLL
+XI_TT_TESTCASE_PREDECLARATION( utest_event_loop_epoll );
+#endif
+
+#ifdef XI_BSP_MEM_ARENA
+XI_TT_TESTCASE_PREDECLARATION( utest_bsp_mem_arena );
+#endif
+
 #include "xi_test_utils.h"
 #include "xi_lamp_communication.h"
 
@@ -174,6 +188,14 @@ struct testgroup_t groups[] = {
     {"utest_mqtt_logic_layer_subscribe - ", utest_mqtt_logic_layer_subscribe},
 #endif
 
+#if ( XI_TT_TEST_SET & XI_TT_MQTT_LOGIC_LAYER_TASK_INDEX )
+    {"utest_mqtt_logic_layer_task_index - ", utest_mqtt_logic_layer_task_index},
+#endif
+
+#if ( XI_TT_TEST_SET & XI_TT_MQTT_LOGIC_LAYER_TOPIC_TRIE )
+    {"utest_mqtt_logic_layer_topic_trie - ", utest_mqtt_logic_layer_topic_trie},
+#endif
+
 #if ( XI_TT_TEST_SET & XI_TT_PUBLISH )
     {"utest_publish - ", utest_publish},
 #endif
@@ -255,6 +277,18 @@ struct testgroup_t groups[] = {
     {"utest_time_event - ", utest_time_event},
 #endif
 
+#ifdef XI_EVENT_LOOP_EPOLL
+#if ( XI_TT_TEST_SET & XI_TT_EVENT_LOOP_EPOLL )
+    {"utest_event_loop_epoll - ", utest_event_loop_epoll},
+#endif
+#endif
+
+#ifdef XI_BSP_MEM_ARENA
+#if ( XI_TT_TEST_SET & XI_TT_BSP_MEM_ARENA )
+    {"utest_bsp_mem_arena - ", utest_bsp_mem_arena},
+#endif
+#endif
+
     {"utest_rng - ", utest_rng},
     {"utest_fwu_checksum - ", utest_fwu_checksum},
 #ifdef XI_SECURE_FILE_TRANSFER_ENABLED